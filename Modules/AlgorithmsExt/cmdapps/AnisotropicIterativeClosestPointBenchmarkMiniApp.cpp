@@ -0,0 +1,191 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// std includes
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+// VTK includes
+#include <vtkCleanPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+#include <vtkTransform.h>
+#include <vtkTransformPolyDataFilter.h>
+
+// CTK includes
+#include "mitkCommandLineParser.h"
+
+// MITK includes
+#include <mitkAnisotropicIterativeClosestPointRegistration.h>
+#include <mitkCovarianceMatrixCalculator.h>
+#include <mitkSurface.h>
+
+/** \brief MiniApp that measures the run time of repeated A-ICP registrations of two synthetic ellipsoids
+ *
+ * Every run registers the same surfaces, once with a new registration object, which builds the kd tree of the
+ * fixed surface and allocates its search buffers, and once with a registration object that is reused between
+ * the runs like in an intraoperative loop. The mean run times of both variants are reported.
+ */
+
+namespace
+{
+  typedef itk::Matrix<double, 3, 3> Matrix3x3;
+  typedef std::vector<Matrix3x3> CovarianceMatrixList;
+
+  mitk::Surface::Pointer CreateEllipsoid(vtkTransform *transform, int thetaResolution, int phiResolution)
+  {
+    auto sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSource->SetRadius(1.0);
+    sphereSource->SetThetaResolution(thetaResolution);
+    sphereSource->SetPhiResolution(phiResolution);
+
+    auto transformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+    transformFilter->SetInputConnection(sphereSource->GetOutputPort());
+    transformFilter->SetTransform(transform);
+
+    auto cleanFilter = vtkSmartPointer<vtkCleanPolyData>::New();
+    cleanFilter->SetInputConnection(transformFilter->GetOutputPort());
+    cleanFilter->Update();
+
+    auto surface = mitk::Surface::New();
+    surface->SetVtkPolyData(cleanFilter->GetOutput());
+    return surface;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  mitkCommandLineParser parser;
+
+  parser.setCategory("Registration Tools");
+  parser.setTitle("A-ICP Benchmark");
+  parser.setDescription("MiniApp that measures the run time of repeated A-ICP registrations of two synthetic ellipsoids.");
+  parser.setContributor("DKFZ MIC");
+
+  parser.setArgumentPrefix("--", "-");
+  parser.beginGroup("Optional parameters");
+  parser.addArgument("theta", "t", mitkCommandLineParser::Int, "Theta resolution", "Theta resolution of the ellipsoids (default: 200)");
+  parser.addArgument("phi", "p", mitkCommandLineParser::Int, "Phi resolution", "Phi resolution of the ellipsoids (default: 125)");
+  parser.addArgument("runs", "n", mitkCommandLineParser::Int, "Runs", "Number of registrations per variant (default: 5)");
+  parser.addArgument("help", "h", mitkCommandLineParser::Bool, "Help:", "Show this help text");
+  parser.endGroup();
+
+  std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
+
+  if (parsedArgs.count("help") || parsedArgs.count("h"))
+  {
+    std::cout << parser.helpText();
+    return EXIT_SUCCESS;
+  }
+
+  // about 25k vertices by default, comparable to intraoperatively acquired surfaces
+  int thetaResolution = 200;
+  int phiResolution = 125;
+  int runs = 5;
+
+  if (parsedArgs.count("theta"))
+    thetaResolution = us::any_cast<int>(parsedArgs["theta"]);
+  if (parsedArgs.count("phi"))
+    phiResolution = us::any_cast<int>(parsedArgs["phi"]);
+  if (parsedArgs.count("runs"))
+    runs = us::any_cast<int>(parsedArgs["runs"]);
+
+  if (thetaResolution < 3 || phiResolution < 3 || runs < 1)
+  {
+    std::cerr << "The resolutions have to be at least 3 and the number of runs has to be positive." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  try
+  {
+    auto fixedTransform = vtkSmartPointer<vtkTransform>::New();
+    fixedTransform->Scale(80.0, 60.0, 40.0);
+
+    auto movingTransform = vtkSmartPointer<vtkTransform>::New();
+    movingTransform->Translate(1.0, -2.0, 1.5);
+    movingTransform->RotateWXYZ(3.0, 1.0, 1.0, 0.0);
+    movingTransform->Concatenate(fixedTransform);
+
+    auto fixedSurface = CreateEllipsoid(fixedTransform, thetaResolution, phiResolution);
+    auto movingSurface = CreateEllipsoid(movingTransform, thetaResolution, phiResolution);
+
+    mitk::CovarianceMatrixCalculator::Pointer matrixCalculator = mitk::CovarianceMatrixCalculator::New();
+
+    matrixCalculator->SetInputSurface(movingSurface);
+    matrixCalculator->ComputeCovarianceMatrices();
+    CovarianceMatrixList sigmasMovingSurface = matrixCalculator->GetCovarianceMatrices();
+    const double meanVarX = matrixCalculator->GetMeanVariance();
+
+    matrixCalculator->SetInputSurface(fixedSurface);
+    matrixCalculator->ComputeCovarianceMatrices();
+    CovarianceMatrixList sigmasFixedSurface = matrixCalculator->GetCovarianceMatrices();
+    const double meanVarY = matrixCalculator->GetMeanVariance();
+
+    auto createRegistration = [&]() {
+      mitk::AnisotropicIterativeClosestPointRegistration::Pointer aICP =
+        mitk::AnisotropicIterativeClosestPointRegistration::New();
+      aICP->SetMovingSurface(movingSurface);
+      aICP->SetFixedSurface(fixedSurface);
+      aICP->SetCovarianceMatricesMovingSurface(sigmasMovingSurface);
+      aICP->SetCovarianceMatricesFixedSurface(sigmasFixedSurface);
+      aICP->SetFRENormalizationFactor(sqrt(meanVarX + meanVarY));
+      aICP->SetSearchRadius(2.0);
+      aICP->SetMaxIterations(10);
+      aICP->SetTrimmFactor(0.9);
+      return aICP;
+    };
+
+    std::cout << "Registering ellipsoids with " << movingSurface->GetVtkPolyData()->GetNumberOfPoints()
+              << " and " << fixedSurface->GetVtkPolyData()->GetNumberOfPoints() << " points" << std::endl;
+
+    double newRegistrationMilliseconds = 0.0;
+    for (int run = 0; run < runs; ++run)
+    {
+      auto aICP = createRegistration();
+
+      const auto start = std::chrono::steady_clock::now();
+      aICP->Update();
+      newRegistrationMilliseconds +=
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // the first run of the reused registration builds the kd tree, the following runs reuse it
+    auto reusedRegistration = createRegistration();
+    double reusedRegistrationMilliseconds = 0.0;
+    for (int run = 0; run < runs; ++run)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      reusedRegistration->Update();
+      reusedRegistrationMilliseconds +=
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::cout << "New registration per run: " << newRegistrationMilliseconds / runs << " ms" << std::endl;
+    std::cout << "Reused registration: " << reusedRegistrationMilliseconds / runs << " ms, "
+              << reusedRegistration->GetNumberOfIterations() << " iterations, FRE "
+              << reusedRegistration->GetFRE() << std::endl;
+
+    return EXIT_SUCCESS;
+  }
+  catch (const std::exception &e)
+  {
+    MITK_ERROR << e.what();
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    MITK_ERROR << "Unexpected error encountered.";
+    return EXIT_FAILURE;
+  }
+}
@@ -25,8 +25,11 @@ found in the LICENSE file.
 
 // ITK
 #include <itkMatrix.h>
+// VTK
+#include <vtkSmartPointer.h>
 
 // forward declarations
+class vtkIdList;
 class vtkPoints;
 class vtkKdTreePointLocator;
 
@@ -57,6 +60,9 @@ namespace mitk
     * Surface representation.
     *
     * \note The correspondence search is accelerated when OpenMP is enabled.
+    * The kd tree of the fixed surface and the scratch buffers of the
+    * correspondence search are kept between calls of Update(). The kd tree
+    * is only rebuilt if the fixed surface was exchanged or modified.
     *
     * \b Example:
     *
@@ -175,6 +181,12 @@ namespace mitk
     /** The computed 3x3 rotation matrix.*/
     Rotation m_Rotation;
 
+    /** Kd tree of the fixed surface that is reused between calls of Update().*/
+    vtkSmartPointer<vtkKdTreePointLocator> m_FixedSurfaceLocator;
+
+    /** Per-thread id lists used by the radius search in ComputeCorrespondences().*/
+    std::vector<vtkSmartPointer<vtkIdList>> m_SearchIdLists;
+
     /**
       * Method that computes the correspondences between the moving point set X
       * and the fixed point set Y. The distances between the points
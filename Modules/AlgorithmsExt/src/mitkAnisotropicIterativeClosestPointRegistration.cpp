@@ -10,6 +10,10 @@ found in the LICENSE file.
 
 ============================================================================*/
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 // MITK
 #include "mitkAnisotropicIterativeClosestPointRegistration.h"
 #include "mitkAnisotropicRegistrationCommon.h"
@@ -22,10 +26,11 @@ found in the LICENSE file.
 #include <vtkKdTreePointLocator.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
-// STL pair
+// STL
+#include <algorithm>
 #include <utility>
 
-/** \brief Comperator implementation used to sort the CorrespondenceList in the
+/** \brief Comperator implementation used to partition the CorrespondenceList in the
   *        trimmed version of the AnisotropicIterativeClosestPointRegistration.
   */
 struct AICPComperator
@@ -46,7 +51,8 @@ mitk::AnisotropicIterativeClosestPointRegistration::AnisotropicIterativeClosestP
     m_NumberOfIterations(0),
     m_MovingSurface(nullptr),
     m_FixedSurface(nullptr),
-    m_WeightedPointTransform(mitk::WeightedPointTransform::New())
+    m_WeightedPointTransform(mitk::WeightedPointTransform::New()),
+    m_FixedSurfaceLocator(vtkSmartPointer<vtkKdTreePointLocator>::New())
 {
 }
 
@@ -65,6 +71,16 @@ void mitk::AnisotropicIterativeClosestPointRegistration::ComputeCorrespondences(
 {
   typedef itk::Matrix<double, 3, 3> WeightMatrix;
 
+#ifdef _OPENMP
+  const auto numberOfThreads = static_cast<std::size_t>(omp_get_max_threads());
+#else
+  const std::size_t numberOfThreads = 1;
+#endif
+
+  // allocate the id lists of the radius search only once per thread
+  while (m_SearchIdLists.size() < numberOfThreads)
+    m_SearchIdLists.push_back(vtkSmartPointer<vtkIdList>::New());
+
 #pragma omp parallel for
   for (int i = 0; i < X->GetNumberOfPoints(); ++i)
   {
@@ -72,7 +88,12 @@ void mitk::AnisotropicIterativeClosestPointRegistration::ComputeCorrespondences(
     mitk::Vector3D x;
     mitk::Vector3D y;
     double bestDist = std::numeric_limits<double>::max();
-    vtkIdList *ids = vtkIdList::New();
+#ifdef _OPENMP
+    vtkIdList *ids = m_SearchIdLists[omp_get_thread_num()];
+#else
+    vtkIdList *ids = m_SearchIdLists[0];
+#endif
+    ids->Reset();
     double r = radius;
     double p[3];
     // get point
@@ -123,8 +144,6 @@ void mitk::AnisotropicIterativeClosestPointRegistration::ComputeCorrespondences(
 
     Correspondence _pair(i, bestDist);
     correspondences[i] = _pair;
-
-    ids->Delete();
   }
 }
 
@@ -155,8 +174,9 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
   CovarianceMatrixList Sigma_X_sorted;
   CovarianceMatrixList Sigma_Z_sorted;
 
-  // create kdtree for correspondence search
-  vtkKdTreePointLocator *Y = vtkKdTreePointLocator::New();
+  // kdtree for correspondence search, BuildLocator() only rebuilds the
+  // tree if the fixed surface was exchanged or modified since the last call
+  vtkKdTreePointLocator *Y = m_FixedSurfaceLocator;
   Y->SetDataSet(m_FixedSurface->GetVtkPolyData());
   Y->BuildLocator();
 
@@ -216,11 +236,17 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
       CovarianceMatrixList *Sigma_Z_k = &Sigma_Z;
       CovarianceMatrixList *Sigma_X_k = &Sigma_X;
 
-      // sort the correspondences depending on their
-      // distance, if trimming is enabled
+      // select the correspondences with the smallest
+      // distances, if trimming is enabled
       if (m_TrimmFactor > 0.0)
       {
-        std::sort(distanceList.begin(), distanceList.end(), AICPComp);
+        if (numberOfTrimmedPoints < distanceList.size())
+        {
+          std::nth_element(distanceList.begin(),
+                           distanceList.begin() + numberOfTrimmedPoints,
+                           distanceList.end(),
+                           AICPComp);
+        }
         // map correspondences to the data arrays
         for (unsigned int i = 0; i < numberOfTrimmedPoints; ++i)
         {
@@ -298,7 +324,6 @@ void mitk::AnisotropicIterativeClosestPointRegistration::Update()
     mitk::ProgressBar::GetInstance()->Progress(steps);
 
   // free memory
-  Y->Delete();
   Z->Delete();
   X->Delete();
   X_sorted->Delete();
@@ -13,6 +13,7 @@ found in the LICENSE file.
 #include <mitkAnisotropicRegistrationCommon.h>
 #include <mitkPointSet.h>
 #include <vtkPoints.h>
+#include <vnl/algo/vnl_svd_fixed.h>
 
 mitk::AnisotropicRegistrationCommon::WeightMatrix mitk::AnisotropicRegistrationCommon::CalculateWeightMatrix(
   const CovarianceMatrix &sigma_X, const CovarianceMatrix &sigma_Y)
@@ -20,7 +21,8 @@ mitk::AnisotropicRegistrationCommon::WeightMatrix mitk::AnisotropicRegistrationC
   WeightMatrix returnValue;
 
   WeightMatrix sum = sigma_X + sigma_Y;
-  vnl_svd<double> svd(sum.GetVnlMatrix());
+  // fixed size decomposition, avoids heap allocations in the correspondence search
+  vnl_svd_fixed<double, 3, 3> svd(sum.GetVnlMatrix());
 
   WeightMatrix diag;
   diag.Fill(0.0);
@@ -15,6 +15,7 @@ found in the LICENSE file.
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 #include <vtkCleanPolyData.h>
+#include <vtkSphereSource.h>
 #include <vtkTransformPolyDataFilter.h>
 #include <vtkTransform.h>
 
@@ -25,12 +26,15 @@ found in the LICENSE file.
 /**
  * Test to verify the results of the A-ICP registration.
  * The test runs the standard A-ICP and the trimmed variant.
+ * In addition, repeated registrations that reuse the kd tree of the fixed
+ * surface are checked to yield the same result.
  */
 class mitkAnisotropicIterativeClosestPointRegistrationTestSuite : public mitk::TestFixture
 {
   CPPUNIT_TEST_SUITE(mitkAnisotropicIterativeClosestPointRegistrationTestSuite);
   MITK_TEST(testAicpRegistration);
   MITK_TEST(testTrimmedAicpregistration);
+  MITK_TEST(testRepeatedAicpRegistrationReusesKdTree);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -163,6 +167,87 @@ public:
     CPPUNIT_ASSERT_MESSAGE("mitkAnisotropicIterativeClosestPointRegistrationTest:AicpRegistration Test TRE",
                            mitk::Equal(tre, expTRE, 0.01));
   }
+
+  mitk::Surface::Pointer CreateEllipsoid(vtkTransform *transform)
+  {
+    auto sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSource->SetRadius(1.0);
+    sphereSource->SetThetaResolution(100);
+    sphereSource->SetPhiResolution(60);
+
+    auto transformFilter = vtkSmartPointer<vtkTransformPolyDataFilter>::New();
+    transformFilter->SetInputConnection(sphereSource->GetOutputPort());
+    transformFilter->SetTransform(transform);
+
+    auto cleanFilter = vtkSmartPointer<vtkCleanPolyData>::New();
+    cleanFilter->SetInputConnection(transformFilter->GetOutputPort());
+    cleanFilter->Update();
+
+    auto surface = mitk::Surface::New();
+    surface->SetVtkPolyData(cleanFilter->GetOutput());
+    return surface;
+  }
+
+  void testRepeatedAicpRegistrationReusesKdTree()
+  {
+    auto fixedTransform = vtkSmartPointer<vtkTransform>::New();
+    fixedTransform->Scale(80.0, 60.0, 40.0);
+
+    auto movingTransform = vtkSmartPointer<vtkTransform>::New();
+    movingTransform->Translate(1.0, -2.0, 1.5);
+    movingTransform->RotateWXYZ(3.0, 1.0, 1.0, 0.0);
+    movingTransform->Concatenate(fixedTransform);
+
+    auto fixedSurface = this->CreateEllipsoid(fixedTransform);
+    auto movingSurface = this->CreateEllipsoid(movingTransform);
+
+    mitk::CovarianceMatrixCalculator::Pointer matrixCalculator = mitk::CovarianceMatrixCalculator::New();
+
+    matrixCalculator->SetInputSurface(movingSurface);
+    matrixCalculator->ComputeCovarianceMatrices();
+    CovarianceMatrixList sigmasMovingSurface = matrixCalculator->GetCovarianceMatrices();
+    const double meanVarX = matrixCalculator->GetMeanVariance();
+
+    matrixCalculator->SetInputSurface(fixedSurface);
+    matrixCalculator->ComputeCovarianceMatrices();
+    CovarianceMatrixList sigmasFixedSurface = matrixCalculator->GetCovarianceMatrices();
+    const double meanVarY = matrixCalculator->GetMeanVariance();
+
+    mitk::AnisotropicIterativeClosestPointRegistration::Pointer aICP =
+      mitk::AnisotropicIterativeClosestPointRegistration::New();
+
+    aICP->SetMovingSurface(movingSurface);
+    aICP->SetFixedSurface(fixedSurface);
+    aICP->SetCovarianceMatricesMovingSurface(sigmasMovingSurface);
+    aICP->SetCovarianceMatricesFixedSurface(sigmasFixedSurface);
+    aICP->SetFRENormalizationFactor(sqrt(meanVarX + meanVarY));
+    aICP->SetSearchRadius(10.0);
+    aICP->SetMaxIterations(10);
+    aICP->SetTrimmFactor(0.9);
+
+    // the first run builds the kd tree of the fixed surface, the following
+    // runs reuse it like the registration in an intraoperative loop
+    const unsigned int numberOfRuns = 3;
+    std::vector<double> fres;
+
+    for (unsigned int run = 0; run < numberOfRuns; ++run)
+    {
+      aICP->Update();
+      fres.push_back(aICP->GetFRE());
+    }
+
+    for (unsigned int run = 1; run < numberOfRuns; ++run)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Repeated registrations with a reused kd tree yield the same FRE",
+                             mitk::Equal(fres[0], fres[run], mitk::eps));
+    }
+
+    // the registration has to recover the translation of the moving surface
+    const Vector3 translation = aICP->GetTranslation();
+    CPPUNIT_ASSERT_MESSAGE("A-ICP recovers the translation of the ellipsoid",
+                           std::abs(translation[0] + 1.0) < 0.5 && std::abs(translation[1] - 2.0) < 0.5 &&
+                             std::abs(translation[2] + 1.5) < 0.5);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkAnisotropicIterativeClosestPointRegistration)
@@ -18,13 +18,13 @@ found in the LICENSE file.
 #include "mitkStatusBar.h"
 #include "mitkTimeHelper.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "vtkMatrix4x4.h"
 #include "vtkSmartPointer.h"
 #include "vtkTransform.h"
 
-#include "itkImageRegionIteratorWithIndex.h"
 #include <itkImageIOBase.h>
 #include <itkImageRegionConstIterator.h>
 #include <itkRGBAPixel.h>
@@ -50,14 +50,13 @@ namespace mitk
   template <typename TPixel, unsigned int VImageDimension>
   void BoundingShapeCropper::CutImage(itk::Image<TPixel, VImageDimension> *inputItkImage, int timeStep)
   {
+    static_assert(VImageDimension == 3, "CutImage processes rows of volumes.");
+
     MITK_INFO << "Scalar Pixeltype" << std::endl;
 
     typedef TPixel TOutputPixel;
-    typedef itk::Image<TPixel, VImageDimension> ItkInputImageType;
     typedef itk::Image<TOutputPixel, VImageDimension> ItkOutputImageType;
     typedef typename itk::ImageBase<VImageDimension>::RegionType ItkRegionType;
-    typedef itk::ImageRegionIteratorWithIndex<ItkInputImageType> ItkInputImageIteratorType;
-    typedef itk::ImageRegionIteratorWithIndex<ItkOutputImageType> ItkOutputImageIteratorType;
 
     TOutputPixel outsideValue = this->GetOutsideValue();
     // currently 0 if not set in advance
@@ -86,9 +85,6 @@ namespace mitk
     typename ItkRegionType::SizeType size;
     size.SetSize(tmpSize);
 
-    // create the ITK-image-region out of index and size
-    ItkRegionType inputRegionOfInterest(index, size);
-
     // Get access to the MITK output image via an ITK image
     typename mitk::ImageToItk<ItkOutputImageType>::Pointer outputimagetoitk =
       mitk::ImageToItk<ItkOutputImageType>::New();
@@ -96,13 +92,8 @@ namespace mitk
     outputimagetoitk->Update();
     typename ItkOutputImageType::Pointer outputItkImage = outputimagetoitk->GetOutput();
 
-    // create the iterators
-    ItkInputImageIteratorType inputIt(inputItkImage, inputRegionOfInterest);
-    ItkOutputImageIteratorType outputIt(outputItkImage, outputItkImage->GetLargestPossibleRegion());
-
-    // Cut the boundingbox out of the image by iterating through all images
-    // TODO: use more efficient method by using the contour instead off all single pixels
-    mitk::Point3D p;
+    // Cut the boundingbox out of the image row by row: along a row the object coordinates of the voxels change
+    // linearly, so the voxels inside the box form one contiguous span that can be computed analytically.
     mitk::BaseGeometry *inputGeometry = this->GetInput()->GetGeometry(timeStep);
 
     // calculates translation based on offset+extent not on the transformation matrix
@@ -119,33 +110,117 @@ namespace mitk
     transform->Concatenate(translation);
     transform->Update();
 
-    mitk::Vector3D extent;
+    // combine index to world and world to object transform into one affine map from index to object coordinates
+    auto worldToObject = vtkSmartPointer<vtkMatrix4x4>::New();
+    vtkMatrix4x4::Invert(transform->GetMatrix(), worldToObject);
+    const auto &indexToWorldMatrix = inputGeometry->GetIndexToWorldTransform()->GetMatrix();
+    const auto &indexToWorldOffset = inputGeometry->GetIndexToWorldTransform()->GetOffset();
+
+    ScalarType indexToObject[3][4];
     for (unsigned int i = 0; i < 3; ++i)
-      extent[i] = (this->m_Geometry->GetGeometry()->GetExtent(i));
+    {
+      for (unsigned int j = 0; j < 3; ++j)
+      {
+        indexToObject[i][j] = 0.0;
+        for (unsigned int k = 0; k < 3; ++k)
+          indexToObject[i][j] += worldToObject->GetElement(i, k) * indexToWorldMatrix[k][j];
+      }
 
-    for (inputIt.GoToBegin(), outputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+      indexToObject[i][3] = worldToObject->GetElement(i, 3);
+      for (unsigned int k = 0; k < 3; ++k)
+        indexToObject[i][3] += worldToObject->GetElement(i, k) * indexToWorldOffset[k];
+    }
+
+    mitk::Vector3D halfExtent;
+    for (unsigned int i = 0; i < 3; ++i)
+      halfExtent[i] = (this->m_Geometry->GetGeometry()->GetExtent(i)) / 2.0;
+
+    const bool isCroppedTimeStep = !this->m_UseCropTimeStepOnly || timeStep == this->m_CurrentTimeStep;
+
+    const TPixel *inputBuffer = inputItkImage->GetBufferPointer();
+    TOutputPixel *outputBuffer = outputItkImage->GetBufferPointer();
+    const auto rowLength = static_cast<itk::OffsetValueType>(size[0]);
+    const auto numberOfRows = static_cast<long>(size[1] * size[2]);
+
+    // rows are independent and processed concurrently
+#pragma omp parallel for
+    for (long row = 0; row < numberOfRows; ++row)
     {
-      vtk2itk(inputIt.GetIndex(), p);
-      inputGeometry->IndexToWorld(p, p);
-      ScalarType p2[4];
-      p2[0] = p[0];
-      p2[1] = p[1];
-      p2[2] = p[2];
-      p2[3] = 1;
-      // transform point from world to object coordinates
-      transform->GetInverse()->TransformPoint(p2, p2);
-      // check if the world point is within bounds
-      bool isInside = (p2[0] >= (-extent[0] / 2.0)) && (p2[0] <= (extent[0] / 2.0)) && (p2[1] >= (-extent[1] / 2.0)) &&
-        (p2[1] <= (extent[1] / 2.0)) && (p2[2] >= (-extent[2] / 2.0)) && (p2[2] <= (extent[2] / 2.0));
-
-      if ((!this->m_UseCropTimeStepOnly && isInside) ||
-        (this->m_UseCropTimeStepOnly && timeStep == this->m_CurrentTimeStep && isInside))
+      typename ItkRegionType::IndexType rowIndex = index;
+      rowIndex[1] += row % static_cast<itk::OffsetValueType>(size[1]);
+      rowIndex[2] += row / static_cast<itk::OffsetValueType>(size[1]);
+
+      // object coordinates of the first voxel of the row and their increment along the row
+      ScalarType rowStart[3];
+      ScalarType rowStep[3];
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        rowStart[i] = indexToObject[i][0] * rowIndex[0] + indexToObject[i][1] * rowIndex[1] +
+                      indexToObject[i][2] * rowIndex[2] + indexToObject[i][3];
+        rowStep[i] = indexToObject[i][0];
+      }
+
+      auto isInside = [&](itk::OffsetValueType x) {
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          const ScalarType p = rowStart[i] + x * rowStep[i];
+          if (p < -halfExtent[i] || p > halfExtent[i])
+            return false;
+        }
+        return true;
+      };
+
+      itk::OffsetValueType spanBegin = 0;
+      itk::OffsetValueType spanEnd = 0;
+      if (isCroppedTimeStep)
+      {
+        ScalarType lower = 0.0;
+        ScalarType upper = rowLength - 1;
+        for (unsigned int i = 0; i < 3 && lower <= upper; ++i)
+        {
+          if (rowStep[i] == 0.0)
+          {
+            if (rowStart[i] < -halfExtent[i] || rowStart[i] > halfExtent[i])
+              upper = -1.0;
+            continue;
+          }
+          const ScalarType t1 = (-halfExtent[i] - rowStart[i]) / rowStep[i];
+          const ScalarType t2 = (halfExtent[i] - rowStart[i]) / rowStep[i];
+          lower = std::max(lower, std::min(t1, t2));
+          upper = std::min(upper, std::max(t1, t2));
+        }
+
+        if (lower <= upper)
+        {
+          spanBegin = static_cast<itk::OffsetValueType>(std::ceil(lower));
+          spanEnd = static_cast<itk::OffsetValueType>(std::floor(upper)) + 1;
+
+          // correct rounding errors at the span borders with the exact inside test
+          while (spanBegin < spanEnd && !isInside(spanBegin))
+            ++spanBegin;
+          while (spanBegin < spanEnd && !isInside(spanEnd - 1))
+            --spanEnd;
+          if (spanBegin < spanEnd)
+          {
+            while (spanBegin > 0 && isInside(spanBegin - 1))
+              --spanBegin;
+            while (spanEnd < rowLength && isInside(spanEnd))
+              ++spanEnd;
+          }
+        }
+      }
+
+      TOutputPixel *outputRow = outputBuffer + row * rowLength;
+      if (spanBegin < spanEnd)
       {
-        outputIt.Set((TOutputPixel)inputIt.Value());
+        const TPixel *inputRow = inputBuffer + inputItkImage->ComputeOffset(rowIndex);
+        std::fill(outputRow, outputRow + spanBegin, outsideValue);
+        std::copy(inputRow + spanBegin, inputRow + spanEnd, outputRow + spanBegin);
+        std::fill(outputRow + spanEnd, outputRow + rowLength, outsideValue);
       }
       else
       {
-        outputIt.Set(outsideValue);
+        std::fill(outputRow, outputRow + rowLength, outsideValue);
       }
     }
   }
@@ -274,7 +349,8 @@ namespace mitk
       return;
     }
 
-    AccessByItk_1(image, CutImage, boTimeStep);
+    // time steps are cut separately, so CutImage only gets volumes
+    AccessFixedDimensionByItk_1(image, CutImage, 3, boTimeStep);
   }
 
   void BoundingShapeCropper::GenerateData()
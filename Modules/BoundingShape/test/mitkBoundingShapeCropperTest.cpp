@@ -0,0 +1,160 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkBoundingShapeCropper.h>
+#include <mitkGeometry3D.h>
+#include <mitkImageGenerator.h>
+#include <mitkImagePixelReadAccessor.h>
+
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
+#include <vtkTransform.h>
+
+class mitkBoundingShapeCropperTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkBoundingShapeCropperTestSuite);
+  MITK_TEST(Mask_AxisAlignedBox_EqualsPerVoxelInsideTest);
+  MITK_TEST(Mask_RotatedBox_EqualsPerVoxelInsideTest);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+
+  static const short OutsideValue = -1;
+
+  static mitk::GeometryData::Pointer CreateBox(double angleZ, double angleX)
+  {
+    mitk::BaseGeometry::BoundsArrayType bounds;
+    bounds[0] = 0.0;
+    bounds[1] = 20.0;
+    bounds[2] = 0.0;
+    bounds[3] = 12.0;
+    bounds[4] = 0.0;
+    bounds[5] = 8.0;
+
+    auto rotation = vtkSmartPointer<vtkTransform>::New();
+    rotation->Translate(6.0, 8.0, 6.0);
+    rotation->RotateZ(angleZ);
+    rotation->RotateX(angleX);
+
+    auto geometry = mitk::Geometry3D::New();
+    geometry->SetBounds(bounds);
+    geometry->SetIndexToWorldTransformByVtkMatrix(rotation->GetMatrix());
+
+    auto box = mitk::GeometryData::New();
+    box->SetGeometry(geometry);
+    return box;
+  }
+
+  /** Masks the image the way the cropper did before it worked row-wise: every voxel is transformed into the
+   * coordinate system of the box and tested against its extent.*/
+  static void CheckAgainstPerVoxelInsideTest(const mitk::Image *input,
+                                             const mitk::Image *output,
+                                             const mitk::GeometryData *box)
+  {
+    mitk::BaseGeometry *boxGeometry = box->GetGeometry();
+    vtkSmartPointer<vtkMatrix4x4> boxMatrix = boxGeometry->GetVtkTransform()->GetMatrix();
+    mitk::Point3D center = boxGeometry->GetCenter();
+    auto translation = vtkSmartPointer<vtkTransform>::New();
+    translation->Translate(center[0] - boxMatrix->GetElement(0, 3),
+                           center[1] - boxMatrix->GetElement(1, 3),
+                           center[2] - boxMatrix->GetElement(2, 3));
+    auto transform = vtkSmartPointer<vtkTransform>::New();
+    transform->SetMatrix(boxMatrix);
+    transform->PostMultiply();
+    transform->Concatenate(translation);
+    transform->Update();
+
+    mitk::Vector3D extent;
+    for (unsigned int i = 0; i < 3; ++i)
+      extent[i] = boxGeometry->GetExtent(i);
+
+    mitk::ImagePixelReadAccessor<short, 3> inputAccessor(input);
+    mitk::ImagePixelReadAccessor<short, 3> outputAccessor(output);
+
+    unsigned int numberOfInsideVoxels = 0;
+    unsigned int numberOfDifferences = 0;
+
+    for (unsigned int z = 0; z < input->GetDimension(2); ++z)
+    {
+      for (unsigned int y = 0; y < input->GetDimension(1); ++y)
+      {
+        for (unsigned int x = 0; x < input->GetDimension(0); ++x)
+        {
+          mitk::Point3D p;
+          p[0] = x;
+          p[1] = y;
+          p[2] = z;
+          input->GetGeometry()->IndexToWorld(p, p);
+
+          double objectPoint[4] = {p[0], p[1], p[2], 1.0};
+          transform->GetInverse()->TransformPoint(objectPoint, objectPoint);
+
+          const bool isInside = objectPoint[0] >= -extent[0] / 2.0 && objectPoint[0] <= extent[0] / 2.0 &&
+                                objectPoint[1] >= -extent[1] / 2.0 && objectPoint[1] <= extent[1] / 2.0 &&
+                                objectPoint[2] >= -extent[2] / 2.0 && objectPoint[2] <= extent[2] / 2.0;
+
+          itk::Index<3> index;
+          index[0] = x;
+          index[1] = y;
+          index[2] = z;
+          const short expected = isInside ? inputAccessor.GetPixelByIndex(index) : OutsideValue;
+
+          if (isInside)
+            ++numberOfInsideVoxels;
+          if (expected != outputAccessor.GetPixelByIndex(index))
+            ++numberOfDifferences;
+        }
+      }
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("The box must contain voxels.", numberOfInsideVoxels > 0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Masked image differs from the per voxel inside test.", 0u, numberOfDifferences);
+  }
+
+  void TestMask(double angleZ, double angleX)
+  {
+    auto box = CreateBox(angleZ, angleX);
+
+    auto cropper = mitk::BoundingShapeCropper::New();
+    cropper->SetInput(m_Image);
+    cropper->SetGeometry(box);
+    cropper->SetUseWholeInputRegion(true);
+    cropper->SetOutsideValue(OutsideValue);
+    cropper->Update();
+
+    mitk::Image::Pointer output = cropper->GetOutput();
+    CPPUNIT_ASSERT(output.IsNotNull());
+    for (unsigned int i = 0; i < 3; ++i)
+      CPPUNIT_ASSERT_EQUAL(m_Image->GetDimension(i), output->GetDimension(i));
+
+    CheckAgainstPerVoxelInsideTest(m_Image, output, box);
+  }
+
+public:
+  void setUp() override
+  {
+    // the spacing makes the box borders fall between voxels at varying positions
+    m_Image = mitk::ImageGenerator::GenerateRandomImage<short>(40, 36, 30, 1, 0.7, 0.9, 1.1, 1000.0, 0.0);
+  }
+
+  void tearDown() override { m_Image = nullptr; }
+
+  void Mask_AxisAlignedBox_EqualsPerVoxelInsideTest() { TestMask(0.0, 0.0); }
+
+  void Mask_RotatedBox_EqualsPerVoxelInsideTest() { TestMask(30.0, 20.0); }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkBoundingShapeCropper)
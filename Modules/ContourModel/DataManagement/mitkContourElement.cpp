@@ -10,9 +10,65 @@ found in the LICENSE file.
 
 ============================================================================*/
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
 #include <mitkContourElement.h>
+#include <unordered_map>
 #include <vtkMath.h>
 
+/** Uniform grid over the vertex coordinates. Only non empty cells are stored.*/
+struct mitk::ContourElement::SpatialIndex
+{
+  using CellKeyType = std::array<long long, 3>;
+
+  struct CellKeyHash
+  {
+    std::size_t operator()(const CellKeyType &key) const
+    {
+      return std::hash<long long>()((key[0] * 73856093LL) ^ (key[1] * 19349663LL) ^ (key[2] * 83492791LL));
+    }
+  };
+
+  explicit SpatialIndex(double cellSize) : CellSize(cellSize) {}
+
+  CellKeyType GetCell(const mitk::Point3D &point) const
+  {
+    return {{static_cast<long long>(std::floor(point[0] / CellSize)),
+             static_cast<long long>(std::floor(point[1] / CellSize)),
+             static_cast<long long>(std::floor(point[2] / CellSize))}};
+  }
+
+  void Insert(VertexType *vertex) { Cells[this->GetCell(vertex->Coordinates)].push_back(vertex); }
+
+  bool Remove(const VertexType *vertex, const mitk::Point3D &coordinates)
+  {
+    auto cell = Cells.find(this->GetCell(coordinates));
+    if (cell == Cells.end())
+    {
+      return false;
+    }
+
+    auto &vertices = cell->second;
+    auto finding = std::find(vertices.begin(), vertices.end(), vertex);
+    if (finding == vertices.end())
+    {
+      return false;
+    }
+
+    *finding = vertices.back();
+    vertices.pop_back();
+    if (vertices.empty())
+    {
+      Cells.erase(cell);
+    }
+    return true;
+  }
+
+  double CellSize;
+  std::unordered_map<CellKeyType, std::vector<VertexType *>, CellKeyHash> Cells;
+};
+
 bool mitk::ContourElement::ContourModelVertex::operator==(const ContourModelVertex &other) const
 {
   return this->Coordinates == other.Coordinates && this->IsControlPoint == other.IsControlPoint;
@@ -58,12 +114,16 @@ mitk::ContourElement::VertexIterator mitk::ContourElement::end()
   return this->m_Vertices.end();
 }
 
+mitk::ContourElement::ContourElement()
+{
+}
+
 mitk::ContourElement::ContourElement(const mitk::ContourElement &other)
   : itk::LightObject(), m_IsClosed(other.m_IsClosed)
 {
   for (const auto &v : other.m_Vertices)
   {
-    m_Vertices.push_back(new ContourModelVertex(*v));
+    m_Vertices.push_back(this->CreateVertex(v->Coordinates, v->IsControlPoint));
   }
 }
 
@@ -74,7 +134,7 @@ mitk::ContourElement &mitk::ContourElement::operator=(const ContourElement &othe
     this->Clear();
     for (const auto &v : other.m_Vertices)
     {
-      m_Vertices.push_back(new ContourModelVertex(*v));
+      m_Vertices.push_back(this->CreateVertex(v->Coordinates, v->IsControlPoint));
     }
   }
 
@@ -94,12 +154,20 @@ mitk::ContourElement::VertexSizeType mitk::ContourElement::GetSize() const
 
 void mitk::ContourElement::AddVertex(const mitk::Point3D &vertex, bool isControlPoint)
 {
-  this->m_Vertices.push_back(new VertexType(vertex, isControlPoint));
+  this->m_Vertices.push_back(this->CreateVertex(vertex, isControlPoint));
+}
+
+void mitk::ContourElement::AddVertices(const std::vector<mitk::Point3D> &points, bool isControlPoint)
+{
+  for (const auto &point : points)
+  {
+    this->m_Vertices.push_back(this->CreateVertex(point, isControlPoint));
+  }
 }
 
 void mitk::ContourElement::AddVertexAtFront(const mitk::Point3D &vertex, bool isControlPoint)
 {
-  this->m_Vertices.push_front(new VertexType(vertex, isControlPoint));
+  this->m_Vertices.push_front(this->CreateVertex(vertex, isControlPoint));
 }
 
 void mitk::ContourElement::InsertVertexAtIndex(const mitk::Point3D &vertex, bool isControlPoint, VertexSizeType index)
@@ -108,7 +176,7 @@ void mitk::ContourElement::InsertVertexAtIndex(const mitk::Point3D &vertex, bool
   {
     auto _where = this->m_Vertices.begin();
     _where += index;
-    this->m_Vertices.insert(_where, new VertexType(vertex, isControlPoint));
+    this->m_Vertices.insert(_where, this->CreateVertex(vertex, isControlPoint));
   }
 }
 
@@ -116,7 +184,9 @@ void mitk::ContourElement::SetVertexAt(VertexSizeType pointId, const Point3D &po
 {
   if (pointId >= 0 && this->GetSize() > pointId)
   {
+    const mitk::Point3D previousCoordinates = this->m_Vertices[pointId]->Coordinates;
     this->m_Vertices[pointId]->Coordinates = point;
+    this->UpdateSpatialIndex(this->m_Vertices[pointId], previousCoordinates);
   }
 }
 
@@ -129,8 +199,10 @@ void mitk::ContourElement::SetVertexAt(VertexSizeType pointId, const VertexType
 
   if (pointId >= 0 && this->GetSize() > pointId)
   {
+    const mitk::Point3D previousCoordinates = this->m_Vertices[pointId]->Coordinates;
     this->m_Vertices[pointId]->Coordinates = vertex->Coordinates;
     this->m_Vertices[pointId]->IsControlPoint = vertex->IsControlPoint;
+    this->UpdateSpatialIndex(this->m_Vertices[pointId], previousCoordinates);
   }
 }
 
@@ -151,52 +223,132 @@ bool mitk::ContourElement::IsEmpty() const
 
 mitk::ContourElement::VertexType *mitk::ContourElement::GetControlVertexAt(const mitk::Point3D &point, float eps)
 {
-  /* current version iterates over the whole deque - should some kind of an octree with spatial query*/
-
   if (eps > 0)
   {
-    // currently no method with better performance is available
-    return BruteForceGetVertexAt(point, eps, true);
+    return this->GetNearestVertex(point, eps, true);
   } // if eps < 0
   return nullptr;
 }
 
 mitk::ContourElement::VertexType *mitk::ContourElement::GetVertexAt(const mitk::Point3D &point, float eps)
 {
-  /* current version iterates over the whole deque - should some kind of an octree with spatial query*/
-
   if (eps > 0)
   {
-    // currently no method with better performance is available
-    return BruteForceGetVertexAt(point, eps);
+    return this->GetNearestVertex(point, eps, false);
   } // if eps < 0
   return nullptr;
 }
 
 mitk::ContourElement::VertexType *mitk::ContourElement::GetNextControlVertexAt(const mitk::Point3D &point, float eps)
 {
-  /* current version iterates over the whole deque - should some kind of an octree with spatial query*/
-
   if (eps > 0)
   {
-    // currently no method with better performance is available
-    return BruteForceGetVertexAt(point, eps, true, 1);
+    return this->GetControlVertexWithOffset(point, eps, 1);
   } // if eps < 0
   return nullptr;
 }
 
 mitk::ContourElement::VertexType *mitk::ContourElement::GetPreviousControlVertexAt(const mitk::Point3D &point, float eps)
 {
-  /* current version iterates over the whole deque - should some kind of an octree with spatial query*/
-
   if (eps > 0)
   {
-    // currently no method with better performance is available
-    return BruteForceGetVertexAt(point, eps, true, -1);
+    return this->GetControlVertexWithOffset(point, eps, -1);
   } // if eps < 0
   return nullptr;
 }
 
+mitk::ContourElement::VertexType *mitk::ContourElement::GetNearestVertex(const mitk::Point3D &point,
+                                                                         double eps,
+                                                                         bool controlPointsOnly)
+{
+  VertexType *nearestVertex = nullptr;
+  double nearestDistance = std::numeric_limits<double>::max();
+
+  auto checkVertex = [&](VertexType *vertex) {
+    if (controlPointsOnly && !vertex->IsControlPoint)
+    {
+      return;
+    }
+
+    const double distance = vertex->Coordinates.EuclideanDistanceTo(point);
+    if (distance < eps && distance < nearestDistance)
+    {
+      nearestVertex = vertex;
+      nearestDistance = distance;
+    }
+  };
+
+  if (this->m_Vertices.size() >= SPATIAL_INDEX_MINIMUM_SIZE)
+  {
+    if (nullptr == m_SpatialIndex)
+    {
+      // cells of the size of the query radius, so a query has to check 27 cells
+      m_SpatialIndex.reset(new SpatialIndex(eps));
+      for (auto vertex : this->m_Vertices)
+      {
+        m_SpatialIndex->Insert(vertex);
+      }
+    }
+
+    const auto reach = static_cast<long long>(std::ceil(eps / m_SpatialIndex->CellSize));
+    const auto cellCount = (2 * reach + 1) * (2 * reach + 1) * (2 * reach + 1);
+
+    // for radii much larger than the cell size checking all vertices is cheaper
+    if (cellCount <= static_cast<long long>(this->m_Vertices.size()))
+    {
+      const auto center = m_SpatialIndex->GetCell(point);
+      SpatialIndex::CellKeyType key;
+
+      for (key[0] = center[0] - reach; key[0] <= center[0] + reach; ++key[0])
+      {
+        for (key[1] = center[1] - reach; key[1] <= center[1] + reach; ++key[1])
+        {
+          for (key[2] = center[2] - reach; key[2] <= center[2] + reach; ++key[2])
+          {
+            const auto cell = m_SpatialIndex->Cells.find(key);
+            if (cell != m_SpatialIndex->Cells.end())
+            {
+              std::for_each(cell->second.begin(), cell->second.end(), checkVertex);
+            }
+          }
+        }
+      }
+
+      return nearestVertex;
+    }
+  }
+
+  std::for_each(this->m_Vertices.begin(), this->m_Vertices.end(), checkVertex);
+  return nearestVertex;
+}
+
+mitk::ContourElement::VertexType *mitk::ContourElement::GetControlVertexWithOffset(const mitk::Point3D &point,
+                                                                                   double eps,
+                                                                                   int offset)
+{
+  VertexType *vertex = this->GetNearestVertex(point, eps, true);
+
+  if (nullptr == vertex || 0 == offset)
+  {
+    return vertex;
+  }
+
+  const auto size = static_cast<long long>(this->m_Vertices.size());
+  long long index = std::find(this->m_Vertices.begin(), this->m_Vertices.end(), vertex) - this->m_Vertices.begin();
+  const long long step = offset > 0 ? 1 : -1;
+
+  for (int remaining = std::abs(offset); remaining > 0;)
+  {
+    index = (index + step + size) % size;
+    if (this->m_Vertices[index]->IsControlPoint)
+    {
+      --remaining;
+    }
+  }
+
+  return this->m_Vertices[index];
+}
+
 mitk::ContourElement::VertexType *mitk::ContourElement::BruteForceGetVertexAt(const mitk::Point3D &point,
                                                                               double eps,
                                                                               bool isControlPoint,
@@ -373,12 +525,12 @@ void mitk::ContourElement::Concatenate(const mitk::ContourElement *other, bool c
 
         if (finding == this->m_Vertices.end())
         {
-          this->m_Vertices.push_back(new ContourModelVertex(*sourceVertex));
+          this->m_Vertices.push_back(this->CreateVertex(sourceVertex->Coordinates, sourceVertex->IsControlPoint));
         }
       }
       else
       {
-        this->m_Vertices.push_back(new ContourModelVertex(*sourceVertex));
+        this->m_Vertices.push_back(this->CreateVertex(sourceVertex->Coordinates, sourceVertex->IsControlPoint));
       }
     }
   }
@@ -433,7 +585,7 @@ bool mitk::ContourElement::RemoveVertexByIterator(VertexListType::iterator &iter
 {
   if (iter != this->m_Vertices.end())
   {
-    delete *iter;
+    this->ReleaseVertex(*iter);
     this->m_Vertices.erase(iter);
     return true;
   }
@@ -443,11 +595,59 @@ bool mitk::ContourElement::RemoveVertexByIterator(VertexListType::iterator &iter
 
 void mitk::ContourElement::Clear()
 {
-  for (auto vertex : m_Vertices)
+  this->m_Vertices.clear();
+  this->m_FreeVertices.clear();
+  this->m_VertexStorage.clear();
+  this->m_SpatialIndex.reset();
+}
+
+mitk::ContourElement::VertexType *mitk::ContourElement::CreateVertex(const mitk::Point3D &point, bool isControlPoint)
+{
+  VertexType *vertex = nullptr;
+
+  if (this->m_FreeVertices.empty())
   {
-    delete vertex;
+    this->m_VertexStorage.emplace_back(point, isControlPoint);
+    vertex = &(this->m_VertexStorage.back());
   }
-  this->m_Vertices.clear();
+  else
+  {
+    vertex = this->m_FreeVertices.back();
+    this->m_FreeVertices.pop_back();
+    vertex->Coordinates = point;
+    vertex->IsControlPoint = isControlPoint;
+  }
+
+  if (nullptr != m_SpatialIndex)
+  {
+    m_SpatialIndex->Insert(vertex);
+  }
+
+  return vertex;
+}
+
+void mitk::ContourElement::ReleaseVertex(VertexType *vertex)
+{
+  if (nullptr != m_SpatialIndex)
+  {
+    m_SpatialIndex->Remove(vertex, vertex->Coordinates);
+  }
+
+  this->m_FreeVertices.push_back(vertex);
+}
+
+void mitk::ContourElement::UpdateSpatialIndex(const VertexType *vertex, const mitk::Point3D &previousCoordinates)
+{
+  if (nullptr != m_SpatialIndex && m_SpatialIndex->Remove(vertex, previousCoordinates))
+  {
+    // the vertex is owned by this contour, so the const_cast is safe
+    m_SpatialIndex->Insert(const_cast<VertexType *>(vertex));
+  }
+}
+
+void mitk::ContourElement::ResetSpatialIndex()
+{
+  this->m_SpatialIndex.reset();
 }
 
 //----------------------------------------------------------------------
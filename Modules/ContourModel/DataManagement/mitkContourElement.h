@@ -17,6 +17,8 @@ found in the LICENSE file.
 #include <mitkNumericTypes.h>
 
 #include <deque>
+#include <memory>
+#include <vector>
 
 namespace mitk
 {
@@ -29,6 +31,13 @@ namespace mitk
   \note This class assumes that it manages its vertices. So if a vertex instance is added to this
   class the ownership of the vertex is transfered to the ContourElement instance.
   The ContourElement instance takes care of deleting vertex instances if needed.
+  The vertices themselves are kept in contiguous blocks; the addresses of vertices stay valid
+  until they are removed, so vertex pointers can be used as handles.
+
+  Position based queries (e.g. GetVertexAt(const mitk::Point3D&, float)) of contours with many
+  vertices use a uniform grid that is built on the first query and kept up to date by all
+  modifying methods of this class. If vertex coordinates are changed directly via a vertex pointer,
+  UpdateSpatialIndex() or ResetSpatialIndex() has to be called.
   It is highly not recommend to use this class directly as it is designed as a internal class of
   ContourModel. Therefore it is adviced to use ContourModel if contour representations are needed in
   MITK.
@@ -71,6 +80,9 @@ namespace mitk
      * It is always the maximum of the unsigned int type.*/
     static const VertexSizeType NPOS = -1;
 
+    /**Minimum number of vertices for which position based queries use the spatial index.*/
+    static const VertexSizeType SPATIAL_INDEX_MINIMUM_SIZE = 64;
+
     /** \brief Return a const iterator a the front.
     */
     ConstVertexIterator ConstIteratorBegin() const;
@@ -111,6 +123,12 @@ namespace mitk
     */
     void AddVertex(const mitk::Point3D &point, bool isControlPoint);
 
+    /** \brief Add several vertices at the end of the contour
+    \param points - coordinates in 3D space.
+    \param isControlPoint - are the vertices special control points.
+    */
+    void AddVertices(const std::vector<mitk::Point3D> &points, bool isControlPoint);
+
     /** \brief Add a vertex at the front of the contour
     \param point - coordinates in 3D space.
     \param isControlPoint - is the vertex a control point.
@@ -234,6 +252,18 @@ namespace mitk
     */
     void Clear();
 
+    /** \brief Updates the spatial index after the coordinates of a vertex were changed directly.
+    Does nothing if the vertex is not part of this contour or no index exists.
+    \param vertex - the moved vertex.
+    \param previousCoordinates - the coordinates of the vertex before it was moved.
+    */
+    void UpdateSpatialIndex(const VertexType *vertex, const mitk::Point3D &previousCoordinates);
+
+    /** \brief Discards the spatial index, e.g. after many vertices were moved directly.
+    It is rebuilt on the next position based query.
+    */
+    void ResetSpatialIndex();
+
     /** \brief Returns the approximate nearest vertex a given position in 3D space. With the parameter 'isControlPoint', 
     one can decide if any vertex should be returned, or just control vertices.
     \param point - query position in 3D space.
@@ -269,7 +299,7 @@ namespace mitk
   protected:
     mitkCloneMacro(Self);
 
-    ContourElement() = default;
+    ContourElement();
     ContourElement(const mitk::ContourElement &other);
     ~ContourElement();
 
@@ -281,8 +311,32 @@ namespace mitk
     \result Indicates if the element indicated by the iterator was removed. If iterator points to end it returns false.*/
     bool RemoveVertexByIterator(VertexListType::iterator& iter);
 
+    /** Returns a vertex from the vertex storage, initialized with the passed values.*/
+    VertexType *CreateVertex(const mitk::Point3D &point, bool isControlPoint);
+
+    /** Returns the vertex to the vertex storage. The vertex must not be used afterwards.*/
+    void ReleaseVertex(VertexType *vertex);
+
+    /** Returns the nearest vertex (or control vertex) closer than eps to the point.
+    Uses the spatial index for large contours.*/
+    VertexType *GetNearestVertex(const mitk::Point3D &point, double eps, bool controlPointsOnly);
+
+    /** Returns the control vertex that is offset control vertices after (or before for negative offsets)
+    the nearest control vertex of the point. The search wraps around at the ends of the contour.*/
+    VertexType *GetControlVertexWithOffset(const mitk::Point3D &point, double eps, int offset);
+
     VertexListType m_Vertices; // double ended queue with vertices
     bool m_IsClosed = false;
+
+  private:
+    struct SpatialIndex;
+
+    /** Storage of the vertices. Only grows at its end, so element addresses are stable.*/
+    std::deque<VertexType> m_VertexStorage;
+    /** Released vertices of m_VertexStorage that are reused by CreateVertex().*/
+    std::vector<VertexType *> m_FreeVertices;
+
+    std::unique_ptr<SpatialIndex> m_SpatialIndex;
   };
 } // namespace mitk
 
@@ -49,6 +49,17 @@ void mitk::ContourModel::AddVertex(const Point3D &vertex, bool isControlPoint, T
   }
 }
 
+void mitk::ContourModel::AddVertices(const std::vector<Point3D> &points, bool isControlPoint, TimeStepType timestep)
+{
+  if (!this->IsEmptyTimeStep(timestep) && !points.empty())
+  {
+    this->m_ContourSeries[timestep]->AddVertices(points, isControlPoint);
+    this->InvokeEvent(ContourModelSizeChangeEvent());
+    this->Modified();
+    this->m_UpdateBoundingBox = true;
+  }
+}
+
 void mitk::ContourModel::AddVertex(const VertexType &vertex, TimeStepType timestep)
 {
   this->AddVertex(vertex.Coordinates, vertex.IsControlPoint, timestep);
@@ -429,7 +440,14 @@ void mitk::ContourModel::ShiftSelectedVertex(Vector3D &translate)
 {
   if (this->m_SelectedVertex)
   {
+    const Point3D previousCoordinates = this->m_SelectedVertex->Coordinates;
     this->ShiftVertex(this->m_SelectedVertex, translate);
+
+    // the selected vertex belongs to one of the contours, which has to update its spatial index
+    for (const auto &contour : this->m_ContourSeries)
+    {
+      contour->UpdateSpatialIndex(this->m_SelectedVertex, previousCoordinates);
+    }
     this->Modified();
     this->m_UpdateBoundingBox = true;
   }
@@ -444,6 +462,7 @@ void mitk::ContourModel::ShiftContour(Vector3D &translate, TimeStepType timestep
     {
       this->ShiftVertex(vertex, translate);
     }
+    this->m_ContourSeries[timestep]->ResetSpatialIndex();
 
     this->Modified();
     this->m_UpdateBoundingBox = true;
@@ -130,6 +130,16 @@ namespace mitk
     */
     void AddVertex(const Point3D& vertex, bool isControlPoint, TimeStepType timestep = 0);
 
+    /** \brief Add several vertices to the end of the contour at once.
+    In contrast to calling AddVertex for every point, the size change event is only invoked once.
+    \param points - coordinates of the vertices in contour order
+    \param isControlPoint - specifies whether all added vertices are control points
+    \param timestep - the timestep at which the vertices will be added ( default 0)
+    @note Adding vertices to a timestep which exceeds the timebounds of the contour
+    will not be added, the TimeGeometry will not be expanded.
+    */
+    void AddVertices(const std::vector<Point3D> &points, bool isControlPoint, TimeStepType timestep = 0);
+
     /** Clears the contour of destinationTimeStep and copies
         the contour of the passed source model at the sourceTimeStep.
      @pre soureModel must point to a valid instance
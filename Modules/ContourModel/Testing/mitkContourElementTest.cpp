@@ -14,6 +14,7 @@ found in the LICENSE file.
 
 #include "mitkTestFixture.h"
 #include "mitkTestingMacros.h"
+#include <cmath>
 #include <limits>
 
 class mitkContourElementTestSuite : public mitk::TestFixture
@@ -33,6 +34,7 @@ class mitkContourElementTestSuite : public mitk::TestFixture
   MITK_TEST(GetControlVertices);
   MITK_TEST(RedistributeControlVertices);
   MITK_TEST(Others);
+  MITK_TEST(SpatialIndexQueries);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -344,6 +346,66 @@ public:
     CPPUNIT_ASSERT(m_Contour5to6->GetSize() == copyConstructed->GetSize());
   }
 
+  void CheckQueriesAgainstBruteForce(mitk::ContourElement *contour, double eps)
+  {
+    for (mitk::ContourElement::VertexSizeType i = 0; i < contour->GetSize(); ++i)
+    {
+      mitk::Point3D query = contour->GetVertexAt(i)->Coordinates;
+      query[0] += 0.1;
+      query[2] -= 0.05;
+
+      CPPUNIT_ASSERT(contour->GetVertexAt(query, eps) == contour->BruteForceGetVertexAt(query, eps));
+      CPPUNIT_ASSERT(contour->GetControlVertexAt(query, eps) == contour->BruteForceGetVertexAt(query, eps, true));
+      CPPUNIT_ASSERT(contour->GetNextControlVertexAt(query, eps) ==
+                     contour->BruteForceGetVertexAt(query, eps, true, 1));
+      CPPUNIT_ASSERT(contour->GetPreviousControlVertexAt(query, eps) ==
+                     contour->BruteForceGetVertexAt(query, eps, true, -1));
+    }
+  }
+
+  void SpatialIndexQueries()
+  {
+    // large enough to use the spatial index
+    std::vector<mitk::Point3D> points;
+    for (int i = 0; i < 200; ++i)
+    {
+      mitk::Point3D point;
+      point[0] = 20.0 * std::cos(0.1 * i);
+      point[1] = 20.0 * std::sin(0.1 * i);
+      point[2] = 0.5 * i;
+      points.push_back(point);
+    }
+
+    auto contour = mitk::ContourElement::New();
+    contour->AddVertices(points, false);
+    contour->RedistributeControlVertices(contour->GetVertexAt(0), 5);
+    CPPUNIT_ASSERT(contour->GetSize() == 200);
+
+    this->CheckQueriesAgainstBruteForce(contour, 1.5);
+    // radius much larger than the cells of the index
+    this->CheckQueriesAgainstBruteForce(contour, 30.0);
+
+    mitk::Point3D farAway(1000.0);
+    CPPUNIT_ASSERT(contour->GetVertexAt(farAway, 1.5) == nullptr);
+
+    // the index has to follow modifications of the contour
+    contour->SetVertexAt(10, farAway);
+    CPPUNIT_ASSERT(contour->GetVertexAt(farAway, 1.5) == contour->GetVertexAt(10));
+    contour->RemoveVertexAt(20);
+    contour->InsertVertexAtIndex(points[20], true, 5);
+    contour->AddVertexAtFront(mitk::Point3D(-50.0), true);
+
+    mitk::ContourElement::VertexType *vertex = contour->GetVertexAt(30);
+    const mitk::Point3D previousCoordinates = vertex->Coordinates;
+    vertex->Coordinates[1] += 3.0;
+    contour->UpdateSpatialIndex(vertex, previousCoordinates);
+
+    this->CheckQueriesAgainstBruteForce(contour, 1.5);
+
+    mitk::ContourElement::Pointer copy = contour->Clone();
+    this->CheckQueriesAgainstBruteForce(copy, 1.5);
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkContourElement)
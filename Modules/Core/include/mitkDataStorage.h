@@ -20,7 +20,13 @@ found in the LICENSE file.
 #include "mitkGeometry3D.h"
 #include "mitkMessage.h"
 #include <MitkCoreExports.h>
+#include <list>
 #include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
 
 namespace mitk
 {
@@ -98,6 +104,11 @@ namespace mitk
     //## (see definition of NodePredicateBase for details).
     //## The method returns a set of SmartPointers to the DataNodes that fulfill the
     //## conditions. A set of all objects can be retrieved with the GetAll() method;
+    //##
+    //## Conditions on the exact data type (NodePredicateDataType), the data UID (NodePredicateDataUID) and
+    //## the properties "name", "helper object", "hidden object" and "binary" (NodePredicateProperty without
+    //## renderer), as well as conjunctions and disjunctions of them, are answered from an index of the nodes.
+    //## Only the candidates found in the index are tested with the condition.
     SetOfObjects::ConstPointer GetSubset(const NodePredicateBase *condition) const;
 
     //##Documentation
@@ -268,6 +279,10 @@ namespace mitk
     //##Documentation
     //## @brief Compute the axis-parallel bounding geometry of the input objects
     //##
+    //## The world corner points, spacing and time points of each node are cached and only
+    //## recomputed if the data or its time geometry was modified. If the considered nodes and their
+    //## data did not change since a previous call, the previously computed geometry is returned.
+    //##
     //## Throws std::invalid_argument exception if input is nullptr
     //## @param input set of objects of the DataStorage to be included in the bounding geometry
     //## @param boolPropertyKey if a BoolProperty with this boolPropertyKey exists for a node (for @a renderer)
@@ -415,6 +430,90 @@ namespace mitk
     //## to suppress NodeChangedEvent to be emitted.
     bool m_BlockNodeModifiedEvents;
 
+    //##Documentation
+    //## @brief Part of the bounding geometry that depends only on the data of a node.
+    struct BoundingGeometryContribution
+    {
+      const BaseData *Data = nullptr;
+      const TimeGeometry *Geometry = nullptr;
+      unsigned long DataMTime = 0;
+      bool HasZeroBounds = false;
+      std::vector<Point3D> CornerPoints;
+      Vector3D MinSpacing;
+      std::vector<ScalarType> TimePoints;
+      ScalarType MaximalTime = 0;
+    };
+
+    using BoundingGeometryContributionPointer = std::shared_ptr<const BoundingGeometryContribution>;
+
+    //##Documentation
+    //## @brief Identifies the data of all nodes that were considered for a bounding geometry.
+    using BoundingGeometryStampsType = std::vector<std::tuple<const DataNode *, const BaseData *, unsigned long>>;
+
+    //##Documentation
+    //## @brief Returns the (cached) contribution of the node to bounding geometries.
+    //##
+    //## Contributions are only cached for nodes of this DataStorage and are dropped if the node is removed.
+    BoundingGeometryContributionPointer GetBoundingGeometryContribution(const DataNode *node,
+                                                                        const TimeGeometry *timeGeometry) const;
+
+    mutable std::map<const DataNode *, BoundingGeometryContributionPointer> m_BoundingGeometryContributions;
+
+    //##Documentation
+    //## @brief Recently computed bounding geometries, the most recent one first.
+    mutable std::list<std::pair<BoundingGeometryStampsType, TimeGeometry::ConstPointer>> m_BoundingGeometries;
+
+    mutable itk::SimpleFastMutexLock m_BoundingGeometryCacheMutex;
+
+    //##Documentation
+    //## @brief Values of a node that are used to answer GetSubset() queries without testing every node.
+    //##
+    //## Indexed are the class name and UID of the data as well as the properties listed in
+    //## GetIndexedPropertyKeys(). Property values are stored as class name and GetValueAsString().
+    struct NodeIndexEntry
+    {
+      std::string DataType;
+      std::string DataUID;
+      std::map<std::string, std::string> PropertyValues;
+      std::vector<std::pair<itk::Object::Pointer, unsigned long>> ObserverTags;
+    };
+
+    //##Documentation
+    //## @brief Keys of the properties that are indexed for GetSubset() queries.
+    static const std::vector<std::string> &GetIndexedPropertyKeys();
+
+    //##Documentation
+    //## @brief (Re)computes the index entry of a node of this DataStorage.
+    //##
+    //## Also observes the indexed property objects and the property list of the data, so that changes that do
+    //## not modify the node itself update the index, too. Has to be called with m_NodeIndexMutex locked.
+    void UpdateNodeIndex(const DataNode *node);
+
+    //##Documentation
+    //## @brief Removes the index entry of a node. Has to be called with m_NodeIndexMutex locked.
+    void RemoveNodeIndex(const DataNode *node);
+
+    //##Documentation
+    //## @brief Updates the index entries of all nodes that observe the modified object.
+    void OnIndexedObjectModified(const itk::Object *caller, const itk::EventObject &event);
+
+    //##Documentation
+    //## @brief Collects candidates for condition from the index.
+    //##
+    //## Returns false if the condition cannot be answered from the index. Otherwise candidates contains
+    //## at least every node of this DataStorage that fulfills the condition. Has to be called with
+    //## m_NodeIndexMutex locked.
+    bool GetIndexedCandidates(const NodePredicateBase *condition, std::set<const DataNode *> &candidates) const;
+
+    std::map<const DataNode *, NodeIndexEntry> m_NodeIndexEntries;
+    std::map<std::string, std::set<const DataNode *>> m_DataTypeIndex;
+    std::map<std::string, std::set<const DataNode *>> m_DataUIDIndex;
+    //##Documentation
+    //## @brief Nodes per property key and value. The empty value lists all nodes that have the property.
+    std::map<std::pair<std::string, std::string>, std::set<const DataNode *>> m_PropertyIndex;
+    std::multimap<const itk::Object *, const DataNode *> m_IndexedObjectNodes;
+    mutable itk::SimpleFastMutexLock m_NodeIndexMutex;
+
     DataStorage();
     ~DataStorage() override;
 
@@ -90,8 +90,10 @@ namespace mitk
 
     static CustomMimeType POINTSET_MIMETYPE();      // mps
     static CustomMimeType GEOMETRY_DATA_MIMETYPE(); // .mitkgeometry
+    static CustomMimeType CHUNKED_IMAGE_MIMETYPE(); // (mitk::Image) mci
 
-    static std::string POINTSET_MIMETYPE_NAME(); // DEFAULT_BASE_NAME.pointset
+    static std::string POINTSET_MIMETYPE_NAME();      // DEFAULT_BASE_NAME.pointset
+    static std::string CHUNKED_IMAGE_MIMETYPE_NAME(); // DEFAULT_BASE_NAME.image.chunked
 
   private:
     // purposely not implemented
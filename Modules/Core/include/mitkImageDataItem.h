@@ -17,6 +17,8 @@ found in the LICENSE file.
 #include <MitkCoreExports.h>
 #include "mitkImageDescriptor.h"
 
+#include <memory>
+
 class vtkImageData;
 
 namespace mitk
@@ -117,6 +119,11 @@ namespace mitk
 
     // Returns if image data should be deleted on destruction of ImageDataItem.
     bool GetManageMemory() const { return m_ManageMemory; }
+
+    /** Keeps an external owner of referenced (not managed) image data alive as long as this item
+     * exists, e.g. the memory mapping of a file the data is read from. */
+    void SetDataOwner(const std::shared_ptr<void> &owner) { m_DataOwner = owner; }
+    std::shared_ptr<void> GetDataOwner() const { return m_DataOwner; }
     virtual void ConstructVtkImageData(ImageConstPointer) const;
 
     size_t GetSize() const { return m_Size; }
@@ -149,6 +156,7 @@ namespace mitk
     void ComputeItemSize(const unsigned int *dimensions, unsigned int dimension);
 
     ImageDataItem::ConstPointer m_Parent;
+    std::shared_ptr<void> m_DataOwner;
 
     unsigned int m_Dimension;
 
@@ -29,6 +29,12 @@ namespace mitk
    * For all ITK ImageIOs that support the serialization of MetaData
    * (e.g. nrrd or mhd) the ItkImageIO ensures the serialization
    * of Identification UID.
+   *
+   * If OPTION_MEMORY_MAPPING() is enabled, uncompressed NRRD, MetaImage and NIfTI files
+   * are memory mapped instead of read into a newly allocated buffer. Reading returns as
+   * soon as the header is parsed and the pages of a volume or slice are loaded from
+   * the file on first access. Write access to the image data does not alter the file.
+   * The file must not be modified by other applications while the image exists.
    */
   class MITKCORE_EXPORT ItkImageIO : public AbstractFileIO
   {
@@ -36,6 +42,10 @@ namespace mitk
     ItkImageIO(itk::ImageIOBase::Pointer imageIO);
     ItkImageIO(const CustomMimeType &mimeType, itk::ImageIOBase::Pointer imageIO, int rank);
 
+    /** Reader option (bool, default false) to memory map uncompressed image files instead of
+     * reading them completely.*/
+    static std::string OPTION_MEMORY_MAPPING();
+
     // -------------- AbstractFileReader -------------
 
     using AbstractFileReader::Read;
@@ -40,6 +40,10 @@ namespace mitk
     //## @brief Checks, if the nodes data object is of a specific data type
     bool CheckNode(const mitk::DataNode *node) const override;
 
+    //##Documentation
+    //## @brief Returns the class name that the data of a node has to match
+    const std::string &GetValidDataType() const;
+
   protected:
     //##Documentation
     //## @brief Protected constructor, use static instantiation functions instead
@@ -44,6 +44,18 @@ namespace mitk
     //## @brief Checks, if the nodes contains a property that is equal to m_ValidProperty
     bool CheckNode(const mitk::DataNode *node) const override;
 
+    //##Documentation
+    //## @brief Returns the name of the checked property
+    const std::string &GetValidPropertyName() const;
+
+    //##Documentation
+    //## @brief Returns the property the node property has to be equal to, or nullptr if only its existence is checked
+    const mitk::BaseProperty *GetValidProperty() const;
+
+    //##Documentation
+    //## @brief Returns the renderer whose renderer-specific property is checked, or nullptr
+    const mitk::BaseRenderer *GetRenderer() const;
+
   protected:
     //##Documentation
     //## @brief Constructor to check for a named property
@@ -12,16 +12,70 @@ found in the LICENSE file.
 
 #include "mitkDataStorage.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include "itkCommand.h"
 #include "itkMutexLockHolder.h"
 #include "mitkDataNode.h"
 #include "mitkGroupTagProperty.h"
 #include "mitkImage.h"
+#include "mitkNodePredicateAnd.h"
 #include "mitkNodePredicateBase.h"
+#include "mitkNodePredicateDataType.h"
+#include "mitkNodePredicateDataUID.h"
+#include "mitkNodePredicateOr.h"
 #include "mitkNodePredicateProperty.h"
 #include "mitkProperties.h"
+#include "mitkStringProperty.h"
 #include "mitkArbitraryTimeGeometry.h"
 
+namespace
+{
+  /** Number of recently computed bounding geometries that are kept.*/
+  const std::size_t BOUNDING_GEOMETRY_CACHE_SIZE = 8;
+
+  /** Returns the value under which a property is indexed. Only string and bool properties, for which equality
+  * of the value strings implies equality of the properties, are indexed by value. For all other properties an
+  * empty string is returned.*/
+  std::string GetIndexedPropertyValue(const mitk::BaseProperty *property)
+  {
+    if (nullptr == dynamic_cast<const mitk::StringProperty *>(property) &&
+        nullptr == dynamic_cast<const mitk::BoolProperty *>(property))
+      return std::string();
+
+    return std::string(property->GetNameOfClass()) + ':' + property->GetValueAsString();
+  }
+
+  template <typename TKey>
+  void EraseFromIndex(std::map<TKey, std::set<const mitk::DataNode *>> &index,
+                      const TKey &key,
+                      const mitk::DataNode *node)
+  {
+    auto indexIter = index.find(key);
+    if (indexIter == index.end())
+      return;
+
+    indexIter->second.erase(node);
+    if (indexIter->second.empty())
+      index.erase(indexIter);
+  }
+
+  void EraseIndexedObjectNode(std::multimap<const itk::Object *, const mitk::DataNode *> &indexedObjectNodes,
+                              const itk::Object *object,
+                              const mitk::DataNode *node)
+  {
+    auto range = indexedObjectNodes.equal_range(object);
+    for (auto iter = range.first; iter != range.second;)
+    {
+      if (iter->second == node)
+        iter = indexedObjectNodes.erase(iter);
+      else
+        ++iter;
+    }
+  }
+}
+
 mitk::DataStorage::DataStorage() : itk::Object(), m_BlockNodeModifiedEvents(false)
 {
 }
@@ -54,6 +108,28 @@ void mitk::DataStorage::Remove(const DataStorage::SetOfObjects *nodes)
 
 mitk::DataStorage::SetOfObjects::ConstPointer mitk::DataStorage::GetSubset(const NodePredicateBase *condition) const
 {
+  if (condition != nullptr)
+  {
+    std::set<const DataNode *> candidates;
+    bool isIndexed = false;
+    DataStorage::SetOfObjects::Pointer candidateSet = DataStorage::SetOfObjects::New();
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_NodeIndexMutex);
+      // nodes are indexed by subclasses calling AddListeners(), fall back to testing all nodes if there are none
+      isIndexed = !m_NodeIndexEntries.empty() && this->GetIndexedCandidates(condition, candidates);
+      if (isIndexed)
+      {
+        // std::set keeps the pointer order of GetAll(), indexed nodes are still referenced by the storage
+        for (const auto *node : candidates)
+          candidateSet->InsertElement(candidateSet->Size(), const_cast<DataNode *>(node));
+      }
+    }
+
+    // the index only narrows down the candidates, the condition still decides
+    if (isIndexed)
+      return this->FilterSetOfObjects(candidateSet, condition);
+  }
+
   DataStorage::SetOfObjects::ConstPointer result = this->FilterSetOfObjects(this->GetAll(), condition);
   return result;
 }
@@ -194,13 +270,22 @@ void mitk::DataStorage::OnNodeInteractorChanged(itk::Object *caller, const itk::
 
 void mitk::DataStorage::OnNodeModifiedOrDeleted(const itk::Object *caller, const itk::EventObject &event)
 {
+  const auto *_Node = dynamic_cast<const DataNode *>(caller);
+  const auto *modEvent = dynamic_cast<const itk::ModifiedEvent *>(&event);
+
+  // the index has to be kept up to date even if events are blocked
+  if (_Node && modEvent)
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_NodeIndexMutex);
+    if (m_NodeIndexEntries.find(_Node) != m_NodeIndexEntries.end())
+      this->UpdateNodeIndex(_Node);
+  }
+
   if (m_BlockNodeModifiedEvents)
     return;
 
-  const auto *_Node = dynamic_cast<const DataNode *>(caller);
   if (_Node)
   {
-    const auto *modEvent = dynamic_cast<const itk::ModifiedEvent *>(&event);
     if (modEvent)
       ChangedNodeEvent.Send(_Node);
     else
@@ -230,6 +315,9 @@ void mitk::DataStorage::AddListeners(const DataNode *_Node)
     deleteCommand->SetCallbackFunction(this, &DataStorage::OnNodeModifiedOrDeleted);
     // add observer
     m_NodeDeleteObserverTags[NonConstNode] = NonConstNode->AddObserver(itk::DeleteEvent(), deleteCommand);
+
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> indexLocked(m_NodeIndexMutex);
+    this->UpdateNodeIndex(_Node);
   }
 }
 
@@ -249,105 +337,399 @@ void mitk::DataStorage::RemoveListeners(const DataNode *_Node)
     m_NodeModifiedObserverTags.erase(NonConstNode);
     m_NodeDeleteObserverTags.erase(NonConstNode);
     m_NodeInteractorChangedObserverTags.erase(NonConstNode);
+
+    {
+      itk::MutexLockHolder<itk::SimpleFastMutexLock> indexLocked(m_NodeIndexMutex);
+      this->RemoveNodeIndex(_Node);
+    }
+
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> cacheLocked(m_BoundingGeometryCacheMutex);
+    m_BoundingGeometryContributions.erase(_Node);
   }
 }
 
-mitk::TimeGeometry::ConstPointer mitk::DataStorage::ComputeBoundingGeometry3D(const SetOfObjects *input,
-                                                                              const char *boolPropertyKey,
-                                                                              const BaseRenderer *renderer,
-                                                                              const char *boolPropertyKey2) const
+const std::vector<std::string> &mitk::DataStorage::GetIndexedPropertyKeys()
 {
-  if (input == nullptr)
-    throw std::invalid_argument("DataStorage: input is invalid");
+  static const std::vector<std::string> keys = {"name", "helper object", "hidden object", "binary"};
+  return keys;
+}
 
-  BoundingBox::PointsContainer::Pointer pointscontainer = BoundingBox::PointsContainer::New();
+void mitk::DataStorage::UpdateNodeIndex(const DataNode *node)
+{
+  // keep the observers of objects that are still indexed, the update might be triggered by one of them
+  std::vector<std::pair<itk::Object::Pointer, unsigned long>> observerTags;
+  auto entryIter = m_NodeIndexEntries.find(node);
+  if (entryIter != m_NodeIndexEntries.end())
+  {
+    observerTags.swap(entryIter->second.ObserverTags);
+    for (const auto &observerTag : observerTags)
+      EraseIndexedObjectNode(m_IndexedObjectNodes, observerTag.first, node);
+    this->RemoveNodeIndex(node);
+  }
 
-  BoundingBox::PointIdentifier pointid = 0;
-  Point3D point;
+  NodeIndexEntry entry;
+  std::vector<itk::Object *> observedObjects;
 
-  Vector3D minSpacing;
-  minSpacing.Fill(itk::NumericTraits<ScalarType>::max());
+  const BaseData *data = node->GetData();
+  if (nullptr != data)
+  {
+    entry.DataType = data->GetNameOfClass();
+    entry.DataUID = data->GetUID();
+    m_DataTypeIndex[entry.DataType].insert(node);
+    m_DataUIDIndex[entry.DataUID].insert(node);
 
-  ScalarType stmax = itk::NumericTraits<ScalarType>::max();
-  ScalarType stmin = itk::NumericTraits<ScalarType>::NonpositiveMin();
+    // properties of the data are found by the fallback of DataNode::GetProperty()
+    observedObjects.push_back(data->GetPropertyList().GetPointer());
+  }
 
-  std::set<ScalarType> existingTimePoints;
-  ScalarType maximalTime = 0;
+  for (const auto &key : GetIndexedPropertyKeys())
+  {
+    BaseProperty *property = node->GetProperty(key.c_str());
+    if (nullptr == property)
+      continue;
+
+    const std::string value = GetIndexedPropertyValue(property);
+    entry.PropertyValues[key] = value;
+    m_PropertyIndex[std::make_pair(key, std::string())].insert(node);
+    if (!value.empty())
+      m_PropertyIndex[std::make_pair(key, value)].insert(node);
+
+    observedObjects.push_back(property);
+  }
+
+  itk::MemberCommand<DataStorage>::Pointer modifiedCommand = itk::MemberCommand<DataStorage>::New();
+  modifiedCommand->SetCallbackFunction(this, &DataStorage::OnIndexedObjectModified);
+
+  for (auto *object : observedObjects)
+  {
+    auto tagIter = std::find_if(observerTags.begin(),
+                                observerTags.end(),
+                                [object](const std::pair<itk::Object::Pointer, unsigned long> &observerTag) {
+                                  return observerTag.first == object;
+                                });
+    if (tagIter != observerTags.end())
+    {
+      entry.ObserverTags.push_back(*tagIter);
+      observerTags.erase(tagIter);
+    }
+    else
+    {
+      entry.ObserverTags.emplace_back(object, object->AddObserver(itk::ModifiedEvent(), modifiedCommand));
+    }
+    m_IndexedObjectNodes.emplace(object, node);
+  }
+
+  for (const auto &observerTag : observerTags)
+    observerTag.first->RemoveObserver(observerTag.second);
+
+  m_NodeIndexEntries[node] = entry;
+}
+
+void mitk::DataStorage::RemoveNodeIndex(const DataNode *node)
+{
+  auto entryIter = m_NodeIndexEntries.find(node);
+  if (entryIter == m_NodeIndexEntries.end())
+    return;
+
+  const NodeIndexEntry &entry = entryIter->second;
+  if (!entry.DataType.empty())
+  {
+    EraseFromIndex(m_DataTypeIndex, entry.DataType, node);
+    EraseFromIndex(m_DataUIDIndex, entry.DataUID, node);
+  }
+
+  for (const auto &propertyValue : entry.PropertyValues)
+  {
+    EraseFromIndex(m_PropertyIndex, std::make_pair(propertyValue.first, std::string()), node);
+    if (!propertyValue.second.empty())
+      EraseFromIndex(m_PropertyIndex, std::make_pair(propertyValue.first, propertyValue.second), node);
+  }
+
+  for (const auto &observerTag : entry.ObserverTags)
+  {
+    observerTag.first->RemoveObserver(observerTag.second);
+    EraseIndexedObjectNode(m_IndexedObjectNodes, observerTag.first, node);
+  }
+
+  m_NodeIndexEntries.erase(entryIter);
+}
+
+void mitk::DataStorage::OnIndexedObjectModified(const itk::Object *caller, const itk::EventObject &)
+{
+  itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_NodeIndexMutex);
+
+  std::set<const DataNode *> nodes;
+  auto range = m_IndexedObjectNodes.equal_range(caller);
+  for (auto iter = range.first; iter != range.second; ++iter)
+    nodes.insert(iter->second);
+
+  for (const auto *node : nodes)
+    this->UpdateNodeIndex(node);
+}
+
+bool mitk::DataStorage::GetIndexedCandidates(const NodePredicateBase *condition,
+                                             std::set<const DataNode *> &candidates) const
+{
+  if (const auto *dataTypePredicate = dynamic_cast<const NodePredicateDataType *>(condition))
+  {
+    auto indexIter = m_DataTypeIndex.find(dataTypePredicate->GetValidDataType());
+    if (indexIter != m_DataTypeIndex.end())
+      candidates = indexIter->second;
+    return true;
+  }
+
+  if (const auto *dataUIDPredicate = dynamic_cast<const NodePredicateDataUID *>(condition))
+  {
+    auto indexIter = m_DataUIDIndex.find(dataUIDPredicate->GetUID());
+    if (indexIter != m_DataUIDIndex.end())
+      candidates = indexIter->second;
+    return true;
+  }
+
+  if (const auto *propertyPredicate = dynamic_cast<const NodePredicateProperty *>(condition))
+  {
+    const auto &keys = GetIndexedPropertyKeys();
+    if (nullptr != propertyPredicate->GetRenderer() ||
+        std::find(keys.begin(), keys.end(), propertyPredicate->GetValidPropertyName()) == keys.end())
+      return false;
+
+    std::string value;
+    if (nullptr != propertyPredicate->GetValidProperty())
+    {
+      value = GetIndexedPropertyValue(propertyPredicate->GetValidProperty());
+      if (value.empty())
+        return false;
+    }
+
+    auto indexIter = m_PropertyIndex.find(std::make_pair(propertyPredicate->GetValidPropertyName(), value));
+    if (indexIter != m_PropertyIndex.end())
+      candidates = indexIter->second;
+    return true;
+  }
+
+  if (const auto *andPredicate = dynamic_cast<const NodePredicateAnd *>(condition))
+  {
+    // children that cannot be answered from the index are left to the final test of the condition
+    bool isIndexed = false;
+    for (const auto &child : andPredicate->GetPredicates())
+    {
+      std::set<const DataNode *> childCandidates;
+      if (!this->GetIndexedCandidates(child, childCandidates))
+        continue;
+
+      if (!isIndexed)
+      {
+        candidates.swap(childCandidates);
+        isIndexed = true;
+      }
+      else
+      {
+        std::set<const DataNode *> intersection;
+        std::set_intersection(candidates.begin(),
+                              candidates.end(),
+                              childCandidates.begin(),
+                              childCandidates.end(),
+                              std::inserter(intersection, intersection.begin()));
+        candidates.swap(intersection);
+      }
+
+      if (candidates.empty())
+        break;
+    }
+    return isIndexed;
+  }
+
+  if (const auto *orPredicate = dynamic_cast<const NodePredicateOr *>(condition))
+  {
+    const auto children = orPredicate->GetPredicates();
+    if (children.empty())
+      return false;
+
+    for (const auto &child : children)
+    {
+      std::set<const DataNode *> childCandidates;
+      if (!this->GetIndexedCandidates(child, childCandidates))
+        return false;
+      candidates.insert(childCandidates.begin(), childCandidates.end());
+    }
+    return true;
+  }
+
+  return false;
+}
+
+mitk::DataStorage::BoundingGeometryContributionPointer mitk::DataStorage::GetBoundingGeometryContribution(
+  const DataNode *node, const TimeGeometry *timeGeometry) const
+{
+  const BaseData *data = node->GetData();
+  const unsigned long dataMTime = data->GetMTime();
+
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_BoundingGeometryCacheMutex);
+    auto finding = m_BoundingGeometryContributions.find(node);
+    if (finding != m_BoundingGeometryContributions.end() && finding->second->Data == data &&
+        finding->second->Geometry == timeGeometry && finding->second->DataMTime == dataMTime)
+    {
+      return finding->second;
+    }
+  }
+
+  auto contribution = std::make_shared<BoundingGeometryContribution>();
+  contribution->Data = data;
+  contribution->Geometry = timeGeometry;
+  contribution->DataMTime = dataMTime;
+  contribution->MinSpacing.Fill(itk::NumericTraits<ScalarType>::max());
 
   // Needed for check of zero bounding boxes
   ScalarType nullpoint[] = {0, 0, 0, 0, 0, 0};
   BoundingBox::BoundsArrayType itkBoundsZero(nullpoint);
 
-  for (SetOfObjects::ConstIterator it = input->Begin(); it != input->End(); ++it)
+  // bounding box (only if non-zero)
+  BoundingBox::BoundsArrayType itkBounds = timeGeometry->GetBoundingBoxInWorld()->GetBounds();
+  contribution->HasZeroBounds = itkBounds == itkBoundsZero;
+
+  if (!contribution->HasZeroBounds)
   {
-    DataNode::Pointer node = it->Value();
-    if ((node.IsNotNull()) && (node->GetData() != nullptr) && (node->GetData()->IsEmpty() == false) &&
-        node->IsOn(boolPropertyKey, renderer) && node->IsOn(boolPropertyKey2, renderer))
+    for (unsigned char i = 0; i < 8; ++i)
     {
-      const TimeGeometry *timeGeometry = node->GetData()->GetUpdatedTimeGeometry();
+      Point3D point = timeGeometry->GetCornerPointInWorld(i);
+      if (point[0] * point[0] + point[1] * point[1] + point[2] * point[2] < large)
+        contribution->CornerPoints.push_back(point);
+      else
+      {
+        itkGenericOutputMacro(<< "Unrealistically distant corner point encountered. Ignored. Node: " << node);
+      }
+    }
 
-      if (timeGeometry != nullptr)
+    ScalarType stmax = itk::NumericTraits<ScalarType>::max();
+    ScalarType stmin = itk::NumericTraits<ScalarType>::NonpositiveMin();
+
+    try
+    {
+      // time bounds
+      // iterate over all time steps
+      // Attention: Objects with zero bounding box are not respected in time bound calculation
+      for (TimeStepType i = 0; i < timeGeometry->CountTimeSteps(); i++)
       {
-        // bounding box (only if non-zero)
-        BoundingBox::BoundsArrayType itkBounds = timeGeometry->GetBoundingBoxInWorld()->GetBounds();
-        if (itkBounds == itkBoundsZero)
+        // We must not use 'node->GetData()->GetGeometry(i)->GetSpacing()' here, as it returns the spacing
+        // in its original space, which, in case of an image geometry, can have the values in different
+        // order than in world space. For the further calculations, we need to have the spacing values
+        // in world coordinate order (sag-cor-ax).
+        Vector3D spacing;
+        spacing.Fill(1.0);
+        node->GetData()->GetGeometry(i)->IndexToWorld(spacing, spacing);
+        for (int axis = 0; axis < 3; ++ axis)
         {
-          continue;
+          ScalarType space = std::abs(spacing[axis]);
+          if (space < contribution->MinSpacing[axis])
+          {
+            contribution->MinSpacing[axis] = space;
+          }
         }
 
-        unsigned char i;
-        for (i = 0; i < 8; ++i)
+        const auto curTimeBounds = timeGeometry->GetTimeBounds(i);
+        if ((curTimeBounds[0] > stmin) && (curTimeBounds[0] < stmax))
         {
-          point = timeGeometry->GetCornerPointInWorld(i);
-          if (point[0] * point[0] + point[1] * point[1] + point[2] * point[2] < large)
-            pointscontainer->InsertElement(pointid++, point);
-          else
-          {
-            itkGenericOutputMacro(<< "Unrealistically distant corner point encountered. Ignored. Node: " << node);
-          }
+          contribution->TimePoints.push_back(curTimeBounds[0]);
         }
-        try
+        if ((curTimeBounds[1] > contribution->MaximalTime) && (curTimeBounds[1] < stmax))
         {
-          // time bounds
-          // iterate over all time steps
-          // Attention: Objects with zero bounding box are not respected in time bound calculation
-          for (TimeStepType i = 0; i < timeGeometry->CountTimeSteps(); i++)
-          {
-            // We must not use 'node->GetData()->GetGeometry(i)->GetSpacing()' here, as it returns the spacing
-            // in its original space, which, in case of an image geometry, can have the values in different
-            // order than in world space. For the further calculations, we need to have the spacing values
-            // in world coordinate order (sag-cor-ax).
-            Vector3D spacing;
-            spacing.Fill(1.0);
-            node->GetData()->GetGeometry(i)->IndexToWorld(spacing, spacing);
-            for (int axis = 0; axis < 3; ++ axis)
-            {
-              ScalarType space = std::abs(spacing[axis]);
-              if (space < minSpacing[axis])
-              {
-                minSpacing[axis] = space;
-              }
-            }
-
-            const auto curTimeBounds = timeGeometry->GetTimeBounds(i);
-            if ((curTimeBounds[0] > stmin) && (curTimeBounds[0] < stmax))
-            {
-              existingTimePoints.insert(curTimeBounds[0]);
-            }
-            if ((curTimeBounds[1] > maximalTime) && (curTimeBounds[1] < stmax))
-            {
-               maximalTime = curTimeBounds[1];
-            }
-          }
+          contribution->MaximalTime = curTimeBounds[1];
         }
-        catch ( const itk::ExceptionObject &e )
+      }
+    }
+    catch ( const itk::ExceptionObject &e )
+    {
+      MITK_ERROR << e.GetDescription() << std::endl;
+    }
+  }
+
+  // only nodes of this storage are cached, their entries are removed together with the node
+  bool isStorageNode = false;
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_MutexOne);
+    isStorageNode = m_NodeModifiedObserverTags.find(node) != m_NodeModifiedObserverTags.end();
+  }
+
+  if (isStorageNode)
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_BoundingGeometryCacheMutex);
+    m_BoundingGeometryContributions[node] = contribution;
+  }
+
+  return contribution;
+}
+
+mitk::TimeGeometry::ConstPointer mitk::DataStorage::ComputeBoundingGeometry3D(const SetOfObjects *input,
+                                                                              const char *boolPropertyKey,
+                                                                              const BaseRenderer *renderer,
+                                                                              const char *boolPropertyKey2) const
+{
+  if (input == nullptr)
+    throw std::invalid_argument("DataStorage: input is invalid");
+
+  BoundingGeometryStampsType stamps;
+  std::vector<BoundingGeometryContributionPointer> contributions;
+
+  for (SetOfObjects::ConstIterator it = input->Begin(); it != input->End(); ++it)
+  {
+    DataNode::Pointer node = it->Value();
+    if ((node.IsNotNull()) && (node->GetData() != nullptr) && (node->GetData()->IsEmpty() == false) &&
+        node->IsOn(boolPropertyKey, renderer) && node->IsOn(boolPropertyKey2, renderer))
+    {
+      const TimeGeometry *timeGeometry = node->GetData()->GetUpdatedTimeGeometry();
+
+      if (timeGeometry != nullptr)
+      {
+        auto contribution = this->GetBoundingGeometryContribution(node, timeGeometry);
+        if (!contribution->HasZeroBounds)
         {
-          MITK_ERROR << e.GetDescription() << std::endl;
+          stamps.emplace_back(node.GetPointer(), contribution->Data, contribution->DataMTime);
+          contributions.push_back(contribution);
         }
       }
     }
   }
 
+  {
+    // the result only depends on the contributions, so an unchanged scene yields the same geometry
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_BoundingGeometryCacheMutex);
+    for (auto cacheIter = m_BoundingGeometries.begin(); cacheIter != m_BoundingGeometries.end(); ++cacheIter)
+    {
+      if (cacheIter->first == stamps)
+      {
+        m_BoundingGeometries.splice(m_BoundingGeometries.begin(), m_BoundingGeometries, cacheIter);
+        return m_BoundingGeometries.front().second;
+      }
+    }
+  }
+
+  BoundingBox::PointsContainer::Pointer pointscontainer = BoundingBox::PointsContainer::New();
+
+  BoundingBox::PointIdentifier pointid = 0;
+
+  Vector3D minSpacing;
+  minSpacing.Fill(itk::NumericTraits<ScalarType>::max());
+
+  std::set<ScalarType> existingTimePoints;
+  ScalarType maximalTime = 0;
+
+  for (const auto &contribution : contributions)
+  {
+    for (const auto &point : contribution->CornerPoints)
+    {
+      pointscontainer->InsertElement(pointid++, point);
+    }
+
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      minSpacing[axis] = std::min(minSpacing[axis], contribution->MinSpacing[axis]);
+    }
+
+    existingTimePoints.insert(contribution->TimePoints.begin(), contribution->TimePoints.end());
+    maximalTime = std::max(maximalTime, contribution->MaximalTime);
+  }
+
   BoundingBox::Pointer result = BoundingBox::New();
   result->SetPoints(pointscontainer);
   result->ComputeBoundingBox();
@@ -392,7 +774,19 @@ mitk::TimeGeometry::ConstPointer mitk::DataStorage::ComputeBoundingGeometry3D(co
 
     timeGeometry->Update();
   }
-  return timeGeometry.GetPointer();
+
+  TimeGeometry::ConstPointer resultGeometry = timeGeometry.GetPointer();
+
+  {
+    itk::MutexLockHolder<itk::SimpleFastMutexLock> locked(m_BoundingGeometryCacheMutex);
+    m_BoundingGeometries.emplace_front(stamps, resultGeometry);
+    if (m_BoundingGeometries.size() > BOUNDING_GEOMETRY_CACHE_SIZE)
+    {
+      m_BoundingGeometries.pop_back();
+    }
+  }
+
+  return resultGeometry;
 }
 
 mitk::TimeGeometry::ConstPointer mitk::DataStorage::ComputeBoundingGeometry3D(const char *boolPropertyKey,
@@ -415,11 +809,6 @@ mitk::BoundingBox::Pointer mitk::DataStorage::ComputeBoundingBox(const char *boo
   BoundingBox::PointsContainer::Pointer pointscontainer = BoundingBox::PointsContainer::New();
 
   BoundingBox::PointIdentifier pointid = 0;
-  Point3D point;
-
-  // Needed for check of zero bounding boxes
-  ScalarType nullpoint[] = {0, 0, 0, 0, 0, 0};
-  BoundingBox::BoundsArrayType itkBoundsZero(nullpoint);
 
   SetOfObjects::ConstPointer all = this->GetAll();
   for (SetOfObjects::ConstIterator it = all->Begin(); it != all->End(); ++it)
@@ -432,22 +821,10 @@ mitk::BoundingBox::Pointer mitk::DataStorage::ComputeBoundingBox(const char *boo
       if (geometry != nullptr)
       {
         // bounding box (only if non-zero)
-        BoundingBox::BoundsArrayType itkBounds = geometry->GetBoundingBoxInWorld()->GetBounds();
-        if (itkBounds == itkBoundsZero)
+        auto contribution = this->GetBoundingGeometryContribution(node, geometry);
+        for (const auto &point : contribution->CornerPoints)
         {
-          continue;
-        }
-
-        unsigned char i;
-        for (i = 0; i < 8; ++i)
-        {
-          point = geometry->GetCornerPointInWorld(i);
-          if (point[0] * point[0] + point[1] * point[1] + point[2] * point[2] < large)
-            pointscontainer->InsertElement(pointid++, point);
-          else
-          {
-            itkGenericOutputMacro(<< "Unrealistically distant corner point encountered. Ignored. Node: " << node);
-          }
+          pointscontainer->InsertElement(pointid++, point);
         }
       }
     }
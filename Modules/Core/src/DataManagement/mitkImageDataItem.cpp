@@ -176,6 +176,7 @@ mitk::ImageDataItem::ImageDataItem(const ImageDataItem &other)
     m_IsComplete(other.m_IsComplete),
     m_Size(other.m_Size),
     m_Parent(other.m_Parent),
+    m_DataOwner(other.m_DataOwner),
     m_Dimension(other.m_Dimension),
     m_Timestep(other.m_Timestep)
 {
@@ -39,3 +39,8 @@ bool mitk::NodePredicateDataType::CheckNode(const mitk::DataNode *node) const
 
   return (m_ValidDataType.compare(data->GetNameOfClass()) == 0); // return true if data type matches
 }
+
+const std::string &mitk::NodePredicateDataType::GetValidDataType() const
+{
+  return m_ValidDataType;
+}
@@ -37,3 +37,8 @@ bool mitk::NodePredicateDataUID::CheckNode(const mitk::DataNode *node) const
 
   return false;
 }
+
+const mitk::Identifiable::UIDType &mitk::NodePredicateDataUID::GetUID() const
+{
+  return m_UID;
+}
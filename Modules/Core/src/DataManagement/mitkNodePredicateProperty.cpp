@@ -46,3 +46,18 @@ bool mitk::NodePredicateProperty::CheckNode(const mitk::DataNode *node) const
     return (*p == *m_ValidProperty); // search for name and property
   }
 }
+
+const std::string &mitk::NodePredicateProperty::GetValidPropertyName() const
+{
+  return m_ValidPropertyName;
+}
+
+const mitk::BaseProperty *mitk::NodePredicateProperty::GetValidProperty() const
+{
+  return m_ValidProperty;
+}
+
+const mitk::BaseRenderer *mitk::NodePredicateProperty::GetRenderer() const
+{
+  return m_Renderer;
+}
@@ -122,6 +122,7 @@ namespace mitk
 
     mimeTypes.push_back(RAW_MIMETYPE().Clone());
     mimeTypes.push_back(POINTSET_MIMETYPE().Clone());
+    mimeTypes.push_back(CHUNKED_IMAGE_MIMETYPE().Clone());
     return mimeTypes;
   }
 
@@ -352,6 +353,21 @@ namespace mitk
     return name;
   }
 
+  CustomMimeType IOMimeTypes::CHUNKED_IMAGE_MIMETYPE()
+  {
+    CustomMimeType mimeType(CHUNKED_IMAGE_MIMETYPE_NAME());
+    mimeType.AddExtension("mci");
+    mimeType.SetCategory(CATEGORY_IMAGES());
+    mimeType.SetComment("MITK Chunked Image");
+    return mimeType;
+  }
+
+  std::string IOMimeTypes::CHUNKED_IMAGE_MIMETYPE_NAME()
+  {
+    static std::string name = DEFAULT_BASE_NAME() + ".image.chunked";
+    return name;
+  }
+
   CustomMimeType IOMimeTypes::GEOMETRY_DATA_MIMETYPE()
   {
     mitk::CustomMimeType mimeType(DEFAULT_BASE_NAME() + ".geometrydata");
@@ -22,13 +22,373 @@ found in the LICENSE file.
 #include <mitkLocaleSwitch.h>
 #include <mitkUIDManipulator.h>
 
+#include <itkByteSwapper.h>
 #include <itkImage.h>
 #include <itkImageFileReader.h>
 #include <itkImageIOFactory.h>
 #include <itkImageIORegion.h>
 #include <itkMetaDataObject.h>
+#include <itksys/SystemTools.hxx>
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  /** Copy-on-write memory mapping of a complete file. Pages are read from the file on first access,
+   * modifications of the mapped data are private to the process and never written back.*/
+  class MappedFile
+  {
+  public:
+    /** Identifies data owners that are mapped files, see GetMappedFile().*/
+    struct Deleter
+    {
+      void operator()(MappedFile *mappedFile) const { delete mappedFile; }
+    };
+
+    static std::shared_ptr<MappedFile> Map(const std::string &fileName)
+    {
+      std::shared_ptr<MappedFile> mappedFile(new MappedFile(fileName), Deleter());
+      return mappedFile->m_Data != nullptr ? mappedFile : nullptr;
+    }
+
+    /** Returns the mapped file if the data owner of an image data item is one, otherwise nullptr.*/
+    static const MappedFile *GetMappedFile(const std::shared_ptr<void> &dataOwner)
+    {
+      return std::get_deleter<Deleter>(dataOwner) != nullptr ? static_cast<const MappedFile *>(dataOwner.get())
+                                                              : nullptr;
+    }
+
+    ~MappedFile()
+    {
+      if (m_Data == nullptr)
+        return;
+
+#ifdef _WIN32
+      UnmapViewOfFile(m_Data);
+#else
+      munmap(m_Data, m_Size);
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    unsigned char *GetData() const { return m_Data; }
+    std::size_t GetSize() const { return m_Size; }
+    const std::string &GetFileName() const { return m_FileName; }
+
+  private:
+    explicit MappedFile(const std::string &fileName) : m_FileName(fileName), m_Data(nullptr), m_Size(0)
+    {
+      // the view keeps the file mapped, so file and mapping handles are closed right away
+#ifdef _WIN32
+      HANDLE fileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+      LARGE_INTEGER fileSize;
+      if (fileHandle == INVALID_HANDLE_VALUE)
+        return;
+
+      if (GetFileSizeEx(fileHandle, &fileSize) && fileSize.QuadPart > 0)
+      {
+        HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (mappingHandle != nullptr)
+        {
+          m_Data = static_cast<unsigned char *>(MapViewOfFile(mappingHandle, FILE_MAP_COPY, 0, 0, 0));
+          m_Size = static_cast<std::size_t>(fileSize.QuadPart);
+          CloseHandle(mappingHandle);
+        }
+      }
+      CloseHandle(fileHandle);
+#else
+      const int fileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+      struct stat fileStatus;
+      if (fileDescriptor < 0)
+        return;
+
+      if (fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size > 0)
+      {
+        const auto size = static_cast<std::size_t>(fileStatus.st_size);
+        void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileDescriptor, 0);
+        if (data != MAP_FAILED)
+        {
+          m_Data = static_cast<unsigned char *>(data);
+          m_Size = size;
+        }
+      }
+      ::close(fileDescriptor);
+#endif
+    }
+
+    const std::string m_FileName;
+    unsigned char *m_Data;
+    std::size_t m_Size;
+  };
+
+  /** Location of the uncompressed voxel data of an image file.*/
+  struct RawDataLocation
+  {
+    std::string FileName;
+    std::size_t Offset = 0;
+    bool BigEndian = itk::ByteSwapper<int>::SystemIsBigEndian();
+  };
+
+  std::string Trim(const std::string &value)
+  {
+    const auto begin = value.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos)
+      return std::string();
+
+    return value.substr(begin, value.find_last_not_of(" \t\r\n") - begin + 1);
+  }
+
+  std::string ToLower(std::string value)
+  {
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    return value;
+  }
+
+  std::string ResolveDataFileName(const std::string &headerFileName, const std::string &dataFileName)
+  {
+    if (itksys::SystemTools::FileIsFullPath(dataFileName))
+      return dataFileName;
+
+    return itksys::SystemTools::CollapseFullPath(dataFileName, itksys::SystemTools::GetFilenamePath(headerFileName));
+  }
+
+  /** Offsets of -1 denote data at the end of the file, as allowed by NRRD (byte skip) and MetaImage (HeaderSize).*/
+  bool ResolveOffsetFromEnd(long long offset, std::size_t dataSize, RawDataLocation &location)
+  {
+    if (offset >= 0)
+    {
+      location.Offset += static_cast<std::size_t>(offset);
+      return true;
+    }
+
+    if (offset != -1)
+      return false;
+
+    const auto fileSize = static_cast<std::size_t>(itksys::SystemTools::FileLength(location.FileName));
+    if (fileSize < dataSize)
+      return false;
+
+    location.Offset = fileSize - dataSize;
+    return true;
+  }
+
+  bool LocateNrrdData(const std::string &fileName, std::size_t dataSize, RawDataLocation &location)
+  {
+    std::ifstream stream(fileName, std::ios::binary);
+    std::string line;
+    if (!std::getline(stream, line) || line.compare(0, 4, "NRRD") != 0)
+      return false;
+
+    std::string dataFileName;
+    long long byteSkip = 0;
+    bool headerComplete = false;
+
+    while (std::getline(stream, line))
+    {
+      line = Trim(line);
+      if (line.empty())
+      {
+        headerComplete = true;
+        break;
+      }
+
+      const auto separator = line.find(": ");
+      if (line[0] == '#' || separator == std::string::npos)
+        continue; // comments and key/value pairs (":=")
+
+      const auto field = ToLower(Trim(line.substr(0, separator)));
+      const auto value = Trim(line.substr(separator + 2));
+
+      if (field == "encoding" && ToLower(value) != "raw")
+        return false;
+      else if (field == "endian")
+        location.BigEndian = ToLower(value) == "big";
+      else if ((field == "line skip" || field == "lineskip") && value != "0")
+        return false;
+      else if (field == "byte skip" || field == "byteskip")
+        byteSkip = std::stoll(value);
+      else if (field == "data file" || field == "datafile")
+        dataFileName = value;
+    }
+
+    if (dataFileName.empty())
+    {
+      if (!headerComplete)
+        return false;
+
+      location.FileName = fileName;
+      location.Offset = static_cast<std::size_t>(stream.tellg());
+    }
+    else
+    {
+      // lists of data files and file name patterns are not supported
+      if (dataFileName == "LIST" || dataFileName.find(' ') != std::string::npos)
+        return false;
+
+      location.FileName = ResolveDataFileName(fileName, dataFileName);
+      location.Offset = 0;
+    }
+
+    return ResolveOffsetFromEnd(byteSkip, dataSize, location);
+  }
+
+  bool LocateMetaImageData(const std::string &fileName, std::size_t dataSize, RawDataLocation &location)
+  {
+    std::ifstream stream(fileName, std::ios::binary);
+    std::string line;
+    long long headerSize = 0;
+
+    while (std::getline(stream, line))
+    {
+      const auto separator = line.find('=');
+      if (separator == std::string::npos)
+        continue;
+
+      const auto key = Trim(line.substr(0, separator));
+      const auto value = Trim(line.substr(separator + 1));
+
+      if (key == "CompressedData" && ToLower(value) == "true")
+        return false;
+      else if (key == "BinaryDataByteOrderMSB" || key == "ElementByteOrderMSB")
+        location.BigEndian = ToLower(value) == "true";
+      else if (key == "HeaderSize")
+        headerSize = std::stoll(value);
+      else if (key == "ElementDataFile")
+      {
+        // ElementDataFile is the last entry of the header
+        if (value == "LOCAL")
+        {
+          location.FileName = fileName;
+          location.Offset = static_cast<std::size_t>(stream.tellg());
+        }
+        else if (value.compare(0, 4, "LIST") == 0 || value.find(' ') != std::string::npos ||
+                 value.find('%') != std::string::npos)
+        {
+          return false;
+        }
+        else
+        {
+          location.FileName = ResolveDataFileName(fileName, value);
+          location.Offset = 0;
+        }
+
+        return ResolveOffsetFromEnd(headerSize, dataSize, location);
+      }
+    }
+
+    return false;
+  }
+
+  bool LocateNiftiData(const std::string &fileName, RawDataLocation &location)
+  {
+    // only single file NIfTI-1 (magic "n+1") in native byte order without intensity scaling
+    const std::size_t HeaderSize = 348;
+    char header[HeaderSize];
+
+    std::ifstream stream(fileName, std::ios::binary);
+    if (!stream.read(header, HeaderSize))
+      return false;
+
+    std::int32_t sizeOfHeader;
+    float voxelOffset, slope, intercept;
+    std::memcpy(&sizeOfHeader, header, sizeof(std::int32_t));
+    std::memcpy(&voxelOffset, header + 108, sizeof(float));
+    std::memcpy(&slope, header + 112, sizeof(float));
+    std::memcpy(&intercept, header + 116, sizeof(float));
+
+    if (sizeOfHeader != static_cast<std::int32_t>(HeaderSize) || std::strncmp(header + 344, "n+1", 4) != 0)
+      return false;
+
+    if ((slope != 0.0f && slope != 1.0f) || intercept != 0.0f || voxelOffset < HeaderSize + 4)
+      return false;
+
+    location.FileName = fileName;
+    location.Offset = static_cast<std::size_t>(voxelOffset);
+    return true;
+  }
+
+  /** Maps the file containing the voxel data of the image the given ImageIO has read the information of.
+   * Returns nullptr if the data is compressed, not stored in a single contiguous block in the byte order
+   * of the system or otherwise cannot be referenced directly.*/
+  std::shared_ptr<MappedFile> MapRawImageData(const itk::ImageIOBase *imageIO,
+                                              const std::string &fileName,
+                                              std::size_t dataSize,
+                                              std::size_t &dataOffset)
+  {
+    if (imageIO->GetNumberOfComponents() != 1)
+      return nullptr;
+
+    const std::string imageIOName = imageIO->GetNameOfClass();
+    RawDataLocation location;
+    bool located = false;
+
+    try
+    {
+      if (imageIOName == "NrrdImageIO")
+        located = LocateNrrdData(fileName, dataSize, location);
+      else if (imageIOName == "MetaImageIO")
+        located = LocateMetaImageData(fileName, dataSize, location);
+      else if (imageIOName == "NiftiImageIO")
+        located = LocateNiftiData(fileName, location);
+    }
+    catch (const std::exception &e)
+    {
+      MITK_DEBUG << "Cannot locate raw image data of " << fileName << ": " << e.what();
+      located = false;
+    }
+
+    const auto componentSize = imageIO->GetComponentSize();
+    if (!located || (componentSize > 1 && location.BigEndian != itk::ByteSwapper<int>::SystemIsBigEndian()))
+      return nullptr;
+
+    auto mappedFile = MappedFile::Map(location.FileName);
+    if (mappedFile == nullptr || mappedFile->GetSize() < location.Offset + dataSize)
+      return nullptr;
+
+    // pixels must be aligned as if they were allocated
+    if (reinterpret_cast<std::uintptr_t>(mappedFile->GetData() + location.Offset) % componentSize != 0)
+      return nullptr;
+
+    dataOffset = location.Offset;
+    return mappedFile;
+  }
+
+  /** Returns true if writing the given file may overwrite the mapped file. This is the case if it is the mapped file
+   * itself or a header in the same directory with the same name as the mapped data file, e.g. .mhd and .raw.*/
+  bool MayOverwrite(const std::string &fileName, const MappedFile &mappedFile)
+  {
+    if (itksys::SystemTools::SameFile(fileName, mappedFile.GetFileName()))
+      return true;
+
+    auto directory = itksys::SystemTools::GetFilenamePath(fileName);
+    auto mappedDirectory = itksys::SystemTools::GetFilenamePath(mappedFile.GetFileName());
+    if (!itksys::SystemTools::SameFile(directory.empty() ? "." : directory,
+                                      mappedDirectory.empty() ? "." : mappedDirectory))
+      return false;
+
+    return itksys::SystemTools::GetFilenameWithoutLastExtension(fileName) ==
+           itksys::SystemTools::GetFilenameWithoutLastExtension(mappedFile.GetFileName());
+  }
+}
 
 namespace mitk
 {
@@ -38,6 +398,12 @@ namespace mitk
   const char *const PROPERTY_KEY_TIMEGEOMETRY_TIMEPOINTS = "org_mitk_timegeometry_timepoints";
   const char* const PROPERTY_KEY_UID = "org_mitk_uid";
 
+  std::string ItkImageIO::OPTION_MEMORY_MAPPING()
+  {
+    static std::string s = "Memory mapped reading";
+    return s;
+  }
+
   ItkImageIO::ItkImageIO(const ItkImageIO &other)
     : AbstractFileIO(other), m_ImageIO(dynamic_cast<itk::ImageIOBase *>(other.m_ImageIO->Clone().GetPointer()))
   {
@@ -193,6 +559,10 @@ namespace mitk
     this->SetReaderDescription(description);
     this->SetWriterDescription(description);
 
+    Options defaultReaderOptions;
+    defaultReaderOptions[OPTION_MEMORY_MAPPING()] = us::Any(false);
+    this->SetDefaultReaderOptions(defaultReaderOptions);
+
     this->RegisterService();
   }
 
@@ -214,6 +584,10 @@ namespace mitk
       this->AbstractFileWriter::SetRanking(rank);
     }
 
+    Options defaultReaderOptions;
+    defaultReaderOptions[OPTION_MEMORY_MAPPING()] = us::Any(false);
+    this->SetDefaultReaderOptions(defaultReaderOptions);
+
     this->RegisterService();
   }
 
@@ -338,11 +712,40 @@ namespace mitk
 
     MITK_INFO << "ioRegion: " << ioRegion << std::endl;
     m_ImageIO->SetIORegion(ioRegion);
-    void *buffer = new unsigned char[m_ImageIO->GetImageSizeInBytes()];
-    m_ImageIO->Read(buffer);
-
     image->Initialize(MakePixelType(m_ImageIO), ndim, dimensions);
-    image->SetImportChannel(buffer, 0, Image::ManageMemory);
+
+    bool useMemoryMapping = false;
+    try
+    {
+      useMemoryMapping = us::any_cast<bool>(this->GetReaderOption(OPTION_MEMORY_MAPPING()));
+    }
+    catch (const us::BadAnyCastException &e)
+    {
+      MITK_WARN << "Unexpected error: " << e.what();
+    }
+
+    const auto dataSize = static_cast<std::size_t>(m_ImageIO->GetImageSizeInBytes());
+    std::shared_ptr<MappedFile> mappedFile;
+    std::size_t dataOffset = 0;
+
+    // temporary copies of input streams are deleted after reading, hence only files are mapped
+    if (useMemoryMapping && this->GetInputStream() == nullptr && ndim == m_ImageIO->GetNumberOfDimensions())
+    {
+      mappedFile = MapRawImageData(m_ImageIO, path, dataSize, dataOffset);
+    }
+
+    if (mappedFile != nullptr)
+    {
+      MITK_INFO << "memory mapped image data at offset " << dataOffset;
+      image->SetImportChannel(mappedFile->GetData() + dataOffset, 0, Image::ReferenceMemory);
+      image->GetChannelData(0)->SetDataOwner(mappedFile);
+    }
+    else
+    {
+      void *buffer = new unsigned char[dataSize];
+      m_ImageIO->Read(buffer);
+      image->SetImportChannel(buffer, 0, Image::ManageMemory);
+    }
 
     const itk::MetaDataDictionary &dictionary = m_ImageIO->GetMetaDataDictionary();
 
@@ -706,7 +1109,23 @@ namespace mitk
 
       ImageReadAccessor imageAccess(image);
       LocaleSwitch localeSwitch2("C");
-      m_ImageIO->Write(imageAccess.GetData());
+
+      const MappedFile *mappedFile =
+        image->IsChannelSet(0) ? MappedFile::GetMappedFile(image->GetChannelData(0)->GetDataOwner()) : nullptr;
+
+      if (mappedFile != nullptr && MayOverwrite(path, *mappedFile))
+      {
+        // The data is memory mapped from the file that is written now. Truncating that file
+        // would invalidate the pages that were not loaded yet, hence the data is copied first.
+        const auto dataSize = static_cast<std::size_t>(m_ImageIO->GetImageSizeInBytes());
+        std::unique_ptr<unsigned char[]> buffer(new unsigned char[dataSize]);
+        std::memcpy(buffer.get(), imageAccess.GetData(), dataSize);
+        m_ImageIO->Write(buffer.get());
+      }
+      else
+      {
+        m_ImageIO->Write(imageAccess.GetData());
+      }
     }
     catch (const std::exception &e)
     {
@@ -27,6 +27,7 @@ found in the LICENSE file.
 #include "mitkNodePredicateAnd.h"
 #include "mitkNodePredicateData.h"
 #include "mitkNodePredicateDataType.h"
+#include "mitkNodePredicateDataUID.h"
 #include "mitkNodePredicateDimension.h"
 #include "mitkNodePredicateNot.h"
 #include "mitkNodePredicateOr.h"
@@ -847,6 +848,91 @@ void TestDataStorage(mitk::DataStorage *ds, std::string filename)
     MITK_TEST_CONDITION((bounds[0] == i) && (bounds[1] == i + 1),
                         "Test for timebounds of geometry at different time steps with ComputeBoundingGeometry()");
   }
+  MITK_TEST_CONDITION(ds->ComputeBoundingGeometry3D(all) == geometry,
+                      "Test that ComputeBoundingGeometry3D() returns the same geometry for an unchanged scene");
+
+  mitk::Image::Pointer farImage = mitk::Image::New();
+  unsigned int farImageDimensions[] = {2, 2, 2};
+  farImage->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 3, farImageDimensions);
+  mitk::Point3D farOrigin;
+  farOrigin.Fill(1000.0);
+  farImage->GetGeometry()->SetOrigin(farOrigin);
+  farImage->GetTimeGeometry()->Update();
+  mitk::DataNode::Pointer farNode = mitk::DataNode::New();
+  farNode->SetData(farImage);
+  ds->Add(farNode);
+  geometry = ds->ComputeBoundingGeometry3D();
+  MITK_TEST_CONDITION(geometry->GetBoundingBoxInWorld()->GetMaximum()[0] >= 1000.0,
+                      "Test that ComputeBoundingGeometry3D() considers added nodes");
+
+  farOrigin.Fill(2000.0);
+  farImage->GetGeometry()->SetOrigin(farOrigin);
+  farImage->GetTimeGeometry()->Update();
+  geometry = ds->ComputeBoundingGeometry3D();
+  MITK_TEST_CONDITION(geometry->GetBoundingBoxInWorld()->GetMaximum()[0] >= 2000.0,
+                      "Test that ComputeBoundingGeometry3D() considers modified geometries");
+
+  ds->Remove(farNode);
+  geometry = ds->ComputeBoundingGeometry3D();
+  MITK_TEST_CONDITION(geometry->GetBoundingBoxInWorld()->GetMaximum()[0] < 1000.0,
+                      "Test that ComputeBoundingGeometry3D() ignores removed nodes");
+
+  // test that queries answered from the node index follow changes of the nodes
+  mitk::Image::Pointer indexedImage = mitk::Image::New();
+  mitk::DataNode::Pointer indexedNode = mitk::DataNode::New();
+  indexedNode->SetData(indexedImage);
+  indexedNode->SetName("indexedNode");
+  ds->Add(indexedNode);
+
+  mitk::NodePredicateProperty::Pointer indexedNamePredicate =
+    mitk::NodePredicateProperty::New("name", mitk::StringProperty::New("indexedNode"));
+  mitk::DataStorage::SetOfObjects::ConstPointer indexedSubset = ds->GetSubset(indexedNamePredicate);
+  MITK_TEST_CONDITION((indexedSubset->Size() == 1) && (indexedSubset->GetElement(0) == indexedNode),
+                      "Test that GetSubset() finds a node by an indexed property");
+
+  dynamic_cast<mitk::StringProperty *>(indexedNode->GetProperty("name"))->SetValue("renamedNode");
+  mitk::NodePredicateProperty::Pointer renamedNamePredicate =
+    mitk::NodePredicateProperty::New("name", mitk::StringProperty::New("renamedNode"));
+  MITK_TEST_CONDITION((ds->GetSubset(indexedNamePredicate)->Size() == 0) &&
+                        (ds->GetSubset(renamedNamePredicate)->Size() == 1),
+                      "Test that GetSubset() considers changed values of indexed properties");
+
+  mitk::NodePredicateDataUID::Pointer indexedUIDPredicate = mitk::NodePredicateDataUID::New(indexedImage->GetUID());
+  MITK_TEST_CONDITION(ds->GetSubset(mitk::NodePredicateAnd::New(mitk::NodePredicateDataType::New("Image"),
+                                                                renamedNamePredicate,
+                                                                indexedUIDPredicate))
+                          ->Size() == 1,
+                      "Test that GetSubset() answers conjunctions of indexed conditions");
+  MITK_TEST_CONDITION(
+    ds->GetSubset(mitk::NodePredicateOr::New(indexedNamePredicate, indexedUIDPredicate))->Size() == 1,
+    "Test that GetSubset() answers disjunctions of indexed conditions");
+
+  mitk::NodePredicateProperty::Pointer binaryPredicate =
+    mitk::NodePredicateProperty::New("binary", mitk::BoolProperty::New(true));
+  const unsigned int numberOfBinaryNodes = ds->GetSubset(binaryPredicate)->Size();
+  indexedImage->SetProperty("binary", mitk::BoolProperty::New(true));
+  MITK_TEST_CONDITION(ds->GetSubset(binaryPredicate)->Size() == numberOfBinaryNodes + 1,
+                      "Test that GetSubset() considers indexed properties of the data");
+
+  unsigned int numberOfMatchingNodes = 0;
+  mitk::DataStorage::SetOfObjects::ConstPointer allNodes = ds->GetAll();
+  for (auto nodeIt = allNodes->Begin(); nodeIt != allNodes->End(); ++nodeIt)
+  {
+    if (binaryPredicate->CheckNode(nodeIt.Value()))
+      ++numberOfMatchingNodes;
+  }
+  MITK_TEST_CONDITION(ds->GetSubset(binaryPredicate)->Size() == numberOfMatchingNodes,
+                      "Test that GetSubset() with indexed conditions equals testing all nodes");
+
+  indexedNode->SetData(mitk::Surface::New());
+  MITK_TEST_CONDITION(ds->GetSubset(mitk::NodePredicateAnd::New(mitk::NodePredicateDataType::New("Image"),
+                                                                renamedNamePredicate))
+                          ->Size() == 0,
+                      "Test that GetSubset() considers replaced data");
+
+  ds->Remove(indexedNode);
+  MITK_TEST_CONDITION(ds->GetSubset(renamedNamePredicate)->Size() == 0,
+                      "Test that GetSubset() ignores removed nodes");
 
   // test for thread safety of DataStorage
   try
@@ -18,8 +18,12 @@ found in the LICENSE file.
 #include "mitkIOUtil.h"
 #include "mitkITKImageImport.h"
 #include <mitkExtractSliceFilter.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkItkImageIO.h>
 
 #include "itksys/SystemTools.hxx"
+#include <itkImageFileWriter.h>
 #include <itkImageRegionIterator.h>
 
 #include <fstream>
@@ -43,6 +47,11 @@ class mitkItkImageIOTestSuite : public mitk::TestFixture
   MITK_TEST(TestWrite3DImageWithTwoPlanes);
   MITK_TEST(TestWrite3DplusT_ArbitraryTG);
   MITK_TEST(TestWrite3DplusT_ProportionalTG);
+  MITK_TEST(TestMemoryMappedReadingNrrd);
+  MITK_TEST(TestMemoryMappedReadingMhd);
+  MITK_TEST(TestMemoryMappedReadingNifti);
+  MITK_TEST(TestMemoryMappedSaveToSourceFileNrrd);
+  MITK_TEST(TestMemoryMappedSaveToSourceFileMhd);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -422,6 +431,122 @@ public:
     CPPUNIT_ASSERT_THROW(mitk::IOUtil::Save(image, mitk::IOUtil::CreateTemporaryFile("3Dto2DTestImageXXXXXX.png")),
                          mitk::Exception);
   }
+
+  /**
+  *  test for reading uncompressed files via memory mapping
+  */
+  void TestMemoryMappedReading(const std::string &extension)
+  {
+    typedef itk::Image<short, 3> ItkImageType;
+    ItkImageType::Pointer itkImage = ItkImageType::New();
+    ItkImageType::SizeType size = {{31, 17, 9}};
+    itkImage->SetRegions(size);
+    itkImage->Allocate();
+
+    itk::ImageRegionIterator<ItkImageType> imageIterator(itkImage, itkImage->GetLargestPossibleRegion());
+    for (short value = 0; !imageIterator.IsAtEnd(); ++imageIterator, ++value)
+    {
+      imageIterator.Set(value);
+    }
+
+    const std::string tmpFilePath = mitk::IOUtil::CreateTemporaryFile("MemoryMappingTestImageXXXXXX" + extension);
+    typedef itk::ImageFileWriter<ItkImageType> WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(itkImage);
+    writer->SetFileName(tmpFilePath);
+    writer->UseCompressionOff();
+    writer->Update();
+
+    mitk::IFileReader::Options options;
+    options[mitk::ItkImageIO::OPTION_MEMORY_MAPPING()] = us::Any(false);
+    mitk::Image::Pointer readImage = mitk::IOUtil::Load<mitk::Image>(tmpFilePath, options);
+    options[mitk::ItkImageIO::OPTION_MEMORY_MAPPING()] = us::Any(true);
+    mitk::Image::Pointer mappedImage = mitk::IOUtil::Load<mitk::Image>(tmpFilePath, options);
+
+    CPPUNIT_ASSERT_MESSAGE("Memory mapped image equals read image.",
+                           mitk::Equal(*readImage, *mappedImage, mitk::eps, true));
+
+    const itk::Index<3> index = {{3, 4, 5}};
+    {
+      mitk::ImagePixelWriteAccessor<short, 3> writeAccessor(mappedImage);
+      writeAccessor.SetPixelByIndex(index, -1);
+    }
+
+    // modifications of the mapped image must not change the file
+    mitk::Image::Pointer reloadedImage = mitk::IOUtil::Load<mitk::Image>(tmpFilePath, options);
+    {
+      mitk::ImagePixelReadAccessor<short, 3> mappedAccessor(mappedImage);
+      mitk::ImagePixelReadAccessor<short, 3> reloadedAccessor(reloadedImage);
+      CPPUNIT_ASSERT_EQUAL(static_cast<short>(-1), mappedAccessor.GetPixelByIndex(index));
+      CPPUNIT_ASSERT_EQUAL(itkImage->GetPixel(index), reloadedAccessor.GetPixelByIndex(index));
+    }
+
+    // release the mappings before removing the file
+    mappedImage = nullptr;
+    reloadedImage = nullptr;
+    std::remove(tmpFilePath.c_str());
+  }
+
+  /**
+  *  test for saving a memory mapped image to the file it was read from
+  */
+  void TestMemoryMappedSaveToSourceFile(const std::string &extension)
+  {
+    typedef itk::Image<short, 3> ItkImageType;
+    ItkImageType::Pointer itkImage = ItkImageType::New();
+    ItkImageType::SizeType size = {{64, 48, 32}};
+    itkImage->SetRegions(size);
+    itkImage->Allocate();
+
+    itk::ImageRegionIterator<ItkImageType> imageIterator(itkImage, itkImage->GetLargestPossibleRegion());
+    for (short value = 0; !imageIterator.IsAtEnd(); ++imageIterator, ++value)
+    {
+      imageIterator.Set(value);
+    }
+
+    const std::string tmpFilePath = mitk::IOUtil::CreateTemporaryFile("MemoryMappingSaveTestImageXXXXXX" + extension);
+    typedef itk::ImageFileWriter<ItkImageType> WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(itkImage);
+    writer->SetFileName(tmpFilePath);
+    writer->UseCompressionOff();
+    writer->Update();
+
+    mitk::IFileReader::Options options;
+    options[mitk::ItkImageIO::OPTION_MEMORY_MAPPING()] = us::Any(true);
+    mitk::Image::Pointer mappedImage = mitk::IOUtil::Load<mitk::Image>(tmpFilePath, options);
+
+    const itk::Index<3> index = {{3, 4, 5}};
+    {
+      mitk::ImagePixelWriteAccessor<short, 3> writeAccessor(mappedImage);
+      writeAccessor.SetPixelByIndex(index, -1);
+    }
+
+    // the file is truncated while the image still references the mapping
+    mitk::IOUtil::Save(mappedImage, tmpFilePath);
+
+    options[mitk::ItkImageIO::OPTION_MEMORY_MAPPING()] = us::Any(false);
+    mitk::Image::Pointer reloadedImage = mitk::IOUtil::Load<mitk::Image>(tmpFilePath, options);
+
+    CPPUNIT_ASSERT_MESSAGE("Saved image equals memory mapped image.",
+                           mitk::Equal(*mappedImage, *reloadedImage, mitk::eps, true));
+    {
+      mitk::ImagePixelReadAccessor<short, 3> reloadedAccessor(reloadedImage);
+      const itk::Index<3> lastIndex = {{63, 47, 31}};
+      CPPUNIT_ASSERT_EQUAL(static_cast<short>(-1), reloadedAccessor.GetPixelByIndex(index));
+      CPPUNIT_ASSERT_EQUAL(itkImage->GetPixel(lastIndex), reloadedAccessor.GetPixelByIndex(lastIndex));
+    }
+
+    mappedImage = nullptr;
+    reloadedImage = nullptr;
+    std::remove(tmpFilePath.c_str());
+  }
+
+  void TestMemoryMappedReadingNrrd() { TestMemoryMappedReading(".nrrd"); }
+  void TestMemoryMappedReadingMhd() { TestMemoryMappedReading(".mha"); }
+  void TestMemoryMappedReadingNifti() { TestMemoryMappedReading(".nii"); }
+  void TestMemoryMappedSaveToSourceFileNrrd() { TestMemoryMappedSaveToSourceFile(".nrrd"); }
+  void TestMemoryMappedSaveToSourceFileMhd() { TestMemoryMappedSaveToSourceFile(".mha"); }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkItkImageIO)
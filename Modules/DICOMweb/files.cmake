@@ -1,3 +1,4 @@
 set(CPP_FILES
   mitkDICOMweb.cpp
+  mitkMultipartParser.cpp
 )
@@ -17,7 +17,10 @@ found in the LICENSE file.
 
 #include "cpprest/asyncrt_utils.h"
 #include "cpprest/http_client.h"
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <mitkCommon.h>
 #include <mitkIRESTManager.h>
 #include <mitkRESTUtil.h>
@@ -44,6 +47,11 @@ namespace mitk
    typedef web::http::http_response MitkResponse;
    typedef web::http::methods MitkRESTMethods;
 
+   /**
+    * @brief Receives the encoded DICOM object instances of a streamed WADO-RS retrieval, one call per instance.
+    */
+   typedef std::function<void(const std::string &instance)> InstanceCallback;
+
    DICOMweb();
 
    /**
@@ -82,6 +90,13 @@ namespace mitk
     * @brief Sends a WADO request for an DICOM object series matching the given uid parameters and stores all the
     * containing instances at the given folder path.
     *
+    * The series is retrieved with a single WADO-RS request (see SendWADORS()) and the instances are written to
+    * files while they are received. If the server does not answer the WADO-RS request before an instance was
+    * stored, the instances are requested one by one instead, at most GetMaximumNumberOfRequests() at the same time.
+    * In both cases the files are named <code>\<SOP instance uid\>.dcm</code>, so several series can be stored in
+    * the same folder. Received instances without a readable SOP instance uid in their file meta information are
+    * stored as <code>\<series uid\>_\<n\>.dcm</code>, numbered in the order they are received.
+    *
     * @param folderPath the path at which the retrieved DICOM object instances of the retrieved series will be stored
     * @param studyUID the DICOM study uid
     * @param seriesUID the DICOM series uid
@@ -105,6 +120,28 @@ namespace mitk
     */
    pplx::task<web::json::value> SendQIDO(mitk::RESTUtil::ParamMap map);
 
+   /**
+    * @brief Sends a WADO-RS request for a DICOM object series and hands each contained instance to the callback as
+    * soon as it is received.
+    *
+    * The whole series is transferred as one multipart response, which is parsed while it is received. Instances are
+    * kept in memory only until the callback returns, no files are written. The callback is called from the thread
+    * that receives the response, one instance after another in the order sent by the server.
+    *
+    * @param studyUID the DICOM study uid
+    * @param seriesUID the DICOM series uid
+    * @param callback the function each encoded DICOM object instance is handed to
+    * @return the task to wait for, which finishes after the last instance has been handed to the callback
+    */
+   pplx::task<void> SendWADORS(utility::string_t studyUID, utility::string_t seriesUID, InstanceCallback callback);
+
+   /**
+    * @brief Sets the maximum number of instance requests a series retrieval without WADO-RS sends at the same time
+    * (default: 8).
+    */
+   void SetMaximumNumberOfRequests(unsigned int maximumNumberOfRequests);
+   unsigned int GetMaximumNumberOfRequests() const;
+
  private:
    /**
     * @brief Creates a QIDO request URI with the given parameter map
@@ -123,6 +160,28 @@ namespace mitk
     */
    utility::string_t CreateSTOWUri(utility::string_t studyUID);
 
+   /**
+    * @brief Creates a WADO-RS request URI for the series given by the uids
+    */
+   utility::string_t CreateWADORSUri(utility::string_t studyUID, utility::string_t seriesUID);
+
+   /**
+    * @brief Queries the instances of a series and retrieves them with one WADO request per instance.
+    */
+   pplx::task<std::string> SendWADOInstances(utility::string_t folderPath,
+                                             utility::string_t studyUID,
+                                             utility::string_t seriesUID);
+
+   /**
+    * @brief Retrieves the instances of a series one after another, starting with the next one not yet taken by
+    * another chain of requests.
+    */
+   pplx::task<void> SendWADOChain(utility::string_t folderPath,
+                                  utility::string_t studyUID,
+                                  utility::string_t seriesUID,
+                                  std::shared_ptr<const std::vector<utility::string_t>> instanceUIDs,
+                                  std::shared_ptr<std::atomic<std::size_t>> nextInstance);
+
    /**
     * @brief Initializes the rest manager for this service instance. Should be called in constructor to make sure the
     * public API can work properly.
@@ -131,6 +190,7 @@ namespace mitk
 
    utility::string_t m_BaseURI;
    mitk::IRESTManager *m_RESTManager;
+   unsigned int m_MaximumNumberOfRequests;
  };
 }
 
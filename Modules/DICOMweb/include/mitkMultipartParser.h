@@ -0,0 +1,91 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkMultipartParser_h
+#define mitkMultipartParser_h
+
+#include <MitkDICOMwebExports.h>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace mitk
+{
+  /**
+   * @brief Splits a multipart body (RFC 2046) into its parts while it is received.
+   *
+   * The body may be fed in chunks of any size, delimiters and headers split across chunks are handled. The content of
+   * each complete part is handed to the callback, the part headers, the preamble and the epilogue are skipped.
+   */
+  class MITKDICOMWEB_EXPORT MultipartParser
+  {
+  public:
+    typedef std::function<void(const std::string &content)> PartCallback;
+
+    /**
+     * @param boundary the boundary parameter of the multipart content type without quotes
+     * @param callback the function the content of each complete part is handed to
+     */
+    MultipartParser(const std::string &boundary, PartCallback callback);
+
+    /**
+     * @brief Appends the next chunk of the body and hands all parts completed by it to the callback.
+     */
+    void Feed(const char *data, std::size_t size);
+
+    /**
+     * @brief Returns true if the close delimiter was received, i.e. the body is complete.
+     */
+    bool IsFinished() const;
+
+    /**
+     * @brief Returns the boundary parameter of a multipart content type without quotes or an empty string if the
+     * content type is no multipart type or has no boundary.
+     */
+    static std::string GetBoundary(const std::string &contentType);
+
+  private:
+    enum class State
+    {
+      Preamble,
+      AfterDelimiter,
+      Headers,
+      Content,
+      Finished
+    };
+
+    /**
+     * @brief Continues with the next element of the body. Returns false if more data is needed.
+     */
+    bool ParseNext();
+
+    /**
+     * @brief Drops everything up to and including the pattern and switches to the next state.
+     */
+    bool SkipTo(const std::string &pattern, State nextState);
+
+    /**
+     * @brief Avoids searching the already searched part of the buffer again, a pattern may only start in its tail.
+     */
+    void UpdateSearchOffset(std::size_t patternSize);
+
+    const std::string m_Delimiter;
+    const std::string m_ContentDelimiter;
+    PartCallback m_Callback;
+    State m_State;
+    std::string m_Buffer;
+    std::size_t m_SearchOffset;
+  };
+}
+
+#endif
@@ -11,10 +11,95 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkDICOMweb.h"
+#include "mitkMultipartParser.h"
 
-mitk::DICOMweb::DICOMweb() {}
+#include <cpprest/containerstream.h>
 
-mitk::DICOMweb::DICOMweb(utility::string_t baseURI) : m_BaseURI(baseURI)
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+
+namespace
+{
+  /** Number of bytes read at once from the body of a streamed response.*/
+  const std::size_t READ_CHUNK_SIZE = 1 << 20;
+
+  /** Reads the body chunk by chunk into the parser until it ends.*/
+  pplx::task<void> ReadMultipartBody(concurrency::streams::istream body,
+                                     std::shared_ptr<mitk::MultipartParser> parser)
+  {
+    concurrency::streams::container_buffer<std::vector<uint8_t>> chunk;
+    return body.read(chunk, READ_CHUNK_SIZE).then([=](std::size_t bytesRead) -> pplx::task<void> {
+      if (0 == bytesRead)
+        return pplx::task_from_result();
+
+      const auto &data = chunk.collection();
+      parser->Feed(reinterpret_cast<const char *>(data.data()), data.size());
+      return ReadMultipartBody(body, parser);
+    });
+  }
+
+  /** Returns the media storage SOP instance uid (0002,0003) from the file meta information of a DICOM part 10
+   * object. It equals the SOP instance uid (0008,0018) of the data set. An empty string is returned if the uid is
+   * missing or contains characters that are not allowed in a uid, so that it is safe to use it as a file name.*/
+  std::string ReadSOPInstanceUID(const std::string &instance)
+  {
+    const std::size_t preambleSize = 128;
+    if (instance.size() < preambleSize + 4 || 0 != instance.compare(preambleSize, 4, "DICM"))
+      return std::string();
+
+    auto readUInt16 = [&instance](std::size_t position) -> std::size_t {
+      return static_cast<uint8_t>(instance[position]) | (static_cast<uint8_t>(instance[position + 1]) << 8);
+    };
+
+    // the file meta information is always encoded in explicit VR little endian
+    auto position = preambleSize + 4;
+    while (position + 8 <= instance.size() && 0x0002 == readUInt16(position))
+    {
+      const auto element = readUInt16(position + 2);
+      const auto vr = instance.substr(position + 4, 2);
+
+      std::size_t length = 0;
+      if ("OB" == vr || "OW" == vr || "OF" == vr || "SQ" == vr || "UT" == vr || "UN" == vr)
+      {
+        if (position + 12 > instance.size())
+          break;
+        length = readUInt16(position + 8) | (readUInt16(position + 10) << 16);
+        position += 12;
+      }
+      else
+      {
+        length = readUInt16(position + 6);
+        position += 8;
+      }
+
+      if (length > instance.size() - position)
+        break;
+
+      if (0x0003 == element)
+      {
+        // values are padded to an even length
+        auto uid = instance.substr(position, length);
+        while (!uid.empty() && ('\0' == uid.back() || ' ' == uid.back()))
+          uid.pop_back();
+
+        if (uid.empty() || uid.size() > 64 || std::string::npos != uid.find_first_not_of("0123456789."))
+          return std::string();
+
+        return uid;
+      }
+
+      position += length;
+    }
+
+    return std::string();
+  }
+}
+
+mitk::DICOMweb::DICOMweb() : m_RESTManager(nullptr), m_MaximumNumberOfRequests(8) {}
+
+mitk::DICOMweb::DICOMweb(utility::string_t baseURI)
+  : m_BaseURI(baseURI), m_RESTManager(nullptr), m_MaximumNumberOfRequests(8)
 {
   MITK_INFO << "base uri: " << mitk::RESTUtil::convertToUtf8(m_BaseURI);
   InitializeRESTManager();
@@ -46,6 +131,15 @@ utility::string_t mitk::DICOMweb::CreateWADOUri(utility::string_t studyUID,
   return builder.to_string();
 }
 
+utility::string_t mitk::DICOMweb::CreateWADORSUri(utility::string_t studyUID, utility::string_t seriesUID)
+{
+  MitkUriBuilder builder(m_BaseURI + U("rs/studies"));
+  builder.append_path(studyUID);
+  builder.append_path(U("series"));
+  builder.append_path(seriesUID);
+  return builder.to_string();
+}
+
 utility::string_t mitk::DICOMweb::CreateSTOWUri(utility::string_t studyUID)
 {
   MitkUriBuilder builder(m_BaseURI + U("rs/studies"));
@@ -137,6 +231,52 @@ pplx::task<void> mitk::DICOMweb::SendWADO(utility::string_t filePath,
 pplx::task<std::string> mitk::DICOMweb::SendWADO(utility::string_t folderPath,
                                                  utility::string_t studyUID,
                                                  utility::string_t seriesUID)
+{
+  // instances are named by their SOP instance uid like the ones retrieved one by one, instances without a readable
+  // uid are numbered in the order they are received
+  auto filePaths = std::make_shared<std::vector<utility::string_t>>();
+
+  auto storeInstance = [=](const std::string &instance) {
+    auto sopInstanceUID = ReadSOPInstanceUID(instance);
+    auto fileName = sopInstanceUID.empty()
+                      ? utility::string_t(seriesUID).append(U("_")).append(
+                          utility::conversions::to_string_t(std::to_string(filePaths->size())))
+                      : utility::conversions::to_string_t(sopInstanceUID);
+    auto filePath = utility::string_t(folderPath).append(fileName).append(U(".dcm"));
+
+    std::ofstream file(filePath, std::ios::binary);
+    file.write(instance.data(), instance.size());
+    if (!file)
+      mitkThrow() << "Could not write DICOM object instance to " << mitk::RESTUtil::convertToUtf8(filePath);
+
+    filePaths->push_back(filePath);
+  };
+
+  auto retrieval = SendWADORS(studyUID, seriesUID, storeInstance);
+
+  return retrieval.then([=](pplx::task<void> finishedRetrieval) -> pplx::task<std::string> {
+    try
+    {
+      finishedRetrieval.get();
+      auto result = filePaths->empty() ? folderPath : filePaths->front();
+      return pplx::task_from_result(utility::conversions::to_utf8string(result));
+    }
+    catch (const std::exception &e)
+    {
+      // a partially stored series can not be completed by single instance requests
+      if (!filePaths->empty())
+        throw;
+
+      MITK_WARN << "WADO-RS retrieval failed, retrieving the instances one by one: " << e.what();
+    }
+
+    return SendWADOInstances(folderPath, studyUID, seriesUID);
+  });
+}
+
+pplx::task<std::string> mitk::DICOMweb::SendWADOInstances(utility::string_t folderPath,
+                                                          utility::string_t studyUID,
+                                                          utility::string_t seriesUID)
 {
   mitk::RESTUtil::ParamMap seriesInstances;
   seriesInstances.insert(mitk::RESTUtil::ParamMap::value_type(U("StudyInstanceUID"), studyUID));
@@ -148,7 +288,7 @@ pplx::task<std::string> mitk::DICOMweb::SendWADO(utility::string_t folderPath,
 
     auto firstFileName = std::string();
 
-    std::vector<pplx::task<void>> tasks;
+    auto instanceUIDs = std::make_shared<std::vector<utility::string_t>>();
 
     for (unsigned short i = 0; i < resultArray.size(); i++)
     {
@@ -161,17 +301,13 @@ pplx::task<std::string> mitk::DICOMweb::SendWADO(utility::string_t folderPath,
         auto valueArray = valueKey.as_array();
         auto sopInstanceUID = valueArray[0].as_string();
 
-        auto fileName = utility::string_t(sopInstanceUID).append(U(".dcm"));
-
         // save first file name as result to load series
         if (i == 0)
         {
-          firstFileName = utility::conversions::to_utf8string(fileName);
+          firstFileName = utility::conversions::to_utf8string(utility::string_t(sopInstanceUID).append(U(".dcm")));
         }
 
-        auto filePath = utility::string_t(folderPath).append(fileName);
-        auto task = SendWADO(filePath, studyUID, seriesUID, sopInstanceUID);
-        tasks.push_back(task);
+        instanceUIDs->push_back(sopInstanceUID);
       }
       catch (const web::json::json_exception &e)
       {
@@ -180,6 +316,16 @@ pplx::task<std::string> mitk::DICOMweb::SendWADO(utility::string_t folderPath,
       }
     }
 
+    // each chain requests one instance after another, so at most one request per chain is pending
+    auto nextInstance = std::make_shared<std::atomic<std::size_t>>(0);
+    auto numberOfChains = std::min<std::size_t>(std::max(1u, m_MaximumNumberOfRequests), instanceUIDs->size());
+
+    std::vector<pplx::task<void>> tasks;
+    for (std::size_t i = 0; i < numberOfChains; ++i)
+    {
+      tasks.push_back(SendWADOChain(folderPath, studyUID, seriesUID, instanceUIDs, nextInstance));
+    }
+
     auto joinTask = pplx::when_all(begin(tasks), end(tasks));
 
     auto returnTask = joinTask.then([=](void) -> std::string {
@@ -193,6 +339,60 @@ pplx::task<std::string> mitk::DICOMweb::SendWADO(utility::string_t folderPath,
   });
 }
 
+pplx::task<void> mitk::DICOMweb::SendWADOChain(utility::string_t folderPath,
+                                               utility::string_t studyUID,
+                                               utility::string_t seriesUID,
+                                               std::shared_ptr<const std::vector<utility::string_t>> instanceUIDs,
+                                               std::shared_ptr<std::atomic<std::size_t>> nextInstance)
+{
+  auto index = (*nextInstance)++;
+  if (index >= instanceUIDs->size())
+    return pplx::task_from_result();
+
+  auto instanceUID = (*instanceUIDs)[index];
+  auto filePath = utility::string_t(folderPath).append(instanceUID).append(U(".dcm"));
+
+  return SendWADO(filePath, studyUID, seriesUID, instanceUID).then([=]() {
+    return SendWADOChain(folderPath, studyUID, seriesUID, instanceUIDs, nextInstance);
+  });
+}
+
+pplx::task<void> mitk::DICOMweb::SendWADORS(utility::string_t studyUID,
+                                            utility::string_t seriesUID,
+                                            InstanceCallback callback)
+{
+  auto uri = CreateWADORSUri(studyUID, seriesUID);
+
+  mitk::RESTUtil::ParamMap headers;
+  headers.insert(
+    mitk::RESTUtil::ParamMap::value_type(U("Accept"), U("multipart/related; type=\"application/dicom\"")));
+
+  return m_RESTManager->SendStreamingRequest(uri, headers).then([=](MitkResponse response) -> pplx::task<void> {
+    auto contentType = mitk::RESTUtil::convertToUtf8(response.headers().content_type());
+    auto boundary = mitk::MultipartParser::GetBoundary(contentType);
+    if (boundary.empty())
+      mitkThrow() << "WADO-RS response is no multipart message: " << contentType;
+
+    auto parser = std::make_shared<mitk::MultipartParser>(boundary, callback);
+
+    // the continuation keeps the response and thus its body stream alive until the whole body is read
+    return ReadMultipartBody(response.body(), parser).then([response, parser]() {
+      if (!parser->IsFinished())
+        mitkThrow() << "WADO-RS response ended within the multipart message";
+    });
+  });
+}
+
+void mitk::DICOMweb::SetMaximumNumberOfRequests(unsigned int maximumNumberOfRequests)
+{
+  m_MaximumNumberOfRequests = maximumNumberOfRequests;
+}
+
+unsigned int mitk::DICOMweb::GetMaximumNumberOfRequests() const
+{
+  return m_MaximumNumberOfRequests;
+}
+
 pplx::task<web::json::value> mitk::DICOMweb::SendQIDO(mitk::RESTUtil::ParamMap map)
 {
   auto uri = CreateQIDOUri(map);
@@ -0,0 +1,153 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkMultipartParser.h"
+
+#include <algorithm>
+#include <cctype>
+
+mitk::MultipartParser::MultipartParser(const std::string &boundary, PartCallback callback)
+  : m_Delimiter("--" + boundary),
+    m_ContentDelimiter("\r\n--" + boundary),
+    m_Callback(callback),
+    m_State(State::Preamble),
+    m_SearchOffset(0)
+{
+}
+
+void mitk::MultipartParser::Feed(const char *data, std::size_t size)
+{
+  m_Buffer.append(data, size);
+  while (this->ParseNext())
+  {
+  }
+}
+
+bool mitk::MultipartParser::IsFinished() const
+{
+  return State::Finished == m_State;
+}
+
+std::string mitk::MultipartParser::GetBoundary(const std::string &contentType)
+{
+  std::string lowerContentType(contentType);
+  std::transform(lowerContentType.begin(), lowerContentType.end(), lowerContentType.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+
+  if (0 != lowerContentType.find("multipart/"))
+    return std::string();
+
+  auto position = lowerContentType.find("boundary=");
+  if (std::string::npos == position)
+    return std::string();
+
+  auto boundary = contentType.substr(position + 9);
+  if (!boundary.empty() && '"' == boundary[0])
+  {
+    auto end = boundary.find('"', 1);
+    if (std::string::npos == end)
+      return std::string();
+
+    return boundary.substr(1, end - 1);
+  }
+
+  boundary = boundary.substr(0, boundary.find(';'));
+  return boundary.substr(0, boundary.find_last_not_of(" \t") + 1);
+}
+
+bool mitk::MultipartParser::ParseNext()
+{
+  switch (m_State)
+  {
+    case State::Preamble:
+      return this->SkipTo(m_Delimiter, State::AfterDelimiter);
+
+    case State::AfterDelimiter:
+    {
+      if (m_Buffer.size() < 2)
+        return false;
+
+      if (0 == m_Buffer.compare(0, 2, "--"))
+      {
+        // close delimiter, the epilogue is ignored
+        m_Buffer.clear();
+        m_State = State::Finished;
+        return false;
+      }
+
+      // skip transport padding up to the line break
+      auto lineEnd = m_Buffer.find("\r\n");
+      if (std::string::npos == lineEnd)
+        return false;
+
+      m_Buffer.erase(0, lineEnd + 2);
+      m_State = State::Headers;
+      return true;
+    }
+
+    case State::Headers:
+    {
+      if (m_Buffer.size() < 2)
+        return false;
+
+      // a part without headers starts with the empty line
+      if (0 == m_Buffer.compare(0, 2, "\r\n"))
+      {
+        m_Buffer.erase(0, 2);
+        m_State = State::Content;
+        return true;
+      }
+
+      return this->SkipTo("\r\n\r\n", State::Content);
+    }
+
+    case State::Content:
+    {
+      auto position = m_Buffer.find(m_ContentDelimiter, m_SearchOffset);
+      if (std::string::npos == position)
+      {
+        this->UpdateSearchOffset(m_ContentDelimiter.size());
+        return false;
+      }
+
+      m_Callback(m_Buffer.substr(0, position));
+      m_Buffer.erase(0, position + m_ContentDelimiter.size());
+      m_SearchOffset = 0;
+      m_State = State::AfterDelimiter;
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+bool mitk::MultipartParser::SkipTo(const std::string &pattern, State nextState)
+{
+  auto position = m_Buffer.find(pattern, m_SearchOffset);
+  if (std::string::npos == position)
+  {
+    this->UpdateSearchOffset(pattern.size());
+    return false;
+  }
+
+  m_Buffer.erase(0, position + pattern.size());
+  m_SearchOffset = 0;
+  m_State = nextState;
+  return true;
+}
+
+void mitk::MultipartParser::UpdateSearchOffset(std::size_t patternSize)
+{
+  m_SearchOffset = m_Buffer.size() >= patternSize ? m_Buffer.size() - patternSize + 1 : 0;
+}
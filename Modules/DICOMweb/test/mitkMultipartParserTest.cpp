@@ -0,0 +1,156 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkMultipartParser.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+class mitkMultipartParserTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkMultipartParserTestSuite);
+  MITK_TEST(Feed_WholeBody_ReturnsAllParts);
+  MITK_TEST(Feed_ChunksOfAnySize_ReturnsAllParts);
+  MITK_TEST(Feed_PartWithoutHeaders_ReturnsContent);
+  MITK_TEST(Feed_TruncatedBody_IsNotFinished);
+  MITK_TEST(GetBoundary_QuotedBoundary_ReturnsBoundaryWithoutQuotes);
+  MITK_TEST(GetBoundary_TokenBoundary_ReturnsBoundary);
+  MITK_TEST(GetBoundary_NoMultipartType_ReturnsEmptyString);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::string m_Body;
+  std::vector<std::string> m_ExpectedParts;
+
+  /** Feeds the body in chunks of the given size and returns the received parts.*/
+  std::vector<std::string> Parse(const std::string &body, std::size_t chunkSize, bool &isFinished)
+  {
+    std::vector<std::string> parts;
+    mitk::MultipartParser parser("a:b c", [&parts](const std::string &content) { parts.push_back(content); });
+
+    for (std::size_t offset = 0; offset < body.size(); offset += chunkSize)
+      parser.Feed(body.data() + offset, std::min(chunkSize, body.size() - offset));
+
+    isFinished = parser.IsFinished();
+    return parts;
+  }
+
+public:
+  void setUp() override
+  {
+    // binary content including line breaks, null bytes and text similar to the delimiter
+    std::string firstPart("\x00\x01\r\n--a:b\r\n\xff", 12);
+    std::string secondPart("DICM--a:b c\r\n");
+
+    m_ExpectedParts = {firstPart, secondPart, std::string()};
+
+    m_Body = "preamble\r\n--a:b c\r\n";
+    m_Body += "Content-Type: application/dicom\r\nContent-Length: 12\r\n\r\n";
+    m_Body += firstPart;
+    m_Body += "\r\n--a:b c  \r\n";
+    m_Body += "Content-Type: application/dicom\r\n\r\n";
+    m_Body += secondPart;
+    m_Body += "\r\n--a:b c\r\n";
+    m_Body += "Content-Type: application/dicom\r\n\r\n";
+    m_Body += "\r\n--a:b c--\r\nepilogue";
+  }
+
+  void tearDown() override
+  {
+    m_Body.clear();
+    m_ExpectedParts.clear();
+  }
+
+  void Feed_WholeBody_ReturnsAllParts()
+  {
+    bool isFinished = false;
+    auto parts = this->Parse(m_Body, m_Body.size(), isFinished);
+
+    CPPUNIT_ASSERT(isFinished);
+    CPPUNIT_ASSERT(m_ExpectedParts == parts);
+  }
+
+  void Feed_ChunksOfAnySize_ReturnsAllParts()
+  {
+    // every delimiter and header is split across chunk boundaries at some chunk size
+    for (std::size_t chunkSize = 1; chunkSize < 40; ++chunkSize)
+    {
+      bool isFinished = false;
+      auto parts = this->Parse(m_Body, chunkSize, isFinished);
+
+      CPPUNIT_ASSERT_MESSAGE("Chunk size " + std::to_string(chunkSize), isFinished);
+      CPPUNIT_ASSERT_MESSAGE("Chunk size " + std::to_string(chunkSize), m_ExpectedParts == parts);
+    }
+  }
+
+  void Feed_PartWithoutHeaders_ReturnsContent()
+  {
+    bool isFinished = false;
+    auto parts = this->Parse("--a:b c\r\n\r\ncontent\r\n--a:b c--", 4, isFinished);
+
+    CPPUNIT_ASSERT(isFinished);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), parts.size());
+    CPPUNIT_ASSERT_EQUAL(std::string("content"), parts[0]);
+  }
+
+  void Feed_TruncatedBody_IsNotFinished()
+  {
+    // cut within the content of the second part
+    auto truncatedBody = m_Body.substr(0, m_Body.find("DICM") + 2);
+
+    for (std::size_t chunkSize : {std::size_t(1), std::size_t(7), truncatedBody.size()})
+    {
+      bool isFinished = true;
+      auto parts = this->Parse(truncatedBody, chunkSize, isFinished);
+
+      CPPUNIT_ASSERT(!isFinished);
+      CPPUNIT_ASSERT_EQUAL(std::size_t(1), parts.size());
+      CPPUNIT_ASSERT(m_ExpectedParts[0] == parts[0]);
+    }
+
+    // cut within the close delimiter
+    bool isFinished = true;
+    auto parts = this->Parse(m_Body.substr(0, m_Body.rfind("--a:b c--") + 8), 5, isFinished);
+
+    CPPUNIT_ASSERT(!isFinished);
+    CPPUNIT_ASSERT(m_ExpectedParts == parts);
+  }
+
+  void GetBoundary_QuotedBoundary_ReturnsBoundaryWithoutQuotes()
+  {
+    CPPUNIT_ASSERT_EQUAL(
+      std::string("a:b c"),
+      mitk::MultipartParser::GetBoundary("multipart/related; type=\"application/dicom\"; boundary=\"a:b c\""));
+    CPPUNIT_ASSERT_EQUAL(std::string("a;b"),
+                         mitk::MultipartParser::GetBoundary("Multipart/Related; Boundary=\"a;b\"; start=\"x\""));
+    CPPUNIT_ASSERT_EQUAL(std::string(), mitk::MultipartParser::GetBoundary("multipart/related; boundary=\"abc"));
+  }
+
+  void GetBoundary_TokenBoundary_ReturnsBoundary()
+  {
+    CPPUNIT_ASSERT_EQUAL(std::string("abc"),
+                         mitk::MultipartParser::GetBoundary("multipart/related; boundary=abc ; type=application/dicom"));
+    CPPUNIT_ASSERT_EQUAL(std::string("AbC"), mitk::MultipartParser::GetBoundary("multipart/related;boundary=AbC"));
+  }
+
+  void GetBoundary_NoMultipartType_ReturnsEmptyString()
+  {
+    CPPUNIT_ASSERT_EQUAL(std::string(), mitk::MultipartParser::GetBoundary("application/dicom; boundary=abc"));
+    CPPUNIT_ASSERT_EQUAL(std::string(), mitk::MultipartParser::GetBoundary("multipart/related"));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkMultipartParser)
@@ -0,0 +1,240 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKLOCKFREERINGBUFFER_H_HEADER_INCLUDED_
+#define MITKLOCKFREERINGBUFFER_H_HEADER_INCLUDED_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace mitk
+{
+  /**Documentation
+  * \brief Bounded, lock-free ring buffer for exactly one producer and one consumer thread.
+  *
+  * The producer thread calls Push(), the consumer thread calls Pop() or PopLatest().
+  * Neither of them ever blocks. The buffer is meant for latest-value feeds like tool
+  * poses: if it is full, Push() overwrites the oldest item and counts it as dropped, so
+  * a lagging consumer always gets the newest items. Both threads advance the read index
+  * by compare-and-swap.
+  *
+  * Each slot carries a sequence counter that is odd while the producer writes the slot
+  * and identifies the item index it holds otherwise. The items are stored as atomic
+  * words, so the consumer may read a slot the producer reclaims at the same time. It
+  * detects this by the changed sequence counter and discards the copy, hence it never
+  * returns a partially written item.
+  *
+  * The capacity is rounded up to the next power of two. Items are copied into
+  * preallocated slots word by word, hence T must be a trivially copyable value type.
+  *
+  * \ingroup IGT
+  */
+  template <typename T>
+  class LockFreeRingBuffer
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "LockFreeRingBuffer requires trivially copyable items");
+
+  public:
+    explicit LockFreeRingBuffer(std::size_t capacity = 64)
+      : m_Capacity(RoundUpToPowerOfTwo(capacity)),
+        m_Slots(new Slot[m_Capacity]),
+        m_Mask(m_Capacity - 1),
+        m_WriteIndex(0),
+        m_ReadIndex(0),
+        m_NumberOfDroppedItems(0)
+    {
+    }
+
+    LockFreeRingBuffer(const LockFreeRingBuffer&) = delete;
+    LockFreeRingBuffer& operator=(const LockFreeRingBuffer&) = delete;
+
+    /**
+    * \brief Appends a copy of item. Must only be called by the producer thread.
+    * \return false if the buffer was full and the oldest item was overwritten
+    */
+    bool Push(const T& item)
+    {
+      const auto writeIndex = m_WriteIndex.load(std::memory_order_relaxed);
+      auto readIndex = m_ReadIndex.load(std::memory_order_acquire);
+      bool overwritten = false;
+
+      // reclaim the slot of the oldest item unless the consumer took it in the meantime
+      while (writeIndex - readIndex > m_Mask)
+      {
+        if (m_ReadIndex.compare_exchange_weak(readIndex, readIndex + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+          m_NumberOfDroppedItems.fetch_add(1, std::memory_order_relaxed);
+          overwritten = true;
+          break;
+        }
+      }
+
+      this->WriteSlot(writeIndex, item);
+      m_WriteIndex.store(writeIndex + 1, std::memory_order_release);
+
+      return !overwritten;
+    }
+
+    /**
+    * \brief Removes the oldest item. Must only be called by the consumer thread.
+    * \return false if the buffer was empty
+    */
+    bool Pop(T& item)
+    {
+      auto readIndex = m_ReadIndex.load(std::memory_order_acquire);
+
+      while (readIndex != m_WriteIndex.load(std::memory_order_acquire))
+      {
+        T candidate;
+
+        if (!this->ReadSlot(readIndex, candidate))
+        {
+          // the producer reclaimed the slot, which advanced the read index
+          readIndex = m_ReadIndex.load(std::memory_order_acquire);
+          continue;
+        }
+
+        // fails if the producer reclaimed the slot after it was read
+        if (m_ReadIndex.compare_exchange_strong(readIndex, readIndex + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+          item = candidate;
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    /**
+    * \brief Removes all items and returns the newest one. Must only be called by the consumer thread.
+    * \return the number of removed items, i.e. 0 if the buffer was empty
+    */
+    std::size_t PopLatest(T& item)
+    {
+      auto readIndex = m_ReadIndex.load(std::memory_order_acquire);
+
+      while (true)
+      {
+        const auto writeIndex = m_WriteIndex.load(std::memory_order_acquire);
+
+        if (readIndex == writeIndex)
+          return 0;
+
+        T candidate;
+
+        if (!this->ReadSlot(writeIndex - 1, candidate))
+        {
+          readIndex = m_ReadIndex.load(std::memory_order_acquire);
+          continue;
+        }
+
+        // the producer can only overwrite the newest item after reclaiming all older slots,
+        // which changes the read index and lets the exchange fail
+        if (m_ReadIndex.compare_exchange_strong(readIndex, writeIndex, std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+          item = candidate;
+          return writeIndex - readIndex;
+        }
+      }
+    }
+
+    /** \brief Returns the number of items that are currently stored (approximate if called concurrently). */
+    std::size_t GetSize() const
+    {
+      return m_WriteIndex.load(std::memory_order_acquire) - m_ReadIndex.load(std::memory_order_acquire);
+    }
+
+    std::size_t GetCapacity() const { return m_Capacity; }
+
+    /** \brief Returns the number of items that were overwritten by Push() before the consumer took them. */
+    std::size_t GetNumberOfDroppedItems() const { return m_NumberOfDroppedItems.load(std::memory_order_relaxed); }
+
+  private:
+    static const std::size_t NumberOfWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    struct Slot
+    {
+      std::atomic<std::size_t> Sequence{0};
+      std::atomic<std::uint64_t> Words[NumberOfWords];
+    };
+
+    /** \brief Sequence counter of a slot that completely holds the item with the given index, never 0. */
+    static std::size_t GetSequence(std::size_t index) { return 2 * index + 2; }
+
+    void WriteSlot(std::size_t index, const T& item)
+    {
+      std::uint64_t words[NumberOfWords] = {};
+      std::memcpy(words, &item, sizeof(T));
+
+      auto& slot = m_Slots[index & m_Mask];
+      slot.Sequence.store(GetSequence(index) - 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+
+      for (std::size_t i = 0; i < NumberOfWords; ++i)
+        slot.Words[i].store(words[i], std::memory_order_relaxed);
+
+      slot.Sequence.store(GetSequence(index), std::memory_order_release);
+    }
+
+    /** \brief Copies the item with the given index, returns false if its slot does not hold it completely. */
+    bool ReadSlot(std::size_t index, T& item) const
+    {
+      const auto& slot = m_Slots[index & m_Mask];
+      const auto sequence = slot.Sequence.load(std::memory_order_acquire);
+
+      if (GetSequence(index) != sequence)
+        return false;
+
+      std::uint64_t words[NumberOfWords];
+
+      for (std::size_t i = 0; i < NumberOfWords; ++i)
+        words[i] = slot.Words[i].load(std::memory_order_relaxed);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+
+      if (sequence != slot.Sequence.load(std::memory_order_relaxed))
+        return false;
+
+      std::memcpy(&item, words, sizeof(T));
+      return true;
+    }
+
+    static std::size_t RoundUpToPowerOfTwo(std::size_t value)
+    {
+      std::size_t result = 2;
+
+      while (result < value)
+        result <<= 1;
+
+      return result;
+    }
+
+    // padding keeps the indices of producer and consumer on separate cache lines
+    static const std::size_t CacheLineSize = 64;
+
+    const std::size_t m_Capacity;
+    std::unique_ptr<Slot[]> m_Slots;
+    const std::size_t m_Mask;
+    char m_Padding0[CacheLineSize];
+    std::atomic<std::size_t> m_WriteIndex;
+    char m_Padding1[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_ReadIndex;
+    char m_Padding2[CacheLineSize - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_NumberOfDroppedItems;
+  };
+} // namespace mitk
+
+#endif /* MITKLOCKFREERINGBUFFER_H_HEADER_INCLUDED_ */
@@ -0,0 +1,131 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTrackingPipelineStatistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+void mitk::TrackingPipelineSample::SetNavigationData(const NavigationData* navigationData)
+{
+  const auto position = navigationData->GetPosition();
+  for (unsigned int i = 0; i < 3; ++i)
+    Position[i] = position[i];
+
+  const auto orientation = navigationData->GetOrientation();
+  Orientation[0] = orientation.x();
+  Orientation[1] = orientation.y();
+  Orientation[2] = orientation.z();
+  Orientation[3] = orientation.r();
+
+  const auto covErrorMatrix = navigationData->GetCovErrorMatrix();
+  for (unsigned int row = 0; row < 6; ++row)
+  {
+    for (unsigned int column = 0; column < 6; ++column)
+      CovErrorMatrix[6 * row + column] = covErrorMatrix(row, column);
+  }
+
+  DataValid = navigationData->IsDataValid();
+  HasPosition = navigationData->GetHasPosition();
+  HasOrientation = navigationData->GetHasOrientation();
+}
+
+void mitk::TrackingPipelineSample::GetNavigationData(NavigationData* navigationData) const
+{
+  NavigationData::PositionType position;
+  for (unsigned int i = 0; i < 3; ++i)
+    position[i] = Position[i];
+
+  NavigationData::CovarianceMatrixType covErrorMatrix;
+  for (unsigned int row = 0; row < 6; ++row)
+  {
+    for (unsigned int column = 0; column < 6; ++column)
+      covErrorMatrix(row, column) = CovErrorMatrix[6 * row + column];
+  }
+
+  navigationData->SetPosition(position);
+  navigationData->SetOrientation(NavigationData::OrientationType(Orientation[0], Orientation[1], Orientation[2], Orientation[3]));
+  navigationData->SetCovErrorMatrix(covErrorMatrix);
+  navigationData->SetHasPosition(HasPosition);
+  navigationData->SetHasOrientation(HasOrientation);
+  navigationData->SetDataValid(DataValid);
+}
+
+mitk::TrackingPipelineStatistics::TrackingPipelineStatistics()
+  : m_NumberOfSkippedSamples(0)
+{
+}
+
+void mitk::TrackingPipelineStatistics::AddSample(const TrackingPipelineSample& sample)
+{
+  const double deviceReadTime = sample.GetTimeStamp(TrackingPipelineStage::DeviceRead);
+
+  for (std::size_t stage = 0; stage < m_Accumulators.size(); ++stage)
+  {
+    const double latency = sample.TimeStamps[stage] - deviceReadTime;
+    auto& accumulator = m_Accumulators[stage];
+
+    // Welford's online algorithm
+    ++accumulator.NumberOfSamples;
+    const double delta = latency - accumulator.Mean;
+    accumulator.Mean += delta / accumulator.NumberOfSamples;
+    accumulator.SumOfSquaredDifferences += delta * (latency - accumulator.Mean);
+
+    if (1 == accumulator.NumberOfSamples)
+    {
+      accumulator.Minimum = latency;
+      accumulator.Maximum = latency;
+    }
+    else
+    {
+      accumulator.Minimum = std::min(accumulator.Minimum, latency);
+      accumulator.Maximum = std::max(accumulator.Maximum, latency);
+    }
+  }
+}
+
+mitk::TrackingPipelineStatistics::StageStatistics mitk::TrackingPipelineStatistics::GetStageStatistics(TrackingPipelineStage stage) const
+{
+  const auto& accumulator = m_Accumulators[static_cast<std::size_t>(stage)];
+
+  StageStatistics statistics;
+  statistics.NumberOfSamples = accumulator.NumberOfSamples;
+  statistics.MeanLatency = accumulator.Mean;
+  statistics.MinimumLatency = accumulator.Minimum;
+  statistics.MaximumLatency = accumulator.Maximum;
+
+  if (accumulator.NumberOfSamples > 1)
+    statistics.Jitter = std::sqrt(accumulator.SumOfSquaredDifferences / (accumulator.NumberOfSamples - 1));
+
+  return statistics;
+}
+
+mitk::TrackingPipelineStatistics::StageStatistics mitk::TrackingPipelineStatistics::GetEndToEndStatistics() const
+{
+  return this->GetStageStatistics(TrackingPipelineStage::Consumed);
+}
+
+void mitk::TrackingPipelineStatistics::AddSkippedSamples(unsigned long numberOfSamples)
+{
+  m_NumberOfSkippedSamples += numberOfSamples;
+}
+
+unsigned long mitk::TrackingPipelineStatistics::GetNumberOfSkippedSamples() const
+{
+  return m_NumberOfSkippedSamples;
+}
+
+void mitk::TrackingPipelineStatistics::Reset()
+{
+  m_Accumulators.fill(Accumulator());
+  m_NumberOfSkippedSamples = 0;
+}
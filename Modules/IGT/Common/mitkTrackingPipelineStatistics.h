@@ -0,0 +1,125 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKTRACKINGPIPELINESTATISTICS_H_HEADER_INCLUDED_
+#define MITKTRACKINGPIPELINESTATISTICS_H_HEADER_INCLUDED_
+
+#include <mitkNavigationData.h>
+#include "MitkIGTExports.h"
+
+#include <array>
+
+namespace mitk
+{
+  /**Documentation
+  * \brief Stages a tool pose passes on its way from the tracking device to the renderer.
+  *
+  * \ingroup IGT
+  */
+  enum class TrackingPipelineStage
+  {
+    DeviceRead = 0,  ///< the pose was read from the device (IGT time stamp of the source output)
+    SourceUpdated,   ///< the navigation data source was updated by the pipeline thread
+    FiltersApplied,  ///< all navigation data filters of the pipeline were applied
+    Published,       ///< the pose was published to the ring buffer of its tool
+    Consumed,        ///< the pose was taken from the ring buffer for rendering
+    NumberOfStages
+  };
+
+  /**Documentation
+  * \brief Tool pose as passed from the pipeline thread to the consumer.
+  *
+  * The pose is stored in plain arrays, hence the sample is trivially copyable and can be
+  * passed through a mitk::LockFreeRingBuffer. Use SetNavigationData() and
+  * GetNavigationData() to convert from and to mitk::NavigationData.
+  * All time stamps are given in milliseconds of the mitk::IGTTimeStamp time base.
+  *
+  * \ingroup IGT
+  */
+  struct MITKIGT_EXPORT TrackingPipelineSample
+  {
+    double Position[3] = {};
+    double Orientation[4] = {0.0, 0.0, 0.0, 1.0}; ///< quaternion in the order x, y, z, r
+    double CovErrorMatrix[36] = {};                ///< 6x6 matrix in row-major order
+    bool DataValid = false;
+    bool HasPosition = false;
+    bool HasOrientation = false;
+    unsigned long FrameNumber = 0;
+    std::array<double, static_cast<std::size_t>(TrackingPipelineStage::NumberOfStages)> TimeStamps = {};
+
+    double GetTimeStamp(TrackingPipelineStage stage) const { return TimeStamps[static_cast<std::size_t>(stage)]; }
+    void SetTimeStamp(TrackingPipelineStage stage, double timeStamp) { TimeStamps[static_cast<std::size_t>(stage)] = timeStamp; }
+
+    /** \brief Copies pose, covariance and validity flags of the navigation data. */
+    void SetNavigationData(const NavigationData* navigationData);
+
+    /** \brief Sets pose, covariance and validity flags of the navigation data. */
+    void GetNavigationData(NavigationData* navigationData) const;
+  };
+
+  /**Documentation
+  * \brief Accumulates latency and jitter of tool poses per pipeline stage.
+  *
+  * The latency of a stage is the time between reading a pose from the device and
+  * reaching the stage. Jitter is reported as the standard deviation of the latency.
+  * Mean and variance are accumulated incrementally, hence memory does not grow with the
+  * number of samples. The class is not thread-safe and is meant to be fed by the
+  * consumer thread only.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGT_EXPORT TrackingPipelineStatistics
+  {
+  public:
+    struct StageStatistics
+    {
+      unsigned long NumberOfSamples = 0;
+      double MeanLatency = 0.0;    ///< in ms
+      double Jitter = 0.0;         ///< standard deviation of the latency in ms
+      double MinimumLatency = 0.0; ///< in ms
+      double MaximumLatency = 0.0; ///< in ms
+    };
+
+    TrackingPipelineStatistics();
+
+    /** \brief Adds the latencies of all stages of a consumed sample. */
+    void AddSample(const TrackingPipelineSample& sample);
+
+    /** \brief Returns the latency statistics from reading the device to the given stage. */
+    StageStatistics GetStageStatistics(TrackingPipelineStage stage) const;
+
+    /** \brief Returns the latency statistics from reading the device to consuming the pose. */
+    StageStatistics GetEndToEndStatistics() const;
+
+    /** \brief Adds the number of poses that were overwritten by newer ones before being consumed. */
+    void AddSkippedSamples(unsigned long numberOfSamples);
+
+    unsigned long GetNumberOfSkippedSamples() const;
+
+    void Reset();
+
+  private:
+    struct Accumulator
+    {
+      unsigned long NumberOfSamples = 0;
+      double Mean = 0.0;
+      double SumOfSquaredDifferences = 0.0;
+      double Minimum = 0.0;
+      double Maximum = 0.0;
+    };
+
+    std::array<Accumulator, static_cast<std::size_t>(TrackingPipelineStage::NumberOfStages)> m_Accumulators;
+    unsigned long m_NumberOfSkippedSamples;
+  };
+} // namespace mitk
+
+#endif /* MITKTRACKINGPIPELINESTATISTICS_H_HEADER_INCLUDED_ */
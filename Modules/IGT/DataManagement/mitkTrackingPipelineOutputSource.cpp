@@ -0,0 +1,105 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTrackingPipelineOutputSource.h"
+#include "mitkIGTTimeStamp.h"
+
+#include <algorithm>
+
+mitk::TrackingPipelineOutputSource::TrackingPipelineOutputSource()
+  : m_PipelineThread(nullptr)
+{
+}
+
+mitk::TrackingPipelineOutputSource::~TrackingPipelineOutputSource()
+{
+}
+
+void mitk::TrackingPipelineOutputSource::SetPipelineThread(TrackingPipelineThread* pipelineThread)
+{
+  if (m_PipelineThread.GetPointer() == pipelineThread)
+    return;
+
+  m_PipelineThread = pipelineThread;
+  this->CreateOutputs();
+  this->ResetStatistics();
+  this->Modified();
+}
+
+void mitk::TrackingPipelineOutputSource::CreateOutputs()
+{
+  // if outputs are set then delete them
+  for (int numOP = this->GetNumberOfOutputs() - 1; numOP >= 0; numOP--)
+    this->RemoveOutput(numOP);
+
+  if (m_PipelineThread.IsNull())
+    return;
+
+  const auto numberOfTools = m_PipelineThread->GetNumberOfTools();
+  this->SetNumberOfIndexedOutputs(numberOfTools);
+
+  for (unsigned int idx = 0; idx < numberOfTools; ++idx)
+  {
+    DataObjectPointer newOutput = this->MakeOutput(idx);
+    static_cast<mitk::NavigationData*>(newOutput.GetPointer())->SetName(m_PipelineThread->GetToolName(idx));
+    this->SetNthOutput(idx, newOutput);
+  }
+}
+
+void mitk::TrackingPipelineOutputSource::UpdateOutputInformation()
+{
+  if (m_PipelineThread.IsNotNull() && m_PipelineThread->GetNumberOfTools() != this->GetNumberOfIndexedOutputs())
+    this->CreateOutputs();
+
+  this->Modified(); // make sure that we need to be updated
+  Superclass::UpdateOutputInformation();
+}
+
+void mitk::TrackingPipelineOutputSource::GenerateData()
+{
+  if (m_IsFrozen || m_PipelineThread.IsNull())
+    return;
+
+  const auto numberOfTools = std::min(m_PipelineThread->GetNumberOfTools(), static_cast<unsigned int>(this->GetNumberOfIndexedOutputs()));
+  TrackingPipelineSample sample;
+
+  for (unsigned int i = 0; i < numberOfTools; ++i)
+  {
+    const auto numberOfSamples = m_PipelineThread->PopLatestSample(i, sample);
+
+    if (0 == numberOfSamples)
+      continue; // no new pose, keep the last one
+
+    sample.SetTimeStamp(TrackingPipelineStage::Consumed, mitk::IGTTimeStamp::GetInstance()->GetElapsed());
+    m_Statistics.AddSample(sample);
+    m_Statistics.AddSkippedSamples(static_cast<unsigned long>(numberOfSamples - 1));
+
+    mitk::NavigationData* nd = this->GetOutput(i);
+    sample.GetNavigationData(nd);
+    nd->SetIGTTimeStamp(sample.GetTimeStamp(TrackingPipelineStage::DeviceRead));
+  }
+}
+
+const mitk::TrackingPipelineStatistics& mitk::TrackingPipelineOutputSource::GetStatistics() const
+{
+  return m_Statistics;
+}
+
+mitk::TrackingPipelineStatistics::StageStatistics mitk::TrackingPipelineOutputSource::GetEndToEndStatistics() const
+{
+  return m_Statistics.GetEndToEndStatistics();
+}
+
+void mitk::TrackingPipelineOutputSource::ResetStatistics()
+{
+  m_Statistics.Reset();
+}
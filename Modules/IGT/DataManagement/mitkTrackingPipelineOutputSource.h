@@ -0,0 +1,78 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKTRACKINGPIPELINEOUTPUTSOURCE_H_HEADER_INCLUDED_
+#define MITKTRACKINGPIPELINEOUTPUTSOURCE_H_HEADER_INCLUDED_
+
+#include <mitkNavigationDataSource.h>
+#include "mitkTrackingPipelineThread.h"
+#include "MitkIGTExports.h"
+
+namespace mitk {
+  /**Documentation
+  * \brief Provides the poses published by a mitk::TrackingPipelineThread as navigation data.
+  *
+  * This source decouples the render side of a navigation pipeline from the tracking side.
+  * Connect e.g. a mitk::NavigationDataObjectVisualizationFilter to it and update it from
+  * the GUI timer. Each update takes the newest pose of every tool from the wait-free ring
+  * buffers of the pipeline thread; older poses that were never rendered are skipped.
+  *
+  * The source also stamps the time a pose is consumed and accumulates the latency and
+  * jitter of all pipeline stages (see GetStatistics()). Only one thread may update this
+  * source.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGT_EXPORT TrackingPipelineOutputSource : public NavigationDataSource
+  {
+  public:
+    mitkClassMacro(TrackingPipelineOutputSource, NavigationDataSource);
+    itkFactorylessNewMacro(Self);
+
+    /**
+    * \brief Sets the pipeline thread whose poses are provided. Creates one output per tool.
+    * The thread has to be started before, because the tools are determined at Start().
+    */
+    void SetPipelineThread(TrackingPipelineThread* pipelineThread);
+    itkGetObjectMacro(PipelineThread, TrackingPipelineThread);
+
+    /** \brief Returns the latency statistics of all poses consumed so far. */
+    const TrackingPipelineStatistics& GetStatistics() const;
+
+    /** \brief Returns the latency statistics from reading the device to consuming the pose. */
+    TrackingPipelineStatistics::StageStatistics GetEndToEndStatistics() const;
+
+    void ResetStatistics();
+
+    /**
+    * \brief Used for pipeline update
+    */
+    void UpdateOutputInformation() override;
+
+  protected:
+    TrackingPipelineOutputSource();
+    ~TrackingPipelineOutputSource() override;
+
+    /**
+    * \brief Takes the newest pose of each tool from the pipeline thread.
+    * Outputs keep their last pose if no new one was published.
+    */
+    void GenerateData() override;
+
+    void CreateOutputs();
+
+    TrackingPipelineThread::Pointer m_PipelineThread;
+    TrackingPipelineStatistics m_Statistics;
+  };
+} // namespace mitk
+
+#endif /* MITKTRACKINGPIPELINEOUTPUTSOURCE_H_HEADER_INCLUDED_ */
@@ -0,0 +1,206 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkTrackingPipelineThread.h"
+#include "mitkIGTTimeStamp.h"
+
+#include <mitkExceptionMacro.h>
+
+#include <algorithm>
+#include <chrono>
+
+mitk::TrackingPipelineThread::TrackingPipelineThread()
+  : m_Source(nullptr),
+    m_UpdateRate(100.0),
+    m_RingBufferCapacity(64),
+    m_StopThread(false),
+    m_NumberOfUpdates(0)
+{
+}
+
+mitk::TrackingPipelineThread::~TrackingPipelineThread()
+{
+  this->Stop();
+}
+
+void mitk::TrackingPipelineThread::SetSource(NavigationDataSource* source)
+{
+  if (this->IsRunning())
+    mitkThrow() << "Cannot change the source while the pipeline thread is running.";
+
+  m_Source = source;
+  m_Filters.clear();
+  this->Modified();
+}
+
+void mitk::TrackingPipelineThread::AddFilter(NavigationDataToNavigationDataFilter* filter)
+{
+  if (this->IsRunning())
+    mitkThrow() << "Cannot add filters while the pipeline thread is running.";
+
+  if (m_Source.IsNull())
+    mitkThrow() << "A source has to be set before filters can be added.";
+
+  if (nullptr == filter)
+    mitkThrow() << "Filter must not be null.";
+
+  filter->ConnectTo(this->GetPipelineOutput());
+  m_Filters.push_back(filter);
+  this->Modified();
+}
+
+mitk::NavigationDataSource* mitk::TrackingPipelineThread::GetPipelineOutput() const
+{
+  if (!m_Filters.empty())
+    return m_Filters.back();
+
+  return m_Source;
+}
+
+void mitk::TrackingPipelineThread::Start()
+{
+  if (this->IsRunning())
+    return;
+
+  if (m_Source.IsNull())
+    mitkThrow() << "Cannot start the pipeline thread without a source.";
+
+  auto* output = this->GetPipelineOutput();
+  const auto numberOfTools = output->GetNumberOfIndexedOutputs();
+
+  m_RingBuffers.clear();
+  m_ToolNames.clear();
+
+  for (unsigned int i = 0; i < numberOfTools; ++i)
+  {
+    m_RingBuffers.push_back(std::make_unique<RingBuffer>(m_RingBufferCapacity));
+    m_ToolNames.push_back(output->GetOutput(i)->GetName());
+  }
+
+  m_NumberOfUpdates = 0;
+  m_StopThread = false;
+  m_Thread = std::thread(&TrackingPipelineThread::Run, this);
+}
+
+void mitk::TrackingPipelineThread::Stop()
+{
+  if (!m_Thread.joinable())
+    return;
+
+  m_StopThread = true;
+  m_Thread.join();
+}
+
+bool mitk::TrackingPipelineThread::IsRunning() const
+{
+  return m_Thread.joinable();
+}
+
+unsigned int mitk::TrackingPipelineThread::GetNumberOfTools() const
+{
+  return static_cast<unsigned int>(m_RingBuffers.size());
+}
+
+std::string mitk::TrackingPipelineThread::GetToolName(unsigned int toolIndex) const
+{
+  return toolIndex < m_ToolNames.size() ? m_ToolNames[toolIndex] : std::string();
+}
+
+std::size_t mitk::TrackingPipelineThread::PopLatestSample(unsigned int toolIndex, TrackingPipelineSample& sample)
+{
+  if (toolIndex >= m_RingBuffers.size())
+    return 0;
+
+  return m_RingBuffers[toolIndex]->PopLatest(sample);
+}
+
+std::size_t mitk::TrackingPipelineThread::GetNumberOfDroppedSamples() const
+{
+  std::size_t numberOfDroppedSamples = 0;
+
+  for (const auto& ringBuffer : m_RingBuffers)
+    numberOfDroppedSamples += ringBuffer->GetNumberOfDroppedItems();
+
+  return numberOfDroppedSamples;
+}
+
+unsigned long mitk::TrackingPipelineThread::GetNumberOfUpdates() const
+{
+  return m_NumberOfUpdates;
+}
+
+void mitk::TrackingPipelineThread::Run()
+{
+  using Clock = std::chrono::steady_clock;
+
+  const auto period = std::chrono::duration_cast<Clock::duration>(
+    std::chrono::duration<double>(1.0 / std::max(m_UpdateRate, 1.0)));
+
+  auto nextUpdate = Clock::now();
+
+  while (!m_StopThread)
+  {
+    try
+    {
+      this->UpdatePipeline();
+    }
+    catch (const std::exception& e)
+    {
+      MITK_ERROR << "Updating the tracking pipeline failed: " << e.what();
+    }
+
+    // fixed rate without drift; skip missed periods instead of catching up
+    nextUpdate += period;
+    const auto now = Clock::now();
+
+    if (nextUpdate < now)
+      nextUpdate = now;
+
+    std::this_thread::sleep_until(nextUpdate);
+  }
+}
+
+void mitk::TrackingPipelineThread::UpdatePipeline()
+{
+  auto* timeStamp = mitk::IGTTimeStamp::GetInstance();
+
+  m_Source->Update();
+  const double sourceUpdated = timeStamp->GetElapsed();
+
+  // update the filters stage by stage, each one only processes the new data of its predecessor
+  for (auto& filter : m_Filters)
+    filter->Update();
+
+  const double filtersApplied = timeStamp->GetElapsed();
+  const unsigned long frameNumber = ++m_NumberOfUpdates;
+
+  auto* output = this->GetPipelineOutput();
+  const auto numberOfTools = std::min<std::size_t>(m_RingBuffers.size(), output->GetNumberOfIndexedOutputs());
+
+  TrackingPipelineSample sample;
+  sample.FrameNumber = frameNumber;
+  sample.SetTimeStamp(TrackingPipelineStage::SourceUpdated, sourceUpdated);
+  sample.SetTimeStamp(TrackingPipelineStage::FiltersApplied, filtersApplied);
+
+  for (std::size_t i = 0; i < numberOfTools; ++i)
+  {
+    const auto* navigationData = output->GetOutput(static_cast<unsigned int>(i));
+
+    sample.SetNavigationData(navigationData);
+
+    // the IGT time stamp of the navigation data is set when the pose is read from the device
+    sample.SetTimeStamp(TrackingPipelineStage::DeviceRead, navigationData->GetIGTTimeStamp());
+    sample.SetTimeStamp(TrackingPipelineStage::Published, timeStamp->GetElapsed());
+
+    m_RingBuffers[i]->Push(sample);
+  }
+}
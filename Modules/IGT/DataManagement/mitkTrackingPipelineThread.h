@@ -0,0 +1,131 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKTRACKINGPIPELINETHREAD_H_HEADER_INCLUDED_
+#define MITKTRACKINGPIPELINETHREAD_H_HEADER_INCLUDED_
+
+#include <mitkNavigationDataSource.h>
+#include <mitkNavigationDataToNavigationDataFilter.h>
+#include "mitkLockFreeRingBuffer.h"
+#include "mitkTrackingPipelineStatistics.h"
+#include "MitkIGTExports.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace mitk {
+  /**Documentation
+  * \brief Runs a navigation data filter pipeline in a dedicated thread.
+  *
+  * The pipeline consists of a source (usually a mitk::TrackingDeviceSource) followed by an
+  * arbitrary number of mitk::NavigationDataToNavigationDataFilter objects, e.g. smoothing,
+  * reference transform and landmark transform filters. After Start() the thread updates
+  * the pipeline at the configured rate, independent of the GUI timer. The resulting tool
+  * poses are published to one wait-free single producer/single consumer ring buffer per
+  * tool. Consumers, usually a mitk::TrackingPipelineOutputSource that feeds the
+  * visualization, take the poses from these buffers without ever blocking the pipeline.
+  *
+  * Every published pose carries the time stamps of the pipeline stages it passed
+  * (see mitk::TrackingPipelineStage) for latency and jitter measurements.
+  *
+  * \warning While the thread is running, the pipeline is owned by the thread. Do not
+  * update the source or the filters from other threads, and do not modify the pipeline.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGT_EXPORT TrackingPipelineThread : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(TrackingPipelineThread, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /** \brief Ring buffer the poses of one tool are published to. */
+    using RingBuffer = LockFreeRingBuffer<TrackingPipelineSample>;
+
+    /**
+    * \brief Sets the source of the pipeline. Resets all filters.
+    * \warning Throws an mitk::Exception if the thread is running.
+    */
+    void SetSource(NavigationDataSource* source);
+    itkGetObjectMacro(Source, NavigationDataSource);
+
+    /**
+    * \brief Appends a filter to the pipeline and connects it to the previous stage.
+    * \warning Throws an mitk::Exception if the thread is running or no source was set.
+    */
+    void AddFilter(NavigationDataToNavigationDataFilter* filter);
+
+    /** \brief Returns the last stage of the pipeline, i.e. the last filter or the source. */
+    NavigationDataSource* GetPipelineOutput() const;
+
+    /** \brief Sets the update rate of the pipeline in Hz (default: 100 Hz). */
+    itkSetMacro(UpdateRate, double);
+    itkGetConstMacro(UpdateRate, double);
+
+    /** \brief Sets the capacity of the ring buffer of each tool (default: 64). Takes effect on the next Start(). */
+    itkSetMacro(RingBufferCapacity, unsigned int);
+    itkGetConstMacro(RingBufferCapacity, unsigned int);
+
+    /**
+    * \brief Starts the pipeline thread. The ring buffers are recreated for the current
+    * number of outputs of the pipeline. Does nothing if the thread is already running.
+    */
+    void Start();
+
+    /** \brief Stops the pipeline thread and waits for it to finish. */
+    void Stop();
+
+    bool IsRunning() const;
+
+    /** \brief Returns the number of tools, i.e. ring buffers. */
+    unsigned int GetNumberOfTools() const;
+
+    /** \brief Returns the name of the navigation data of the given tool. */
+    std::string GetToolName(unsigned int toolIndex) const;
+
+    /**
+    * \brief Takes the newest pose of the given tool. Must only be called by a single consumer thread.
+    * \return the number of poses taken from the buffer, i.e. 0 if no new pose was available
+    */
+    std::size_t PopLatestSample(unsigned int toolIndex, TrackingPipelineSample& sample);
+
+    /** \brief Returns the number of poses that were overwritten because the consumer lagged behind by more than the ring buffer capacity. */
+    std::size_t GetNumberOfDroppedSamples() const;
+
+    /** \brief Returns the number of pipeline updates since Start(). */
+    unsigned long GetNumberOfUpdates() const;
+
+  protected:
+    TrackingPipelineThread();
+    ~TrackingPipelineThread() override;
+
+    /** \brief Main loop of the pipeline thread. */
+    void Run();
+
+    /** \brief Updates all stages of the pipeline and publishes the resulting poses. */
+    void UpdatePipeline();
+
+    NavigationDataSource::Pointer m_Source;
+    std::vector<NavigationDataToNavigationDataFilter::Pointer> m_Filters;
+    std::vector<std::unique_ptr<RingBuffer>> m_RingBuffers;
+    std::vector<std::string> m_ToolNames;
+    double m_UpdateRate;
+    unsigned int m_RingBufferCapacity;
+    std::thread m_Thread;
+    std::atomic<bool> m_StopThread;
+    std::atomic<unsigned long> m_NumberOfUpdates;
+  };
+} // namespace mitk
+
+#endif /* MITKTRACKINGPIPELINETHREAD_H_HEADER_INCLUDED_ */
@@ -0,0 +1,296 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkNavigationDataBinaryReader.h"
+#include "mitkNavigationDataBinaryWriter.h"
+
+// include for exceptions
+#include "mitkIGTException.h"
+#include "mitkIGTIOException.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+  typedef mitk::NavigationDataBinaryWriter::FileFormat FileFormat;
+
+  template <typename T>
+  T ReadValue(const char* data)
+  {
+    // records are not aligned, hence memcpy instead of a cast
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+}
+
+mitk::NavigationDataBinaryReader::NavigationDataBinaryReader()
+  : m_MappedData(nullptr),
+    m_MappedSize(0),
+#ifdef _WIN32
+    m_FileHandle(INVALID_HANDLE_VALUE),
+    m_MappingHandle(nullptr),
+#else
+    m_FileDescriptor(-1),
+#endif
+    m_FrameSize(0),
+    m_FirstFrameOffset(0),
+    m_NumberOfFrames(0)
+{
+}
+
+mitk::NavigationDataBinaryReader::~NavigationDataBinaryReader()
+{
+  this->Close();
+}
+
+void mitk::NavigationDataBinaryReader::Open(const std::string& fileName)
+{
+  this->Close();
+
+#ifdef _WIN32
+  m_FileHandle = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  LARGE_INTEGER fileSize;
+  if (m_FileHandle == INVALID_HANDLE_VALUE || !GetFileSizeEx(m_FileHandle, &fileSize))
+  {
+    this->Close();
+    mitkThrowException(mitk::IGTIOException) << "Cannot open binary navigation data file " << fileName << ".";
+  }
+  m_MappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+
+  if (m_MappedSize > 0)
+  {
+    m_MappingHandle = CreateFileMappingA(m_FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_MappingHandle != nullptr)
+      m_MappedData = static_cast<const char*>(MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0));
+  }
+#else
+  m_FileDescriptor = ::open(fileName.c_str(), O_RDONLY);
+  struct stat fileStatus;
+  if (m_FileDescriptor < 0 || fstat(m_FileDescriptor, &fileStatus) != 0)
+  {
+    this->Close();
+    mitkThrowException(mitk::IGTIOException) << "Cannot open binary navigation data file " << fileName << ".";
+  }
+  m_MappedSize = static_cast<std::size_t>(fileStatus.st_size);
+
+  if (m_MappedSize > 0)
+  {
+    void* mappedData = mmap(nullptr, m_MappedSize, PROT_READ, MAP_SHARED, m_FileDescriptor, 0);
+    if (mappedData != MAP_FAILED)
+      m_MappedData = static_cast<const char*>(mappedData);
+  }
+#endif
+
+  if (m_MappedData == nullptr)
+  {
+    this->Close();
+    mitkThrowException(mitk::IGTIOException) << "Cannot map binary navigation data file " << fileName << " into memory.";
+  }
+
+  // read header
+  std::size_t offset = sizeof(FileFormat::Magic) + 2 * sizeof(uint32_t);
+  if (m_MappedSize < offset || 0 != std::memcmp(m_MappedData, FileFormat::Magic, sizeof(FileFormat::Magic)) ||
+      ReadValue<uint32_t>(m_MappedData + sizeof(FileFormat::Magic)) != FileFormat::Version)
+  {
+    this->Close();
+    mitkThrowException(mitk::IGTIOException) << fileName << " is no binary navigation data file of version " << FileFormat::Version << ".";
+  }
+
+  const auto numberOfTools = ReadValue<uint32_t>(m_MappedData + sizeof(FileFormat::Magic) + sizeof(uint32_t));
+  for (uint32_t i = 0; i < numberOfTools; ++i)
+  {
+    if (m_MappedSize < offset + sizeof(uint32_t))
+      break;
+    const auto nameLength = ReadValue<uint32_t>(m_MappedData + offset);
+    offset += sizeof(uint32_t);
+
+    if (m_MappedSize < offset + nameLength)
+      break;
+    m_ToolNames.emplace_back(m_MappedData + offset, nameLength);
+    offset += nameLength;
+  }
+
+  if (m_ToolNames.size() != numberOfTools)
+  {
+    this->Close();
+    mitkThrowException(mitk::IGTIOException) << "Header of binary navigation data file " << fileName << " is truncated.";
+  }
+
+  m_FirstFrameOffset = offset;
+  m_FrameSize = FileFormat::GetFrameSize(numberOfTools);
+  // a partially written frame at the end of the file is ignored
+  m_NumberOfFrames = static_cast<unsigned int>((m_MappedSize - m_FirstFrameOffset) / m_FrameSize);
+}
+
+void mitk::NavigationDataBinaryReader::Close()
+{
+#ifdef _WIN32
+  if (m_MappedData != nullptr)
+    UnmapViewOfFile(m_MappedData);
+  if (m_MappingHandle != nullptr)
+    CloseHandle(m_MappingHandle);
+  if (m_FileHandle != INVALID_HANDLE_VALUE)
+    CloseHandle(m_FileHandle);
+  m_MappingHandle = nullptr;
+  m_FileHandle = INVALID_HANDLE_VALUE;
+#else
+  if (m_MappedData != nullptr)
+    munmap(const_cast<char*>(m_MappedData), m_MappedSize);
+  if (m_FileDescriptor >= 0)
+    ::close(m_FileDescriptor);
+  m_FileDescriptor = -1;
+#endif
+
+  m_MappedData = nullptr;
+  m_MappedSize = 0;
+  m_ToolNames.clear();
+  m_FrameSize = 0;
+  m_FirstFrameOffset = 0;
+  m_NumberOfFrames = 0;
+}
+
+bool mitk::NavigationDataBinaryReader::IsOpen() const
+{
+  return m_MappedData != nullptr;
+}
+
+unsigned int mitk::NavigationDataBinaryReader::GetNumberOfTools() const
+{
+  return static_cast<unsigned int>(m_ToolNames.size());
+}
+
+std::string mitk::NavigationDataBinaryReader::GetToolName(unsigned int toolIndex) const
+{
+  if (toolIndex >= m_ToolNames.size())
+  {
+    mitkThrowException(mitk::IGTException) << "Tool index " << toolIndex << " is out of range.";
+  }
+  return m_ToolNames[toolIndex];
+}
+
+unsigned int mitk::NavigationDataBinaryReader::GetNumberOfFrames() const
+{
+  return m_NumberOfFrames;
+}
+
+mitk::NavigationDataBinaryReader::TimeStampType mitk::NavigationDataBinaryReader::GetTimeStamp(unsigned int frameIndex) const
+{
+  return ReadValue<double>(this->GetFrameData(frameIndex));
+}
+
+unsigned int mitk::NavigationDataBinaryReader::FindFrame(TimeStampType timeStamp) const
+{
+  if (m_NumberOfFrames == 0)
+  {
+    mitkThrowException(mitk::IGTException) << "Cannot search a time stamp in an empty recording.";
+  }
+
+  // binary search for the first frame with a greater time stamp
+  unsigned int first = 0;
+  unsigned int count = m_NumberOfFrames;
+  while (count > 0)
+  {
+    const unsigned int step = count / 2;
+    const unsigned int middle = first + step;
+    if (ReadValue<double>(m_MappedData + m_FirstFrameOffset + middle * m_FrameSize) <= timeStamp)
+    {
+      first = middle + 1;
+      count -= step + 1;
+    }
+    else
+    {
+      count = step;
+    }
+  }
+
+  return first > 0 ? first - 1 : 0;
+}
+
+mitk::NavigationData::Pointer mitk::NavigationDataBinaryReader::GetNavigationData(unsigned int frameIndex, unsigned int toolIndex) const
+{
+  if (toolIndex >= m_ToolNames.size())
+  {
+    mitkThrowException(mitk::IGTException) << "Tool index " << toolIndex << " is out of range.";
+  }
+
+  const char* record = this->GetFrameData(frameIndex) + FileFormat::FrameHeaderSize + toolIndex * FileFormat::ToolRecordSize;
+
+  const auto flags = ReadValue<uint32_t>(record);
+  record += 2 * sizeof(uint32_t);
+  const auto timeStamp = ReadValue<double>(record);
+  record += sizeof(double);
+
+  mitk::NavigationData::PositionType position;
+  for (unsigned int i = 0; i < 3; ++i, record += sizeof(double))
+    position[i] = ReadValue<double>(record);
+
+  double orientation[4];
+  for (unsigned int i = 0; i < 4; ++i, record += sizeof(double))
+    orientation[i] = ReadValue<double>(record);
+
+  mitk::NavigationData::Pointer navigationData = mitk::NavigationData::New();
+  navigationData->SetName(m_ToolNames[toolIndex].c_str());
+  navigationData->SetIGTTimeStamp(timeStamp);
+  navigationData->SetPosition(position);
+  navigationData->SetOrientation(mitk::NavigationData::OrientationType(orientation[0], orientation[1], orientation[2], orientation[3]));
+  navigationData->SetDataValid((flags & FileFormat::DataValid) != 0);
+  navigationData->SetHasPosition((flags & FileFormat::HasPosition) != 0);
+  navigationData->SetHasOrientation((flags & FileFormat::HasOrientation) != 0);
+  return navigationData;
+}
+
+std::vector<mitk::NavigationData::Pointer> mitk::NavigationDataBinaryReader::GetFrame(unsigned int frameIndex) const
+{
+  std::vector<mitk::NavigationData::Pointer> navigationDatas;
+  navigationDatas.reserve(m_ToolNames.size());
+
+  for (unsigned int toolIndex = 0; toolIndex < m_ToolNames.size(); ++toolIndex)
+    navigationDatas.push_back(this->GetNavigationData(frameIndex, toolIndex));
+
+  return navigationDatas;
+}
+
+mitk::NavigationDataSet::Pointer mitk::NavigationDataBinaryReader::ReadNavigationDataSet(unsigned int firstFrame, unsigned int numberOfFrames) const
+{
+  mitk::NavigationDataSet::Pointer navigationDataSet = mitk::NavigationDataSet::New(this->GetNumberOfTools());
+
+  const unsigned int endFrame = firstFrame + std::min(numberOfFrames, m_NumberOfFrames - std::min(firstFrame, m_NumberOfFrames));
+  for (unsigned int frameIndex = firstFrame; frameIndex < endFrame; ++frameIndex)
+    navigationDataSet->AddNavigationDatas(this->GetFrame(frameIndex));
+
+  return navigationDataSet;
+}
+
+const char* mitk::NavigationDataBinaryReader::GetFrameData(unsigned int frameIndex) const
+{
+  if (frameIndex >= m_NumberOfFrames)
+  {
+    mitkThrowException(mitk::IGTException) << "Frame index " << frameIndex << " is out of range.";
+  }
+  return m_MappedData + m_FirstFrameOffset + static_cast<std::size_t>(frameIndex) * m_FrameSize;
+}
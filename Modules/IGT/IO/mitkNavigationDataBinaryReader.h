@@ -0,0 +1,120 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKNavigationDataBinaryReader_H_HEADER_INCLUDED_
+#define MITKNavigationDataBinaryReader_H_HEADER_INCLUDED_
+
+#include <MitkIGTExports.h>
+#include <mitkCommon.h>
+#include <mitkNavigationData.h>
+#include <mitkNavigationDataSet.h>
+
+#include <itkObject.h>
+
+#include <string>
+#include <vector>
+
+namespace mitk
+{
+  /**Documentation
+  * \brief Provides random access to files written by mitk::NavigationDataBinaryWriter.
+  *
+  * The file is memory mapped, so opening a recording does not parse it and only the
+  * accessed frames are paged in. FindFrame() seeks to a time stamp in O(log n), which
+  * requires the frame time stamps to be ascending as it is the case for recordings
+  * with IGT time stamps.
+  *
+  * Frames which are appended after Open() was called are not visible until the file
+  * is opened again.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGT_EXPORT NavigationDataBinaryReader : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(NavigationDataBinaryReader, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    typedef mitk::NavigationData::TimeStampType TimeStampType;
+
+    /**
+    * \brief Maps the file into memory and reads the header.
+    * @throw mitk::IGTIOException If the file cannot be mapped or is no binary navigation data file.
+    */
+    void Open(const std::string& fileName);
+
+    void Close();
+
+    bool IsOpen() const;
+
+    unsigned int GetNumberOfTools() const;
+
+    std::string GetToolName(unsigned int toolIndex) const;
+
+    unsigned int GetNumberOfFrames() const;
+
+    /**
+    * \brief Returns the time stamp of the given frame.
+    * @throw mitk::IGTException If the frame index is out of range.
+    */
+    TimeStampType GetTimeStamp(unsigned int frameIndex) const;
+
+    /**
+    * \brief Returns the index of the last frame with a time stamp less or equal to the given one.
+    * If the time stamp lies before the first frame, 0 is returned.
+    * @throw mitk::IGTException If the file contains no frames.
+    */
+    unsigned int FindFrame(TimeStampType timeStamp) const;
+
+    /**
+    * \brief Creates the NavigationData of one tool in the given frame.
+    * @throw mitk::IGTException If an index is out of range.
+    */
+    mitk::NavigationData::Pointer GetNavigationData(unsigned int frameIndex, unsigned int toolIndex) const;
+
+    /**
+    * \brief Creates the NavigationDatas of all tools in the given frame.
+    * @throw mitk::IGTException If the frame index is out of range.
+    */
+    std::vector<mitk::NavigationData::Pointer> GetFrame(unsigned int frameIndex) const;
+
+    /**
+    * \brief Copies a range of frames into a NavigationDataSet, e.g. to play a part of a long recording
+    * with mitk::NavigationDataPlayer.
+    *
+    * @param numberOfFrames Number of frames to copy, the range is clipped at the end of the file.
+    */
+    mitk::NavigationDataSet::Pointer ReadNavigationDataSet(unsigned int firstFrame, unsigned int numberOfFrames) const;
+
+  protected:
+    NavigationDataBinaryReader();
+    ~NavigationDataBinaryReader() override;
+
+    const char* GetFrameData(unsigned int frameIndex) const;
+
+    const char* m_MappedData;
+    std::size_t m_MappedSize;
+#ifdef _WIN32
+    void* m_FileHandle;
+    void* m_MappingHandle;
+#else
+    int m_FileDescriptor;
+#endif
+
+    std::vector<std::string> m_ToolNames;
+    std::size_t m_FrameSize;
+    std::size_t m_FirstFrameOffset;
+    unsigned int m_NumberOfFrames;
+  };
+} // namespace mitk
+
+#endif /* MITKNavigationDataBinaryReader_H_HEADER_INCLUDED_ */
@@ -0,0 +1,254 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkNavigationDataBinaryWriter.h"
+
+// include for exceptions
+#include "mitkIGTException.h"
+#include "mitkIGTIOException.h"
+
+#include <cstring>
+
+const char mitk::NavigationDataBinaryWriter::FileFormat::Magic[8] = { 'M', 'I', 'T', 'K', 'N', 'D', 'B', 'N' };
+const uint32_t mitk::NavigationDataBinaryWriter::FileFormat::Version;
+const std::size_t mitk::NavigationDataBinaryWriter::FileFormat::FrameHeaderSize;
+const std::size_t mitk::NavigationDataBinaryWriter::FileFormat::ToolRecordSize;
+
+namespace
+{
+  template <typename T>
+  void AppendValue(std::vector<char>& buffer, const T& value)
+  {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+  }
+
+  template <typename T>
+  bool ReadValue(std::istream& stream, T& value)
+  {
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return stream.good();
+  }
+}
+
+mitk::NavigationDataBinaryWriter::NavigationDataBinaryWriter()
+  : m_NumberOfTools(0),
+    m_FrameSize(0),
+    m_StopThread(false),
+    m_NumberOfFrames(0)
+{
+}
+
+mitk::NavigationDataBinaryWriter::~NavigationDataBinaryWriter()
+{
+  this->Close();
+}
+
+void mitk::NavigationDataBinaryWriter::Open(const std::string& fileName, const std::vector<std::string>& toolNames, bool append)
+{
+  if (this->IsOpen())
+  {
+    mitkThrowException(mitk::IGTIOException) << "Binary navigation data file is already open.";
+  }
+
+  m_NumberOfTools = toolNames.size();
+  m_FrameSize = FileFormat::GetFrameSize(m_NumberOfTools);
+  m_NumberOfFrames = 0;
+
+  std::streamoff endOfFrames = 0;
+  unsigned int numberOfFrames = 0;
+  if (append && this->CheckExistingRecording(fileName, toolNames, endOfFrames, numberOfFrames))
+  {
+    m_File.open(fileName, std::ios::in | std::ios::out | std::ios::binary);
+    if (!m_File.is_open())
+    {
+      mitkThrowException(mitk::IGTIOException) << "Cannot open " << fileName << " for appending navigation data.";
+    }
+
+    // a partially written frame at the end is overwritten by the next frame
+    m_File.seekp(endOfFrames);
+    m_NumberOfFrames = numberOfFrames;
+  }
+  else
+  {
+    m_File.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_File.is_open())
+    {
+      mitkThrowException(mitk::IGTIOException) << "Cannot open " << fileName << " for writing navigation data.";
+    }
+    this->WriteHeader(toolNames);
+  }
+
+  m_PendingBuffer.clear();
+  m_StopThread = false;
+  m_Thread = std::thread(&NavigationDataBinaryWriter::Run, this);
+}
+
+void mitk::NavigationDataBinaryWriter::Close()
+{
+  if (!m_Thread.joinable())
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_StopThread = true;
+  }
+  m_FrameAdded.notify_one();
+  m_Thread.join();
+
+  m_File.close();
+}
+
+bool mitk::NavigationDataBinaryWriter::IsOpen() const
+{
+  return m_Thread.joinable();
+}
+
+void mitk::NavigationDataBinaryWriter::Write(const std::vector<const mitk::NavigationData*>& navigationDatas)
+{
+  this->WriteFrame(navigationDatas, nullptr);
+}
+
+void mitk::NavigationDataBinaryWriter::Write(const std::vector<const mitk::NavigationData*>& navigationDatas, TimeStampType timeStamp)
+{
+  this->WriteFrame(navigationDatas, &timeStamp);
+}
+
+unsigned int mitk::NavigationDataBinaryWriter::GetNumberOfFrames() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfFrames;
+}
+
+void mitk::NavigationDataBinaryWriter::WriteFrame(const std::vector<const mitk::NavigationData*>& navigationDatas, const TimeStampType* timeStamp)
+{
+  if (!this->IsOpen())
+  {
+    mitkThrowException(mitk::IGTException) << "Binary navigation data file has to be opened before writing.";
+  }
+
+  if (navigationDatas.size() != m_NumberOfTools)
+  {
+    mitkThrowException(mitk::IGTException) << "Number of navigation datas (" << navigationDatas.size()
+      << ") does not match the number of tools (" << m_NumberOfTools << ") of the recording.";
+  }
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  const TimeStampType frameTimeStamp = timeStamp ? *timeStamp
+    : (m_NumberOfTools > 0 ? navigationDatas[0]->GetIGTTimeStamp() : 0.0);
+  AppendValue(m_PendingBuffer, frameTimeStamp);
+
+  for (const mitk::NavigationData* nd : navigationDatas)
+  {
+    uint32_t flags = 0;
+    if (nd->IsDataValid())
+      flags |= FileFormat::DataValid;
+    if (nd->GetHasPosition())
+      flags |= FileFormat::HasPosition;
+    if (nd->GetHasOrientation())
+      flags |= FileFormat::HasOrientation;
+
+    AppendValue(m_PendingBuffer, flags);
+    AppendValue(m_PendingBuffer, uint32_t(0));
+    AppendValue(m_PendingBuffer, timeStamp ? *timeStamp : nd->GetIGTTimeStamp());
+
+    const mitk::NavigationData::PositionType position = nd->GetPosition();
+    for (unsigned int i = 0; i < 3; ++i)
+      AppendValue(m_PendingBuffer, static_cast<double>(position[i]));
+
+    const mitk::NavigationData::OrientationType orientation = nd->GetOrientation();
+    for (unsigned int i = 0; i < 4; ++i)
+      AppendValue(m_PendingBuffer, static_cast<double>(orientation[i]));
+  }
+
+  ++m_NumberOfFrames;
+  m_FrameAdded.notify_one();
+}
+
+bool mitk::NavigationDataBinaryWriter::CheckExistingRecording(const std::string& fileName, const std::vector<std::string>& toolNames,
+                                                              std::streamoff& endOfFrames, unsigned int& numberOfFrames) const
+{
+  std::ifstream file(fileName, std::ios::binary);
+  if (!file.is_open())
+    return false;
+
+  char magic[8];
+  uint32_t version = 0, numberOfTools = 0;
+  file.read(magic, sizeof(magic));
+  if (!file || 0 != std::memcmp(magic, FileFormat::Magic, sizeof(magic)) ||
+      !ReadValue(file, version) || version != FileFormat::Version ||
+      !ReadValue(file, numberOfTools) || numberOfTools != toolNames.size())
+  {
+    return false;
+  }
+
+  for (const auto& toolName : toolNames)
+  {
+    uint32_t nameLength = 0;
+    if (!ReadValue(file, nameLength) || nameLength != toolName.size())
+      return false;
+
+    std::string name(nameLength, '\0');
+    if (nameLength > 0 && !file.read(&name[0], nameLength))
+      return false;
+    if (name != toolName)
+      return false;
+  }
+
+  const std::streamoff endOfHeader = file.tellg();
+  file.seekg(0, std::ios::end);
+  const std::streamoff fileSize = file.tellg();
+
+  numberOfFrames = static_cast<unsigned int>((fileSize - endOfHeader) / static_cast<std::streamoff>(m_FrameSize));
+  endOfFrames = endOfHeader + static_cast<std::streamoff>(numberOfFrames * m_FrameSize);
+  return true;
+}
+
+void mitk::NavigationDataBinaryWriter::WriteHeader(const std::vector<std::string>& toolNames)
+{
+  m_File.write(FileFormat::Magic, sizeof(FileFormat::Magic));
+  m_File.write(reinterpret_cast<const char*>(&FileFormat::Version), sizeof(FileFormat::Version));
+
+  const auto numberOfTools = static_cast<uint32_t>(toolNames.size());
+  m_File.write(reinterpret_cast<const char*>(&numberOfTools), sizeof(numberOfTools));
+
+  for (const auto& toolName : toolNames)
+  {
+    const auto nameLength = static_cast<uint32_t>(toolName.size());
+    m_File.write(reinterpret_cast<const char*>(&nameLength), sizeof(nameLength));
+    m_File.write(toolName.data(), nameLength);
+  }
+  m_File.flush();
+}
+
+void mitk::NavigationDataBinaryWriter::Run()
+{
+  std::vector<char> buffer;
+
+  while (true)
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_FrameAdded.wait(lock, [this]() { return m_StopThread || !m_PendingBuffer.empty(); });
+
+    if (m_PendingBuffer.empty())
+      return; // stopped and all frames are written
+
+    // take all pending frames at once, the producer continues with the (cleared) buffer of the last iteration
+    buffer.swap(m_PendingBuffer);
+    m_PendingBuffer.clear();
+    lock.unlock();
+
+    m_File.write(buffer.data(), buffer.size());
+    m_File.flush();
+  }
+}
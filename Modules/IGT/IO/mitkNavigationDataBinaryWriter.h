@@ -0,0 +1,144 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKNavigationDataBinaryWriter_H_HEADER_INCLUDED_
+#define MITKNavigationDataBinaryWriter_H_HEADER_INCLUDED_
+
+#include <MitkIGTExports.h>
+#include <mitkCommon.h>
+#include <mitkNavigationData.h>
+
+#include <itkObject.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mitk
+{
+  /**Documentation
+  * \brief Streams NavigationData to a compact binary file on a background thread.
+  *
+  * The file starts with a header containing the tool names, followed by one fixed size
+  * record per frame. Because all records have the same size, the frame count and the
+  * position of every frame follow from the file size, so no separate index is needed:
+  * mitk::NavigationDataBinaryReader can seek to a time stamp by a binary search over the
+  * memory mapped records. A frame that was only partially written (e.g. after a crash)
+  * is ignored by the reader and overwritten when the file is appended to.
+  *
+  * Write() only serializes the data into a buffer, the file access is done by the worker thread.
+  * Data is written in the byte order of the recording machine.
+  *
+  * \ingroup IGT
+  */
+  class MITKIGT_EXPORT NavigationDataBinaryWriter : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(NavigationDataBinaryWriter, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    typedef mitk::NavigationData::TimeStampType TimeStampType;
+
+    /**
+    * \brief Opens the file and starts the worker thread.
+    *
+    * @param append If true and the file is an existing recording with the same tools, new frames are appended.
+    *               Otherwise the file is overwritten.
+    * @throw mitk::IGTIOException If the file cannot be opened or already is open.
+    */
+    void Open(const std::string& fileName, const std::vector<std::string>& toolNames, bool append = false);
+
+    /**
+    * \brief Writes all pending frames, stops the worker thread and closes the file.
+    */
+    void Close();
+
+    bool IsOpen() const;
+
+    /**
+    * \brief Adds a frame with one NavigationData per tool, using their own time stamps.
+    * @throw mitk::IGTException If the number of NavigationDatas does not match the number of tools.
+    */
+    void Write(const std::vector<const mitk::NavigationData*>& navigationDatas);
+
+    /**
+    * \brief Adds a frame with one NavigationData per tool, all tools get the given time stamp.
+    * @throw mitk::IGTException If the number of NavigationDatas does not match the number of tools.
+    */
+    void Write(const std::vector<const mitk::NavigationData*>& navigationDatas, TimeStampType timeStamp);
+
+    /**
+    * \brief Returns the number of frames in the file, including the frames which are pending.
+    */
+    unsigned int GetNumberOfFrames() const;
+
+    /** Constants of the file format shared with mitk::NavigationDataBinaryReader. */
+    struct FileFormat
+    {
+      static const char Magic[8];
+      static const uint32_t Version = 1;
+      static const std::size_t FrameHeaderSize = sizeof(double); // time stamp of the first tool
+      static const std::size_t ToolRecordSize = 2 * sizeof(uint32_t) + 8 * sizeof(double); // flags, reserved, time stamp, position, orientation
+
+      enum ToolFlags
+      {
+        DataValid = 1,
+        HasPosition = 2,
+        HasOrientation = 4
+      };
+
+      static std::size_t GetFrameSize(std::size_t numberOfTools) { return FrameHeaderSize + numberOfTools * ToolRecordSize; }
+    };
+
+  protected:
+    NavigationDataBinaryWriter();
+    ~NavigationDataBinaryWriter() override;
+
+    /**
+    * \brief Appends the serialized frame to the pending buffer.
+    */
+    void WriteFrame(const std::vector<const mitk::NavigationData*>& navigationDatas, const TimeStampType* timeStamp);
+
+    /**
+    * \brief Checks whether the file is an existing recording of the given tools.
+    *
+    * @param endOfFrames Returns the end of the last complete frame.
+    * @param numberOfFrames Returns the number of complete frames.
+    */
+    bool CheckExistingRecording(const std::string& fileName, const std::vector<std::string>& toolNames,
+                                std::streamoff& endOfFrames, unsigned int& numberOfFrames) const;
+
+    void WriteHeader(const std::vector<std::string>& toolNames);
+
+    /**
+    * \brief Writes the pending buffer to the file until Close() is called.
+    */
+    void Run();
+
+    std::fstream m_File;
+    std::thread m_Thread;
+    std::size_t m_NumberOfTools;
+    std::size_t m_FrameSize;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_FrameAdded;
+    std::vector<char> m_PendingBuffer; ///< serialized frames which are not written yet, swapped with the buffer of the worker
+    bool m_StopThread;
+    unsigned int m_NumberOfFrames;
+  };
+} // namespace mitk
+
+#endif /* MITKNavigationDataBinaryWriter_H_HEADER_INCLUDED_ */
@@ -27,6 +27,8 @@ mitk::NavigationDataRecorder::NavigationDataRecorder()
 
 mitk::NavigationDataRecorder::~NavigationDataRecorder()
 {
+  if (m_BinaryWriter.IsNotNull())
+    m_BinaryWriter->Close();
   //mitk::IGTTimeStamp::GetInstance()->Stop(this); //commented out because of bug 18952
 }
 
@@ -38,6 +40,10 @@ void mitk::NavigationDataRecorder::GenerateData()
   //This vector will hold the NavigationDatas that are copied from the inputs
   std::vector< mitk::NavigationData::Pointer > clonedDatas;
 
+  // If streaming to a file, the writer serializes the inputs directly and no clones are needed
+  const bool recordToFile = m_BinaryWriter.IsNotNull() && m_BinaryWriter->IsOpen();
+  std::vector< const mitk::NavigationData* > recordedDatas;
+
   bool atLeastOneInputIsInvalid = false;
 
   // For each input
@@ -54,6 +60,12 @@ void mitk::NavigationDataRecorder::GenerateData()
        atLeastOneInputIsInvalid = true;
     }
 
+    if (recordToFile)
+    {
+      recordedDatas.push_back(this->GetInput(index));
+      continue;
+    }
+
     // Clone a Navigation Data
     mitk::NavigationData::Pointer clone = mitk::NavigationData::New();
     clone->Graft(this->GetInput(index));
@@ -67,13 +79,22 @@ void mitk::NavigationDataRecorder::GenerateData()
   }
 
   // if limitation is set and has been reached, stop recording
-  if ((m_RecordCountLimit > 0) && (m_NavigationDataSet->Size() >= static_cast<unsigned int>(m_RecordCountLimit)))
+  if ((m_RecordCountLimit > 0) && (this->GetNumberOfRecordedSteps() >= m_RecordCountLimit))
     m_Recording = false;
   // We can skip the rest of the method, if recording is deactivated
   if (!m_Recording) return;
   // We can skip the rest of the method, if we read only valid data
   if (m_RecordOnlyValidData && atLeastOneInputIsInvalid) return;
 
+  if (recordToFile)
+  {
+    if (m_StandardizeTime)
+      m_BinaryWriter->Write(recordedDatas, mitk::IGTTimeStamp::GetInstance()->GetElapsed(this));
+    else
+      m_BinaryWriter->Write(recordedDatas);
+    return;
+  }
+
   // Add data to set
   m_NavigationDataSet->AddNavigationDatas(clonedDatas);
 }
@@ -94,6 +115,24 @@ void mitk::NavigationDataRecorder::StartRecording()
 
   if (m_NavigationDataSet.IsNull())
     m_NavigationDataSet = mitk::NavigationDataSet::New(GetNumberOfIndexedInputs());
+
+  if (!m_OutputFileName.empty() && (m_BinaryWriter.IsNull() || !m_BinaryWriter->IsOpen()))
+  {
+    std::vector<std::string> toolNames;
+    for (unsigned int index = 0; index < this->GetNumberOfIndexedInputs(); ++index)
+      toolNames.push_back(this->GetInput(index)->GetName());
+
+    m_BinaryWriter = mitk::NavigationDataBinaryWriter::New();
+    try
+    {
+      m_BinaryWriter->Open(m_OutputFileName, toolNames);
+    }
+    catch (...)
+    {
+      m_Recording = false;
+      throw;
+    }
+  }
 }
 
 void mitk::NavigationDataRecorder::StopRecording()
@@ -110,6 +149,12 @@ void mitk::NavigationDataRecorder::ResetRecording()
 {
   m_NavigationDataSet = mitk::NavigationDataSet::New(GetNumberOfIndexedInputs());
 
+  if (m_BinaryWriter.IsNotNull())
+  {
+    m_BinaryWriter->Close();
+    m_BinaryWriter = nullptr;
+  }
+
   if (m_Recording)
   {
     mitk::IGTTimeStamp::GetInstance()->Stop(this);
@@ -119,5 +164,8 @@ void mitk::NavigationDataRecorder::ResetRecording()
 
 int mitk::NavigationDataRecorder::GetNumberOfRecordedSteps()
 {
+  if (m_BinaryWriter.IsNotNull())
+    return m_BinaryWriter->GetNumberOfFrames();
+
   return m_NavigationDataSet->Size();
 }
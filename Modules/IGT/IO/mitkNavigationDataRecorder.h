@@ -16,6 +16,7 @@ found in the LICENSE file.
 #include "mitkNavigationDataToNavigationDataFilter.h"
 #include "mitkNavigationData.h"
 #include "mitkNavigationDataSet.h"
+#include "mitkNavigationDataBinaryWriter.h"
 
 namespace mitk
 {
@@ -27,6 +28,10 @@ namespace mitk
   * With StopRecording() the stream is stopped, but can be resumed anytime.
   * To start recording to a new NavigationDataSet, call ResetRecording();
   *
+  * For long recordings an output file can be set with SetOutputFileName() before StartRecording().
+  * The data is then streamed to this file by a mitk::NavigationDataBinaryWriter instead of being
+  * kept in the NavigationDataSet. The file can be read with mitk::NavigationDataBinaryReader.
+  *
   * \warning Do not add inputs while the recorder ist recording. The recorder can't handle that and will cause a nullpointer exception.
   * \ingroup IGT
   */
@@ -79,7 +84,15 @@ namespace mitk
     itkGetMacro(RecordOnlyValidData, bool);
 
     /**
-    * \brief Starts recording NavigationData into the NavigationDataSet
+    * \brief Sets a binary file the data is streamed to instead of the NavigationDataSet. An empty name (default)
+    * records to the NavigationDataSet. A new name takes effect on the first StartRecording() after ResetRecording().
+    */
+    itkSetStringMacro(OutputFileName);
+    itkGetStringMacro(OutputFileName);
+
+    /**
+    * \brief Starts recording NavigationData into the NavigationDataSet or the output file
+    * @throw mitk::IGTIOException If the output file cannot be opened.
     */
     virtual void StartRecording();
 
@@ -95,6 +108,7 @@ namespace mitk
     * \brief Resets the Datasets and the timestamp, so a new recording can happen.
     *
     * Do not forget to save the old Dataset, it will be lost after calling this function.
+    * If the data is streamed to an output file, the file is closed. The next StartRecording() overwrites it.
     */
     virtual void ResetRecording();
 
@@ -125,6 +139,10 @@ namespace mitk
     int m_RecordCountLimit; ///< limits the number of frames, recording will be stopped if the limit is reached. -1 disables the limit
 
     bool m_RecordOnlyValidData; ///< indicates whether only valid data is recorded
+
+    std::string m_OutputFileName; ///< binary file the data is streamed to, the NavigationDataSet is used if empty
+
+    mitk::NavigationDataBinaryWriter::Pointer m_BinaryWriter; ///< writes to m_OutputFileName while recording to a file
   };
 }
 #endif // #define _MITK_POINT_SET_SOURCE_H
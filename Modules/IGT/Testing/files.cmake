@@ -18,6 +18,8 @@ set(MODULE_TESTS
    mitkClaronInterfaceTest.cpp
    mitkClaronToolTest.cpp
    mitkClaronTrackingDeviceTest.cpp
+   mitkLancetVegaFrameBufferTest.cpp
+   mitkNavigationDataBinaryReaderWriterTest.cpp
    mitkNavigationDataDisplacementFilterTest.cpp
    mitkNavigationDataLandmarkTransformFilterTest.cpp
    mitkNavigationDataObjectVisualizationFilterTest.cpp
@@ -41,6 +43,7 @@ set(MODULE_TESTS
    mitkTrackingVolumeGeneratorTest.cpp
    mitkTrackingDeviceTest.cpp
    mitkTrackingToolTest.cpp
+   mitkTrackingPipelineThreadTest.cpp
    mitkVirtualTrackingDeviceTest.cpp
    # mitkNavigationDataPlayerTest.cpp # random fails see bug 16485.
    # We decided to won't fix because of complete restructuring via bug 15959.
@@ -0,0 +1,170 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+//Testing
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+//MITK includes
+#include "LancetVegaFrameBuffer.h"
+
+//Std includes
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+class mitkLancetVegaFrameBufferTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLancetVegaFrameBufferTestSuite);
+
+  MITK_TEST(GetLatestFrame_NothingPublished_ReturnsFalse);
+  MITK_TEST(EndFrame_FramesPublished_LatestFrameReturned);
+  MITK_TEST(EndFrame_FrameNumberGap_DroppedFramesCounted);
+  MITK_TEST(EndFrame_SameFrameNumber_DuplicateDiscarded);
+  MITK_TEST(SetOrientation_RotationMatrixComputed);
+  MITK_TEST(GetLatestFrame_ConcurrentWriter_FramesConsistent);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  static void PublishFrame(mitk::LancetVegaFrameBuffer& buffer, uint32_t frameNumber)
+  {
+    mitk::LancetVegaFrame& frame = buffer.BeginFrame();
+    frame.FrameNumber = frameNumber;
+    frame.NumberOfTools = 2;
+
+    for (unsigned int i = 0; i < frame.NumberOfTools; ++i)
+    {
+      frame.Tools[i].PortHandle = static_cast<uint16_t>(i + 1);
+      frame.Tools[i].Valid = true;
+      frame.Tools[i].Position[0] = frameNumber;
+      frame.Tools[i].Position[1] = frameNumber;
+      frame.Tools[i].Position[2] = frameNumber;
+    }
+
+    buffer.EndFrame();
+  }
+
+public:
+
+  void GetLatestFrame_NothingPublished_ReturnsFalse()
+  {
+    mitk::LancetVegaFrameBuffer buffer;
+    mitk::LancetVegaFrame frame;
+
+    CPPUNIT_ASSERT_MESSAGE("No frame available before the first one is published", !buffer.GetLatestFrame(frame));
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), buffer.GetNumberOfPublishedFrames());
+  }
+
+  void EndFrame_FramesPublished_LatestFrameReturned()
+  {
+    mitk::LancetVegaFrameBuffer buffer;
+
+    for (uint32_t frameNumber = 1; frameNumber <= 5; ++frameNumber)
+      PublishFrame(buffer, frameNumber);
+
+    mitk::LancetVegaFrame frame;
+    CPPUNIT_ASSERT(buffer.GetLatestFrame(frame));
+    CPPUNIT_ASSERT_EQUAL(uint32_t(5), frame.FrameNumber);
+    CPPUNIT_ASSERT_EQUAL(2u, frame.NumberOfTools);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(5), buffer.GetNumberOfPublishedFrames());
+
+    const mitk::LancetVegaToolState* toolState = frame.FindTool(2);
+    CPPUNIT_ASSERT(toolState != nullptr);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(5.0, toolState->Position[0], 1e-12);
+    CPPUNIT_ASSERT_MESSAGE("Unknown port handle is not found", frame.FindTool(3) == nullptr);
+  }
+
+  void EndFrame_FrameNumberGap_DroppedFramesCounted()
+  {
+    mitk::LancetVegaFrameBuffer buffer;
+    PublishFrame(buffer, 10);
+    PublishFrame(buffer, 11);
+    PublishFrame(buffer, 15);
+
+    CPPUNIT_ASSERT_EQUAL(uint64_t(3), buffer.GetNumberOfDroppedFrames());
+    CPPUNIT_ASSERT_EQUAL(uint32_t(15), buffer.GetLatestFrameNumber());
+  }
+
+  void EndFrame_SameFrameNumber_DuplicateDiscarded()
+  {
+    mitk::LancetVegaFrameBuffer buffer;
+    PublishFrame(buffer, 1);
+    PublishFrame(buffer, 1);
+    PublishFrame(buffer, 2);
+
+    CPPUNIT_ASSERT_EQUAL(uint64_t(1), buffer.GetNumberOfDuplicatedFrames());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(2), buffer.GetNumberOfPublishedFrames());
+
+    buffer.Reset();
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), buffer.GetNumberOfDuplicatedFrames());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), buffer.GetNumberOfPublishedFrames());
+  }
+
+  void SetOrientation_RotationMatrixComputed()
+  {
+    // 90 degrees around z: (w, x, y, z) = (cos 45, 0, 0, sin 45)
+    const double halfSqrt2 = std::sqrt(0.5);
+    mitk::LancetVegaToolState toolState;
+    toolState.SetOrientation(halfSqrt2, 0.0, 0.0, halfSqrt2);
+    toolState.Position[0] = 1.0;
+
+    double matrix[16];
+    toolState.GetMatrix4x4(matrix);
+
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, matrix[0], 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(-1.0, matrix[1], 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, matrix[4], 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, matrix[10], 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, matrix[3], 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, matrix[15], 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(halfSqrt2, toolState.Quaternion[3], 1e-12);
+  }
+
+  void GetLatestFrame_ConcurrentWriter_FramesConsistent()
+  {
+    mitk::LancetVegaFrameBuffer buffer;
+    std::atomic<bool> writerFinished(false);
+
+    std::thread writer([&buffer, &writerFinished]() {
+      for (uint32_t frameNumber = 1; frameNumber <= 20000; ++frameNumber)
+        PublishFrame(buffer, frameNumber);
+      writerFinished = true;
+    });
+
+    bool consistent = true;
+    uint32_t lastFrameNumber = 0;
+    mitk::LancetVegaFrame frame;
+
+    while (!writerFinished)
+    {
+      if (!buffer.GetLatestFrame(frame))
+        continue;
+
+      // all values of a frame are written from the same frame number, a torn read would mix them
+      for (unsigned int i = 0; i < frame.NumberOfTools; ++i)
+        consistent = consistent && frame.Tools[i].Position[2] == frame.FrameNumber;
+
+      consistent = consistent && frame.FrameNumber >= lastFrameNumber;
+      lastFrameNumber = frame.FrameNumber;
+    }
+
+    writer.join();
+
+    CPPUNIT_ASSERT_MESSAGE("Frames read during writing are consistent", consistent);
+    CPPUNIT_ASSERT_EQUAL(uint64_t(20000), buffer.GetNumberOfPublishedFrames());
+    CPPUNIT_ASSERT_EQUAL(uint64_t(0), buffer.GetNumberOfDroppedFrames());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLancetVegaFrameBuffer)
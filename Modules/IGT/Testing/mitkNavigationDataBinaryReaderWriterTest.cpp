@@ -0,0 +1,209 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkNavigationDataBinaryReader.h>
+#include <mitkNavigationDataBinaryWriter.h>
+#include <mitkNavigationDataRecorder.h>
+#include <mitkNavigationDataSequentialPlayer.h>
+#include <mitkNavigationDataSet.h>
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include <mitkIOUtil.h>
+
+//for exceptions
+#include "mitkIGTException.h"
+#include "mitkIGTIOException.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+class mitkNavigationDataBinaryReaderWriterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkNavigationDataBinaryReaderWriterTestSuite);
+  MITK_TEST(TestWriteAndRead);
+  MITK_TEST(TestFindFrame);
+  MITK_TEST(TestAppendAfterPartialFrame);
+  MITK_TEST(TestRecorderStreamsToFile);
+  MITK_TEST(TestInvalidFile);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::string m_FileName;
+  std::vector<std::string> m_ToolNames;
+
+  static mitk::NavigationData::Pointer CreateNavigationData(const std::string& name, double timeStamp, double x, bool valid)
+  {
+    mitk::NavigationData::Pointer nd = mitk::NavigationData::New();
+    nd->SetName(name.c_str());
+    nd->SetIGTTimeStamp(timeStamp);
+    mitk::NavigationData::PositionType position;
+    position[0] = x; position[1] = 2.0 * x; position[2] = -x;
+    nd->SetPosition(position);
+    nd->SetOrientation(mitk::NavigationData::OrientationType(0.0, 0.0, std::sin(x), std::cos(x)));
+    nd->SetDataValid(valid);
+    return nd;
+  }
+
+  void WriteFrames(mitk::NavigationDataBinaryWriter* writer, unsigned int firstFrame, unsigned int numberOfFrames)
+  {
+    for (unsigned int i = firstFrame; i < firstFrame + numberOfFrames; ++i)
+    {
+      mitk::NavigationData::Pointer nd1 = CreateNavigationData(m_ToolNames[0], 10.0 * i, i, true);
+      mitk::NavigationData::Pointer nd2 = CreateNavigationData(m_ToolNames[1], 10.0 * i, -1.0 * i, i % 2 == 0);
+      writer->Write({ nd1.GetPointer(), nd2.GetPointer() });
+    }
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_FileName = mitk::IOUtil::CreateTemporaryFile("NavigationDataBinaryTest_XXXXXX.ndbin");
+    m_ToolNames = { "Pointer", "Reference" };
+  }
+
+  void tearDown() override
+  {
+    std::remove(m_FileName.c_str());
+  }
+
+  void TestWriteAndRead()
+  {
+    mitk::NavigationDataBinaryWriter::Pointer writer = mitk::NavigationDataBinaryWriter::New();
+    writer->Open(m_FileName, m_ToolNames);
+    WriteFrames(writer, 0, 100);
+    writer->Close();
+    CPPUNIT_ASSERT_EQUAL(100u, writer->GetNumberOfFrames());
+
+    mitk::NavigationDataBinaryReader::Pointer reader = mitk::NavigationDataBinaryReader::New();
+    reader->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(2u, reader->GetNumberOfTools());
+    CPPUNIT_ASSERT_EQUAL(std::string("Reference"), reader->GetToolName(1));
+    CPPUNIT_ASSERT_EQUAL(100u, reader->GetNumberOfFrames());
+
+    for (unsigned int i = 0; i < 100; i += 7)
+    {
+      mitk::NavigationData::Pointer expected = CreateNavigationData(m_ToolNames[1], 10.0 * i, -1.0 * i, i % 2 == 0);
+      mitk::NavigationData::Pointer actual = reader->GetNavigationData(i, 1);
+      CPPUNIT_ASSERT_MESSAGE("Navigation data is restored", mitk::Equal(*expected, *actual));
+      CPPUNIT_ASSERT_EQUAL(std::string("Reference"), std::string(actual->GetName()));
+    }
+
+    mitk::NavigationDataSet::Pointer set = reader->ReadNavigationDataSet(95, 10);
+    CPPUNIT_ASSERT_EQUAL(5u, set->Size());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(950.0, set->GetNavigationDataForIndex(0, 0)->GetIGTTimeStamp(), 1e-12);
+
+    CPPUNIT_ASSERT_THROW(reader->GetNavigationData(100, 0), mitk::IGTException);
+  }
+
+  void TestFindFrame()
+  {
+    mitk::NavigationDataBinaryWriter::Pointer writer = mitk::NavigationDataBinaryWriter::New();
+    writer->Open(m_FileName, m_ToolNames);
+    WriteFrames(writer, 0, 1000);
+    writer->Close();
+
+    mitk::NavigationDataBinaryReader::Pointer reader = mitk::NavigationDataBinaryReader::New();
+    reader->Open(m_FileName);
+
+    CPPUNIT_ASSERT_EQUAL(0u, reader->FindFrame(-5.0));
+    CPPUNIT_ASSERT_EQUAL(0u, reader->FindFrame(0.0));
+    CPPUNIT_ASSERT_EQUAL(42u, reader->FindFrame(420.0));
+    CPPUNIT_ASSERT_EQUAL(42u, reader->FindFrame(429.9));
+    CPPUNIT_ASSERT_EQUAL(999u, reader->FindFrame(1e6));
+  }
+
+  void TestAppendAfterPartialFrame()
+  {
+    mitk::NavigationDataBinaryWriter::Pointer writer = mitk::NavigationDataBinaryWriter::New();
+    writer->Open(m_FileName, m_ToolNames);
+    WriteFrames(writer, 0, 10);
+    writer->Close();
+
+    // simulate a crash while writing a frame
+    {
+      std::ofstream file(m_FileName, std::ios::binary | std::ios::app);
+      file << "partial";
+    }
+
+    mitk::NavigationDataBinaryReader::Pointer reader = mitk::NavigationDataBinaryReader::New();
+    reader->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(10u, reader->GetNumberOfFrames());
+    reader->Close();
+
+    writer = mitk::NavigationDataBinaryWriter::New();
+    writer->Open(m_FileName, m_ToolNames, true);
+    CPPUNIT_ASSERT_EQUAL(10u, writer->GetNumberOfFrames());
+    WriteFrames(writer, 10, 5);
+    writer->Close();
+
+    reader->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(15u, reader->GetNumberOfFrames());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(100.0, reader->GetTimeStamp(10), 1e-12);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(140.0, reader->GetTimeStamp(14), 1e-12);
+  }
+
+  void TestRecorderStreamsToFile()
+  {
+    std::string path = GetTestDataFilePath("IGT-Data/RecordedNavigationData.xml");
+    mitk::NavigationDataSet::Pointer navigationDataSet = dynamic_cast<mitk::NavigationDataSet*> (mitk::IOUtil::Load(path)[0].GetPointer());
+
+    mitk::NavigationDataSequentialPlayer::Pointer player = mitk::NavigationDataSequentialPlayer::New();
+    player->SetNavigationDataSet(navigationDataSet);
+
+    mitk::NavigationDataRecorder::Pointer recorder = mitk::NavigationDataRecorder::New();
+    recorder->SetStandardizeTime(false);
+    recorder->SetOutputFileName(m_FileName);
+    recorder->ConnectTo(player);
+
+    recorder->StartRecording();
+    while (!player->IsAtEnd())
+    {
+      recorder->Update();
+      player->GoToNextSnapshot();
+    }
+    recorder->StopRecording();
+    CPPUNIT_ASSERT_EQUAL(static_cast<int>(navigationDataSet->Size()), recorder->GetNumberOfRecordedSteps());
+    CPPUNIT_ASSERT_EQUAL(0u, recorder->GetNavigationDataSet()->Size());
+    recorder->ResetRecording();
+
+    mitk::NavigationDataBinaryReader::Pointer reader = mitk::NavigationDataBinaryReader::New();
+    reader->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(navigationDataSet->Size(), reader->GetNumberOfFrames());
+    CPPUNIT_ASSERT_EQUAL(navigationDataSet->GetNumberOfTools(), reader->GetNumberOfTools());
+
+    for (unsigned int i = 0; i < reader->GetNumberOfFrames(); ++i)
+    {
+      for (unsigned int tool = 0; tool < reader->GetNumberOfTools(); ++tool)
+      {
+        mitk::NavigationData::Pointer ref = navigationDataSet->GetNavigationDataForIndex(i, tool);
+        mitk::NavigationData::Pointer rec = reader->GetNavigationData(i, tool);
+        CPPUNIT_ASSERT(ref->GetOrientation().as_vector() == rec->GetOrientation().as_vector());
+        CPPUNIT_ASSERT(ref->GetPosition().GetVnlVector() == rec->GetPosition().GetVnlVector());
+      }
+    }
+  }
+
+  void TestInvalidFile()
+  {
+    {
+      std::ofstream file(m_FileName, std::ios::binary | std::ios::trunc);
+      file << "no navigation data";
+    }
+
+    mitk::NavigationDataBinaryReader::Pointer reader = mitk::NavigationDataBinaryReader::New();
+    CPPUNIT_ASSERT_THROW(reader->Open(m_FileName), mitk::IGTIOException);
+    CPPUNIT_ASSERT(!reader->IsOpen());
+  }
+};
+MITK_TEST_SUITE_REGISTRATION(mitkNavigationDataBinaryReaderWriter)
@@ -0,0 +1,332 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+//Testing
+#include "mitkTestingMacros.h"
+#include "mitkTestFixture.h"
+
+//MITK includes
+#include "mitkLockFreeRingBuffer.h"
+#include "mitkNavigationDataPassThroughFilter.h"
+#include "mitkTrackingDeviceSource.h"
+#include "mitkTrackingPipelineOutputSource.h"
+#include "mitkTrackingPipelineThread.h"
+#include "mitkVirtualTrackingDevice.h"
+
+//ITK includes
+#include "itksys/SystemTools.hxx"
+
+//Std includes
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+class mitkTrackingPipelineThreadTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkTrackingPipelineThreadTestSuite);
+
+  MITK_TEST(RingBuffer_PushAndPop_FirstInFirstOut);
+  MITK_TEST(RingBuffer_Full_OldestItemOverwritten);
+  MITK_TEST(RingBuffer_LaggingConsumer_GetsNewestItems);
+  MITK_TEST(RingBuffer_PopLatest_NewestItemAndCount);
+  MITK_TEST(RingBuffer_ConcurrentSamples_NeverTorn);
+  MITK_TEST(Sample_NavigationData_RoundTrip);
+  MITK_TEST(Statistics_LatenciesOfStages);
+  MITK_TEST(AddFilter_NoSource_Error);
+  MITK_TEST(StartPipeline_PosesPublishedAndMeasured);
+
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  mitk::VirtualTrackingDevice::Pointer m_Tracker;
+  mitk::TrackingDeviceSource::Pointer m_Source;
+
+public:
+
+  void setUp() override
+  {
+    m_Tracker = mitk::VirtualTrackingDevice::New();
+    m_Tracker->SetRefreshRate(10);
+    m_Tracker->AddTool("T0");
+    m_Tracker->AddTool("T1");
+
+    m_Source = mitk::TrackingDeviceSource::New();
+    m_Source->SetTrackingDevice(m_Tracker);
+  }
+
+  void tearDown() override
+  {
+    m_Source->StopTracking();
+    m_Source->Disconnect();
+  }
+
+  void RingBuffer_PushAndPop_FirstInFirstOut()
+  {
+    mitk::LockFreeRingBuffer<int> ringBuffer(4);
+    CPPUNIT_ASSERT(ringBuffer.Push(1));
+    CPPUNIT_ASSERT(ringBuffer.Push(2));
+
+    int item = 0;
+    CPPUNIT_ASSERT(ringBuffer.Pop(item));
+    CPPUNIT_ASSERT_EQUAL(1, item);
+    CPPUNIT_ASSERT(ringBuffer.Pop(item));
+    CPPUNIT_ASSERT_EQUAL(2, item);
+    CPPUNIT_ASSERT(!ringBuffer.Pop(item));
+  }
+
+  void RingBuffer_Full_OldestItemOverwritten()
+  {
+    mitk::LockFreeRingBuffer<int> ringBuffer(3);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), ringBuffer.GetCapacity());
+
+    for (int i = 0; i < 4; ++i)
+      CPPUNIT_ASSERT(ringBuffer.Push(i));
+
+    CPPUNIT_ASSERT(!ringBuffer.Push(4));
+    CPPUNIT_ASSERT(!ringBuffer.Push(5));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), ringBuffer.GetNumberOfDroppedItems());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(4), ringBuffer.GetSize());
+
+    int item = 0;
+    for (int i = 2; i < 6; ++i)
+    {
+      CPPUNIT_ASSERT(ringBuffer.Pop(item));
+      CPPUNIT_ASSERT_EQUAL(i, item);
+    }
+    CPPUNIT_ASSERT(!ringBuffer.Pop(item));
+  }
+
+  void RingBuffer_LaggingConsumer_GetsNewestItems()
+  {
+    const int numberOfItems = 100000;
+    mitk::LockFreeRingBuffer<int> ringBuffer(8);
+
+    std::thread producer([&ringBuffer, numberOfItems]() {
+      for (int i = 0; i < numberOfItems; ++i)
+        ringBuffer.Push(i);
+    });
+
+    // the consumer is much slower than the producer, but must never see an old or torn item
+    int lastItem = -1;
+    int item = 0;
+    std::size_t numberOfTakenItems = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+      const auto numberOfPoppedItems = ringBuffer.PopLatest(item);
+      if (0 != numberOfPoppedItems)
+      {
+        CPPUNIT_ASSERT(item > lastItem && item < numberOfItems);
+        lastItem = item;
+        numberOfTakenItems += numberOfPoppedItems;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    producer.join();
+
+    // the live item is still available after the consumer fell behind
+    if (lastItem != numberOfItems - 1)
+    {
+      numberOfTakenItems += ringBuffer.PopLatest(item);
+      CPPUNIT_ASSERT_EQUAL(numberOfItems - 1, item);
+    }
+
+    CPPUNIT_ASSERT(ringBuffer.GetNumberOfDroppedItems() > 0);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(numberOfItems), numberOfTakenItems + ringBuffer.GetNumberOfDroppedItems());
+  }
+
+  void RingBuffer_PopLatest_NewestItemAndCount()
+  {
+    mitk::LockFreeRingBuffer<int> ringBuffer(8);
+    int item = 0;
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), ringBuffer.PopLatest(item));
+
+    for (int i = 0; i < 5; ++i)
+      ringBuffer.Push(i);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(5), ringBuffer.PopLatest(item));
+    CPPUNIT_ASSERT_EQUAL(4, item);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), ringBuffer.GetSize());
+  }
+
+  /** Fills all values of a sample with the frame number, so a torn copy is detectable. */
+  static mitk::TrackingPipelineSample CreateSample(unsigned long frameNumber)
+  {
+    mitk::TrackingPipelineSample sample;
+    const double value = static_cast<double>(frameNumber);
+
+    for (auto& position : sample.Position)
+      position = value;
+    for (auto& orientation : sample.Orientation)
+      orientation = value;
+    for (auto& covariance : sample.CovErrorMatrix)
+      covariance = value;
+    sample.TimeStamps.fill(value);
+    sample.FrameNumber = frameNumber;
+    sample.DataValid = true;
+
+    return sample;
+  }
+
+  static bool IsConsistent(const mitk::TrackingPipelineSample& sample)
+  {
+    const double value = static_cast<double>(sample.FrameNumber);
+    bool consistent = sample.DataValid;
+
+    for (auto position : sample.Position)
+      consistent = consistent && value == position;
+    for (auto orientation : sample.Orientation)
+      consistent = consistent && value == orientation;
+    for (auto covariance : sample.CovErrorMatrix)
+      consistent = consistent && value == covariance;
+    for (auto timeStamp : sample.TimeStamps)
+      consistent = consistent && value == timeStamp;
+
+    return consistent;
+  }
+
+  void RingBuffer_ConcurrentSamples_NeverTorn()
+  {
+    const unsigned long numberOfSamples = 200000;
+    mitk::TrackingPipelineThread::RingBuffer ringBuffer(4);
+
+    std::thread producer([&ringBuffer, numberOfSamples]() {
+      for (unsigned long i = 1; i <= numberOfSamples; ++i)
+        ringBuffer.Push(CreateSample(i));
+    });
+
+    // alternate between both ways of consuming, the slots are constantly reclaimed by the producer
+    unsigned long lastFrameNumber = 0;
+    unsigned long numberOfTornSamples = 0;
+    std::size_t numberOfTakenSamples = 0;
+    mitk::TrackingPipelineSample sample;
+
+    for (std::size_t i = 0; lastFrameNumber != numberOfSamples; ++i)
+    {
+      const std::size_t numberOfPoppedSamples = 0 == i % 2 ? ringBuffer.PopLatest(sample) : (ringBuffer.Pop(sample) ? 1 : 0);
+
+      if (0 == numberOfPoppedSamples)
+        continue;
+
+      if (!IsConsistent(sample) || sample.FrameNumber <= lastFrameNumber)
+        ++numberOfTornSamples;
+
+      lastFrameNumber = sample.FrameNumber;
+      numberOfTakenSamples += numberOfPoppedSamples;
+    }
+
+    producer.join();
+
+    CPPUNIT_ASSERT_EQUAL(0ul, numberOfTornSamples);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(numberOfSamples), numberOfTakenSamples + ringBuffer.GetNumberOfDroppedItems());
+  }
+
+  void Sample_NavigationData_RoundTrip()
+  {
+    auto navigationData = mitk::NavigationData::New();
+    mitk::NavigationData::PositionType position;
+    mitk::FillVector3D(position, 1.0, 2.0, 3.0);
+    navigationData->SetPosition(position);
+    navigationData->SetOrientation(mitk::Quaternion(0.0, 0.6, 0.0, 0.8));
+    mitk::NavigationData::CovarianceMatrixType covErrorMatrix;
+    covErrorMatrix.SetIdentity();
+    covErrorMatrix(1, 4) = 0.5;
+    navigationData->SetCovErrorMatrix(covErrorMatrix);
+    navigationData->SetDataValid(true);
+
+    mitk::TrackingPipelineSample sample;
+    sample.SetNavigationData(navigationData);
+
+    auto result = mitk::NavigationData::New();
+    sample.GetNavigationData(result);
+
+    CPPUNIT_ASSERT(mitk::Equal(*navigationData, *result));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.5, result->GetCovErrorMatrix()(1, 4), mitk::eps);
+  }
+
+  void Statistics_LatenciesOfStages()
+  {
+    mitk::TrackingPipelineStatistics statistics;
+    mitk::TrackingPipelineSample sample;
+
+    for (int i = 0; i < 2; ++i)
+    {
+      sample.SetTimeStamp(mitk::TrackingPipelineStage::DeviceRead, 100.0 * i);
+      sample.SetTimeStamp(mitk::TrackingPipelineStage::SourceUpdated, 100.0 * i + 1.0);
+      sample.SetTimeStamp(mitk::TrackingPipelineStage::FiltersApplied, 100.0 * i + 2.0);
+      sample.SetTimeStamp(mitk::TrackingPipelineStage::Published, 100.0 * i + 3.0);
+      sample.SetTimeStamp(mitk::TrackingPipelineStage::Consumed, 100.0 * i + 10.0 + 2.0 * i);
+      statistics.AddSample(sample);
+    }
+
+    auto filtersApplied = statistics.GetStageStatistics(mitk::TrackingPipelineStage::FiltersApplied);
+    CPPUNIT_ASSERT_EQUAL(2ul, filtersApplied.NumberOfSamples);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(2.0, filtersApplied.MeanLatency, mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(0.0, filtersApplied.Jitter, mitk::eps);
+
+    auto endToEnd = statistics.GetEndToEndStatistics();
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(11.0, endToEnd.MeanLatency, mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0, endToEnd.MinimumLatency, mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(12.0, endToEnd.MaximumLatency, mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(std::sqrt(2.0), endToEnd.Jitter, mitk::eps);
+
+    statistics.Reset();
+    CPPUNIT_ASSERT_EQUAL(0ul, statistics.GetEndToEndStatistics().NumberOfSamples);
+  }
+
+  void AddFilter_NoSource_Error()
+  {
+    auto pipelineThread = mitk::TrackingPipelineThread::New();
+    CPPUNIT_ASSERT_THROW(pipelineThread->AddFilter(mitk::NavigationDataPassThroughFilter::New()), mitk::Exception);
+    CPPUNIT_ASSERT_THROW(pipelineThread->Start(), mitk::Exception);
+  }
+
+  void StartPipeline_PosesPublishedAndMeasured()
+  {
+    m_Source->Connect();
+    m_Source->StartTracking();
+
+    auto pipelineThread = mitk::TrackingPipelineThread::New();
+    pipelineThread->SetSource(m_Source);
+    pipelineThread->AddFilter(mitk::NavigationDataPassThroughFilter::New());
+    pipelineThread->SetUpdateRate(200.0);
+    pipelineThread->Start();
+    CPPUNIT_ASSERT(pipelineThread->IsRunning());
+    CPPUNIT_ASSERT_EQUAL(2u, pipelineThread->GetNumberOfTools());
+
+    auto outputSource = mitk::TrackingPipelineOutputSource::New();
+    outputSource->SetPipelineThread(pipelineThread);
+    CPPUNIT_ASSERT_EQUAL(2u, static_cast<unsigned int>(outputSource->GetNumberOfIndexedOutputs()));
+    CPPUNIT_ASSERT_EQUAL(std::string("T0"), std::string(outputSource->GetOutput(0)->GetName()));
+
+    for (int i = 0; i < 10; ++i)
+    {
+      itksys::SystemTools::Delay(20);
+      outputSource->Update();
+    }
+
+    pipelineThread->Stop();
+    CPPUNIT_ASSERT(!pipelineThread->IsRunning());
+    CPPUNIT_ASSERT(pipelineThread->GetNumberOfUpdates() > 0);
+
+    auto endToEnd = outputSource->GetEndToEndStatistics();
+    CPPUNIT_ASSERT(endToEnd.NumberOfSamples > 0);
+    CPPUNIT_ASSERT(endToEnd.MinimumLatency >= 0.0);
+    CPPUNIT_ASSERT(endToEnd.MeanLatency <= endToEnd.MaximumLatency);
+
+    auto published = outputSource->GetStatistics().GetStageStatistics(mitk::TrackingPipelineStage::Published);
+    CPPUNIT_ASSERT(published.MeanLatency <= endToEnd.MeanLatency);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkTrackingPipelineThread)
@@ -0,0 +1,140 @@
+#include "LancetVegaFrameBuffer.h"
+
+namespace mitk
+{
+  void LancetVegaToolState::SetOrientation(double q0, double qx, double qy, double qz)
+  {
+    Quaternion[0] = qx;
+    Quaternion[1] = qy;
+    Quaternion[2] = qz;
+    Quaternion[3] = q0;
+
+    const double xx = qx * qx, yy = qy * qy, zz = qz * qz;
+    const double xy = qx * qy, xz = qx * qz, yz = qy * qz;
+    const double wx = q0 * qx, wy = q0 * qy, wz = q0 * qz;
+
+    Rotation[0][0] = 1.0 - 2.0 * (yy + zz);
+    Rotation[0][1] = 2.0 * (xy - wz);
+    Rotation[0][2] = 2.0 * (xz + wy);
+    Rotation[1][0] = 2.0 * (xy + wz);
+    Rotation[1][1] = 1.0 - 2.0 * (xx + zz);
+    Rotation[1][2] = 2.0 * (yz - wx);
+    Rotation[2][0] = 2.0 * (xz - wy);
+    Rotation[2][1] = 2.0 * (yz + wx);
+    Rotation[2][2] = 1.0 - 2.0 * (xx + yy);
+  }
+
+  void LancetVegaToolState::GetMatrix4x4(double matrix[16]) const
+  {
+    for (int row = 0; row < 3; ++row)
+    {
+      matrix[row * 4 + 0] = Rotation[row][0];
+      matrix[row * 4 + 1] = Rotation[row][1];
+      matrix[row * 4 + 2] = Rotation[row][2];
+      matrix[row * 4 + 3] = Position[row];
+    }
+    matrix[12] = 0.0;
+    matrix[13] = 0.0;
+    matrix[14] = 0.0;
+    matrix[15] = 1.0;
+  }
+
+  const LancetVegaToolState *LancetVegaFrame::FindTool(uint16_t portHandle) const
+  {
+    for (unsigned int i = 0; i < NumberOfTools; ++i)
+    {
+      if (Tools[i].PortHandle == portHandle)
+        return &Tools[i];
+    }
+    return nullptr;
+  }
+
+  LancetVegaFrameBuffer::LancetVegaFrameBuffer()
+    : m_Sequence(0),
+      m_WriteSequence(0),
+      m_NumberOfDroppedFrames(0),
+      m_NumberOfDuplicatedFrames(0)
+  {
+  }
+
+  LancetVegaFrame &LancetVegaFrameBuffer::BeginFrame()
+  {
+    // the back buffer is the one that is not referenced by the current sequence number;
+    // announce the write before touching it so that readers of the older frame retry
+    const uint64_t writeSequence = m_Sequence.load(std::memory_order_relaxed) + 1;
+    m_WriteSequence.store(writeSequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    return m_Frames[writeSequence & 1];
+  }
+
+  bool LancetVegaFrameBuffer::EndFrame()
+  {
+    const uint64_t sequence = m_Sequence.load(std::memory_order_relaxed);
+    const LancetVegaFrame &frame = m_Frames[(sequence + 1) & 1];
+
+    if (sequence > 0)
+    {
+      const uint32_t latestFrameNumber = m_Frames[sequence & 1].FrameNumber;
+
+      if (frame.FrameNumber == latestFrameNumber)
+      {
+        m_NumberOfDuplicatedFrames.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+
+      if (frame.FrameNumber > latestFrameNumber + 1)
+        m_NumberOfDroppedFrames.fetch_add(frame.FrameNumber - latestFrameNumber - 1, std::memory_order_relaxed);
+    }
+
+    m_Sequence.store(sequence + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool LancetVegaFrameBuffer::GetLatestFrame(LancetVegaFrame &frame) const
+  {
+    while (true)
+    {
+      const uint64_t sequence = m_Sequence.load(std::memory_order_acquire);
+
+      if (sequence == 0)
+        return false;
+
+      frame = m_Frames[sequence & 1];
+
+      // the buffer is overwritten by the write that follows the next published frame
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (m_WriteSequence.load(std::memory_order_relaxed) < sequence + 2)
+        return true;
+    }
+  }
+
+  uint32_t LancetVegaFrameBuffer::GetLatestFrameNumber() const
+  {
+    LancetVegaFrame frame;
+    return this->GetLatestFrame(frame) ? frame.FrameNumber : 0;
+  }
+
+  uint64_t LancetVegaFrameBuffer::GetNumberOfPublishedFrames() const
+  {
+    return m_Sequence.load(std::memory_order_relaxed);
+  }
+
+  uint64_t LancetVegaFrameBuffer::GetNumberOfDroppedFrames() const
+  {
+    return m_NumberOfDroppedFrames.load(std::memory_order_relaxed);
+  }
+
+  uint64_t LancetVegaFrameBuffer::GetNumberOfDuplicatedFrames() const
+  {
+    return m_NumberOfDuplicatedFrames.load(std::memory_order_relaxed);
+  }
+
+  void LancetVegaFrameBuffer::Reset()
+  {
+    m_Sequence.store(0, std::memory_order_relaxed);
+    m_WriteSequence.store(0, std::memory_order_relaxed);
+    m_NumberOfDroppedFrames.store(0, std::memory_order_relaxed);
+    m_NumberOfDuplicatedFrames.store(0, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,107 @@
+#ifndef LANCET_VEGA_FRAME_BUFFER_H
+#define LANCET_VEGA_FRAME_BUFFER_H
+// mitk
+#include "MitkIGTExports.h"
+// std
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace mitk
+{
+  /** Documentation
+    * \brief State of one tool in a frame of the Vega tracking device.
+    *
+    * The rotation matrix is computed once per frame by the tracking thread, so consumers
+    * do not need to convert the quaternion on every access.
+    */
+  struct MITKIGT_EXPORT LancetVegaToolState
+  {
+    uint16_t PortHandle = 0;
+    bool Valid = false;
+    uint32_t PortStatus = 0;
+    double Position[3] = { 0.0, 0.0, 0.0 };
+    double Quaternion[4] = { 0.0, 0.0, 0.0, 1.0 }; ///< x, y, z, w
+    double Rotation[3][3] = { { 1.0, 0.0, 0.0 }, { 0.0, 1.0, 0.0 }, { 0.0, 0.0, 1.0 } };
+    double Error = 0.0;
+
+    /** \brief Sets quaternion and rotation matrix from the (w, x, y, z) quaternion reported by the device. */
+    void SetOrientation(double q0, double qx, double qy, double qz);
+
+    /** \brief Writes the pose as row-major homogeneous 4x4 matrix. */
+    void GetMatrix4x4(double matrix[16]) const;
+  };
+
+  /** Documentation
+    * \brief Snapshot of all tools reported by the Vega tracking device for one frame.
+    */
+  struct MITKIGT_EXPORT LancetVegaFrame
+  {
+    static const unsigned int MaximumNumberOfTools = 16;
+
+    uint32_t FrameNumber = 0;        ///< frame number reported by the device
+    double DeviceTimeStamp = 0.0;    ///< device time in seconds (BX2 only, 0 otherwise)
+    double IGTTimeStamp = 0.0;       ///< time the frame was received in milliseconds (mitk::IGTTimeStamp)
+    unsigned int NumberOfTools = 0;
+    std::array<LancetVegaToolState, MaximumNumberOfTools> Tools;
+
+    /** \brief Returns the state of the tool with the given port handle or nullptr if the tool is not part of the frame. */
+    const LancetVegaToolState* FindTool(uint16_t portHandle) const;
+  };
+
+  /** Documentation
+    * \brief Double-buffered, lock-free snapshot of the latest Vega frame.
+    *
+    * The tracking thread is the only writer. It fills the back buffer in place
+    * (BeginFrame() / EndFrame()) and publishes it by incrementing a sequence counter.
+    * Any number of consumer threads read the latest published frame with GetLatestFrame()
+    * without taking locks. A reader that overlaps with a writer overwriting its buffer
+    * detects this by the sequence counters (seqlock) and retries.
+    *
+    * The buffer also counts frames that were skipped (gaps in the device frame numbers)
+    * or duplicated (the device reported the same frame again).
+    *
+    * \ingroup IGT
+    */
+  class MITKIGT_EXPORT LancetVegaFrameBuffer
+  {
+  public:
+    LancetVegaFrameBuffer();
+
+    LancetVegaFrameBuffer(const LancetVegaFrameBuffer&) = delete;
+    LancetVegaFrameBuffer& operator=(const LancetVegaFrameBuffer&) = delete;
+
+    /** \brief Returns the back buffer to be filled by the writer thread. */
+    LancetVegaFrame& BeginFrame();
+
+    /**
+      * \brief Publishes the back buffer filled since BeginFrame().
+      * \return false if the frame is a duplicate of the last published frame and was discarded
+      */
+    bool EndFrame();
+
+    /**
+      * \brief Copies the latest published frame.
+      * \return false if no frame was published yet
+      */
+    bool GetLatestFrame(LancetVegaFrame& frame) const;
+
+    /** \brief Returns the frame number of the latest published frame. */
+    uint32_t GetLatestFrameNumber() const;
+
+    uint64_t GetNumberOfPublishedFrames() const;
+    uint64_t GetNumberOfDroppedFrames() const;
+    uint64_t GetNumberOfDuplicatedFrames() const;
+
+    /** \brief Discards all frames and resets the counters. Must not be called while a writer is active. */
+    void Reset();
+
+  private:
+    std::array<LancetVegaFrame, 2> m_Frames;
+    std::atomic<uint64_t> m_Sequence; ///< number of published frames, the latest one is in m_Frames[m_Sequence & 1]
+    std::atomic<uint64_t> m_WriteSequence; ///< sequence number of the frame that is currently written
+    std::atomic<uint64_t> m_NumberOfDroppedFrames;
+    std::atomic<uint64_t> m_NumberOfDuplicatedFrames;
+  };
+}
+#endif //!LANCET_VEGA_FRAME_BUFFER_H
@@ -5,6 +5,9 @@
 // vtk
 #include "mitkIGTException.h"
 #include "mitkIGTTimeStamp.h"
+
+#include <unordered_map>
+
 typedef itk::MutexLockHolder<itk::FastMutexLock> MutexLockHolder;
 
 namespace mitk
@@ -141,7 +144,7 @@ namespace mitk
     MITK_INFO<< m_capi.getUserParameter("Features.Firmware.Version");
 
     // Determine if the connected device supports the BX2 command
-    determineApiSupportForBX2();
+    m_ApiSupportsBX2 = determineApiSupportForBX2();
 
     // Initialize the system. This clears all previously loaded tools, unsaved settings etc...
     errorCode = this->m_capi.initialize();
@@ -328,6 +331,16 @@ namespace mitk
     this->m_6DTools.clear();
   }
 
+  bool LancetVegaTrackingDevice::GetLatestFrame(LancetVegaFrame &frame) const
+  {
+    return m_FrameBuffer.GetLatestFrame(frame);
+  }
+
+  const LancetVegaFrameBuffer &LancetVegaTrackingDevice::GetFrameBuffer() const
+  {
+    return m_FrameBuffer;
+  }
+
   OperationMode LancetVegaTrackingDevice::GetOperationMode() const
   {
     return m_OperationMode;
@@ -353,6 +366,20 @@ namespace mitk
       return;
     }
 
+    // Resolve the port handles once instead of searching the tool container for every tool of every frame.
+    // Tools can not be added or removed while tracking.
+    std::unordered_map<uint16_t, NDIPassiveTool::Pointer> toolsByPortHandle;
+    {
+      MutexLockHolder toolsMutexLockHolder(*m_ToolsMutex); // lock and unlock the mutex
+      for (const auto &tool : m_6DTools)
+      {
+        if (!tool->GetPortHandle().empty())
+          toolsByPortHandle[static_cast<uint16_t>(std::stoi(tool->GetPortHandle()))] = tool;
+      }
+    }
+
+    m_FrameBuffer.Reset();
+
     bool localStopTracking;
     // Because m_StopTracking is used by two threads, access has to be guarded by a mutex. To minimize thread locking, a local copy is used here
     this->m_StopTrackingMutex->Lock(); // update the local copy of m_StopTracking
@@ -361,16 +388,48 @@ namespace mitk
     while ((this->GetState() == Tracking) && (localStopTracking == false))
     {
       //MITK_INFO << "tracking";
-      std::vector<ToolData> dataOfTools = m_capi.getTrackingDataBX();
+      std::vector<ToolData> dataOfTools = m_ApiSupportsBX2 ? m_capi.getTrackingDataBX2("--6d=tools")
+                                                           : m_capi.getTrackingDataBX();
       if (dataOfTools.empty())
       {
         MITK_INFO << "dataOfTools.empty()";
         break;
       }
 
-      for (auto toolData : dataOfTools)
+      const double igtTimeStamp = mitk::IGTTimeStamp::GetInstance()->GetElapsed();
+
+      // fill the back buffer in place, all tools of a reply belong to the same frame
+      LancetVegaFrame &frame = m_FrameBuffer.BeginFrame();
+      frame.FrameNumber = dataOfTools.front().frameNumber;
+      frame.DeviceTimeStamp = m_ApiSupportsBX2
+        ? dataOfTools.front().timespec_s + dataOfTools.front().timespec_ns * 1.0e-9
+        : 0.0;
+      frame.IGTTimeStamp = igtTimeStamp;
+      frame.NumberOfTools = 0;
+
+      for (const auto &toolData : dataOfTools)
       {
-        NDIPassiveTool::Pointer tool = GetInternalTool(intToString(toolData.transform.toolHandle, 2));
+        const bool dataValid = !toolData.transform.isMissing();
+
+        if (frame.NumberOfTools < LancetVegaFrame::MaximumNumberOfTools)
+        {
+          LancetVegaToolState &toolState = frame.Tools[frame.NumberOfTools++];
+          toolState.PortHandle = toolData.transform.toolHandle;
+          toolState.Valid = dataValid;
+          toolState.PortStatus = toolData.portStatus;
+          toolState.Position[0] = toolData.transform.tx;
+          toolState.Position[1] = toolData.transform.ty;
+          toolState.Position[2] = toolData.transform.tz;
+          toolState.SetOrientation(toolData.transform.q0, toolData.transform.qx, toolData.transform.qy, toolData.transform.qz);
+          toolState.Error = toolData.transform.error;
+        }
+
+        // keep the tools up to date for the mitk::TrackingDeviceSource
+        auto toolIt = toolsByPortHandle.find(toolData.transform.toolHandle);
+        if (toolIt == toolsByPortHandle.end())
+          continue;
+
+        NDIPassiveTool *tool = toolIt->second;
         mitk::Quaternion quaternion{toolData.transform.qx, toolData.transform.qy, toolData.transform.qz,
                                     toolData.transform.q0};
         tool->SetOrientation(quaternion);
@@ -378,15 +437,18 @@ namespace mitk
         position[0] = toolData.transform.tx;
         position[1] = toolData.transform.ty;
         position[2] = toolData.transform.tz;
-        
+
         tool->SetPosition(position);
         tool->SetTrackingError(toolData.transform.error);
         tool->SetErrorMessage("");
         tool->SetFrameNumber(toolData.frameNumber);
-        
-        tool->SetDataValid(!toolData.transform.isMissing());
-        
+        tool->SetIGTTimeStamp(igtTimeStamp);
+
+        tool->SetDataValid(dataValid);
       }
+
+      m_FrameBuffer.EndFrame();
+
       /* Update the local copy of m_StopTracking */
       this->m_StopTrackingMutex->Lock();
       localStopTracking = m_StopTracking;
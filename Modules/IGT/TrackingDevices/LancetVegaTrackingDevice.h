@@ -3,6 +3,7 @@
 // mitk
 #include <mitkTrackingDevice.h>
 #include "mitkNDIPassiveTool.h"
+#include "LancetVegaFrameBuffer.h"
 #include "CombinedApi.h"
 
 namespace mitk
@@ -113,6 +114,18 @@ namespace mitk
 
     //itkGetConstMacro(Vega, VegaThread*);
 
+    /**
+    * \brief Copies the latest frame published by the tracking thread without locking.
+    *
+    * In contrast to the tools returned by GetTool(), the frame is a consistent snapshot of all
+    * tools and carries the device frame number and time stamps.
+    * \return false if no frame was received since the tracking was started
+    */
+    bool GetLatestFrame(LancetVegaFrame &frame) const;
+
+    /** \brief Returns the frame buffer to query the number of published, dropped and duplicated frames. */
+    const LancetVegaFrameBuffer &GetFrameBuffer() const;
+
     itkGetConstMacro(TrackingFrequencyPara, unsigned int);
     itkSetMacro(hostName, std::string); ///< set host-name for socket communication
     itkGetConstMacro(hostName, std::string);
@@ -165,6 +178,8 @@ namespace mitk
     unsigned int m_TrackingFrequencyPara = 2;
 
     CombinedApi m_capi;
+    bool m_ApiSupportsBX2 = false;  ///< BX2 replies carry the device time stamp of the frame
+    LancetVegaFrameBuffer m_FrameBuffer; ///< latest frame, written by the tracking thread only
     std::string m_DeviceName;
     std::string m_hostName;
 
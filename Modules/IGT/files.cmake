@@ -20,6 +20,7 @@ set(CPP_FILES
 
   Common/mitkIGTTimeStamp.cpp
   Common/mitkSerialCommunication.cpp
+  Common/mitkTrackingPipelineStatistics.cpp
 
   DataManagement/mitkNavigationDataSource.cpp
   DataManagement/mitkNavigationTool.cpp
@@ -27,11 +28,15 @@ set(CPP_FILES
   DataManagement/mitkTrackingDeviceSourceConfigurator.cpp
   DataManagement/mitkTrackingDeviceSource.cpp
   DataManagement/mitkTrackingDeviceTypeCollection.cpp
+  DataManagement/mitkTrackingPipelineOutputSource.cpp
+  DataManagement/mitkTrackingPipelineThread.cpp
 
   ExceptionHandling/mitkIGTException.cpp
   ExceptionHandling/mitkIGTHardwareException.cpp
   ExceptionHandling/mitkIGTIOException.cpp
 
+  IO/mitkNavigationDataBinaryReader.cpp
+  IO/mitkNavigationDataBinaryWriter.cpp
   IO/mitkNavigationDataPlayer.cpp
   IO/mitkNavigationDataPlayerBase.cpp
   IO/mitkNavigationDataRecorder.cpp
@@ -72,12 +77,14 @@ set(CPP_FILES
 #  TrackingDevices/mitkPolhemusTrackingDevice.cpp
 #  TrackingDevices/mitkPolhemusTool.cpp
 #  TrackingDevices/mitkPolhemusTrackerTypeInformation.cpp
+  TrackingDevices/LancetVegaFrameBuffer.cpp
   TrackingDevices/LancetVegaTrackingDevice.cpp
   TrackingDevices/LancetVegaTrackingDeviceTypeInformation.cpp
 )
 
 set(H_FILES
   DataManagement/mitkTrackingDeviceTypeInformation.h
+  Common/mitkLockFreeRingBuffer.h
   Common/mitkTrackingTypes.h
 )
 
@@ -12,6 +12,7 @@ found in the LICENSE file.
 
 #include "mitkIOExtActivator.h"
 
+#include "mitkImageChunkedIO.h"
 #include "mitkObjFileReaderService.h"
 #include "mitkPlyFileReaderService.h"
 #include "mitkPlyFileWriterService.h"
@@ -29,6 +30,7 @@ namespace mitk
 
     m_PlyReader.reset(new PlyFileReaderService());
     m_ObjWriter.reset(new PlyFileWriterService());
+    m_ChunkedImageIO.reset(new ImageChunkedIO());
   }
 
   void IOExtActivator::Unload(us::ModuleContext *) {}
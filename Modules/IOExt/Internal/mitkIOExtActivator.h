@@ -21,6 +21,7 @@ namespace mitk
 {
   struct IFileReader;
   struct IFileWriter;
+  class AbstractFileIO;
 
   class IOExtActivator : public us::ModuleActivator
   {
@@ -35,6 +36,7 @@ namespace mitk
     std::unique_ptr<IFileWriter> m_ObjWriter;
 
     std::unique_ptr<IFileReader> m_PlyReader;
+    std::unique_ptr<AbstractFileIO> m_ChunkedImageIO;
   };
 }
 
@@ -0,0 +1,550 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkImageChunkedIO.h"
+
+#include <mitkArbitraryTimeGeometry.h>
+#include <mitkIOMimeTypes.h>
+#include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
+#include <mitkItkImageIO.h>
+#include <mitkLocaleSwitch.h>
+#include <mitkProportionalTimeGeometry.h>
+#include <mitkUIDManipulator.h>
+
+#include <itkByteSwapper.h>
+#include <itkMetaDataObject.h>
+#include <itkMultiThreader.h>
+#include <itkNrrdImageIO.h>
+
+#include <lz4.h>
+#include <tinyxml2.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <sstream>
+
+namespace
+{
+  const char Magic[8] = {'M', 'I', 'T', 'K', 'C', 'H', 'N', 'K'};
+  const std::uint32_t Version = 1;
+  const std::uint64_t MaximumHeaderSize = 1024 * 1024;
+
+  /** Uncompressed size of a chunk. Large enough for LZ4 to compress well, small enough to keep all cores busy
+   * for single volumes and to bound the memory needed for batches of compressed chunks.*/
+  const std::uint64_t DefaultChunkSize = 4 * 1024 * 1024;
+
+  struct ChunkIndexEntry
+  {
+    std::uint64_t Offset = 0;
+    std::uint64_t CompressedSize = 0;
+    std::uint64_t Size = 0;
+  };
+
+  /** Chunks of a batch that are compressed or decompressed by the threads of an itk::MultiThreader.*/
+  struct ChunkBatch
+  {
+    std::uint64_t NumberOfChunks = 0;
+    std::function<void(std::uint64_t)> ProcessChunk;
+    std::vector<std::exception_ptr> Exceptions;
+  };
+
+  ITK_THREAD_RETURN_TYPE ProcessChunksThread(void *param)
+  {
+    auto *threadInfo = static_cast<itk::MultiThreader::ThreadInfoStruct *>(param);
+    auto *batch = static_cast<ChunkBatch *>(threadInfo->UserData);
+
+    try
+    {
+      for (std::uint64_t i = threadInfo->ThreadID; i < batch->NumberOfChunks; i += threadInfo->NumberOfThreads)
+        batch->ProcessChunk(i);
+    }
+    catch (...)
+    {
+      batch->Exceptions[threadInfo->ThreadID] = std::current_exception();
+    }
+
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+  /** Calls processChunk(i) for all chunks i in [0, numberOfChunks) with the threads of the given threader.*/
+  void ProcessChunks(itk::MultiThreader *threader,
+                     std::uint64_t numberOfChunks,
+                     const std::function<void(std::uint64_t)> &processChunk)
+  {
+    ChunkBatch batch;
+    batch.NumberOfChunks = numberOfChunks;
+    batch.ProcessChunk = processChunk;
+    batch.Exceptions.resize(threader->GetNumberOfThreads());
+
+    threader->SetSingleMethod(ProcessChunksThread, &batch);
+    threader->SingleMethodExecute();
+
+    for (const auto &exception : batch.Exceptions)
+    {
+      if (exception)
+        std::rethrow_exception(exception);
+    }
+  }
+
+  std::size_t GetBatchSize(const itk::MultiThreader *threader)
+  {
+    return 2 * static_cast<std::size_t>(threader->GetNumberOfThreads());
+  }
+
+  /** Numbers of the file structure are stored in little endian byte order.*/
+  template <typename T>
+  void WriteValue(std::ostream &stream, T value)
+  {
+    itk::ByteSwapper<T>::SwapFromSystemToLittleEndian(&value);
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  T ReadValue(std::istream &stream)
+  {
+    T value = 0;
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    itk::ByteSwapper<T>::SwapFromSystemToLittleEndian(&value);
+    return value;
+  }
+
+  template <typename T>
+  std::string ToString(const T *values, unsigned int count)
+  {
+    std::ostringstream stream;
+    stream.precision(17);
+    for (unsigned int i = 0; i < count; ++i)
+      stream << (i > 0 ? " " : "") << values[i];
+    return stream.str();
+  }
+
+  template <typename T>
+  std::vector<T> FromString(const char *value)
+  {
+    std::vector<T> values;
+    if (value != nullptr)
+    {
+      std::istringstream stream(value);
+      T element;
+      while (stream >> element)
+        values.push_back(element);
+    }
+    return values;
+  }
+
+  const char *GetByteOrderName()
+  {
+    return itk::ByteSwapper<int>::SystemIsBigEndian() ? "BigEndian" : "LittleEndian";
+  }
+
+  bool HasMagic(std::istream &stream)
+  {
+    char magic[sizeof(Magic)];
+    return stream.read(magic, sizeof(Magic)) && std::equal(magic, magic + sizeof(Magic), Magic);
+  }
+}
+
+namespace mitk
+{
+  std::string ImageChunkedIO::OPTION_TIME_STEP()
+  {
+    static std::string s = "Time step";
+    return s;
+  }
+
+  ImageChunkedIO::ImageChunkedIO()
+    : AbstractFileIO(Image::GetStaticNameOfClass(), IOMimeTypes::CHUNKED_IMAGE_MIMETYPE(), "MITK Chunked Image")
+  {
+    Options defaultReaderOptions;
+    defaultReaderOptions[OPTION_TIME_STEP()] = us::Any(-1);
+    this->SetDefaultReaderOptions(defaultReaderOptions);
+
+    this->RegisterService();
+  }
+
+  std::vector<BaseData::Pointer> ImageChunkedIO::DoRead()
+  {
+    LocaleSwitch localeSwitch("C");
+
+    const std::string path = this->GetLocalFileName();
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.is_open() || !HasMagic(file))
+      mitkThrow() << path << " is no MITK chunked image.";
+
+    const auto version = ReadValue<std::uint32_t>(file);
+    if (version != Version)
+      mitkThrow() << "Unsupported version " << version << " of MITK chunked image " << path << ".";
+
+    const auto headerSize = ReadValue<std::uint64_t>(file);
+    if (!file || headerSize == 0 || headerSize > MaximumHeaderSize)
+      mitkThrow() << "Invalid header of MITK chunked image " << path << ".";
+
+    std::string header(headerSize, '\0');
+    file.read(&header[0], header.size());
+
+    tinyxml2::XMLDocument document;
+    if (!file || tinyxml2::XML_SUCCESS != document.Parse(header.c_str(), header.size()))
+      mitkThrow() << "Cannot parse header of MITK chunked image " << path << ".";
+
+    const auto *imageElement = document.FirstChildElement("ChunkedImage");
+    if (imageElement == nullptr)
+      mitkThrow() << "Missing image description in MITK chunked image " << path << ".";
+
+    const char *byteOrder = imageElement->Attribute("ByteOrder");
+    const char *compression = imageElement->Attribute("Compression");
+    if (byteOrder == nullptr || std::string(byteOrder) != GetByteOrderName())
+      mitkThrow() << "Unsupported byte order of MITK chunked image " << path << ".";
+    if (compression == nullptr || std::string(compression) != "LZ4")
+      mitkThrow() << "Unsupported compression of MITK chunked image " << path << ".";
+
+    auto dimensions = FromString<unsigned int>(imageElement->Attribute("Dimensions"));
+    const auto origin = FromString<ScalarType>(imageElement->Attribute("Origin"));
+    const auto spacing = FromString<ScalarType>(imageElement->Attribute("Spacing"));
+    const auto direction = FromString<ScalarType>(imageElement->Attribute("Direction"));
+    const std::uint64_t chunkSize = imageElement->UnsignedAttribute("ChunkSize", DefaultChunkSize);
+
+    if (dimensions.size() < 2 || dimensions.size() > 4 || origin.size() != 3 || spacing.size() != 3 ||
+        direction.size() != 9 || chunkSize == 0 || chunkSize > LZ4_MAX_INPUT_SIZE)
+    {
+      mitkThrow() << "Invalid image description in MITK chunked image " << path << ".";
+    }
+
+    const unsigned int timeSteps = dimensions.size() == 4 ? dimensions[3] : 1;
+    const std::uint64_t numberOfVolumePixels = static_cast<std::uint64_t>(dimensions[0]) * dimensions[1] *
+                                               (dimensions.size() > 2 ? dimensions[2] : 1);
+
+    int timeStep = -1;
+    try
+    {
+      timeStep = us::any_cast<int>(this->GetReaderOption(OPTION_TIME_STEP()));
+    }
+    catch (const us::BadAnyCastException &e)
+    {
+      MITK_WARN << "Unexpected error: " << e.what();
+    }
+
+    if (timeStep >= static_cast<int>(timeSteps))
+      mitkThrow() << "Cannot read time step " << timeStep << " of MITK chunked image " << path << " with "
+                  << timeSteps << " time steps.";
+
+    const unsigned int firstTimeStep = timeStep < 0 ? 0 : timeStep;
+    const unsigned int numberOfReadTimeSteps = timeStep < 0 ? timeSteps : 1;
+    if (numberOfReadTimeSteps == 1 && dimensions.size() == 4)
+      dimensions.resize(3);
+
+    // the pixel type is described the way ITK image IOs do
+    auto pixelTypeDescription = itk::NrrdImageIO::New();
+    pixelTypeDescription->SetComponentType(
+      static_cast<itk::ImageIOBase::IOComponentType>(imageElement->IntAttribute("ComponentType")));
+    pixelTypeDescription->SetPixelType(
+      static_cast<itk::ImageIOBase::IOPixelType>(imageElement->IntAttribute("PixelType")));
+    pixelTypeDescription->SetNumberOfComponents(imageElement->UnsignedAttribute("NumberOfComponents", 1));
+
+    Image::Pointer image = Image::New();
+    image->Initialize(MakePixelType(pixelTypeDescription), dimensions.size(), dimensions.data());
+
+    // re-initialize PlaneGeometry with origin and direction
+    Point3D originPoint;
+    Vector3D spacingVector;
+    Matrix3D matrix;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      originPoint[i] = origin[i];
+      spacingVector[i] = spacing[i];
+      for (unsigned int j = 0; j < 3; ++j)
+        matrix[i][j] = direction[3 * i + j];
+    }
+
+    PlaneGeometry *planeGeometry = image->GetSlicedGeometry(0)->GetPlaneGeometry(0);
+    planeGeometry->SetOrigin(originPoint);
+    planeGeometry->GetIndexToWorldTransform()->SetMatrix(matrix);
+
+    // re-initialize SlicedGeometry3D
+    SlicedGeometry3D *slicedGeometry = image->GetSlicedGeometry(0);
+    slicedGeometry->InitializeEvenlySpaced(planeGeometry, image->GetDimension(2));
+    slicedGeometry->SetSpacing(spacingVector);
+
+    // re-initialize TimeGeometry
+    TimeGeometry::Pointer timeGeometry;
+    const char *timeGeometryType = imageElement->Attribute("TimeGeometry");
+    if (timeGeometryType != nullptr && ArbitraryTimeGeometry::GetStaticNameOfClass() == std::string(timeGeometryType))
+    {
+      auto timePointsData = itk::MetaDataObject<std::string>::New();
+      timePointsData->SetMetaDataObjectValue(imageElement->Attribute("TimePoints") != nullptr
+                                               ? imageElement->Attribute("TimePoints")
+                                               : "");
+      const auto timePoints = ConvertMetaDataObjectToTimePointList(timePointsData);
+
+      if (timePoints.size() == timeSteps + 1)
+      {
+        ArbitraryTimeGeometry::Pointer arbitraryTimeGeometry = ArbitraryTimeGeometry::New();
+        for (std::size_t t = 0; t + 1 < timePoints.size(); ++t)
+          arbitraryTimeGeometry->AppendNewTimeStepClone(slicedGeometry, timePoints[t], timePoints[t + 1]);
+        timeGeometry = arbitraryTimeGeometry;
+      }
+      else
+      {
+        MITK_ERROR << "Stored time points and size of image time dimension do not match. Switch to "
+                      "ProportionalTimeGeometry fallback";
+      }
+    }
+
+    if (timeGeometry.IsNull())
+    {
+      ProportionalTimeGeometry::Pointer propTimeGeometry = ProportionalTimeGeometry::New();
+      propTimeGeometry->Initialize(slicedGeometry, timeSteps);
+      timeGeometry = propTimeGeometry;
+    }
+
+    if (timeStep >= 0)
+    {
+      const auto timeBounds = timeGeometry->GetTimeBounds(timeStep);
+      ProportionalTimeGeometry::Pointer propTimeGeometry = ProportionalTimeGeometry::New();
+      propTimeGeometry->Initialize(slicedGeometry, 1);
+      propTimeGeometry->SetFirstTimePoint(timeBounds[0]);
+      propTimeGeometry->SetStepDuration(timeBounds[1] - timeBounds[0]);
+      timeGeometry = propTimeGeometry;
+    }
+
+    image->SetTimeGeometry(timeGeometry);
+
+    if (imageElement->Attribute("UID") != nullptr)
+    {
+      UIDManipulator uidManipulator(image);
+      uidManipulator.SetUID(imageElement->Attribute("UID"));
+    }
+
+    // chunk index
+    const auto numberOfChunks = ReadValue<std::uint64_t>(file);
+    const std::uint64_t volumeSize = image->GetPixelType().GetSize() * numberOfVolumePixels;
+    const std::uint64_t chunksPerTimeStep = (volumeSize + chunkSize - 1) / chunkSize;
+
+    if (!file || numberOfChunks != chunksPerTimeStep * timeSteps)
+      mitkThrow() << "Invalid chunk index in MITK chunked image " << path << ".";
+
+    std::vector<ChunkIndexEntry> index(numberOfChunks);
+    for (auto &entry : index)
+    {
+      entry.Offset = ReadValue<std::uint64_t>(file);
+      entry.CompressedSize = ReadValue<std::uint64_t>(file);
+      entry.Size = ReadValue<std::uint64_t>(file);
+    }
+
+    // compressed chunks are read serially in batches and decompressed in parallel
+    auto threader = itk::MultiThreader::New();
+    const auto batchSize = GetBatchSize(threader);
+    for (unsigned int t = 0; t < numberOfReadTimeSteps; ++t)
+    {
+      const auto *timeStepIndex = index.data() + (firstTimeStep + t) * chunksPerTimeStep;
+      ImageWriteAccessor accessor(image, image->GetVolumeData(t));
+      auto *volumeData = static_cast<char *>(accessor.GetData());
+
+      for (std::uint64_t firstChunk = 0; firstChunk < chunksPerTimeStep; firstChunk += batchSize)
+      {
+        const auto numberOfBatchChunks = std::min<std::uint64_t>(batchSize, chunksPerTimeStep - firstChunk);
+        std::vector<std::vector<char>> compressedChunks(numberOfBatchChunks);
+
+        for (std::uint64_t i = 0; i < numberOfBatchChunks; ++i)
+        {
+          const auto &entry = timeStepIndex[firstChunk + i];
+          const auto expectedSize = std::min(chunkSize, volumeSize - (firstChunk + i) * chunkSize);
+
+          if (entry.Size != expectedSize ||
+              entry.CompressedSize > static_cast<std::uint64_t>(LZ4_compressBound(static_cast<int>(entry.Size))))
+            mitkThrow() << "Invalid chunk index in MITK chunked image " << path << ".";
+
+          compressedChunks[i].resize(entry.CompressedSize);
+          file.seekg(entry.Offset);
+          file.read(compressedChunks[i].data(), entry.CompressedSize);
+        }
+
+        if (!file)
+          mitkThrow() << "Unexpected end of MITK chunked image " << path << ".";
+
+        ProcessChunks(threader, numberOfBatchChunks, [&](std::uint64_t i) {
+          const auto &entry = timeStepIndex[firstChunk + i];
+          const auto decompressedSize = LZ4_decompress_safe(compressedChunks[i].data(),
+                                                            volumeData + (firstChunk + i) * chunkSize,
+                                                            static_cast<int>(entry.CompressedSize),
+                                                            static_cast<int>(entry.Size));
+
+          if (decompressedSize < 0 || static_cast<std::uint64_t>(decompressedSize) != entry.Size)
+            mitkThrow() << "LZ4 decompression of MITK chunked image failed.";
+        });
+      }
+    }
+
+    std::vector<BaseData::Pointer> result;
+    result.push_back(image.GetPointer());
+    return result;
+  }
+
+  IFileIO::ConfidenceLevel ImageChunkedIO::GetReaderConfidenceLevel() const
+  {
+    if (AbstractFileIO::GetReaderConfidenceLevel() == Unsupported)
+      return Unsupported;
+
+    std::ifstream file(this->GetLocalFileName(), std::ios::binary);
+    return HasMagic(file) ? Supported : Unsupported;
+  }
+
+  void ImageChunkedIO::Write()
+  {
+    const auto *image = dynamic_cast<const Image *>(this->GetInput());
+
+    if (image == nullptr)
+      mitkThrow() << "Cannot write non-image data";
+
+    LocaleSwitch localeSwitch("C");
+
+    LocalFile localFile(this);
+    const std::string path = localFile.GetFileName();
+
+    MITK_INFO << "Writing image: " << path << std::endl;
+
+    const BaseGeometry *geometry = image->GetGeometry();
+    const auto pixelType = image->GetPixelType();
+    const auto spacing = geometry->GetSpacing();
+    const auto origin = geometry->GetOrigin();
+
+    ScalarType direction[9];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      for (unsigned int j = 0; j < 3; ++j)
+        direction[3 * i + j] = geometry->GetIndexToWorldTransform()->GetMatrix()[i][j] / spacing[j];
+    }
+
+    tinyxml2::XMLDocument document;
+    auto *imageElement = document.NewElement("ChunkedImage");
+    imageElement->SetAttribute("ByteOrder", GetByteOrderName());
+    imageElement->SetAttribute("Compression", "LZ4");
+    imageElement->SetAttribute("ChunkSize", static_cast<unsigned int>(DefaultChunkSize));
+    imageElement->SetAttribute("ComponentType", pixelType.GetComponentType());
+    imageElement->SetAttribute("PixelType", static_cast<int>(pixelType.GetPixelType()));
+    imageElement->SetAttribute("NumberOfComponents", static_cast<unsigned int>(pixelType.GetNumberOfComponents()));
+    imageElement->SetAttribute("Dimensions", ToString(image->GetDimensions(), image->GetDimension()).c_str());
+    imageElement->SetAttribute("Origin", ToString(origin.GetDataPointer(), 3).c_str());
+    imageElement->SetAttribute("Spacing", ToString(spacing.GetDataPointer(), 3).c_str());
+    imageElement->SetAttribute("Direction", ToString(direction, 9).c_str());
+    imageElement->SetAttribute("UID", image->GetUID().c_str());
+
+    if (dynamic_cast<const ArbitraryTimeGeometry *>(image->GetTimeGeometry()) != nullptr)
+    {
+      const auto timePoints = ConvertTimePointListToMetaDataObject(image->GetTimeGeometry());
+      imageElement->SetAttribute("TimeGeometry", ArbitraryTimeGeometry::GetStaticNameOfClass());
+      const auto *timePointsData = dynamic_cast<const itk::MetaDataObject<std::string> *>(timePoints.GetPointer());
+      imageElement->SetAttribute("TimePoints", timePointsData->GetMetaDataObjectValue().c_str());
+    }
+    else
+    {
+      imageElement->SetAttribute("TimeGeometry", ProportionalTimeGeometry::GetStaticNameOfClass());
+    }
+
+    document.InsertEndChild(imageElement);
+    tinyxml2::XMLPrinter printer;
+    document.Print(&printer);
+    const std::string header = printer.CStr();
+
+    const std::uint64_t volumeSize =
+      pixelType.GetSize() * image->GetDimension(0) * image->GetDimension(1) * image->GetDimension(2);
+    const std::uint64_t chunksPerTimeStep = (volumeSize + DefaultChunkSize - 1) / DefaultChunkSize;
+    const unsigned int timeSteps = image->GetTimeSteps();
+    std::vector<ChunkIndexEntry> index(chunksPerTimeStep * timeSteps);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+      mitkThrow() << "Cannot open " << path << " for writing.";
+
+    file.write(Magic, sizeof(Magic));
+    WriteValue<std::uint32_t>(file, Version);
+    WriteValue<std::uint64_t>(file, header.size());
+    file.write(header.data(), header.size());
+    WriteValue<std::uint64_t>(file, index.size());
+
+    // the index is written after the chunks, when their sizes are known
+    const auto indexPosition = file.tellp();
+    const std::vector<char> placeholder(index.size() * 3 * sizeof(std::uint64_t), 0);
+    file.write(placeholder.data(), placeholder.size());
+
+    // chunks are compressed in parallel in batches and written serially
+    auto threader = itk::MultiThreader::New();
+    const auto batchSize = GetBatchSize(threader);
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      ImageReadAccessor accessor(image, image->GetVolumeData(t));
+      const auto *volumeData = static_cast<const char *>(accessor.GetData());
+
+      for (std::uint64_t firstChunk = 0; firstChunk < chunksPerTimeStep; firstChunk += batchSize)
+      {
+        const auto numberOfBatchChunks = std::min<std::uint64_t>(batchSize, chunksPerTimeStep - firstChunk);
+        std::vector<std::vector<char>> compressedChunks(numberOfBatchChunks);
+
+        ProcessChunks(threader, numberOfBatchChunks, [&](std::uint64_t i) {
+          const auto chunk = firstChunk + i;
+          const auto size = static_cast<int>(std::min(DefaultChunkSize, volumeSize - chunk * DefaultChunkSize));
+
+          compressedChunks[i].resize(LZ4_compressBound(size));
+          const auto compressedSize = LZ4_compress_default(volumeData + chunk * DefaultChunkSize,
+                                                           compressedChunks[i].data(),
+                                                           size,
+                                                           static_cast<int>(compressedChunks[i].size()));
+
+          if (compressedSize <= 0)
+            mitkThrow() << "LZ4 compression failed!";
+
+          compressedChunks[i].resize(compressedSize);
+          index[t * chunksPerTimeStep + chunk].CompressedSize = compressedSize;
+          index[t * chunksPerTimeStep + chunk].Size = size;
+        });
+
+        for (std::uint64_t i = 0; i < numberOfBatchChunks; ++i)
+        {
+          index[t * chunksPerTimeStep + firstChunk + i].Offset = file.tellp();
+          file.write(compressedChunks[i].data(), compressedChunks[i].size());
+        }
+      }
+    }
+
+    file.seekp(indexPosition);
+    for (const auto &entry : index)
+    {
+      WriteValue(file, entry.Offset);
+      WriteValue(file, entry.CompressedSize);
+      WriteValue(file, entry.Size);
+    }
+
+    if (!file)
+      mitkThrow() << "Error while writing " << path << ".";
+  }
+
+  IFileIO::ConfidenceLevel ImageChunkedIO::GetWriterConfidenceLevel() const
+  {
+    if (AbstractFileIO::GetWriterConfidenceLevel() == Unsupported)
+      return Unsupported;
+
+    const auto *input = static_cast<const Image *>(this->GetInput());
+    if (input->GetDimension() < 2 || input->GetDimension() > 4)
+      return Unsupported;
+
+    // only the pixel data and geometry are stored, derived image types like LabelSetImage lose their additional data
+    return Image::GetStaticNameOfClass() == std::string(input->GetNameOfClass()) ? Supported : PartiallySupported;
+  }
+
+  ImageChunkedIO *ImageChunkedIO::IOClone() const { return new ImageChunkedIO(*this); }
+}
@@ -0,0 +1,75 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKIMAGECHUNKEDIO_H
+#define MITKIMAGECHUNKEDIO_H
+
+#include "mitkAbstractFileIO.h"
+
+namespace mitk
+{
+  /**
+   * @brief Reader and writer for images in the MITK chunked image format (*.mci).
+   *
+   * The pixel data of every time step is split into chunks of a fixed size which
+   * are LZ4 compressed independently. An index of all chunks follows the header, so
+   * chunks are compressed and decompressed in parallel and single time steps can be
+   * located without reading the preceding ones.
+   *
+   * The file starts with the magic "MITKCHNK", the format version (uint32) and the
+   * length (uint64) of an XML header describing pixel type, dimensions, geometry and
+   * time geometry. The header is followed by the number of chunks (uint64), one
+   * (offset, compressed size, size) triple of uint64 per chunk and the chunk data.
+   * These numbers are stored in little endian byte order. The pixel data is stored in
+   * the byte order of the writing system, which the header records as "ByteOrder".
+   * Files with a byte order different from the reading system are rejected.
+   *
+   * Only pixel data, geometry and UID are stored. Derived image types like
+   * LabelSetImage are therefore only partially supported by the writer, so the
+   * writers of these types are preferred for them.
+   *
+   * The format is used when saving with the .mci extension. SceneIO does not use it,
+   * scenes keep storing their images as NRRD files.
+   *
+   * The reader option OPTION_TIME_STEP() reads a single time step of a 3D+t image. Only
+   * the chunks of this time step are read and decompressed.
+   */
+  class ImageChunkedIO : public mitk::AbstractFileIO
+  {
+  public:
+    ImageChunkedIO();
+
+    /** Reader option (int, default -1) to read only the given time step. The result is an image
+     * with a single time step, whose time bounds are the ones of the time step in the file.
+     * Negative values read all time steps.*/
+    static std::string OPTION_TIME_STEP();
+
+    // -------------- AbstractFileReader -------------
+
+    using AbstractFileReader::Read;
+
+    ConfidenceLevel GetReaderConfidenceLevel() const override;
+
+    // -------------- AbstractFileWriter -------------
+
+    void Write() override;
+
+    ConfidenceLevel GetWriterConfidenceLevel() const override;
+
+  protected:
+    std::vector<itk::SmartPointer<BaseData>> DoRead() override;
+
+  private:
+    ImageChunkedIO *IOClone() const override;
+  };
+}
+#endif // MITKIMAGECHUNKEDIO_H
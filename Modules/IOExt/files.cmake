@@ -1,6 +1,7 @@
 set(CPP_FILES
   Internal/mitkIOExtActivator.cpp
   Internal/mitkIOExtObjectFactory.cpp
+  Internal/mitkImageChunkedIO.cpp
   Internal/mitkObjFileReaderService.cpp
   Internal/mitkPlyFileWriterService.cpp
   Internal/mitkPlyFileReaderService.cpp
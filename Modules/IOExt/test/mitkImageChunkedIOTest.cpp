@@ -0,0 +1,134 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkArbitraryTimeGeometry.h>
+#include <mitkIOUtil.h>
+#include <mitkImageGenerator.h>
+#include <mitkImageReadAccessor.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+class mitkImageChunkedIOTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageChunkedIOTestSuite);
+  MITK_TEST(WriteAndRead_3DImage_ReturnsEqualImage);
+  MITK_TEST(WriteAndRead_4DImageWithArbitraryTimeGeometry_ReturnsEqualImage);
+  MITK_TEST(Write_Image_StoresVersionInLittleEndian);
+  MITK_TEST(Read_TimeStepOption_ReturnsSingleTimeStep);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::string m_FilePath;
+
+  mitk::Image::Pointer WriteAndRead(const mitk::Image *image)
+  {
+    mitk::IOUtil::Save(image, m_FilePath);
+    return mitk::IOUtil::Load<mitk::Image>(m_FilePath);
+  }
+
+public:
+  void setUp() override { m_FilePath = mitk::IOUtil::CreateTemporaryFile("ChunkedImageTestXXXXXX.mci"); }
+
+  void tearDown() override { std::remove(m_FilePath.c_str()); }
+
+  void WriteAndRead_3DImage_ReturnsEqualImage()
+  {
+    // more than one chunk per volume
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<short>(300, 300, 30, 1, 0.5, 0.7, 2.0);
+    mitk::Point3D origin;
+    origin[0] = 10.0;
+    origin[1] = -20.5;
+    origin[2] = 3.25;
+    image->GetGeometry()->SetOrigin(origin);
+
+    mitk::Image::Pointer readImage = this->WriteAndRead(image);
+
+    CPPUNIT_ASSERT(readImage.IsNotNull());
+    CPPUNIT_ASSERT_MESSAGE("Read image equals written image.", mitk::Equal(*image, *readImage, mitk::eps, true));
+    CPPUNIT_ASSERT_EQUAL(image->GetUID(), readImage->GetUID());
+  }
+
+  void WriteAndRead_4DImageWithArbitraryTimeGeometry_ReturnsEqualImage()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<float>(40, 30, 20, 3);
+
+    auto timeGeometry = mitk::ArbitraryTimeGeometry::New();
+    timeGeometry->AppendNewTimeStepClone(image->GetGeometry(), 0.0, 1.5);
+    timeGeometry->AppendNewTimeStepClone(image->GetGeometry(), 1.5, 4.0);
+    timeGeometry->AppendNewTimeStepClone(image->GetGeometry(), 4.0, 10.0);
+    image->SetTimeGeometry(timeGeometry);
+
+    mitk::Image::Pointer readImage = this->WriteAndRead(image);
+
+    CPPUNIT_ASSERT(readImage.IsNotNull());
+    CPPUNIT_ASSERT(dynamic_cast<const mitk::ArbitraryTimeGeometry *>(readImage->GetTimeGeometry()) != nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Read image equals written image.", mitk::Equal(*image, *readImage, mitk::eps, true));
+  }
+
+  void Write_Image_StoresVersionInLittleEndian()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<unsigned char>(10, 10, 10);
+    mitk::IOUtil::Save(image, m_FilePath);
+
+    // the version follows the 8 byte magic
+    std::ifstream file(m_FilePath, std::ios::binary);
+    char version[4] = {};
+    file.seekg(8);
+    file.read(version, sizeof(version));
+
+    CPPUNIT_ASSERT(file.good());
+    CPPUNIT_ASSERT_EQUAL(1, static_cast<int>(version[0]));
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(version[1]));
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(version[2]));
+    CPPUNIT_ASSERT_EQUAL(0, static_cast<int>(version[3]));
+  }
+
+  void Read_TimeStepOption_ReturnsSingleTimeStep()
+  {
+    mitk::Image::Pointer image = mitk::ImageGenerator::GenerateRandomImage<short>(40, 30, 20, 3);
+
+    auto timeGeometry = mitk::ArbitraryTimeGeometry::New();
+    timeGeometry->AppendNewTimeStepClone(image->GetGeometry(), 0.0, 1.5);
+    timeGeometry->AppendNewTimeStepClone(image->GetGeometry(), 1.5, 4.0);
+    timeGeometry->AppendNewTimeStepClone(image->GetGeometry(), 4.0, 10.0);
+    image->SetTimeGeometry(timeGeometry);
+
+    mitk::IOUtil::Save(image, m_FilePath);
+
+    // see mitk::ImageChunkedIO::OPTION_TIME_STEP()
+    mitk::IFileReader::Options options;
+    options["Time step"] = us::Any(1);
+    mitk::Image::Pointer readImage = mitk::IOUtil::Load<mitk::Image>(m_FilePath, options);
+
+    CPPUNIT_ASSERT(readImage.IsNotNull());
+    CPPUNIT_ASSERT_EQUAL(1u, readImage->GetTimeSteps());
+    CPPUNIT_ASSERT_EQUAL(3u, readImage->GetDimension());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.5, readImage->GetTimeGeometry()->GetMinimumTimePoint(), mitk::eps);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, readImage->GetTimeGeometry()->GetMaximumTimePoint(), mitk::eps);
+
+    mitk::ImageReadAccessor expectedAccessor(image, image->GetVolumeData(1));
+    mitk::ImageReadAccessor readAccessor(readImage, readImage->GetVolumeData(0));
+    const std::size_t volumeSize = 40 * 30 * 20 * sizeof(short);
+    CPPUNIT_ASSERT_MESSAGE("Read time step equals the written one.",
+                           0 == std::memcmp(expectedAccessor.GetData(), readAccessor.GetData(), volumeSize));
+
+    options["Time step"] = us::Any(3);
+    CPPUNIT_ASSERT_THROW(mitk::IOUtil::Load(m_FilePath, options), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageChunkedIO)
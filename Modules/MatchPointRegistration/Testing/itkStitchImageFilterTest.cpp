@@ -25,6 +25,7 @@ class itkStitchImageFilterTestSuite : public mitk::TestFixture
   MITK_TEST(StitchWithNoTransformAndNoInterp);
   MITK_TEST(StitchWithNoInterp);
   MITK_TEST(Stitch);
+  MITK_TEST(StitchTiledMultiThreaded);
   CPPUNIT_TEST_SUITE_END();
 
   using InputImageType = mitk::TestImageType;
@@ -155,6 +156,33 @@ public:
     CPPUNIT_ASSERT(CheckPixels(output, { 1,2,3,4,5,6,7,8,9,10,20,30,40,50,60,70,80,90,100,200,300,250,350,450,550,650,750 }));
   }
 
+  void StitchTiledMultiThreaded()
+  {
+    using TranslationType = itk::TranslationTransform<double, 2>;
+    TranslationType::OutputVectorType offset;
+    offset[0] = 0;
+    offset[1] = -7.5;
+    auto translation1 = TranslationType::New();
+    translation1->SetOffset(offset);
+
+    offset[1] = -12.5;
+    auto translation2 = TranslationType::New();
+    translation2->SetOffset(offset);
+
+    m_Filter->SetInput(0, m_Input1);
+    m_Filter->SetInput(1, m_Input2, translation1, itk::NearestNeighborInterpolateImageFunction<InputImageType>::New());
+    m_Filter->SetInput(2, m_Input3, translation2);
+
+    FilterType::SizeType tileSize = { 2, 2 };
+    m_Filter->SetTileSize(tileSize);
+    m_Filter->SetNumberOfThreads(3);
+
+    m_Filter->Update();
+    auto output = m_Filter->GetOutput();
+
+    CPPUNIT_ASSERT(CheckPixels(output, { 1,2,3,4,5,6,7,8,9,10,20,30,40,50,60,70,80,90,100,200,300,250,350,450,550,650,750 }));
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(itkStitchImageFilter)
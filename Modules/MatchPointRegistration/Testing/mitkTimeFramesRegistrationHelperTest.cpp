@@ -14,6 +14,14 @@ found in the LICENSE file.
 #include "mitkTestFixture.h"
 
 #include "mitkTimeFramesRegistrationHelper.h"
+#include <mitkImageWriteAccessor.h>
+
+#include <mapAlgorithmIdentificationInterface.h>
+#include <mapDummyImageRegistrationAlgorithm.h>
+
+#include <itkCommand.h>
+
+mapGenerateAlgorithmUIDPolicyMacro(TimeFramesTestDummyRegIDPolicy, "de.dkfz.dipp", "Identity", "1.0.0", "");
 
 class mitkTimeFramesRegistrationHelperTestSuite : public mitk::TestFixture
 {
@@ -25,11 +33,41 @@ class mitkTimeFramesRegistrationHelperTestSuite : public mitk::TestFixture
   MITK_TEST(SetAllowUnregPixels_GetAllowUnregPixels);
   MITK_TEST(SetInterpolatorType_GetInterpolatorType);
   MITK_TEST(Set_Get_Clear_IgnoreList);
+  MITK_TEST(Generate_IdentityRegistration_ReturnsInputFrames);
   CPPUNIT_TEST_SUITE_END();
 private:
+  typedef map::algorithm::DummyImageRegistrationAlgorithm<map::core::discrete::Elements<3>::InternalImageType,
+    map::core::discrete::Elements<3>::InternalImageType, TimeFramesTestDummyRegIDPolicy> DummyRegType;
+
   mitk::TimeFramesRegistrationHelper::Pointer frameRegHelper;
   mitk::TimeFramesRegistrationHelper::IgnoreListType ignoreList;
 
+  struct ProgressCounter
+  {
+    explicit ProgressCounter(unsigned int& count) : m_Count(count) {}
+    void Count() { ++m_Count; }
+    unsigned int& m_Count;
+  };
+
+  /** Creates a 4D image with 4 frames whose voxels all have different values.*/
+  static mitk::Image::Pointer Generate4DImage()
+  {
+    const unsigned int dimensions[4] = { 12, 10, 8, 4 };
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(mitk::MakeScalarPixelType<float>(), 4, dimensions);
+
+    mitk::ImageWriteAccessor accessor(image);
+    auto* data = static_cast<float*>(accessor.GetData());
+    const std::size_t numberOfVoxels = dimensions[0] * dimensions[1] * dimensions[2] * dimensions[3];
+
+    for (std::size_t i = 0; i < numberOfVoxels; ++i)
+    {
+      data[i] = static_cast<float>(i % 97) + static_cast<float>(i / (dimensions[0] * dimensions[1] * dimensions[2]));
+    }
+
+    return image;
+  }
+
 public:
   void setUp() override
   {
@@ -102,6 +140,40 @@ public:
     CPPUNIT_ASSERT(frameRegHelper->GetIgnoreList().empty());
   }
 
+  void Generate_IdentityRegistration_ReturnsInputFrames()
+  {
+    mitk::Image::Pointer image = Generate4DImage();
+
+    frameRegHelper->Set4DImage(image);
+    frameRegHelper->SetAlgorithm(DummyRegType::New().GetPointer());
+    frameRegHelper->SetAlgorithmFactory([]() { return DummyRegType::New().GetPointer(); });
+    frameRegHelper->SetNumberOfThreads(2);
+    frameRegHelper->SetIgnoreList({ 2 });
+
+    unsigned int progressEvents = 0;
+    auto progressCommand = itk::SimpleMemberCommand<ProgressCounter>::New();
+    ProgressCounter counter(progressEvents);
+    progressCommand->SetCallbackFunction(&counter, &ProgressCounter::Count);
+    frameRegHelper->AddObserver(itk::ProgressEvent(), progressCommand);
+
+    frameRegHelper->Generate();
+    mitk::Image::Pointer result = frameRegHelper->GetRegisteredImage();
+
+    CPPUNIT_ASSERT(result.IsNotNull());
+    CPPUNIT_ASSERT_EQUAL(image->GetTimeSteps(), result->GetTimeSteps());
+    CPPUNIT_ASSERT_MESSAGE("Identity registration must not change the frames.",
+                           mitk::Equal(*image, *result, 1e-4, true));
+
+    CPPUNIT_ASSERT_EQUAL(3u, progressEvents);
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(1.0, frameRegHelper->GetProgress(), 1e-10);
+
+    const auto& timings = frameRegHelper->GetFrameTimings();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), timings.size());
+    CPPUNIT_ASSERT_EQUAL(mitk::TimeStepType(1), timings[0].Frame);
+    CPPUNIT_ASSERT_EQUAL(mitk::TimeStepType(3), timings[1].Frame);
+    CPPUNIT_ASSERT(!timings[0].WarmStarted && !timings[1].WarmStarted);
+  }
+
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkTimeFramesRegistrationHelper)
@@ -18,9 +18,12 @@ found in the LICENSE file.
 #include "itkImageRegionIterator.h"
 #include "itkImageToImageFilter.h"
 #include "itkLinearInterpolateImageFunction.h"
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkMatrix.h"
 #include "itkSize.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkDataObjectDecorator.h"
+#include "itkProgressReporter.h"
 
 
 namespace itk
@@ -55,6 +58,10 @@ namespace itk
  *
  * All other behaviors are similar to itk::ResampleImageFilter. See the filter's description for
  * more details.
+ *
+ * The output region of each thread is processed in tiles (see SetTileSize()). Only inputs whose
+ * mapped region can overlap a tile are evaluated for its pixels. For inputs with linear transforms
+ * the continuous input indices are computed incrementally along the output lines.
  */
 template< typename TInputImage,
           typename TOutputImage,
@@ -119,6 +126,9 @@ public:
   typedef typename LinearInterpolatorType::Pointer
   LinearInterpolatorPointerType;
 
+  typedef BSplineInterpolateImageFunction< InputImageType,
+                                           TInterpolatorPrecisionType >  BSplineInterpolatorType;
+
   /** Image size typedef. */
   typedef Size< itkGetStaticConstMacro(ImageDimension) > SizeType;
 
@@ -223,6 +233,11 @@ public:
   itkSetMacro(StitchStrategy, StitchStrategy);
   itkGetConstMacro(StitchStrategy, StitchStrategy);
 
+  /** Get/Set the size of the tiles the output region of a thread is split into.
+   * The default is 64 pixels in every direction. */
+  itkSetMacro(TileSize, SizeType);
+  itkGetConstReferenceMacro(TileSize, SizeType);
+
   /** StitchImageFilter produces an image which is a different size
    * than its input.  As such, it needs to provide an implementation
    * for GenerateOutputInformation() in order to inform the pipeline
@@ -298,6 +313,34 @@ protected:
 
   static std::string GetTransformInputName(unsigned int index);
 
+  /** Everything needed to evaluate an input within ThreadedGenerateData.*/
+  struct InputInfo
+  {
+    const InputImageType* image;
+    const TransformType* transform;
+    const InterpolatorType* interpolator;
+    /** set if the interpolator is a B-spline interpolator, which needs the thread id for a thread safe evaluation.*/
+    const BSplineInterpolatorType* bsplineInterpolator;
+    InputImageRegionType region;
+    typename InputImageType::IndexType lowerIndex;
+    typename InputImageType::IndexType upperIndex;
+    typename InputImageType::SpacingType spacing;
+    /** If the transform is linear, the mapping of output indices onto continuous input indices
+     * is affine: inputIndex = IndexMatrix * outputIndex + IndexOffset.*/
+    bool isLinear;
+    Matrix<TTransformPrecisionType, ImageDimension, ImageDimension> indexMatrix;
+    ContinuousInputIndexType indexOffset;
+  };
+
+  /** Maps a (continuous) output index onto the continuous index of the passed input.*/
+  ContinuousInputIndexType MapOutputIndex(const InputInfo& info,
+                                          const ContinuousIndex<TTransformPrecisionType, ImageDimension>& outputIndex) const;
+
+  /** Checks conservatively if the input may contribute to a pixel of the passed output region.*/
+  bool MayOverlap(const InputInfo& info, const OutputImageRegionType& region) const;
+
+  void GenerateTile(const OutputImageRegionType& tile, ThreadIdType threadId, ProgressReporter& progress);
+
 private:
   ITK_DISALLOW_COPY_AND_ASSIGN(StitchImageFilter);
 
@@ -320,6 +363,9 @@ private:
   IndexType       m_OutputStartIndex;     // output image start index
   bool            m_UseReferenceImage;
   StitchStrategy  m_StitchStrategy;
+  SizeType        m_TileSize;
+
+  std::vector<InputInfo> m_InputInfos;
 };
 } // end namespace itk
 
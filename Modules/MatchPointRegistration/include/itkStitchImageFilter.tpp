@@ -23,6 +23,8 @@ found in the LICENSE file.
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkSimpleDataObjectDecorator.h"
 
+#include <algorithm>
+#include <limits>
 #include <numeric>
 
 namespace itk
@@ -42,6 +44,7 @@ StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTrans
 
   m_Size.Fill( 0 );
   m_OutputStartIndex.Fill( 0 );
+  m_TileSize.Fill( 64 );
 
   m_OutputDirection.SetIdentity();
 
@@ -218,6 +221,51 @@ StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTrans
     interpolator.second->SetInputImage(interpolator.first);
   }
 
+  // Collect everything ThreadedGenerateData needs per input, so that no map
+  // lookups or index to point conversions are needed for linear transforms.
+  TransformMapType transforms = this->GetTransforms();
+  m_InputInfos.clear();
+
+  for (const auto& input : this->GetInputs())
+  {
+    InputInfo info;
+    info.image = input;
+    info.transform = transforms[input];
+    info.interpolator = m_Interpolators[input];
+    info.region = input->GetLargestPossibleRegion();
+    info.lowerIndex = info.region.GetIndex();
+    info.upperIndex = info.region.GetUpperIndex();
+    info.spacing = input->GetSpacing();
+
+    auto bsplineInterpolator = dynamic_cast<BSplineInterpolatorType*>(m_Interpolators[input].GetPointer());
+    if (nullptr != bsplineInterpolator && bsplineInterpolator->GetNumberOfThreads() != this->GetNumberOfThreads())
+    {
+      bsplineInterpolator->SetNumberOfThreads(this->GetNumberOfThreads());
+    }
+    info.bsplineInterpolator = bsplineInterpolator;
+
+    info.isLinear = info.transform->IsLinear();
+    if (info.isLinear)
+    {
+      ContinuousIndex<TTransformPrecisionType, ImageDimension> outputIndex;
+      outputIndex.Fill(0.);
+      info.indexOffset = this->MapOutputIndex(info, outputIndex);
+
+      for (unsigned int k = 0; k < ImageDimension; ++k)
+      {
+        outputIndex.Fill(0.);
+        outputIndex[k] = 1.;
+        const ContinuousInputIndexType column = this->MapOutputIndex(info, outputIndex);
+        for (unsigned int i = 0; i < ImageDimension; ++i)
+        {
+          info.indexMatrix[i][k] = column[i] - info.indexOffset[i];
+        }
+      }
+    }
+
+    m_InputInfos.push_back(info);
+  }
+
   unsigned int nComponents
     = DefaultConvertPixelTraits<PixelType>::GetNumberOfComponents(
         m_DefaultPixelValue );
@@ -244,6 +292,8 @@ void
 StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
 ::AfterThreadedGenerateData()
 {
+  m_InputInfos.clear();
+
   // Disconnect input image from the interpolator
   for (auto& interpolator : m_Interpolators)
   {
@@ -266,36 +316,63 @@ StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTrans
     return;
     }
 
-  // Get the output pointers
-  OutputImageType* outputPtr = this->GetOutput();
-  // Get this input pointers
-  InputImageVectorType inputs = this->GetInputs();
-  TransformMapType transforms = this->GetTransforms();
+  // Support for progress methods/callbacks
+  ProgressReporter progress(this,
+    threadId,
+    outputRegionForThread.GetNumberOfPixels());
+
+  const IndexType regionIndex = outputRegionForThread.GetIndex();
+  const SizeType regionSize = outputRegionForThread.GetSize();
 
-  std::map<const InputImageType*, typename InputImageType::IndexType> lowerIndices;
-  std::map<const InputImageType*, typename InputImageType::IndexType> upperIndices;
-  for (const auto& input : inputs)
+  // Walk the output region tile by tile
+  IndexType tileIndex = regionIndex;
+  bool tilesLeft = true;
+
+  while (tilesLeft)
   {
-    const auto largestRegion = input->GetLargestPossibleRegion();
-    lowerIndices[input] = largestRegion.GetIndex();
-    upperIndices[input] = largestRegion.GetUpperIndex();
-  }
+    OutputImageRegionType tile;
+    tile.SetIndex(tileIndex);
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      const auto tileSize = std::max<SizeValueType>(m_TileSize[i], 1);
+      tile.SetSize(i, std::min<SizeValueType>(tileSize, regionIndex[i] + regionSize[i] - tileIndex[i]));
+    }
 
-  // Create an iterator that will walk the output region for this thread.
-  typedef ImageRegionIteratorWithIndex< OutputImageType > OutputIterator;
-  OutputIterator outIt(outputPtr, outputRegionForThread);
+    this->GenerateTile(tile, threadId, progress);
 
-  // Define a few indices that will be used to translate from an input pixel
-  // to an output pixel
-  PointType outputPoint;         // Coordinates of current output pixel
-  PointType inputPoint;          // Coordinates of current input pixel
+    tilesLeft = false;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      tileIndex[i] += std::max<SizeValueType>(m_TileSize[i], 1);
+      if (tileIndex[i] < static_cast<IndexValueType>(regionIndex[i] + regionSize[i]))
+      {
+        tilesLeft = true;
+        break;
+      }
+      tileIndex[i] = regionIndex[i];
+    }
+  }
+}
 
-  ContinuousInputIndexType inputIndex;
+template< typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType >
+void
+StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::GenerateTile(const OutputImageRegionType & tile, ThreadIdType threadId, ProgressReporter& progress)
+{
+  OutputImageType* outputPtr = this->GetOutput();
 
-  // Support for progress methods/callbacks
-  ProgressReporter progress(this,
-    threadId,
-    outputRegionForThread.GetNumberOfPixels());
+  // Only inputs that may contribute to the tile are evaluated
+  std::vector<const InputInfo*> tileInputs;
+  for (const auto& info : m_InputInfos)
+  {
+    if (this->MayOverlap(info, tile))
+    {
+      tileInputs.push_back(&info);
+    }
+  }
 
   // Min/max values of the output pixel type AND these values
   // represented as the output type of the interpolator
@@ -306,62 +383,168 @@ StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTrans
   const ComponentType minOutputValue = static_cast<ComponentType>(minValue);
   const ComponentType maxOutputValue = static_cast<ComponentType>(maxValue);
 
-  // Walk the output region
-  outIt.GoToBegin();
+  std::vector<PixelType> pixvals;
+  std::vector<double> pixDistance;
+  pixvals.reserve(tileInputs.size());
+  pixDistance.reserve(tileInputs.size());
+
+  // Continuous input indices of the first pixel of the current line (linear transforms only)
+  std::vector<ContinuousInputIndexType> lineStartIndices(tileInputs.size());
+
+  PointType outputPoint;         // Coordinates of current output pixel
+  PointType inputPoint;          // Coordinates of current input pixel
+  ContinuousInputIndexType inputIndex;
+
+  typedef ImageScanlineIterator< OutputImageType > OutputIterator;
+  OutputIterator outIt(outputPtr, tile);
 
   while (!outIt.IsAtEnd())
   {
-    // Determine the index of the current output pixel
-    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), outputPoint);
+    const IndexType lineIndex = outIt.GetIndex();
 
-    std::vector<PixelType> pixvals;
-    std::vector<double> pixDistance;
+    for (std::size_t j = 0; j < tileInputs.size(); ++j)
+    {
+      const InputInfo& info = *(tileInputs[j]);
+      if (info.isLinear)
+      {
+        for (unsigned int i = 0; i < ImageDimension; ++i)
+        {
+          lineStartIndices[j][i] = info.indexOffset[i];
+          for (unsigned int k = 0; k < ImageDimension; ++k)
+          {
+            lineStartIndices[j][i] += info.indexMatrix[i][k] * lineIndex[k];
+          }
+        }
+      }
+    }
 
-    for (const auto& input : inputs)
+    for (IndexValueType x = 0; !outIt.IsAtEndOfLine(); ++x, ++outIt)
     {
-      // Compute corresponding input pixel position
-      inputPoint = transforms[input]->TransformPoint(outputPoint);
-      const bool isInsideInput = input->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+      pixvals.clear();
+      pixDistance.clear();
+      bool hasOutputPoint = false;
 
-      // Evaluate input at right position and copy to the output
-      if (m_Interpolators[input]->IsInsideBuffer(inputIndex) && isInsideInput)
+      for (std::size_t j = 0; j < tileInputs.size(); ++j)
       {
-        OutputType value = m_Interpolators[input]->EvaluateAtContinuousIndex(inputIndex);
-        pixvals.emplace_back(this->CastPixelWithBoundsChecking(value, minOutputValue, maxOutputValue));
+        const InputInfo& info = *(tileInputs[j]);
 
-        ContinuousInputIndexType indexDistance;
-        const auto spacing = input->GetSpacing();
+        // Compute corresponding input pixel position
+        if (info.isLinear)
+        {
+          for (unsigned int i = 0; i < ImageDimension; ++i)
+          {
+            inputIndex[i] = lineStartIndices[j][i] + x * info.indexMatrix[i][0];
+          }
+        }
+        else
+        {
+          if (!hasOutputPoint)
+          {
+            outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), outputPoint);
+            hasOutputPoint = true;
+          }
+          inputPoint = info.transform->TransformPoint(outputPoint);
+          info.image->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+        }
 
-        double minBorderDistance = std::numeric_limits<double>::max();
-        for (unsigned int i = 0; i < ImageDimension; ++i)
+        // Evaluate input at right position and copy to the output
+        if (info.region.IsInside(inputIndex) && info.interpolator->IsInsideBuffer(inputIndex))
         {
-          minBorderDistance = std::min(minBorderDistance, std::min(std::abs(lowerIndices[input][i] - inputIndex[i]) * spacing[i], std::abs(upperIndices[input][i] - inputIndex[i]) * spacing[i]));
+          const OutputType value = nullptr != info.bsplineInterpolator
+            ? info.bsplineInterpolator->EvaluateAtContinuousIndex(inputIndex, threadId)
+            : info.interpolator->EvaluateAtContinuousIndex(inputIndex);
+          pixvals.emplace_back(this->CastPixelWithBoundsChecking(value, minOutputValue, maxOutputValue));
+
+          double minBorderDistance = std::numeric_limits<double>::max();
+          for (unsigned int i = 0; i < ImageDimension; ++i)
+          {
+            minBorderDistance = std::min(minBorderDistance, std::min(std::abs(info.lowerIndex[i] - inputIndex[i]) * info.spacing[i], std::abs(info.upperIndex[i] - inputIndex[i]) * info.spacing[i]));
+          }
+          pixDistance.emplace_back(minBorderDistance);
         }
-        pixDistance.emplace_back(minBorderDistance);
       }
-    }
 
-    if (!pixvals.empty())
-    { //at least one input provided a value
-      if (StitchStrategy::Mean == m_StitchStrategy)
-      {
-        double sum = std::accumulate(pixvals.begin(), pixvals.end(), 0.0);
-        outIt.Set(sum / pixvals.size());
+      if (!pixvals.empty())
+      { //at least one input provided a value
+        if (StitchStrategy::Mean == m_StitchStrategy)
+        {
+          double sum = std::accumulate(pixvals.begin(), pixvals.end(), 0.0);
+          outIt.Set(sum / pixvals.size());
+        }
+        else
+        {
+          auto finding = std::max_element(pixDistance.begin(), pixDistance.end());
+          outIt.Set(pixvals[std::distance(pixDistance.begin(), finding)]);
+        }
       }
       else
       {
-        auto finding = std::max_element(pixDistance.begin(), pixDistance.end());
-        outIt.Set(pixvals[std::distance(pixDistance.begin(), finding)]);
+        outIt.Set(m_DefaultPixelValue); // default background value
       }
+
+      progress.CompletedPixel();
     }
-    else
+
+    outIt.NextLine();
+  }
+}
+
+template< typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType >
+typename StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::ContinuousInputIndexType
+StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::MapOutputIndex(const InputInfo& info, const ContinuousIndex<TTransformPrecisionType, ImageDimension>& outputIndex) const
+{
+  PointType outputPoint;
+  this->GetOutput()->TransformContinuousIndexToPhysicalPoint(outputIndex, outputPoint);
+  const PointType inputPoint = info.transform->TransformPoint(outputPoint);
+
+  ContinuousInputIndexType inputIndex;
+  info.image->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+  return inputIndex;
+}
+
+template< typename TInputImage,
+          typename TOutputImage,
+          typename TInterpolatorPrecisionType,
+          typename TTransformPrecisionType >
+bool
+StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTransformPrecisionType >
+::MayOverlap(const InputInfo& info, const OutputImageRegionType& region) const
+{
+  if (!info.isLinear)
+  {
+    // no cheap way to bound the mapped region, so the input is always considered
+    return true;
+  }
+
+  const IndexType lower = region.GetIndex();
+  const IndexType upper = region.GetUpperIndex();
+
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    // bounding interval of the mapped pixel centers of the region
+    double minIndex = info.indexOffset[i];
+    double maxIndex = info.indexOffset[i];
+    for (unsigned int k = 0; k < ImageDimension; ++k)
     {
-      outIt.Set(m_DefaultPixelValue); // default background value
+      const double a = info.indexMatrix[i][k] * lower[k];
+      const double b = info.indexMatrix[i][k] * upper[k];
+      minIndex += std::min(a, b);
+      maxIndex += std::max(a, b);
     }
 
-    progress.CompletedPixel();
-    ++outIt;
+    // one pixel margin, inputs cover their continuous index range +/-0.5
+    if (maxIndex < info.lowerIndex[i] - 1. || minIndex > info.upperIndex[i] + 1.)
+    {
+      return false;
+    }
   }
+
+  return true;
 }
 
 template< typename TInputImage,
@@ -557,6 +740,7 @@ StitchImageFilter< TInputImage, TOutputImage, TInterpolatorPrecisionType, TTrans
   os << indent << "OutputSpacing: " << m_OutputSpacing << std::endl;
   os << indent << "OutputOrigin: " << m_OutputOrigin << std::endl;
   os << indent << "OutputDirection: " << m_OutputDirection << std::endl;
+  os << indent << "TileSize: " << m_TileSize << std::endl;
   for (const auto& interpolator : m_Interpolators)
   {
     os << indent << "Interpolator: " << interpolator.second.GetPointer() << std::endl;
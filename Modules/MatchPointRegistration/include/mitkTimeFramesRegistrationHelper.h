@@ -24,6 +24,8 @@ found in the LICENSE file.
 
 #include "MitkMatchPointRegistrationExports.h"
 
+#include <functional>
+
 namespace mitk
 {
 
@@ -39,6 +41,12 @@ namespace mitk
    * - mitk::FrameRegistrationEvent: when ever a frame was registered.
    * - mitk::FrameMappingEvent: when ever a frame was mapped registered.
    * - itk::ProgressEvent: when ever a new frame was added to the result image.
+   *
+   * Frames are registered concurrently (see SetNumberOfThreads()). Every thread needs its own instance of the
+   * registration algorithm. If no algorithm factory is set (see SetAlgorithmFactory()), the helper tries to duplicate
+   * the algorithm via its meta properties; if this is not possible, the frames are processed sequentially. All events
+   * are invoked by the thread that called Generate(). Each mapped frame is copied into the result image as soon as
+   * it is available, so at most one moving and one mapped frame per thread are kept in memory.
    */
   class MITKMATCHPOINTREGISTRATION_EXPORT TimeFramesRegistrationHelper : public itk::Object
   {
@@ -54,6 +62,20 @@ namespace mitk
 
     typedef std::vector<mitk::TimeStepType> IgnoreListType;
 
+    /** Function that returns a new, independent instance of the registration algorithm with the same settings.*/
+    typedef std::function<RegistrationAlgorithmPointer()> AlgorithmFactoryType;
+
+    /** Processing statistics of a registered frame. Times are given in seconds.*/
+    struct FrameTimingInfo
+    {
+      mitk::TimeStepType Frame;
+      double RegistrationTime;
+      double MappingTime;
+      /** Indicates if the registration was initialized with the registration of the preceding frame.*/
+      bool WarmStarted;
+    };
+    typedef std::vector<FrameTimingInfo> FrameTimingListType;
+
     itkSetConstObjectMacro(4DImage, Image);
     itkGetConstObjectMacro(4DImage, Image);
 
@@ -83,6 +105,25 @@ namespace mitk
     void SetIgnoreList(const IgnoreListType& il);
     itkGetConstMacro(IgnoreList, IgnoreListType);
 
+    /** Maximum number of frames that are registered concurrently. 0 (default) uses one thread per core.*/
+    itkSetMacro(NumberOfThreads, unsigned int);
+    itkGetConstMacro(NumberOfThreads, unsigned int);
+
+    /** If set, the registration of a frame is initialized with the registration of the preceding registered frame.
+     * The moving frame is premapped with this registration and the result of the algorithm is combined with it.
+     * For concurrent processing the frames are split into one contiguous block per thread; the first frame of a block
+     * is not warm started. Default is false.*/
+    itkSetMacro(WarmStart, bool);
+    itkGetConstMacro(WarmStart, bool);
+    itkBooleanMacro(WarmStart);
+
+    /** Sets the factory used to create the algorithm instances of additional threads. The algorithm set via
+     * SetAlgorithm() is always used by the first thread.*/
+    void SetAlgorithmFactory(const AlgorithmFactoryType& factory);
+
+    /** Timing information of all frames registered by the last call of Generate(), sorted by frame.*/
+    const FrameTimingListType& GetFrameTimings() const;
+
     virtual double GetProgress() const;
 
     /** Commences the generation of the registered 4D image. Stores the result internally.
@@ -110,6 +151,8 @@ namespace mitk
       m_AllowUnregPixels(true),
       m_ErrorValue(0),
       m_InterpolatorType(mitk::ImageMappingInterpolator::Linear),
+      m_NumberOfThreads(0),
+      m_WarmStart(false),
       m_Progress(0)
     {
       m_4DImage = nullptr;
@@ -122,6 +165,12 @@ namespace mitk
     RegistrationPointer DoFrameRegistration(const mitk::Image* movingFrame,
                                             const mitk::Image* targetFrame, const mitk::Image* targetMask) const;
 
+    /** Registers the moving frame with the passed algorithm instance. If initialRegistration is set, the moving frame
+     * is premapped with it and the returned registration is the combination of both.*/
+    RegistrationPointer DoFrameRegistration(RegistrationAlgorithmBaseType* algorithm, const mitk::Image* movingFrame,
+                                            const mitk::Image* targetFrame, const mitk::Image* targetMask,
+                                            const RegistrationType* initialRegistration) const;
+
     mitk::Image::Pointer DoFrameMapping(const mitk::Image* movingFrame, const RegistrationType* reg,
                                         const mitk::Image* targetFrame) const;
 
@@ -132,7 +181,11 @@ namespace mitk
 
     mitk::Image::Pointer GetFrameImage(const mitk::Image* image, mitk::TimePointType timePoint) const;
 
+    /** Returns one algorithm instance per thread (at most maxCount). The first one is m_Algorithm.*/
+    std::vector<RegistrationAlgorithmPointer> GetAlgorithmInstances(unsigned int maxCount) const;
+
     RegistrationAlgorithmPointer m_Algorithm;
+    AlgorithmFactoryType m_AlgorithmFactory;
 
   private:
     Image::ConstPointer m_4DImage;
@@ -152,6 +205,11 @@ namespace mitk
     /** Type of interpolator. Only relevant for images and if m_doGeometryRefinement is false. */
     mitk::ImageMappingInterpolator::Type m_InterpolatorType;
 
+    unsigned int m_NumberOfThreads;
+    bool m_WarmStart;
+
+    FrameTimingListType m_FrameTimings;
+
     double m_Progress;
   };
 
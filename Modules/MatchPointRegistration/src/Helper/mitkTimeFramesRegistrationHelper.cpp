@@ -19,6 +19,91 @@ found in the LICENSE file.
 #include <mitkMaskedAlgorithmHelper.h>
 #include <mitkMAPAlgorithmHelper.h>
 
+#include <mapMetaPropertyAlgorithmInterface.h>
+#include <mapRegistration.h>
+#include <mapRegistrationCombinator.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+  typedef mitk::TimeFramesRegistrationHelper HelperType;
+  typedef ::map::core::Registration<3, 3> Registration3DType;
+  typedef ::map::algorithm::facet::MetaPropertyAlgorithmInterface MetaPropertyInterfaceType;
+
+  /** Creates a new instance of the algorithm and copies all meta properties of the algorithm to it.
+   * Returns nullptr if the algorithm does not support meta properties or a property cannot be copied.*/
+  HelperType::RegistrationAlgorithmPointer CloneAlgorithm(HelperType::RegistrationAlgorithmBaseType* algorithm)
+  {
+    auto sourceInterface = dynamic_cast<MetaPropertyInterfaceType*>(algorithm);
+
+    if (nullptr == sourceInterface)
+    {
+      return nullptr;
+    }
+
+    ::itk::LightObject::Pointer another = algorithm->CreateAnother();
+    HelperType::RegistrationAlgorithmPointer clone =
+      dynamic_cast<HelperType::RegistrationAlgorithmBaseType*>(another.GetPointer());
+    auto cloneInterface = dynamic_cast<MetaPropertyInterfaceType*>(clone.GetPointer());
+
+    if (nullptr == cloneInterface)
+    {
+      return nullptr;
+    }
+
+    const MetaPropertyInterfaceType::MetaPropertyVectorType sourceInfos = sourceInterface->getPropertyInfos();
+    const MetaPropertyInterfaceType::MetaPropertyVectorType cloneInfos = cloneInterface->getPropertyInfos();
+
+    for (const auto& cloneInfo : cloneInfos)
+    {
+      if (!cloneInfo->isWritable())
+      {
+        continue;
+      }
+
+      for (const auto& sourceInfo : sourceInfos)
+      {
+        if (sourceInfo->isReadable() && sourceInfo->getName() == cloneInfo->getName())
+        {
+          MetaPropertyInterfaceType::MetaPropertyPointer property = sourceInterface->getProperty(sourceInfo);
+
+          if (property.IsNull() || !cloneInterface->setProperty(cloneInfo, property))
+          {
+            return nullptr;
+          }
+          break;
+        }
+      }
+    }
+
+    return clone;
+  }
+
+  /** Copies a time step of the image without using a pipeline, so it can be called from several threads.*/
+  mitk::Image::Pointer ExtractFrame(const mitk::Image* image, mitk::TimeStepType timeStep)
+  {
+    mitk::Image::Pointer frame = mitk::Image::New();
+    frame->Initialize(image->GetPixelType(), *(image->GetTimeGeometry()->GetGeometryForTimeStep(timeStep)));
+
+    mitk::ImageReadAccessor accessor(image, image->GetVolumeData(timeStep));
+    frame->SetVolume(accessor.GetData());
+
+    return frame;
+  }
+
+  double SecondsSince(const std::chrono::steady_clock::time_point& start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}
+
 mitk::Image::Pointer
 mitk::TimeFramesRegistrationHelper::GetFrameImage(const mitk::Image* image,
     mitk::TimePointType timePoint) const
@@ -40,8 +125,6 @@ mitk::TimeFramesRegistrationHelper::Generate()
   //prepare processing
   mitk::Image::Pointer targetFrame = GetFrameImage(this->m_4DImage, 0);
 
-  this->m_Registered4DImage = this->m_4DImage->Clone();
-
   Image::ConstPointer mask;
 
   if (m_TargetMask.IsNotNull())
@@ -56,51 +139,206 @@ mitk::TimeFramesRegistrationHelper::Generate()
     }
   }
 
-  double progressDelta = 1.0 / ((this->m_4DImage->GetTimeSteps() - 1) * 3.0);
+  const TimeStepType timeSteps = this->m_4DImage->GetTimeSteps();
+
+  //the result is filled frame by frame instead of cloning the complete input first
+  this->m_Registered4DImage = mitk::Image::New();
+  this->m_Registered4DImage->Initialize(this->m_4DImage);
+  this->m_Registered4DImage->SetPropertyList(this->m_4DImage->GetPropertyList()->Clone());
+
+  double progressDelta = 1.0 / ((timeSteps - 1) * 3.0);
   m_Progress = 0.0;
+  m_FrameTimings.clear();
 
-  //process the frames
-  for (unsigned int i = 1; i < this->m_4DImage->GetTimeSteps(); ++i)
+  //copy the target frame and the ignored frames, collect the frames to process
+  std::vector<TimeStepType> frames;
+
+  for (TimeStepType i = 0; i < timeSteps; ++i)
   {
-    Image::Pointer movingFrame = GetFrameImage(this->m_4DImage, i);
+    if (0 != i && std::find(m_IgnoreList.begin(), m_IgnoreList.end(), i) == m_IgnoreList.end())
+    {
+      frames.push_back(i);
+      continue;
+    }
+
+    mitk::ImageReadAccessor accessor(this->m_4DImage, this->m_4DImage->GetVolumeData(i));
+    this->m_Registered4DImage->SetVolume(accessor.GetData(), i);
+
+    if (0 != i)
+    {
+      m_Progress += 3 * progressDelta;
+      this->InvokeEvent(::itk::ProgressEvent());
+    }
+  }
+
+  if (frames.empty())
+  {
+    return;
+  }
+
+  unsigned int numberOfThreads = m_NumberOfThreads > 0 ? m_NumberOfThreads : std::thread::hardware_concurrency();
+  numberOfThreads = std::max(1u, std::min(numberOfThreads, static_cast<unsigned int>(frames.size())));
+  const std::vector<RegistrationAlgorithmPointer> algorithms = this->GetAlgorithmInstances(numberOfThreads);
+  numberOfThreads = static_cast<unsigned int>(algorithms.size());
+
+  struct FrameResult
+  {
+    FrameTimingInfo timing;
     Image::Pointer mappedFrame;
+  };
+
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::deque<FrameResult> results;
+  std::size_t nextFrame = 0;
+  unsigned int activeThreads = numberOfThreads;
+  bool abort = false;
+  std::exception_ptr error;
+
+  //Without warm start the frames are handed out one by one. With warm start every thread processes a contiguous
+  //block of frames, so each frame can be initialized with the registration of its predecessor.
+  auto processFrames = [&](unsigned int threadIndex)
+  {
+    const std::size_t blockEnd = frames.size() * (threadIndex + 1) / numberOfThreads;
+    std::size_t blockPos = frames.size() * threadIndex / numberOfThreads;
+    RegistrationPointer previousRegistration;
+
+    try
+    {
+      while (true)
+      {
+        std::size_t pos = 0;
+
+        {
+          //limits the number of mapped frames that wait for being copied into the result
+          std::unique_lock<std::mutex> lock(mutex);
+          condition.wait(lock, [&] { return abort || results.size() < numberOfThreads; });
+
+          if (abort || (m_WarmStart ? blockPos == blockEnd : nextFrame == frames.size()))
+          {
+            break;
+          }
+
+          pos = m_WarmStart ? blockPos++ : nextFrame++;
+        }
+
+        FrameResult result;
+        result.timing.Frame = frames[pos];
+        result.timing.WarmStarted = previousRegistration.IsNotNull();
+
+        Image::Pointer movingFrame = ExtractFrame(this->m_4DImage, frames[pos]);
+
+        auto start = std::chrono::steady_clock::now();
+        RegistrationPointer reg =
+          DoFrameRegistration(algorithms[threadIndex], movingFrame, targetFrame, mask, previousRegistration);
+        result.timing.RegistrationTime = SecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        result.mappedFrame = DoFrameMapping(movingFrame, reg, targetFrame);
+        result.timing.MappingTime = SecondsSince(start);
+
+        if (m_WarmStart && nullptr != dynamic_cast<const Registration3DType*>(reg.GetPointer()))
+        {
+          previousRegistration = reg;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        results.push_back(std::move(result));
+        condition.notify_all();
+      }
+    }
+    catch (...)
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (!error)
+      {
+        error = std::current_exception();
+      }
+      abort = true;
+    }
 
-    IgnoreListType::iterator finding = std::find(m_IgnoreList.begin(), m_IgnoreList.end(), i);
+    std::lock_guard<std::mutex> lock(mutex);
+    --activeThreads;
+    condition.notify_all();
+  };
 
+  std::vector<std::thread> threads;
+  threads.reserve(numberOfThreads);
 
-    if (finding == m_IgnoreList.end())
+  for (unsigned int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+  {
+    threads.emplace_back(processFrames, threadIndex);
+  }
+
+  //copy the mapped frames into the result and invoke the events in the calling thread
+  try
+  {
+    while (true)
     {
-      //frame should be processed
-      RegistrationPointer reg = DoFrameRegistration(movingFrame, targetFrame, mask);
+      FrameResult result;
+
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&] { return !results.empty() || 0 == activeThreads; });
+
+        if (results.empty())
+        {
+          break;
+        }
+
+        result = std::move(results.front());
+        results.pop_front();
+        condition.notify_all();
+      }
+
+      const TimeStepType i = result.timing.Frame;
 
       m_Progress += progressDelta;
       this->InvokeEvent(::mitk::FrameRegistrationEvent(nullptr,
                         "Registred frame #" +::map::core::convert::toStr(i)));
 
-      mappedFrame = DoFrameMapping(movingFrame, reg, targetFrame);
-
       m_Progress += progressDelta;
       this->InvokeEvent(::mitk::FrameMappingEvent(nullptr,
                         "Mapped frame #" + ::map::core::convert::toStr(i)));
 
-      mitk::ImageReadAccessor accessor(mappedFrame, mappedFrame->GetVolumeData(0, 0, nullptr,
-                                       mitk::Image::ReferenceMemory));
+      {
+        mitk::ImageReadAccessor accessor(result.mappedFrame, result.mappedFrame->GetVolumeData(0, 0, nullptr,
+                                         mitk::Image::ReferenceMemory));
 
+        this->m_Registered4DImage->SetVolume(accessor.GetData(), i);
+      }
+      this->m_Registered4DImage->GetTimeGeometry()->SetTimeStepGeometry(result.mappedFrame->GetGeometry(), i);
 
-      this->m_Registered4DImage->SetVolume(accessor.GetData(), i);
-      this->m_Registered4DImage->GetTimeGeometry()->SetTimeStepGeometry(mappedFrame->GetGeometry(), i);
+      m_FrameTimings.push_back(result.timing);
 
       m_Progress += progressDelta;
+      this->InvokeEvent(::itk::ProgressEvent());
     }
-    else
+  }
+  catch (...)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error)
     {
-      m_Progress += 3 * progressDelta;
+      error = std::current_exception();
     }
+    abort = true;
+    condition.notify_all();
+  }
 
-    this->InvokeEvent(::itk::ProgressEvent());
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
 
+  if (error)
+  {
+    this->m_Registered4DImage = nullptr;
+    std::rethrow_exception(error);
   }
 
+  std::sort(m_FrameTimings.begin(), m_FrameTimings.end(),
+            [](const FrameTimingInfo& a, const FrameTimingInfo& b) { return a.Frame < b.Frame; });
 };
 
 mitk::Image::Pointer
@@ -129,18 +367,88 @@ mitk::TimeFramesRegistrationHelper::ClearIgnoreList()
   this->Modified();
 };
 
+void
+mitk::TimeFramesRegistrationHelper::SetAlgorithmFactory(const AlgorithmFactoryType& factory)
+{
+  m_AlgorithmFactory = factory;
+  this->Modified();
+};
+
+const mitk::TimeFramesRegistrationHelper::FrameTimingListType&
+mitk::TimeFramesRegistrationHelper::GetFrameTimings() const
+{
+  return m_FrameTimings;
+};
+
+std::vector<mitk::TimeFramesRegistrationHelper::RegistrationAlgorithmPointer>
+mitk::TimeFramesRegistrationHelper::GetAlgorithmInstances(unsigned int maxCount) const
+{
+  std::vector<RegistrationAlgorithmPointer> algorithms = { m_Algorithm };
+
+  while (algorithms.size() < maxCount)
+  {
+    RegistrationAlgorithmPointer instance = m_AlgorithmFactory ? m_AlgorithmFactory() : CloneAlgorithm(m_Algorithm);
+
+    if (instance.IsNull() || instance == m_Algorithm)
+    {
+      if (algorithms.size() == 1)
+      {
+        MITK_INFO << "Registration algorithm cannot be duplicated. Frames are registered sequentially.";
+      }
+      break;
+    }
+
+    algorithms.push_back(instance);
+  }
+
+  return algorithms;
+};
+
 
 mitk::TimeFramesRegistrationHelper::RegistrationPointer
 mitk::TimeFramesRegistrationHelper::DoFrameRegistration(const mitk::Image* movingFrame,
     const mitk::Image* targetFrame, const mitk::Image* targetMask) const
 {
-  mitk::MAPAlgorithmHelper algHelper(m_Algorithm);
+  return DoFrameRegistration(m_Algorithm, movingFrame, targetFrame, targetMask, nullptr);
+};
+
+mitk::TimeFramesRegistrationHelper::RegistrationPointer
+mitk::TimeFramesRegistrationHelper::DoFrameRegistration(RegistrationAlgorithmBaseType* algorithm,
+    const mitk::Image* movingFrame, const mitk::Image* targetFrame, const mitk::Image* targetMask,
+    const RegistrationType* initialRegistration) const
+{
+  const auto initialRegistration3D = dynamic_cast<const Registration3DType*>(initialRegistration);
+
+  if (nullptr != initialRegistration3D)
+  {
+    //premap the moving frame, so that the algorithm only has to determine the remaining motion
+    Image::Pointer premappedFrame = mitk::ImageMappingHelper::map(movingFrame, initialRegistration, false,
+                                    m_PaddingValue, targetFrame->GetGeometry(), false, m_ErrorValue, m_InterpolatorType);
+
+    RegistrationPointer residualRegistration =
+      DoFrameRegistration(algorithm, premappedFrame, targetFrame, targetMask, nullptr);
+    const auto residualRegistration3D = dynamic_cast<const Registration3DType*>(residualRegistration.GetPointer());
+
+    if (nullptr == residualRegistration3D)
+    {
+      mitkThrow() << "Cannot warm start frame registration. Algorithm does not determine 3D registrations.";
+    }
+
+    typedef ::map::core::RegistrationCombinator<Registration3DType, Registration3DType> CombinatorType;
+    CombinatorType::Pointer combinator = CombinatorType::New();
+    Registration3DType::Pointer combinedRegistration =
+      combinator->process(*initialRegistration3D, *residualRegistration3D);
+
+    return combinedRegistration.GetPointer();
+  }
+
+  mitk::MAPAlgorithmHelper algHelper(algorithm);
   algHelper.SetAllowImageCasting(true);
   algHelper.SetData(movingFrame, targetFrame);
 
   if (targetMask)
   {
-    mitk::MaskedAlgorithmHelper maskHelper(m_Algorithm);
+    mitk::MaskedAlgorithmHelper maskHelper(algorithm);
     maskHelper.SetMasks(nullptr, targetMask);
   }
 
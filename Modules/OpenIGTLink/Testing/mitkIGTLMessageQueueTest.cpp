@@ -0,0 +1,194 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+//TEST
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+
+//MITK
+#include "mitkIGTLMessageQueue.h"
+
+//IGTL
+#include "igtlStatusMessage.h"
+
+class mitkIGTLMessageQueueTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkIGTLMessageQueueTestSuite);
+  MITK_TEST(Test_TransformsOfSameDevice_Coalesced);
+  MITK_TEST(Test_ImagesExceedingCapacity_OldestDropped);
+  MITK_TEST(Test_CommandsWithoutBuffering_KeptInOrder);
+  MITK_TEST(Test_NoBufferingMode_SingleMiscMessage);
+  MITK_TEST(Test_PulledMessages_Counted);
+  MITK_TEST(Test_DefaultCapacity_Unbounded);
+  MITK_TEST(Test_CommandsExceedingCapacity_DroppedAndCounted);
+  MITK_TEST(Test_NullCommand_Accepted);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::IGTLMessageQueue::Pointer m_Queue;
+
+  static igtl::TransformMessage::Pointer CreateTransformMessage(const std::string& deviceName, float x)
+  {
+    igtl::TransformMessage::Pointer message = igtl::TransformMessage::New();
+    message->SetDeviceName(deviceName.c_str());
+    igtl::Matrix4x4 matrix;
+    igtl::IdentityMatrix(matrix);
+    matrix[0][3] = x;
+    message->SetMatrix(matrix);
+    return message;
+  }
+
+  static igtl::ImageMessage::Pointer CreateImageMessage(const std::string& deviceName)
+  {
+    igtl::ImageMessage::Pointer message = igtl::ImageMessage::New();
+    message->SetDeviceName(deviceName.c_str());
+    message->SetDimensions(4, 4, 1);
+    return message;
+  }
+
+  static igtl::MessageBase::Pointer CreateStatusMessage(const std::string& deviceName)
+  {
+    igtl::StatusMessage::Pointer message = igtl::StatusMessage::New();
+    message->SetDeviceName(deviceName.c_str());
+    return message.GetPointer();
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_Queue = mitk::IGTLMessageQueue::New();
+    m_Queue->EnableNoBufferingMode(false);
+  }
+
+  void tearDown() override
+  {
+    m_Queue = nullptr;
+  }
+
+  void Test_TransformsOfSameDevice_Coalesced()
+  {
+    m_Queue->PushMessage(CreateTransformMessage("Tool1", 1.0f).GetPointer());
+    m_Queue->PushMessage(CreateTransformMessage("Tool2", 2.0f).GetPointer());
+    m_Queue->PushMessage(CreateTransformMessage("Tool1", 3.0f).GetPointer());
+
+    auto statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::Transform);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), statistics.Depth);
+    CPPUNIT_ASSERT_EQUAL(1ul, statistics.NumberOfCoalescedMessages);
+    CPPUNIT_ASSERT_EQUAL(0ul, statistics.NumberOfDroppedMessages);
+
+    igtl::TransformMessage::Pointer first = m_Queue->PullTransformMessage();
+    igtl::Matrix4x4 matrix;
+    first->GetMatrix(matrix);
+    CPPUNIT_ASSERT_EQUAL(std::string("Tool1"), std::string(first->GetDeviceName()));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(3.0, matrix[0][3], 1e-6);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("Tool2"), std::string(m_Queue->PullTransformMessage()->GetDeviceName()));
+    CPPUNIT_ASSERT(m_Queue->PullTransformMessage().IsNull());
+  }
+
+  void Test_ImagesExceedingCapacity_OldestDropped()
+  {
+    m_Queue->SetCapacity(mitk::IGTLMessageQueue::Image2d, 2);
+
+    for (int i = 0; i < 5; ++i)
+      m_Queue->PushMessage(CreateImageMessage("Image" + std::to_string(i)).GetPointer());
+
+    auto statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::Image2d);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), statistics.Depth);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), statistics.MaximumDepth);
+    CPPUNIT_ASSERT_EQUAL(5ul, statistics.NumberOfPushedMessages);
+    CPPUNIT_ASSERT_EQUAL(3ul, statistics.NumberOfDroppedMessages);
+
+    CPPUNIT_ASSERT_EQUAL(std::string("Image3"), std::string(m_Queue->PullImage2dMessage()->GetDeviceName()));
+    CPPUNIT_ASSERT_EQUAL(std::string("Image4"), std::string(m_Queue->PullImage2dMessage()->GetDeviceName()));
+  }
+
+  void Test_CommandsWithoutBuffering_KeptInOrder()
+  {
+    m_Queue->EnableNoBufferingMode(true);
+
+    m_Queue->PushCommandMessage(CreateStatusMessage("First"));
+    m_Queue->PushCommandMessage(CreateStatusMessage("Second"));
+
+    CPPUNIT_ASSERT_EQUAL(std::string("First"), std::string(m_Queue->PullCommandMessage()->GetDeviceName()));
+    CPPUNIT_ASSERT_EQUAL(std::string("Second"), std::string(m_Queue->PullCommandMessage()->GetDeviceName()));
+    CPPUNIT_ASSERT(m_Queue->PullCommandMessage().IsNull());
+  }
+
+  void Test_NoBufferingMode_SingleMiscMessage()
+  {
+    m_Queue->EnableNoBufferingMode(true);
+
+    m_Queue->PushMessage(CreateStatusMessage("First"));
+    m_Queue->PushMessage(CreateStatusMessage("Second"));
+
+    CPPUNIT_ASSERT_EQUAL(1, m_Queue->GetSize());
+    CPPUNIT_ASSERT_EQUAL(std::string("Second"), std::string(m_Queue->PullMiscMessage()->GetDeviceName()));
+  }
+
+  void Test_PulledMessages_Counted()
+  {
+    m_Queue->PushMessage(CreateStatusMessage("First"));
+    m_Queue->PushMessage(CreateStatusMessage("Second"));
+    m_Queue->PullMiscMessage();
+
+    auto statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::Misc);
+    CPPUNIT_ASSERT_EQUAL(1ul, statistics.NumberOfPulledMessages);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), statistics.Depth);
+    CPPUNIT_ASSERT(statistics.MeanLatency >= 0.0);
+    CPPUNIT_ASSERT(statistics.MaximumLatency >= statistics.MeanLatency);
+
+    m_Queue->ResetStatistics();
+    statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::Misc);
+    CPPUNIT_ASSERT_EQUAL(0ul, statistics.NumberOfPushedMessages);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), statistics.Depth);
+  }
+  void Test_DefaultCapacity_Unbounded()
+  {
+    for (int i = 0; i < 100; ++i)
+    {
+      m_Queue->PushMessage(CreateImageMessage("Image" + std::to_string(i)).GetPointer());
+      m_Queue->PushCommandMessage(CreateStatusMessage("Command" + std::to_string(i)));
+    }
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_Queue->GetCapacity(mitk::IGTLMessageQueue::Image2d));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_Queue->GetCapacity(mitk::IGTLMessageQueue::Command));
+    CPPUNIT_ASSERT_EQUAL(std::size_t(100), m_Queue->GetStatistics(mitk::IGTLMessageQueue::Image2d).Depth);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(100), m_Queue->GetStatistics(mitk::IGTLMessageQueue::Command).Depth);
+    CPPUNIT_ASSERT_EQUAL(0ul, m_Queue->GetStatistics(mitk::IGTLMessageQueue::Command).NumberOfDroppedMessages);
+    CPPUNIT_ASSERT_EQUAL(std::string("Command0"), std::string(m_Queue->PullCommandMessage()->GetDeviceName()));
+  }
+
+  void Test_CommandsExceedingCapacity_DroppedAndCounted()
+  {
+    m_Queue->SetCapacity(mitk::IGTLMessageQueue::Command, 2);
+
+    for (int i = 0; i < 3; ++i)
+      m_Queue->PushCommandMessage(CreateStatusMessage("Command" + std::to_string(i)));
+
+    auto statistics = m_Queue->GetStatistics(mitk::IGTLMessageQueue::Command);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), statistics.Depth);
+    CPPUNIT_ASSERT_EQUAL(1ul, statistics.NumberOfDroppedMessages);
+    CPPUNIT_ASSERT_EQUAL(std::string("Command1"), std::string(m_Queue->PullCommandMessage()->GetDeviceName()));
+  }
+
+  void Test_NullCommand_Accepted()
+  {
+    m_Queue->PushCommandMessage(nullptr);
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), m_Queue->GetStatistics(mitk::IGTLMessageQueue::Command).Depth);
+    CPPUNIT_ASSERT(m_Queue->PullCommandMessage().IsNull());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkIGTLMessageQueue)
@@ -45,6 +45,7 @@ class mitkOpenIGTLinkClientServerTestSuite : public mitk::TestFixture
 #endif
   //MITK_TEST(Test_SendingMessageFromServerToOneClient_Successful);
   //MITK_TEST(Test_SendingMessageFromServerToMultipleClients_Successful);
+  MITK_TEST(Test_DefaultQueueCapacities_ImagesAndTransformsBounded);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -170,6 +171,21 @@ public:
     CPPUNIT_ASSERT(m_Client_Two->CloseConnection());
   }
 
+  void Test_DefaultQueueCapacities_ImagesAndTransformsBounded()
+  {
+    for (mitk::IGTLDevice* device : { static_cast<mitk::IGTLDevice*>(m_Server.GetPointer()), static_cast<mitk::IGTLDevice*>(m_Client_One.GetPointer()) })
+    {
+      CPPUNIT_ASSERT_MESSAGE("2D images should be bounded by default", device->GetQueueCapacity(mitk::IGTLMessageQueue::Image2d) > 0);
+      CPPUNIT_ASSERT_MESSAGE("3D images should be bounded by default", device->GetQueueCapacity(mitk::IGTLMessageQueue::Image3d) > 0);
+      CPPUNIT_ASSERT_MESSAGE("Transforms should be bounded by default", device->GetQueueCapacity(mitk::IGTLMessageQueue::Transform) > 0);
+      CPPUNIT_ASSERT_MESSAGE("Tracking data should be bounded by default", device->GetQueueCapacity(mitk::IGTLMessageQueue::TrackingData) > 0);
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Commands must never be dropped", std::size_t(0), device->GetQueueCapacity(mitk::IGTLMessageQueue::Command));
+    }
+
+    m_Client_One->SetQueueCapacity(mitk::IGTLMessageQueue::Image2d, 0);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), m_Client_One->GetQueueCapacity(mitk::IGTLMessageQueue::Image2d));
+  }
+
   void Test_SendingMessageFromServerToOneClient_Successful()
   {
     CPPUNIT_ASSERT_MESSAGE("Server not connected to Client.", m_Server->OpenConnection());
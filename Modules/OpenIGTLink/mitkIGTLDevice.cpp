@@ -29,6 +29,11 @@ found in the LICENSE file.
 static const int SOCKET_SEND_RECEIVE_TIMEOUT_MSEC = 100;
 typedef itk::MutexLockHolder<itk::FastMutexLock> MutexLockHolder;
 
+//Default number of received messages kept per type. Images are large and only the latest ones
+//are of interest, transforms and tracking data are kept per device name, commands are never dropped.
+static const std::size_t DEFAULT_IMAGE_QUEUE_CAPACITY = 8;
+static const std::size_t DEFAULT_TRANSFORM_QUEUE_CAPACITY = 64;
+
 mitk::IGTLDevice::IGTLDevice(bool ReadFully) :
 //  m_Data(mitk::DeviceDataUnspecified),
 m_State(mitk::IGTLDevice::Setup),
@@ -56,6 +61,10 @@ m_MultiThreader(nullptr), m_SendThreadID(0), m_ReceiveThreadID(0), m_ConnectThre
 
   m_MessageFactory = mitk::IGTLMessageFactory::New();
   m_MessageQueue = mitk::IGTLMessageQueue::New();
+  m_MessageQueue->SetCapacity(mitk::IGTLMessageQueue::Image2d, DEFAULT_IMAGE_QUEUE_CAPACITY);
+  m_MessageQueue->SetCapacity(mitk::IGTLMessageQueue::Image3d, DEFAULT_IMAGE_QUEUE_CAPACITY);
+  m_MessageQueue->SetCapacity(mitk::IGTLMessageQueue::Transform, DEFAULT_TRANSFORM_QUEUE_CAPACITY);
+  m_MessageQueue->SetCapacity(mitk::IGTLMessageQueue::TrackingData, DEFAULT_TRANSFORM_QUEUE_CAPACITY);
 }
 
 mitk::IGTLDevice::~IGTLDevice()
@@ -490,6 +499,27 @@ void mitk::IGTLDevice::EnableNoBufferingMode(
   queue->EnableNoBufferingMode(enable);
 }
 
+void mitk::IGTLDevice::SetQueueCapacity(mitk::IGTLMessageQueue::MessageType type, std::size_t capacity)
+{
+  m_MessageQueue->SetCapacity(type, capacity);
+}
+
+std::size_t mitk::IGTLDevice::GetQueueCapacity(mitk::IGTLMessageQueue::MessageType type) const
+{
+  return m_MessageQueue->GetCapacity(type);
+}
+
+mitk::IGTLMessageQueue::QueueStatistics mitk::IGTLDevice::GetQueueStatistics(
+  mitk::IGTLMessageQueue::MessageType type) const
+{
+  return m_MessageQueue->GetStatistics(type);
+}
+
+void mitk::IGTLDevice::ResetQueueStatistics()
+{
+  m_MessageQueue->ResetStatistics();
+}
+
 ITK_THREAD_RETURN_TYPE mitk::IGTLDevice::ThreadStartSending(void* pInfoStruct)
 {
   /* extract this pointer from Thread Info structure */
@@ -240,6 +240,29 @@ namespace mitk {
 
     void EnableNoBufferingMode(bool enable = true);
 
+    /**
+    * \brief Sets the maximum number of received messages of the given type, 0 means unbounded
+    *
+    * By default a device keeps up to 8 messages of each image type and up to 64 transform
+    * and tracking data messages, all other types are unbounded.
+    */
+    void SetQueueCapacity(mitk::IGTLMessageQueue::MessageType type, std::size_t capacity);
+
+    /**
+    * \brief Returns the maximum number of received messages of the given type, 0 means unbounded
+    */
+    std::size_t GetQueueCapacity(mitk::IGTLMessageQueue::MessageType type) const;
+
+    /**
+    * \brief Returns the queue depth, drop and latency counters of the given message type
+    */
+    mitk::IGTLMessageQueue::QueueStatistics GetQueueStatistics(mitk::IGTLMessageQueue::MessageType type) const;
+
+    /**
+    * \brief Resets the counters of the message queue
+    */
+    void ResetQueueStatistics();
+
     /**
     * \brief Returns the number of connections of this device
     */
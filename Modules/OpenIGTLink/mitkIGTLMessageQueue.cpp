@@ -11,212 +11,206 @@ found in the LICENSE file.
 ============================================================================*/
 
 #include "mitkIGTLMessageQueue.h"
+#include <algorithm>
 #include <string>
 #include "igtlMessageBase.h"
 
-void mitk::IGTLMessageQueue::PushSendMessage(mitk::IGTLMessage::Pointer message)
+template <typename TMessagePointer>
+mitk::IGTLMessageQueue::MessageBuffer<TMessagePointer>::MessageBuffer(bool coalesce)
+  : m_Coalesce(coalesce),
+    m_SumOfLatencies(0.0)
+{
+}
+
+template <typename TMessagePointer>
+std::size_t mitk::IGTLMessageQueue::MessageBuffer<TMessagePointer>::Push(const TMessagePointer& message,
+  const std::string& deviceName, std::size_t capacity)
 {
-  this->m_Mutex->Lock();
-  if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-    m_SendQueue.clear();
+  const auto now = Clock::now();
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  ++m_Statistics.NumberOfPushedMessages;
+
+  if (m_Coalesce)
+  {
+    auto it = std::find_if(m_Entries.begin(), m_Entries.end(),
+      [&deviceName](const Entry& entry) { return entry.DeviceName == deviceName; });
+
+    if (it != m_Entries.end())
+    {
+      it->Message = message;
+      it->PushTime = now;
+      ++m_Statistics.NumberOfCoalescedMessages;
+      return 0;
+    }
+  }
+
+  std::size_t numberOfDroppedMessages = 0;
+
+  if (capacity > 0)
+  {
+    while (m_Entries.size() >= capacity)
+    {
+      m_Entries.pop_front();
+      ++numberOfDroppedMessages;
+    }
+  }
 
-  m_SendQueue.push_back(message);
-  this->m_Mutex->Unlock();
+  m_Statistics.NumberOfDroppedMessages += numberOfDroppedMessages;
+  m_Entries.push_back({ message, deviceName, now });
+  m_Statistics.MaximumDepth = std::max(m_Statistics.MaximumDepth, m_Entries.size());
+
+  return numberOfDroppedMessages;
 }
 
-void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
+template <typename TMessagePointer>
+TMessagePointer mitk::IGTLMessageQueue::MessageBuffer<TMessagePointer>::Pull()
 {
-  this->m_Mutex->Lock();
-  if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-    m_CommandQueue.clear();
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (m_Entries.empty())
+    return nullptr;
 
-  m_CommandQueue.push_back(message);
-  this->m_Mutex->Unlock();
+  TMessagePointer ret = m_Entries.front().Message;
+  const double latency =
+    std::chrono::duration<double, std::milli>(Clock::now() - m_Entries.front().PushTime).count();
+  m_Entries.pop_front();
+
+  ++m_Statistics.NumberOfPulledMessages;
+  m_SumOfLatencies += latency;
+  m_Statistics.MaximumLatency = std::max(m_Statistics.MaximumLatency, latency);
+
+  return ret;
 }
 
-void mitk::IGTLMessageQueue::PushMessage(igtl::MessageBase::Pointer msg)
+template <typename TMessagePointer>
+std::size_t mitk::IGTLMessageQueue::MessageBuffer<TMessagePointer>::GetSize() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+template <typename TMessagePointer>
+mitk::IGTLMessageQueue::QueueStatistics mitk::IGTLMessageQueue::MessageBuffer<TMessagePointer>::GetStatistics() const
 {
-  this->m_Mutex->Lock();
+  std::lock_guard<std::mutex> lock(m_Mutex);
 
-  std::stringstream infolog;
+  QueueStatistics statistics = m_Statistics;
+  statistics.Depth = m_Entries.size();
 
-  infolog << "Received message of type ";
+  if (statistics.NumberOfPulledMessages > 0)
+    statistics.MeanLatency = m_SumOfLatencies / statistics.NumberOfPulledMessages;
 
-  if (dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()) != nullptr)
-  {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_TrackingDataQueue.clear();
+  return statistics;
+}
 
-    this->m_TrackingDataQueue.push_back(dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()));
+template <typename TMessagePointer>
+void mitk::IGTLMessageQueue::MessageBuffer<TMessagePointer>::ResetStatistics()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Statistics = QueueStatistics();
+  m_Statistics.MaximumDepth = m_Entries.size();
+  m_SumOfLatencies = 0.0;
+}
 
-    infolog << "TDATA";
-  }
-  else if (dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()) != nullptr)
-  {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_TransformQueue.clear();
+void mitk::IGTLMessageQueue::PushSendMessage(mitk::IGTLMessage::Pointer message)
+{
+  m_SendQueue.Push(message, message.IsNotNull() ? message->GetName() : "", this->GetEffectiveCapacity(Send));
+}
 
-    this->m_TransformQueue.push_back(dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()));
+void mitk::IGTLMessageQueue::PushCommandMessage(igtl::MessageBase::Pointer message)
+{
+  const auto numberOfDroppedMessages =
+    m_CommandQueue.Push(message, message.IsNotNull() ? message->GetDeviceName() : "", this->GetEffectiveCapacity(Command));
 
-    infolog << "TRANSFORM";
-  }
-  else if (dynamic_cast<igtl::StringMessage*>(msg.GetPointer()) != nullptr)
+  if (numberOfDroppedMessages > 0)
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_StringQueue.clear();
+    MITK_WARN << "Command queue exceeded its capacity of " << this->GetCapacity(Command) << " messages, dropped "
+              << numberOfDroppedMessages << " unprocessed command(s)";
+  }
+}
 
-    this->m_StringQueue.push_back(dynamic_cast<igtl::StringMessage*>(msg.GetPointer()));
+void mitk::IGTLMessageQueue::PushMessage(igtl::MessageBase::Pointer msg)
+{
+  const std::string deviceName = msg->GetDeviceName();
 
-    infolog << "STRING";
+  if (auto* trackingDataMsg = dynamic_cast<igtl::TrackingDataMessage*>(msg.GetPointer()))
+  {
+    this->m_TrackingDataQueue.Push(trackingDataMsg, deviceName, this->GetEffectiveCapacity(TrackingData));
+  }
+  else if (auto* transformMsg = dynamic_cast<igtl::TransformMessage*>(msg.GetPointer()))
+  {
+    this->m_TransformQueue.Push(transformMsg, deviceName, this->GetEffectiveCapacity(Transform));
   }
-  else if (dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()) != nullptr)
+  else if (auto* stringMsg = dynamic_cast<igtl::StringMessage*>(msg.GetPointer()))
   {
-    igtl::ImageMessage::Pointer imageMsg = dynamic_cast<igtl::ImageMessage*>(msg.GetPointer());
-    int* dim = new int[3];
+    this->m_StringQueue.Push(stringMsg, deviceName, this->GetEffectiveCapacity(String));
+  }
+  else if (auto* imageMsg = dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()))
+  {
+    int dim[3];
     imageMsg->GetDimensions(dim);
     if (dim[2] > 1)
     {
-      if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-        m_Image3dQueue.clear();
-
-      this->m_Image3dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
-
-      infolog << "IMAGE3D";
+      this->m_Image3dQueue.Push(imageMsg, deviceName, this->GetEffectiveCapacity(Image3d));
     }
     else
     {
-      if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-        m_Image2dQueue.clear();
-
-      this->m_Image2dQueue.push_back(dynamic_cast<igtl::ImageMessage*>(msg.GetPointer()));
-
-      infolog << "IMAGE2D";
+      this->m_Image2dQueue.Push(imageMsg, deviceName, this->GetEffectiveCapacity(Image2d));
     }
   }
   else
   {
-    if (this->m_BufferingType == IGTLMessageQueue::NoBuffering)
-      m_MiscQueue.clear();
-
-    this->m_MiscQueue.push_back(msg);
-
-    infolog << "OTHER";
+    this->m_MiscQueue.Push(msg, deviceName, this->GetEffectiveCapacity(Misc));
   }
 
+  std::lock_guard<std::mutex> lock(m_LatestMessageMutex);
   m_Latest_Message = msg;
-
-  //MITK_INFO << infolog.str();
-
-  this->m_Mutex->Unlock();
 }
 
 mitk::IGTLMessage::Pointer mitk::IGTLMessageQueue::PullSendMessage()
 {
-  mitk::IGTLMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_SendQueue.size() > 0)
-  {
-    ret = this->m_SendQueue.front();
-    this->m_SendQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_SendQueue.Pull();
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullMiscMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_MiscQueue.size() > 0)
-  {
-    ret = this->m_MiscQueue.front();
-    this->m_MiscQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_MiscQueue.Pull();
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage2dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image2dQueue.size() > 0)
-  {
-    ret = this->m_Image2dQueue.front();
-    this->m_Image2dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_Image2dQueue.Pull();
 }
 
 igtl::ImageMessage::Pointer mitk::IGTLMessageQueue::PullImage3dMessage()
 {
-  igtl::ImageMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_Image3dQueue.size() > 0)
-  {
-    ret = this->m_Image3dQueue.front();
-    this->m_Image3dQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_Image3dQueue.Pull();
 }
 
 igtl::TrackingDataMessage::Pointer mitk::IGTLMessageQueue::PullTrackingMessage()
 {
-  igtl::TrackingDataMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TrackingDataQueue.size() > 0)
-  {
-    ret = this->m_TrackingDataQueue.front();
-    this->m_TrackingDataQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_TrackingDataQueue.Pull();
 }
 
 igtl::MessageBase::Pointer mitk::IGTLMessageQueue::PullCommandMessage()
 {
-  igtl::MessageBase::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_CommandQueue.size() > 0)
-  {
-    ret = this->m_CommandQueue.front();
-    this->m_CommandQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_CommandQueue.Pull();
 }
 
 igtl::StringMessage::Pointer mitk::IGTLMessageQueue::PullStringMessage()
 {
-  igtl::StringMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_StringQueue.size() > 0)
-  {
-    ret = this->m_StringQueue.front();
-    this->m_StringQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_StringQueue.Pull();
 }
 
 igtl::TransformMessage::Pointer mitk::IGTLMessageQueue::PullTransformMessage()
 {
-  igtl::TransformMessage::Pointer ret = nullptr;
-  this->m_Mutex->Lock();
-  if (this->m_TransformQueue.size() > 0)
-  {
-    ret = this->m_TransformQueue.front();
-    this->m_TransformQueue.pop_front();
-  }
-  this->m_Mutex->Unlock();
-  return ret;
+  return this->m_TransformQueue.Pull();
 }
 
 std::string mitk::IGTLMessageQueue::GetNextMsgInformationString()
 {
-  this->m_Mutex->Lock();
+  std::lock_guard<std::mutex> lock(m_LatestMessageMutex);
   std::stringstream s;
   if (this->m_Latest_Message != nullptr)
   {
@@ -227,13 +221,12 @@ std::string mitk::IGTLMessageQueue::GetNextMsgInformationString()
   {
     s << "No Msg";
   }
-  this->m_Mutex->Unlock();
   return s.str();
 }
 
 std::string mitk::IGTLMessageQueue::GetNextMsgDeviceType()
 {
-  this->m_Mutex->Lock();
+  std::lock_guard<std::mutex> lock(m_LatestMessageMutex);
   std::stringstream s;
   if (m_Latest_Message != nullptr)
   {
@@ -243,13 +236,12 @@ std::string mitk::IGTLMessageQueue::GetNextMsgDeviceType()
   {
     s << "";
   }
-  this->m_Mutex->Unlock();
   return s.str();
 }
 
 std::string mitk::IGTLMessageQueue::GetLatestMsgInformationString()
 {
-  this->m_Mutex->Lock();
+  std::lock_guard<std::mutex> lock(m_LatestMessageMutex);
   std::stringstream s;
   if (m_Latest_Message != nullptr)
   {
@@ -260,13 +252,12 @@ std::string mitk::IGTLMessageQueue::GetLatestMsgInformationString()
   {
     s << "No Msg";
   }
-  this->m_Mutex->Unlock();
   return s.str();
 }
 
 std::string mitk::IGTLMessageQueue::GetLatestMsgDeviceType()
 {
-  this->m_Mutex->Lock();
+  std::lock_guard<std::mutex> lock(m_LatestMessageMutex);
   std::stringstream s;
   if (m_Latest_Message != nullptr)
   {
@@ -276,33 +267,101 @@ std::string mitk::IGTLMessageQueue::GetLatestMsgDeviceType()
   {
     s << "";
   }
-  this->m_Mutex->Unlock();
   return s.str();
 }
 
 int mitk::IGTLMessageQueue::GetSize()
 {
-  return (this->m_CommandQueue.size() + this->m_Image2dQueue.size() + this->m_Image3dQueue.size() + this->m_MiscQueue.size()
-    + this->m_StringQueue.size() + this->m_TrackingDataQueue.size() + this->m_TransformQueue.size());
+  return static_cast<int>(this->m_CommandQueue.GetSize() + this->m_Image2dQueue.GetSize() + this->m_Image3dQueue.GetSize()
+    + this->m_MiscQueue.GetSize() + this->m_StringQueue.GetSize() + this->m_TrackingDataQueue.GetSize()
+    + this->m_TransformQueue.GetSize());
 }
 
 void mitk::IGTLMessageQueue::EnableNoBufferingMode(bool enable)
 {
-  this->m_Mutex->Lock();
   if (enable)
     this->m_BufferingType = IGTLMessageQueue::BufferingType::NoBuffering;
   else
     this->m_BufferingType = IGTLMessageQueue::BufferingType::Infinit;
-  this->m_Mutex->Unlock();
+}
+
+void mitk::IGTLMessageQueue::SetCapacity(MessageType type, std::size_t capacity)
+{
+  if (type < 0 || type >= NumberOfMessageTypes)
+    return;
+
+  this->m_Capacities[type] = capacity;
+}
+
+std::size_t mitk::IGTLMessageQueue::GetCapacity(MessageType type) const
+{
+  if (type < 0 || type >= NumberOfMessageTypes)
+    return 0;
+
+  return this->m_Capacities[type];
+}
+
+std::size_t mitk::IGTLMessageQueue::GetEffectiveCapacity(MessageType type) const
+{
+  // Without buffering only the newest message is kept. Commands must not get lost, and
+  // coalesced types already keep only the newest message of every device.
+  if (this->m_BufferingType == IGTLMessageQueue::NoBuffering &&
+    type != Command && type != Transform && type != TrackingData)
+  {
+    return 1;
+  }
+
+  return this->m_Capacities[type];
+}
+
+mitk::IGTLMessageQueue::QueueStatistics mitk::IGTLMessageQueue::GetStatistics(MessageType type) const
+{
+  switch (type)
+  {
+  case Command:
+    return this->m_CommandQueue.GetStatistics();
+  case Image2d:
+    return this->m_Image2dQueue.GetStatistics();
+  case Image3d:
+    return this->m_Image3dQueue.GetStatistics();
+  case Transform:
+    return this->m_TransformQueue.GetStatistics();
+  case TrackingData:
+    return this->m_TrackingDataQueue.GetStatistics();
+  case String:
+    return this->m_StringQueue.GetStatistics();
+  case Misc:
+    return this->m_MiscQueue.GetStatistics();
+  case Send:
+    return this->m_SendQueue.GetStatistics();
+  default:
+    return QueueStatistics();
+  }
+}
+
+void mitk::IGTLMessageQueue::ResetStatistics()
+{
+  this->m_CommandQueue.ResetStatistics();
+  this->m_Image2dQueue.ResetStatistics();
+  this->m_Image3dQueue.ResetStatistics();
+  this->m_TransformQueue.ResetStatistics();
+  this->m_TrackingDataQueue.ResetStatistics();
+  this->m_StringQueue.ResetStatistics();
+  this->m_MiscQueue.ResetStatistics();
+  this->m_SendQueue.ResetStatistics();
 }
 
 mitk::IGTLMessageQueue::IGTLMessageQueue()
+  : m_TransformQueue(true),
+    m_TrackingDataQueue(true)
 {
-  this->m_Mutex = itk::FastMutexLock::New();
+  // all buffers are unbounded unless a capacity is set explicitly
+  for (auto& capacity : this->m_Capacities)
+    capacity = 0;
+
   this->m_BufferingType = IGTLMessageQueue::NoBuffering;
 }
 
 mitk::IGTLMessageQueue::~IGTLMessageQueue()
 {
-  this->m_Mutex->Unlock();
 }
@@ -16,10 +16,13 @@ found in the LICENSE file.
 #include "MitkOpenIGTLinkExports.h"
 
 #include "itkObject.h"
-#include "itkFastMutexLock.h"
 #include "mitkCommon.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <deque>
+#include <mutex>
 #include <mitkIGTLMessage.h>
 
 //OpenIGTLink
@@ -34,6 +37,17 @@ namespace mitk {
   * \class IGTLMessageQueue
   * \brief Thread safe message queue to store OpenIGTLink messages.
   *
+  * Every message type is stored in its own buffer that is guarded by its own mutex, hence
+  * e.g. pulling images does not block pushing tracking data. Buffers are unbounded unless a
+  * capacity is set (see SetCapacity()). If a bounded buffer is full, its oldest message is
+  * dropped; dropping a command is reported as a warning. Commands are kept in FIFO order. Transform and
+  * tracking data messages are coalesced: a new message replaces the queued message of
+  * the same device, so the consumer always gets the latest pose of every device without
+  * the queue growing.
+  *
+  * For every buffer the queue counts pushed, pulled, dropped and coalesced messages,
+  * and measures the time messages spend in the queue (see GetStatistics()).
+  *
   * \ingroup OpenIGTLink
   */
   class MITKOPENIGTLINK_EXPORT IGTLMessageQueue : public itk::Object
@@ -45,11 +59,33 @@ namespace mitk {
 
       /**
        * \brief Different buffering types
-       * Infinit buffering means that you can push as many messages as you want
-       * NoBuffering means that the queue just stores a single message
+       * Infinit buffering means that every buffer stores up to its capacity (see SetCapacity())
+       * NoBuffering means that the queue just stores a single message of every type. Commands
+       * are not affected and transforms and tracking data keep the latest message of every device.
        */
     enum BufferingType { Infinit, NoBuffering };
 
+    /**
+     * \brief Message types, each one is stored in its own buffer
+     */
+    enum MessageType { Command = 0, Image2d, Image3d, Transform, TrackingData, String, Misc, Send, NumberOfMessageTypes };
+
+    /**
+     * \brief Counters of the buffer of one message type. Latencies are given in milliseconds
+     * between pushing and pulling a message.
+     */
+    struct QueueStatistics
+    {
+      std::size_t Depth = 0;
+      std::size_t MaximumDepth = 0;
+      unsigned long NumberOfPushedMessages = 0;
+      unsigned long NumberOfPulledMessages = 0;
+      unsigned long NumberOfDroppedMessages = 0;   ///< removed because the buffer was full
+      unsigned long NumberOfCoalescedMessages = 0; ///< replaced by a newer message of the same device
+      double MeanLatency = 0.0;
+      double MaximumLatency = 0.0;
+    };
+
     void PushSendMessage(mitk::IGTLMessage::Pointer message);
 
     /**
@@ -104,35 +140,103 @@ namespace mitk {
      */
     void EnableNoBufferingMode(bool enable);
 
+    /**
+    * \brief Sets the maximum number of messages of the given type. If the buffer is full,
+    * the oldest message is dropped. 0 means unbounded, which is the default for all types.
+    */
+    void SetCapacity(MessageType type, std::size_t capacity);
+    std::size_t GetCapacity(MessageType type) const;
+
+    /**
+    * \brief Returns the queue depth, drop and latency counters of the given message type
+    */
+    QueueStatistics GetStatistics(MessageType type) const;
+
+    /**
+    * \brief Resets the counters of all message types
+    */
+    void ResetStatistics();
+
   protected:
     IGTLMessageQueue();
     ~IGTLMessageQueue() override;
 
-  protected:
     /**
-    * \brief Mutex to take car of the queue
+    * \brief Bounded buffer of one message type with its own mutex and counters
     */
-    itk::FastMutexLock::Pointer m_Mutex;
+    template <typename TMessagePointer>
+    class MessageBuffer
+    {
+    public:
+      explicit MessageBuffer(bool coalesce = false);
+
+      /**
+      * \brief Appends the message, or replaces the queued message of the same device
+      * if the buffer coalesces. Drops the oldest messages if the buffer exceeds the capacity.
+      * \return the number of dropped messages
+      */
+      std::size_t Push(const TMessagePointer& message, const std::string& deviceName, std::size_t capacity);
+
+      /**
+      * \brief Returns and removes the oldest message, nullptr if the buffer is empty
+      */
+      TMessagePointer Pull();
+
+      std::size_t GetSize() const;
+      QueueStatistics GetStatistics() const;
+      void ResetStatistics();
+
+    private:
+      using Clock = std::chrono::steady_clock;
+
+      struct Entry
+      {
+        TMessagePointer Message;
+        std::string DeviceName;
+        Clock::time_point PushTime;
+      };
+
+      mutable std::mutex m_Mutex;
+      std::deque<Entry> m_Entries;
+      bool m_Coalesce;
+      QueueStatistics m_Statistics;
+      double m_SumOfLatencies;
+    };
 
     /**
-    * \brief the queue that stores pointer to the inserted messages
+    * \brief Returns the capacity of the given type with respect to the buffering type
     */
-    std::deque< igtl::MessageBase::Pointer > m_CommandQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image2dQueue;
-    std::deque< igtl::ImageMessage::Pointer > m_Image3dQueue;
-    std::deque< igtl::TransformMessage::Pointer > m_TransformQueue;
-    std::deque< igtl::TrackingDataMessage::Pointer > m_TrackingDataQueue;
-    std::deque< igtl::StringMessage::Pointer > m_StringQueue;
-    std::deque< igtl::MessageBase::Pointer > m_MiscQueue;
+    std::size_t GetEffectiveCapacity(MessageType type) const;
 
-    std::deque< mitk::IGTLMessage::Pointer > m_SendQueue;
+  protected:
+    /**
+    * \brief the buffers that store pointer to the inserted messages
+    */
+    MessageBuffer< igtl::MessageBase::Pointer > m_CommandQueue;
+    MessageBuffer< igtl::ImageMessage::Pointer > m_Image2dQueue;
+    MessageBuffer< igtl::ImageMessage::Pointer > m_Image3dQueue;
+    MessageBuffer< igtl::TransformMessage::Pointer > m_TransformQueue;
+    MessageBuffer< igtl::TrackingDataMessage::Pointer > m_TrackingDataQueue;
+    MessageBuffer< igtl::StringMessage::Pointer > m_StringQueue;
+    MessageBuffer< igtl::MessageBase::Pointer > m_MiscQueue;
+
+    MessageBuffer< mitk::IGTLMessage::Pointer > m_SendQueue;
 
+    /**
+    * \brief the capacity of every message type, 0 means unbounded
+    */
+    std::array< std::atomic<std::size_t>, NumberOfMessageTypes > m_Capacities;
+
+    /**
+    * \brief Mutex to take care of the latest message
+    */
+    mutable std::mutex m_LatestMessageMutex;
     igtl::MessageBase::Pointer m_Latest_Message;
 
     /**
     * \brief defines the kind of buffering
     */
-    BufferingType m_BufferingType;
+    std::atomic<BufferingType> m_BufferingType;
   };
 }
 
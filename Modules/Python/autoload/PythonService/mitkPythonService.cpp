@@ -41,17 +41,52 @@ found in the LICENSE file.
 
 #include <mitkExceptionMacro.h>
 
+#include <mutex>
+
 #ifndef WIN32
 #include <dlfcn.h>
 #endif
 
 typedef itksys::SystemTools ist;
 
+namespace mitk
+{
+  /** Collects the numpy arrays no image data item references anymore. Items may be deleted on any thread and even
+   * after the interpreter was finalized, so the arrays are not released there but later by the service while it holds
+   * the GIL.*/
+  class NumpyArrayReleaseQueue
+  {
+  public:
+    void Push(PyObject *array)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      if (!m_Closed)
+        m_Arrays.push_back(array);
+    }
+
+    /** Removes and returns the queued arrays. Once closed, no arrays are queued anymore.*/
+    std::vector<PyObject *> Take(bool close)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_Closed = m_Closed || close;
+      std::vector<PyObject *> arrays;
+      arrays.swap(m_Arrays);
+      return arrays;
+    }
+
+  private:
+    std::mutex m_Mutex;
+    std::vector<PyObject *> m_Arrays;
+    bool m_Closed = false;
+  };
+}
+
 mitk::PythonService::PythonService()
   : m_ItkWrappingAvailable( true )
   , m_OpenCVWrappingAvailable( true )
   , m_VtkWrappingAvailable( true )
   , m_ErrorOccured( false )
+  , m_NumpyArrayReleaseQueue( std::make_shared<NumpyArrayReleaseQueue>() )
 {
   bool pythonInitialized = static_cast<bool>( Py_IsInitialized() ); //m_PythonManager.isPythonInitialized() );
 
@@ -95,6 +130,21 @@ mitk::PythonService::PythonService()
 mitk::PythonService::~PythonService()
 {
   MITK_DEBUG("mitk::PythonService") << "destructing PythonService";
+
+  // the interpreter may be finalized together with the python manager
+  this->ReleaseDeletedNumpyArrays(true);
+}
+
+void mitk::PythonService::ReleaseDeletedNumpyArrays(bool close)
+{
+  auto arrays = m_NumpyArrayReleaseQueue->Take(close);
+  if (arrays.empty() || !Py_IsInitialized())
+    return;
+
+  PyGILState_STATE state = PyGILState_Ensure();
+  for (auto array : arrays)
+    Py_DECREF(array);
+  PyGILState_Release(state);
 }
 
 void mitk::PythonService::AddRelativeSearchDirs(std::vector< std::string > dirs)
@@ -119,6 +169,8 @@ void mitk::PythonService::AddAbsoluteSearchDirs(std::vector< std::string > dirs)
 
 std::string mitk::PythonService::Execute(const std::string &stdpythonCommand, int commandType)
 {
+  this->ReleaseDeletedNumpyArrays();
+
   QString pythonCommand = QString::fromStdString(stdpythonCommand);
   QVariant result;
 
@@ -143,6 +195,8 @@ std::string mitk::PythonService::Execute(const std::string &stdpythonCommand, in
 
 void mitk::PythonService::ExecuteScript( const std::string& pythonScript )
 {
+  this->ReleaseDeletedNumpyArrays();
+
   std::ifstream t(pythonScript.c_str());
   std::string str((std::istreambuf_iterator<char>(t)),
                   std::istreambuf_iterator<char>());
@@ -536,7 +590,8 @@ mitk::Image::Pointer mitk::PythonService::CopySimpleItkImageFromPython(const std
   QString command;
   QString varName = QString::fromStdString( stdvarName );
 
-  command.append( QString("%1_numpy_array = sitk.GetArrayFromImage(%1)\n").arg(varName) );
+  // a view avoids copying the pixel data twice, SetChannel below copies it anyway
+  command.append( QString("%1_numpy_array = sitk.GetArrayViewFromImage(%1) if hasattr(sitk, 'GetArrayViewFromImage') else sitk.GetArrayFromImage(%1)\n").arg(varName) );
   command.append( QString("%1_spacing = numpy.asarray(%1.GetSpacing())\n").arg(varName) );
   command.append( QString("%1_origin = numpy.asarray(%1.GetOrigin())\n").arg(varName) );
   command.append( QString("%1_dtype = %1_numpy_array.dtype.name\n").arg(varName) );
@@ -638,6 +693,203 @@ mitk::Image::Pointer mitk::PythonService::CopySimpleItkImageFromPython(const std
   return mitkImage;
 }
 
+namespace
+{
+  const char *const SHARED_IMAGE_CAPSULE_NAME = "mitk.Image";
+
+  /** Releases the reference to the image a numpy view was created on.*/
+  void ReleaseSharedImage(PyObject *capsule)
+  {
+    delete static_cast<mitk::Image::Pointer *>(PyCapsule_GetPointer(capsule, SHARED_IMAGE_CAPSULE_NAME));
+  }
+
+  bool GetNumpyType(itk::ImageIOBase::IOComponentType componentType, int &npyType)
+  {
+    switch (componentType)
+    {
+      case itk::ImageIOBase::DOUBLE: npyType = NPY_DOUBLE; return true;
+      case itk::ImageIOBase::FLOAT: npyType = NPY_FLOAT; return true;
+      case itk::ImageIOBase::CHAR: npyType = NPY_BYTE; return true;
+      case itk::ImageIOBase::UCHAR: npyType = NPY_UBYTE; return true;
+      case itk::ImageIOBase::SHORT: npyType = NPY_SHORT; return true;
+      case itk::ImageIOBase::USHORT: npyType = NPY_USHORT; return true;
+      case itk::ImageIOBase::INT: npyType = NPY_INT; return true;
+      case itk::ImageIOBase::UINT: npyType = NPY_UINT; return true;
+      case itk::ImageIOBase::LONG: npyType = NPY_LONG; return true;
+      case itk::ImageIOBase::ULONG: npyType = NPY_ULONG; return true;
+      default: return false;
+    }
+  }
+}
+
+bool mitk::PythonService::ShareToPythonAsNumpyArray(mitk::Image *image, const std::string &varName, bool writable)
+{
+  if (image == nullptr || !image->IsInitialized())
+  {
+    MITK_WARN << "cannot share an uninitialized image with python";
+    return false;
+  }
+
+  this->ReleaseDeletedNumpyArrays();
+
+  const mitk::PixelType pixelType = image->GetPixelType();
+  int npyType = NPY_USHORT;
+  if (!GetNumpyType(pixelType.GetComponentType(), npyType))
+  {
+    MITK_WARN << "not a recognized pixeltype";
+    return false;
+  }
+
+  // the accessors are only needed to get hold of the buffer, its lifetime is bound to the image
+  void *data = nullptr;
+  if (writable)
+  {
+    mitk::ImageWriteAccessor wacc(image);
+    data = wacc.GetData();
+  }
+  else
+  {
+    mitk::ImageReadAccessor racc(image);
+    data = const_cast<void *>(racc.GetData());
+  }
+
+  // numpy arrays are indexed the other way round, the components are the fastest running axis
+  const unsigned int dimension = image->GetDimension();
+  const unsigned int nrComponents = pixelType.GetNumberOfComponents();
+  std::vector<npy_intp> npyDims;
+  for (unsigned int i = dimension; i > 0; --i)
+    npyDims.push_back(image->GetDimension(i - 1));
+  if (nrComponents > 1)
+    npyDims.push_back(nrComponents);
+
+  import_array1(false);
+  PyObject *npyArray = PyArray_New(&PyArray_Type,
+                                   static_cast<int>(npyDims.size()),
+                                   npyDims.data(),
+                                   npyType,
+                                   nullptr,
+                                   data,
+                                   0,
+                                   writable ? NPY_ARRAY_CARRAY : NPY_ARRAY_CARRAY_RO,
+                                   nullptr);
+  if (npyArray == nullptr)
+    return false;
+
+  // the view owns a reference to the image, which is released together with the array
+  PyObject *capsule =
+    PyCapsule_New(new mitk::Image::Pointer(image), SHARED_IMAGE_CAPSULE_NAME, ReleaseSharedImage);
+  if (capsule == nullptr || PyArray_SetBaseObject(reinterpret_cast<PyArrayObject *>(npyArray), capsule) != 0)
+  {
+    Py_DECREF(npyArray);
+    return false;
+  }
+
+  PyObject *pyMod = PyImport_AddModule("__main__");
+  PyObject *pyDict = PyModule_GetDict(pyMod);
+  const int status = PyDict_SetItemString(pyDict, varName.c_str(), npyArray);
+  Py_DECREF(npyArray);
+
+  return status == 0;
+}
+
+mitk::Image::Pointer mitk::PythonService::ShareNumpyArrayFromPython(const std::string &varName,
+                                                                    unsigned int numberOfComponents,
+                                                                    const mitk::BaseGeometry *geometry)
+{
+  import_array1(nullptr);
+
+  this->ReleaseDeletedNumpyArrays();
+
+  PyObject *pyMod = PyImport_AddModule("__main__");
+  PyObject *pyDict = PyModule_GetDict(pyMod);
+  PyObject *pyObject = PyDict_GetItemString(pyDict, varName.c_str());
+  if (pyObject == nullptr || !PyArray_Check(pyObject))
+  {
+    MITK_WARN << "python variable " << varName << " is not a numpy array";
+    return nullptr;
+  }
+
+  // returns a new reference to the array itself if it can be adopted, otherwise to a copy
+  PyObject *npyObject = PyArray_FROM_OF(pyObject, NPY_ARRAY_CARRAY);
+  if (npyObject == nullptr)
+    return nullptr;
+  PyArrayObject *npyArray = reinterpret_cast<PyArrayObject *>(npyObject);
+
+  if (!PyArray_ISNOTSWAPPED(npyArray))
+  {
+    MITK_WARN << "numpy arrays not in native byte order are not supported";
+    Py_DECREF(npyObject);
+    return nullptr;
+  }
+
+  int nrDimensions = PyArray_NDIM(npyArray);
+  if (numberOfComponents > 1)
+  {
+    if (nrDimensions == 0 || PyArray_DIMS(npyArray)[nrDimensions - 1] != static_cast<npy_intp>(numberOfComponents))
+    {
+      MITK_WARN << "last axis of numpy array " << varName << " does not match the number of components";
+      Py_DECREF(npyObject);
+      return nullptr;
+    }
+    --nrDimensions;
+  }
+
+  if (nrDimensions < 2 || nrDimensions > 4)
+  {
+    MITK_WARN << "numpy array " << varName << " has an unsupported number of dimensions";
+    Py_DECREF(npyObject);
+    return nullptr;
+  }
+
+  PyObject *pyDtypeName = PyObject_GetAttrString(reinterpret_cast<PyObject *>(PyArray_DESCR(npyArray)), "name");
+  const std::string dtype = pyDtypeName != nullptr ? PyString_AsString(pyDtypeName) : "";
+  Py_XDECREF(pyDtypeName);
+
+  mitk::Image::Pointer mitkImage = mitk::Image::New();
+  try
+  {
+    mitk::PixelType pixelType = DeterminePixelType(dtype, numberOfComponents, nrDimensions);
+
+    // the buffer is adopted as it is, e.g. an unsupported dtype for rgb pixels falls back to char
+    if (pixelType.GetNumberOfComponents() != numberOfComponents ||
+        pixelType.GetBitsPerComponent() != static_cast<std::size_t>(PyArray_ITEMSIZE(npyArray)) * 8)
+    {
+      mitkThrow() << "dtype " << dtype << " does not match the pixel type " << pixelType.GetTypeAsString();
+    }
+
+    // fill backwards, numpy saves the dimensions in opposite direction
+    std::vector<unsigned int> dimensions(nrDimensions);
+    for (int i = 0; i < nrDimensions; ++i)
+      dimensions[i] = PyArray_DIMS(npyArray)[nrDimensions - 1 - i];
+
+    mitkImage->Initialize(pixelType, nrDimensions, dimensions.data());
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_WARN << "cannot share numpy array " << varName << ": " << e.GetDescription();
+    Py_DECREF(npyObject);
+    return nullptr;
+  }
+
+  if (!mitkImage->SetImportChannel(PyArray_DATA(npyArray), 0, mitk::Image::ReferenceMemory))
+  {
+    Py_DECREF(npyObject);
+    return nullptr;
+  }
+
+  // the channel data item owns the reference to the array. Items sharing the buffer, e.g. volumes of a time
+  // selector, keep the channel item alive, so the array is queued for release after the last of them is deleted.
+  // Items may be deleted on any thread, hence the GIL is not acquired here.
+  std::shared_ptr<NumpyArrayReleaseQueue> releaseQueue = m_NumpyArrayReleaseQueue;
+  mitkImage->GetChannelData(0)->SetDataOwner(std::shared_ptr<void>(
+    npyObject, [releaseQueue](void *array) { releaseQueue->Push(static_cast<PyObject *>(array)); }));
+
+  if (geometry != nullptr)
+    mitkImage->SetClonedGeometry(geometry);
+
+  return mitkImage;
+}
+
 bool mitk::PythonService::CopyToPythonAsCvImage( mitk::Image* image, const std::string& stdvarName )
 {
   QString varName = QString::fromStdString( stdvarName );
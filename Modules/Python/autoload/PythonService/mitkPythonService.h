@@ -17,8 +17,12 @@ found in the LICENSE file.
 #include <itkLightObject.h>
 #include "mitkSurface.h"
 
+#include <memory>
+
 namespace mitk
 {
+  class NumpyArrayReleaseQueue;
+
   ///
   /// implementation of the IPythonService using ctkabstractpythonmanager
   /// \see IPythonService
@@ -68,6 +72,14 @@ namespace mitk
       /// \see IPythonService::CopyItkImageFromPython()
       mitk::Image::Pointer CopySimpleItkImageFromPython( const std::string& varName ) override;
       ///
+      /// \see IPythonService::ShareToPythonAsNumpyArray()
+      bool ShareToPythonAsNumpyArray( mitk::Image* image, const std::string& varName, bool writable = false ) override;
+      ///
+      /// \see IPythonService::ShareNumpyArrayFromPython()
+      mitk::Image::Pointer ShareNumpyArrayFromPython( const std::string& varName,
+                                                      unsigned int numberOfComponents = 1,
+                                                      const mitk::BaseGeometry* geometry = nullptr ) override;
+      ///
       /// \see IPythonService::IsOpenCvPythonWrappingAvailable()
       bool IsOpenCvPythonWrappingAvailable() override;
       ///
@@ -96,12 +108,18 @@ namespace mitk
   protected:
 
   private:
+      ///
+      /// releases the numpy arrays shared by ShareNumpyArrayFromPython() whose image data was deleted
+      /// in the meantime, arrays of data deleted after "close" are not released anymore
+      void ReleaseDeletedNumpyArrays( bool close = false );
+
       QList<PythonCommandObserver*> m_Observer;
       ctkAbstractPythonManager m_PythonManager;
       bool m_ItkWrappingAvailable;
       bool m_OpenCVWrappingAvailable;
       bool m_VtkWrappingAvailable;
       bool m_ErrorOccured;
+      std::shared_ptr<NumpyArrayReleaseQueue> m_NumpyArrayReleaseQueue;
   };
 }
 #endif
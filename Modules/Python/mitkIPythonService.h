@@ -111,6 +111,28 @@ namespace mitk
         /// copies an itk image from the python process that is named "varName"
         /// \return the image or 0 if copying was not possible
         virtual mitk::Image::Pointer CopySimpleItkImageFromPython( const std::string& varName ) = 0;
+        ///
+        /// makes the pixel data of an mitk image available as numpy array "varName" in python
+        /// without copying it. The array is a view on the image buffer with the axes in
+        /// reverse order (t,z,y,x[,components]) and keeps the image alive as long as it exists.
+        /// If "writable" is false the view is read-only, otherwise changes made in python are
+        /// visible in the image (call Modified() on the image afterwards).
+        /// The image must not be re-initialized while views on it exist.
+        /// \return true if the array was created, else false
+        virtual bool ShareToPythonAsNumpyArray( mitk::Image* image, const std::string& varName, bool writable = false ) = 0;
+        ///
+        /// creates an mitk image that references the buffer of the numpy array "varName".
+        /// C-contiguous, aligned, writable arrays in native byte order are adopted without a
+        /// copy and kept alive until the image and all data items sharing its buffer are
+        /// deleted, all other arrays are copied once. These may be deleted on any thread, the
+        /// array is released by the service the next time it runs python code.
+        /// If "numberOfComponents" is greater than one, the last axis of the array holds the
+        /// components. The geometry is cloned from "geometry" if given.
+        /// \return the image or 0 if the variable is not a supported numpy array or its dtype
+        /// does not match a pixel type with "numberOfComponents" components
+        virtual mitk::Image::Pointer ShareNumpyArrayFromPython( const std::string& varName,
+                                                                unsigned int numberOfComponents = 1,
+                                                                const mitk::BaseGeometry* geometry = nullptr ) = 0;
 
         ///
         /// \return true, if OpenCv wrapping is available, false otherwise
@@ -92,6 +92,17 @@ namespace mitk
                                                      const std::vector<unsigned char> *body = {},
                                                      const std::map<utility::string_t, utility::string_t> headers = {}) = 0;
 
+    /**
+     * @brief Executes a HTTP GET request in the mitkRESTClient class and hands over the response as soon as its
+     * headers are received, so the body can be read while it is transferred
+     *
+     * @param uri defines the URI the request is send to
+     * @param headers the headers for the request (optional)
+     * @return task to wait for, which unfolds the response with the unread body
+     */
+    virtual pplx::task<web::http::http_response> SendStreamingRequest(
+      const web::uri &uri, const std::map<utility::string_t, utility::string_t> headers = {}) = 0;
+
     /**
      * @brief starts listening for requests if there isn't another observer listening and the port is free
      *
@@ -49,6 +49,21 @@ namespace mitk
                                      const utility::string_t &filePath,
                                      const std::map<utility::string_t, utility::string_t> headers);
 
+    /**
+     * @brief Executes a HTTP GET request with the given uri and returns a task waiting for the response, whose body
+     * is not read yet
+     *
+     * The task finishes as soon as the response headers are received, so large bodies can be processed while they
+     * are transferred by reading from web::http::http_response::body().
+     *
+     * @throw mitk::Exception if request went wrong or the response status is not OK
+     * @param uri the URI resulting the target of the HTTP request
+     * @param headers the additional headers to be set to the HTTP request
+     * @return task to wait for with the response
+     */
+    pplx::task<web::http::http_response> GetResponse(const web::uri &uri,
+                                                     const std::map<utility::string_t, utility::string_t> headers);
+
     /**
      * @brief Executes a HTTP PUT request with given uri and the content given as json
      *
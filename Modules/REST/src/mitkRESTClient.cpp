@@ -120,6 +120,34 @@ pplx::task<web::json::value> mitk::RESTClient::Get(const web::uri &uri,
     .then([=]() { return web::json::value(); });
 }
 
+pplx::task<web::http::http_response> mitk::RESTClient::GetResponse(
+  const web::uri &uri, const std::map<utility::string_t, utility::string_t> headers)
+{
+  auto client = new http_client(uri, m_ClientConfig);
+  auto request = InitRequest(headers);
+  request.set_method(methods::GET);
+
+  return client->request(request).then([=](pplx::task<http_response> responseTask) {
+    try
+    {
+      auto response = responseTask.get();
+
+      if (status_codes::OK != response.status_code())
+      {
+        MITK_WARN << "Status: " << response.status_code();
+        mitkThrow() << mitk::RESTUtil::convertToUtf8(response.to_string());
+      }
+
+      return response;
+    }
+    catch (const std::exception &e)
+    {
+      MITK_INFO << e.what();
+      mitkThrow() << "Getting response went wrong: " << e.what();
+    }
+  });
+}
+
 pplx::task<web::json::value> mitk::RESTClient::Put(const web::uri &uri, const web::json::value *content)
 {
   auto client = new http_client(uri, m_ClientConfig);
@@ -36,6 +36,7 @@ class mitkRESTClientTestSuite : public mitk::TestFixture, mitk::IRESTObserver
   MITK_TEST(GetRequestInvalidURI_ThrowsException);
   MITK_TEST(PutRequestInvalidURI_ThrowsException);
   MITK_TEST(PostRequestInvalidURI_ThrowsException);
+  MITK_TEST(StreamingRequestInvalidURI_ThrowsException);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -259,6 +260,17 @@ public:
       .wait();
   }
   void PostRequestInvalidURI_ThrowsException() { CPPUNIT_ASSERT_THROW(PostException(), mitk::Exception); }
+
+  void StreamingException()
+  {
+    // Method which makes a streaming get request to an invalid uri
+    web::http::http_response result;
+
+    m_Service->SendStreamingRequest(U("http://localhost:1234/invalid"))
+      .then([&](pplx::task<web::http::http_response> resultTask) { result = resultTask.get(); })
+      .wait();
+  }
+  void StreamingRequestInvalidURI_ThrowsException() { CPPUNIT_ASSERT_THROW(StreamingException(), mitk::Exception); }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkRESTClient)
@@ -104,6 +104,13 @@ pplx::task<web::json::value> mitk::RESTManager::SendJSONRequest(
   return answer;
 }
 
+pplx::task<web::http::http_response> mitk::RESTManager::SendStreamingRequest(
+  const web::uri &uri, const std::map<utility::string_t, utility::string_t> headers)
+{
+  auto client = new RESTClient;
+  return client->GetResponse(uri, headers);
+}
+
 void mitk::RESTManager::ReceiveRequest(const web::uri &uri, mitk::IRESTObserver *observer)
 {
   // New instance of RESTServer in m_ServerMap, key is port of the request
@@ -27,6 +27,10 @@ found in the LICENSE file.
 #include <vtkPropAssembly.h>
 #include <vtkCellArray.h>
 
+#include <deque>
+#include <map>
+#include <vector>
+
 class vtkActor;
 class vtkPolyDataMapper;
 class vtkPlaneSource;
@@ -40,6 +44,7 @@ class vtkMitkThickSlicesFilter;
 class vtkPolyData;
 class vtkMitkApplyLevelWindowToRGBFilter;
 class vtkMitkLevelWindowFilter;
+class vtkMatrix4x4;
 
 namespace mitk {
 
@@ -106,6 +111,11 @@ namespace mitk {
   * If the modality-property is set for an image, the mapper uses modality-specific default properties,
   * e.g. color maps, if they are defined.
 
+  * The mapper only renders the iso lines of the dose ("dose.showIsoLines"); the color wash is rendered
+  * by the ImageVtkMapper2D of the dose node. The iso lines of the recently shown slices are cached per
+  * render window, so scrolling back to a slice neither reslices the dose nor regenerates the lines.
+  * The cache is discarded if the dose data is modified.
+
   * \ingroup Mapper
   */
   class MITKRT_EXPORT DoseImageVtkMapper2D : public VtkMapper
@@ -179,7 +189,30 @@ namespace mitk {
       itk::TimeStamp m_LastUpdateTime;
 
       /** \brief mmPerPixel relation between pixel and mm. (World spacing).*/
-      mitk::ScalarType* m_mmPerPixel;
+      mitk::ScalarType m_mmPerPixel[2];
+
+      /** \brief Reslice axes of the current slice, used to transform the actors. */
+      vtkSmartPointer<vtkMatrix4x4> m_ResliceAxes;
+
+      /** \brief Iso lines and placement of a slice. */
+      struct IsoLineCacheEntry
+      {
+        vtkSmartPointer<vtkPolyData> m_OutlinePolyData;
+        vtkSmartPointer<vtkMatrix4x4> m_ResliceAxes;
+        mitk::ScalarType m_mmPerPixel[2];
+      };
+
+      /** \brief Identifies a slice (geometry, reslice settings, time step) together with the
+      * visible iso levels. */
+      using IsoLineCacheKeyType = std::vector<double>;
+
+      /** \brief Iso lines of the recently rendered slices. */
+      std::map<IsoLineCacheKeyType, IsoLineCacheEntry> m_IsoLineCache;
+      /** \brief Keys of m_IsoLineCache in the order of insertion, used to limit the cache size. */
+      std::deque<IsoLineCacheKeyType> m_IsoLineCacheOrder;
+      /** \brief Data and its modification time the cached iso lines were generated for. */
+      const mitk::Image *m_IsoLineCacheData;
+      itk::ModifiedTimeType m_IsoLineCacheDataTime;
 
       /** \brief This filter is used to apply the level window to Grayvalue and RBG(A) images. */
       vtkSmartPointer<vtkMitkLevelWindowFilter> m_LevelWindowFilter;
@@ -294,6 +327,20 @@ namespace mitk {
     bool RenderingGeometryIntersectsImage( const PlaneGeometry* renderingGeometry, SlicedGeometry3D* imageGeometry );
 
   private:
+    /** Generates the key of the current slice of the renderer in LocalStorage::m_IsoLineCache.*/
+    LocalStorage::IsoLineCacheKeyType GenerateIsoLineCacheKey(mitk::BaseRenderer *renderer,
+                                                              const PlaneGeometry *worldGeometry,
+                                                              int thickSlicesMode,
+                                                              int thickSlicesNum);
+
+    /** Reslices the dose for the current slice and generates its iso lines.
+    \return false if the slice could not be generated.*/
+    bool GenerateIsoLineCacheEntry(mitk::BaseRenderer *renderer,
+                                   const PlaneGeometry *worldGeometry,
+                                   int thickSlicesMode,
+                                   int thickSlicesNum,
+                                   LocalStorage::IsoLineCacheEntry &entry);
+
     void CreateLevelOutline(mitk::BaseRenderer* renderer, const mitk::IsoDoseLevel* level, float pref, vtkSmartPointer<vtkPoints> points, vtkSmartPointer<vtkCellArray> lines,  vtkSmartPointer<vtkUnsignedCharArray> colors);
 
   };
@@ -55,6 +55,8 @@ found in the LICENSE file.
 #include <vtkTransform.h>
 #include <vtkUnsignedCharArray.h>
 
+#include <algorithm>
+
 // ITK
 #include <itkRGBAPixel.h>
 
@@ -115,6 +117,83 @@ vtkProp *mitk::DoseImageVtkMapper2D::GetVtkProp(mitk::BaseRenderer *renderer)
   return m_LSH.GetLocalStorage(renderer)->m_Actors;
 }
 
+namespace
+{
+  /** Number of slices per render window whose iso lines are kept.*/
+  const std::size_t ISO_LINE_CACHE_SIZE = 64;
+
+  mitk::ExtractSliceFilter::ResliceInterpolation GetResliceInterpolation(const mitk::Image *input,
+                                                                   const mitk::DataNode *datanode)
+  {
+    // switch to nearest neighbor if the input image is too small.
+    if ((input->GetDimension() >= 3) && (input->GetDimension(2) > 1))
+    {
+      mitk::VtkResliceInterpolationProperty *resliceInterpolationProperty;
+      datanode->GetProperty(resliceInterpolationProperty, "reslice interpolation");
+
+      int interpolationMode = VTK_RESLICE_NEAREST;
+      if (resliceInterpolationProperty != nullptr)
+      {
+        interpolationMode = resliceInterpolationProperty->GetInterpolation();
+      }
+
+      switch (interpolationMode)
+      {
+        case VTK_RESLICE_LINEAR:
+          return mitk::ExtractSliceFilter::RESLICE_LINEAR;
+        case VTK_RESLICE_CUBIC:
+          return mitk::ExtractSliceFilter::RESLICE_CUBIC;
+      }
+    }
+
+    return mitk::ExtractSliceFilter::RESLICE_NEAREST;
+  }
+
+  void GetThickSlicesSettings(const mitk::Image *input,
+                              mitk::BaseRenderer *renderer,
+                              int &thickSlicesMode,
+                              int &thickSlicesNum)
+  {
+    thickSlicesMode = 0;
+    thickSlicesNum = 1;
+
+    if (input->GetPixelType().GetNumberOfComponents() == 1) // for now only single component are allowed
+    {
+      mitk::DataNode *dn = renderer->GetCurrentWorldPlaneGeometryNode();
+      if (dn)
+      {
+        mitk::ResliceMethodProperty *resliceMethodEnumProperty = nullptr;
+
+        if (dn->GetProperty(resliceMethodEnumProperty, "reslice.thickslices") && resliceMethodEnumProperty)
+          thickSlicesMode = resliceMethodEnumProperty->GetValueAsId();
+
+        mitk::IntProperty *intProperty = nullptr;
+        if (dn->GetProperty(intProperty, "reslice.thickslices.num") && intProperty)
+        {
+          thickSlicesNum = intProperty->GetValue();
+          if (thickSlicesNum < 1)
+            thickSlicesNum = 1;
+          if (thickSlicesNum > 10)
+            thickSlicesNum = 10;
+        }
+      }
+      else
+      {
+        MITK_WARN << "no associated widget plane data tree node found";
+      }
+    }
+  }
+
+  void AppendIsoLevelToKey(const mitk::IsoDoseLevel *level, float pref, std::vector<double> &key)
+  {
+    const mitk::IsoDoseLevel::ColorType color = level->GetColor();
+    key.push_back(level->GetDoseValue() * pref);
+    key.push_back(color.GetRed());
+    key.push_back(color.GetGreen());
+    key.push_back(color.GetBlue());
+  }
+}
+
 void mitk::DoseImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *renderer)
 {
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
@@ -148,86 +227,199 @@ void mitk::DoseImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *ren
     return;
   }
 
-  // set main input for ExtractSliceFilter
-  localStorage->m_Reslicer->SetInput(input);
-  localStorage->m_Reslicer->SetWorldGeometry(worldGeometry);
-  localStorage->m_Reslicer->SetTimeStep(this->GetTimestep());
-
-  // set the transformation of the image to adapt reslice axis
-  localStorage->m_Reslicer->SetResliceTransformByGeometry(
-    input->GetTimeGeometry()->GetGeometryForTimeStep(this->GetTimestep()));
+  // get the showIsoLines property
+  bool showIsoLines = false;
+  datanode->GetBoolProperty("dose.showIsoLines", showIsoLines, renderer);
 
-  // is the geometry of the slice based on the input image or the worldgeometry?
-  bool inPlaneResampleExtentByGeometry = false;
-  datanode->GetBoolProperty("in plane resample extent by geometry", inPlaneResampleExtentByGeometry, renderer);
-  localStorage->m_Reslicer->SetInPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry);
+  if (!showIsoLines)
+  {
+    localStorage->m_ReslicedImage = nullptr;
+    localStorage->m_Mapper->SetInputData(localStorage->m_EmptyPolyData);
+    return;
+  }
 
-  // Initialize the interpolation mode for resampling; switch to nearest
-  // neighbor if the input image is too small.
-  if ((input->GetDimension() >= 3) && (input->GetDimension(2) > 1))
+  // the cached iso lines are only valid as long as the dose is not modified
+  const itk::ModifiedTimeType dataTime = std::max(input->GetMTime(), input->GetPipelineMTime());
+  if (localStorage->m_IsoLineCacheData != input || localStorage->m_IsoLineCacheDataTime != dataTime)
   {
-    VtkResliceInterpolationProperty *resliceInterpolationProperty;
-    datanode->GetProperty(resliceInterpolationProperty, "reslice interpolation");
+    localStorage->m_IsoLineCache.clear();
+    localStorage->m_IsoLineCacheOrder.clear();
+    localStorage->m_IsoLineCacheData = input;
+    localStorage->m_IsoLineCacheDataTime = dataTime;
+  }
+
+  int thickSlicesMode = 0;
+  int thickSlicesNum = 1;
+  GetThickSlicesSettings(input, renderer, thickSlicesMode, thickSlicesNum);
+
+  const auto key = this->GenerateIsoLineCacheKey(renderer, worldGeometry, thickSlicesMode, thickSlicesNum);
+  auto cacheIter = localStorage->m_IsoLineCache.find(key);
 
-    int interpolationMode = VTK_RESLICE_NEAREST;
-    if (resliceInterpolationProperty != nullptr)
+  if (cacheIter == localStorage->m_IsoLineCache.end())
+  {
+    LocalStorage::IsoLineCacheEntry entry;
+    if (!this->GenerateIsoLineCacheEntry(renderer, worldGeometry, thickSlicesMode, thickSlicesNum, entry))
     {
-      interpolationMode = resliceInterpolationProperty->GetInterpolation();
+      return;
     }
 
-    switch (interpolationMode)
+    while (localStorage->m_IsoLineCacheOrder.size() >= ISO_LINE_CACHE_SIZE)
     {
-      case VTK_RESLICE_NEAREST:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
-        break;
-      case VTK_RESLICE_LINEAR:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_LINEAR);
-        break;
-      case VTK_RESLICE_CUBIC:
-        localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_CUBIC);
-        break;
+      localStorage->m_IsoLineCache.erase(localStorage->m_IsoLineCacheOrder.front());
+      localStorage->m_IsoLineCacheOrder.pop_front();
     }
+
+    cacheIter = localStorage->m_IsoLineCache.emplace(key, entry).first;
+    localStorage->m_IsoLineCacheOrder.push_back(key);
   }
   else
   {
-    localStorage->m_Reslicer->SetInterpolationMode(ExtractSliceFilter::RESLICE_NEAREST);
+    // the slice was not resliced again
+    localStorage->m_ReslicedImage = nullptr;
   }
 
-  // set the vtk output property to true, makes sure that no unneeded mitk image convertion
-  // is done.
-  localStorage->m_Reslicer->SetVtkOutputRequest(true);
+  localStorage->m_OutlinePolyData = cacheIter->second.m_OutlinePolyData;
+  localStorage->m_ResliceAxes = cacheIter->second.m_ResliceAxes;
+  localStorage->m_mmPerPixel[0] = cacheIter->second.m_mmPerPixel[0];
+  localStorage->m_mmPerPixel[1] = cacheIter->second.m_mmPerPixel[1];
 
-  // Thickslicing
-  int thickSlicesMode = 0;
-  int thickSlicesNum = 1;
-  // Thick slices parameters
-  if (input->GetPixelType().GetNumberOfComponents() == 1) // for now only single component are allowed
+  float binaryOutlineWidth(1.0);
+  if (datanode->GetFloatProperty("outline width", binaryOutlineWidth, renderer))
   {
-    DataNode *dn = renderer->GetCurrentWorldPlaneGeometryNode();
-    if (dn)
+    if (localStorage->m_Actors->GetNumberOfPaths() > 1)
     {
-      ResliceMethodProperty *resliceMethodEnumProperty = nullptr;
+      float binaryOutlineShadowWidth(1.5);
+      datanode->GetFloatProperty("outline shadow width", binaryOutlineShadowWidth, renderer);
 
-      if (dn->GetProperty(resliceMethodEnumProperty, "reslice.thickslices") && resliceMethodEnumProperty)
-        thickSlicesMode = resliceMethodEnumProperty->GetValueAsId();
+      dynamic_cast<vtkActor *>(localStorage->m_Actors->GetParts()->GetItemAsObject(0))
+        ->GetProperty()
+        ->SetLineWidth(binaryOutlineWidth * binaryOutlineShadowWidth);
+    }
 
-      IntProperty *intProperty = nullptr;
-      if (dn->GetProperty(intProperty, "reslice.thickslices.num") && intProperty)
-      {
-        thickSlicesNum = intProperty->GetValue();
-        if (thickSlicesNum < 1)
-          thickSlicesNum = 1;
-        if (thickSlicesNum > 10)
-          thickSlicesNum = 10;
-      }
+    localStorage->m_Actor->GetProperty()->SetLineWidth(binaryOutlineWidth);
+  }
+
+  // The lines are colored by their cell scalars. Lookup tables and level window are not needed,
+  // the color wash is rendered by the image mapper of the dose node.
+  this->ApplyOpacity(renderer);
+  this->ApplyColor(renderer);
+
+  this->TransformActor(renderer);
+
+  vtkActor *contourShadowActor = dynamic_cast<vtkActor *>(localStorage->m_Actors->GetParts()->GetItemAsObject(0));
+
+  // connect the mapper with the polyData which contains the lines
+  localStorage->m_Mapper->SetInputData(localStorage->m_OutlinePolyData);
+  localStorage->m_Actor->SetTexture(nullptr); // no texture for contours
+
+  bool binaryOutlineShadow(false);
+  datanode->GetBoolProperty("outline binary shadow", binaryOutlineShadow, renderer);
+
+  if (binaryOutlineShadow)
+    contourShadowActor->SetVisibility(true);
+  else
+    contourShadowActor->SetVisibility(false);
+
+  // We have been modified => save this for next Update()
+  localStorage->m_LastUpdateTime.Modified();
+}
+
+mitk::DoseImageVtkMapper2D::LocalStorage::IsoLineCacheKeyType mitk::DoseImageVtkMapper2D::GenerateIsoLineCacheKey(
+  mitk::BaseRenderer *renderer, const PlaneGeometry *worldGeometry, int thickSlicesMode, int thickSlicesNum)
+{
+  LocalStorage::IsoLineCacheKeyType key;
+  mitk::DataNode *datanode = this->GetDataNode();
+
+  key.push_back(this->GetTimestep());
+
+  // slice geometry
+  const auto matrix = worldGeometry->GetIndexToWorldTransform()->GetMatrix();
+  const auto offset = worldGeometry->GetIndexToWorldTransform()->GetOffset();
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    for (unsigned int j = 0; j < 3; ++j)
+    {
+      key.push_back(matrix[i][j]);
     }
-    else
+    key.push_back(offset[i]);
+  }
+  const auto bounds = worldGeometry->GetBounds();
+  key.insert(key.end(), bounds.Begin(), bounds.End());
+
+  // reslice settings
+  bool inPlaneResampleExtentByGeometry = false;
+  datanode->GetBoolProperty("in plane resample extent by geometry", inPlaneResampleExtentByGeometry, renderer);
+  key.push_back(inPlaneResampleExtentByGeometry);
+  key.push_back(GetResliceInterpolation(this->GetInput(), datanode));
+  key.push_back(thickSlicesMode);
+  key.push_back(thickSlicesNum);
+  key.push_back(this->CalculateLayerDepth(renderer));
+
+  // visible iso levels
+  float pref;
+  datanode->GetFloatProperty(mitk::RTConstants::REFERENCE_DOSE_PROPERTY_NAME.c_str(), pref);
+
+  mitk::IsoDoseLevelSetProperty::Pointer propIsoSet = dynamic_cast<mitk::IsoDoseLevelSetProperty *>(
+    datanode->GetProperty(mitk::RTConstants::DOSE_ISO_LEVELS_PROPERTY_NAME.c_str()));
+  mitk::IsoDoseLevelSet::Pointer isoDoseLevelSet = propIsoSet->GetValue();
+
+  for (mitk::IsoDoseLevelSet::ConstIterator doseIT = isoDoseLevelSet->Begin(); doseIT != isoDoseLevelSet->End();
+       ++doseIT)
+  {
+    if (doseIT->GetVisibleIsoLine())
+    {
+      AppendIsoLevelToKey(&(doseIT.Value()), pref, key);
+    }
+  }
+
+  mitk::IsoDoseLevelVectorProperty::Pointer propfreeIsoVec = dynamic_cast<mitk::IsoDoseLevelVectorProperty *>(
+    datanode->GetProperty(mitk::RTConstants::DOSE_FREE_ISO_VALUES_PROPERTY_NAME.c_str()));
+  mitk::IsoDoseLevelVector::Pointer freeIsoDoseLevelVec = propfreeIsoVec->GetValue();
+
+  for (mitk::IsoDoseLevelVector::ConstIterator freeDoseIT = freeIsoDoseLevelVec->Begin();
+       freeDoseIT != freeIsoDoseLevelVec->End();
+       ++freeDoseIT)
+  {
+    if (freeDoseIT->Value()->GetVisibleIsoLine())
     {
-      MITK_WARN << "no associated widget plane data tree node found";
+      AppendIsoLevelToKey(freeDoseIT->Value(), pref, key);
     }
   }
 
-  const PlaneGeometry *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
+  return key;
+}
+
+bool mitk::DoseImageVtkMapper2D::GenerateIsoLineCacheEntry(mitk::BaseRenderer *renderer,
+                                                           const PlaneGeometry *worldGeometry,
+                                                           int thickSlicesMode,
+                                                           int thickSlicesNum,
+                                                           LocalStorage::IsoLineCacheEntry &entry)
+{
+  LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
+
+  mitk::Image *input = const_cast<mitk::Image *>(this->GetInput());
+  mitk::DataNode *datanode = this->GetDataNode();
+
+  // set main input for ExtractSliceFilter
+  localStorage->m_Reslicer->SetInput(input);
+  localStorage->m_Reslicer->SetWorldGeometry(worldGeometry);
+  localStorage->m_Reslicer->SetTimeStep(this->GetTimestep());
+
+  // set the transformation of the image to adapt reslice axis
+  localStorage->m_Reslicer->SetResliceTransformByGeometry(
+    input->GetTimeGeometry()->GetGeometryForTimeStep(this->GetTimestep()));
+
+  // is the geometry of the slice based on the input image or the worldgeometry?
+  bool inPlaneResampleExtentByGeometry = false;
+  datanode->GetBoolProperty("in plane resample extent by geometry", inPlaneResampleExtentByGeometry, renderer);
+  localStorage->m_Reslicer->SetInPlaneResampleExtentByGeometry(inPlaneResampleExtentByGeometry);
+
+  // Initialize the interpolation mode for resampling
+  localStorage->m_Reslicer->SetInterpolationMode(GetResliceInterpolation(input, datanode));
+
+  // set the vtk output property to true, makes sure that no unneeded mitk image convertion
+  // is done.
+  localStorage->m_Reslicer->SetVtkOutputRequest(true);
 
   if (thickSlicesMode > 0)
   {
@@ -235,6 +427,7 @@ void mitk::DoseImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *ren
 
     Vector3D normInIndex, normal;
 
+    const PlaneGeometry *planeGeometry = dynamic_cast<const PlaneGeometry *>(worldGeometry);
     if (planeGeometry != nullptr)
     {
       normal = planeGeometry->GetNormal();
@@ -246,7 +439,7 @@ void mitk::DoseImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *ren
       if (abstractGeometry != nullptr)
         normal = abstractGeometry->GetPlane()->GetNormal();
       else
-        return; // no fitting geometry set
+        return false; // no fitting geometry set
     }
     normal.Normalize();
 
@@ -285,137 +478,19 @@ void mitk::DoseImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer *ren
     localStorage->m_ReslicedImage = localStorage->m_Reslicer->GetVtkOutput();
   }
 
-  // Bounds information for reslicing (only reuqired if reference geometry
-  // is present)
-  // this used for generating a vtkPLaneSource with the right size
-  double sliceBounds[6];
-  for (int i = 0; i < 6; ++i)
-  {
-    sliceBounds[i] = 0.0;
-  }
-  localStorage->m_Reslicer->GetClippedPlaneBounds(sliceBounds);
-
   // get the spacing of the slice
-  localStorage->m_mmPerPixel = localStorage->m_Reslicer->GetOutputSpacing();
-
-  // calculate minimum bounding rect of IMAGE in texture
-  {
-    double textureClippingBounds[6];
-    for (int i = 0; i < 6; ++i)
-    {
-      textureClippingBounds[i] = 0.0;
-    }
-    // Calculate the actual bounds of the transformed plane clipped by the
-    // dataset bounding box; this is required for drawing the texture at the
-    // correct position during 3D mapping.
-    mitk::PlaneClipping::CalculateClippedPlaneBounds(input->GetGeometry(), planeGeometry, textureClippingBounds);
-
-    textureClippingBounds[0] = static_cast<int>(textureClippingBounds[0] / localStorage->m_mmPerPixel[0] + 0.5);
-    textureClippingBounds[1] = static_cast<int>(textureClippingBounds[1] / localStorage->m_mmPerPixel[0] + 0.5);
-    textureClippingBounds[2] = static_cast<int>(textureClippingBounds[2] / localStorage->m_mmPerPixel[1] + 0.5);
-    textureClippingBounds[3] = static_cast<int>(textureClippingBounds[3] / localStorage->m_mmPerPixel[1] + 0.5);
-
-    // clipping bounds for cutting the image
-    localStorage->m_LevelWindowFilter->SetClippingBounds(textureClippingBounds);
-  }
-
-  // get the number of scalar components to distinguish between different image types
-  int numberOfComponents = localStorage->m_ReslicedImage->GetNumberOfScalarComponents();
-  // get the showIsoLines property
-  bool showIsoLines = false;
-  datanode->GetBoolProperty("dose.showIsoLines", showIsoLines, renderer);
-
-  if (showIsoLines) // contour rendering
-  {
-    // generate contours/outlines
-    localStorage->m_OutlinePolyData = CreateOutlinePolyData(renderer);
-
-    float binaryOutlineWidth(1.0);
-    if (datanode->GetFloatProperty("outline width", binaryOutlineWidth, renderer))
-    {
-      if (localStorage->m_Actors->GetNumberOfPaths() > 1)
-      {
-        float binaryOutlineShadowWidth(1.5);
-        datanode->GetFloatProperty("outline shadow width", binaryOutlineShadowWidth, renderer);
-
-        dynamic_cast<vtkActor *>(localStorage->m_Actors->GetParts()->GetItemAsObject(0))
-          ->GetProperty()
-          ->SetLineWidth(binaryOutlineWidth * binaryOutlineShadowWidth);
-      }
-
-      localStorage->m_Actor->GetProperty()->SetLineWidth(binaryOutlineWidth);
-    }
-  }
-  else
-  {
-    localStorage->m_ReslicedImage = nullptr;
-    localStorage->m_Mapper->SetInputData(localStorage->m_EmptyPolyData);
-    return;
-  }
-
-  this->ApplyOpacity(renderer);
-  this->ApplyRenderingMode(renderer);
-
-  // do not use a VTK lookup table (we do that ourselves in m_LevelWindowFilter)
-  localStorage->m_Texture->SetColorModeToDirectScalars();
-
-  int displayedComponent = 0;
-
-  if (datanode->GetIntProperty("Image.Displayed Component", displayedComponent, renderer) && numberOfComponents > 1)
-  {
-    localStorage->m_VectorComponentExtractor->SetComponents(displayedComponent);
-    localStorage->m_VectorComponentExtractor->SetInputData(localStorage->m_ReslicedImage);
-
-    localStorage->m_LevelWindowFilter->SetInputConnection(localStorage->m_VectorComponentExtractor->GetOutputPort(0));
-  }
-  else
-  {
-    // connect the input with the levelwindow filter
-    localStorage->m_LevelWindowFilter->SetInputData(localStorage->m_ReslicedImage);
-  }
-
-  // check for texture interpolation property
-  bool textureInterpolation = false;
-  GetDataNode()->GetBoolProperty("texture interpolation", textureInterpolation, renderer);
-
-  // set the interpolation modus according to the property
-  localStorage->m_Texture->SetInterpolate(textureInterpolation);
-
-  // connect the texture with the output of the levelwindow filter
-  localStorage->m_Texture->SetInputConnection(localStorage->m_LevelWindowFilter->GetOutputPort());
-
-  this->TransformActor(renderer);
-
-  vtkActor *contourShadowActor = dynamic_cast<vtkActor *>(localStorage->m_Actors->GetParts()->GetItemAsObject(0));
-
-  if (showIsoLines) // connect the mapper with the polyData which contains the lines
-  {
-    // We need the contour for the binary outline property as actor
-    localStorage->m_Mapper->SetInputData(localStorage->m_OutlinePolyData);
-    localStorage->m_Actor->SetTexture(nullptr); // no texture for contours
-
-    bool binaryOutlineShadow(false);
-    datanode->GetBoolProperty("outline binary shadow", binaryOutlineShadow, renderer);
-
-    if (binaryOutlineShadow)
-      contourShadowActor->SetVisibility(true);
-    else
-      contourShadowActor->SetVisibility(false);
-  }
-  else
-  { // Connect the mapper with the input texture. This is the standard case.
-    // setup the textured plane
-    this->GeneratePlane(renderer, sliceBounds);
-    // set the plane as input for the mapper
-    localStorage->m_Mapper->SetInputConnection(localStorage->m_Plane->GetOutputPort());
-    // set the texture for the actor
-
-    localStorage->m_Actor->SetTexture(localStorage->m_Texture);
-    contourShadowActor->SetVisibility(false);
-  }
-
-  // We have been modified => save this for next Update()
-  localStorage->m_LastUpdateTime.Modified();
+  const mitk::ScalarType *spacing = localStorage->m_Reslicer->GetOutputSpacing();
+  localStorage->m_mmPerPixel[0] = spacing[0];
+  localStorage->m_mmPerPixel[1] = spacing[1];
+
+  // generate contours/outlines
+  entry.m_OutlinePolyData = this->CreateOutlinePolyData(renderer);
+  entry.m_ResliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+  entry.m_ResliceAxes->DeepCopy(localStorage->m_Reslicer->GetResliceAxes());
+  entry.m_mmPerPixel[0] = spacing[0];
+  entry.m_mmPerPixel[1] = spacing[1];
+
+  return true;
 }
 
 void mitk::DoseImageVtkMapper2D::ApplyLevelWindow(mitk::BaseRenderer *renderer)
@@ -1066,8 +1141,7 @@ void mitk::DoseImageVtkMapper2D::TransformActor(mitk::BaseRenderer *renderer)
   LocalStorage *localStorage = m_LSH.GetLocalStorage(renderer);
   // get the transformation matrix of the reslicer in order to render the slice as axial, coronal or saggital
   vtkSmartPointer<vtkTransform> trans = vtkSmartPointer<vtkTransform>::New();
-  vtkSmartPointer<vtkMatrix4x4> matrix = localStorage->m_Reslicer->GetResliceAxes();
-  trans->SetMatrix(matrix);
+  trans->SetMatrix(localStorage->m_ResliceAxes);
   // transform the plane/contour (the actual actor) to the corresponding view (axial, coronal or saggital)
   localStorage->m_Actor->SetUserTransform(trans);
   // transform the origin to center based coordinates, because MITK is center based.
@@ -1133,6 +1207,11 @@ mitk::DoseImageVtkMapper2D::LocalStorage::LocalStorage()
   m_OutlinePolyData = vtkSmartPointer<vtkPolyData>::New();
   m_ReslicedImage = vtkSmartPointer<vtkImageData>::New();
   m_EmptyPolyData = vtkSmartPointer<vtkPolyData>::New();
+  m_ResliceAxes = vtkSmartPointer<vtkMatrix4x4>::New();
+  m_mmPerPixel[0] = 1.0;
+  m_mmPerPixel[1] = 1.0;
+  m_IsoLineCacheData = nullptr;
+  m_IsoLineCacheDataTime = 0;
 
   // the following actions are always the same and thus can be performed
   // in the constructor for each image (i.e. the image-corresponding local storage)
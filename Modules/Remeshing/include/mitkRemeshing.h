@@ -23,16 +23,26 @@ namespace mitk
     /** \brief Reduce the number of vertices of an mitk::Surface.
       *
       * The decimation is applied separately to all time steps of the input surface.
+      * Time steps are processed concurrently unless the meshes are partitioned into patches,
+      * in which case the patches of each time step are processed concurrently instead.
       * The meshes of the resulting surface are guaranteed to consist of triangles only.
       *
+      * If more than one patch is requested, each mesh is split into spatially coherent
+      * slabs along its longest axis which are decimated concurrently. Vertices on the
+      * borders between patches are locked during decimation so that the patches can be
+      * stitched together again without cracks. Hence, the border vertices are kept at
+      * full resolution and the resulting number of vertices is slightly higher than in
+      * the unpartitioned case.
+      *
       * \param[in] input Input surface
       * \param[in] percent Relative number of vertices after decimation [0, 1]
       * \param[in] calculateNormals Calculate normals after decimation (\c true by default)
       * \param[in] flipNormals Flip calculated normals (\c false by default)
+      * \param[in] numberOfPatches Number of patches that are decimated concurrently (\c 1 by default, i.e., no partitioning)
       *
       * \return Decimated surface
       */
-    MITKREMESHING_EXPORT Surface::Pointer Decimate(const Surface* input, double percent, bool calculateNormals = true, bool flipNormals = false);
+    MITKREMESHING_EXPORT Surface::Pointer Decimate(const Surface* input, double percent, bool calculateNormals = true, bool flipNormals = false, unsigned int numberOfPatches = 1);
   }
 }
 
@@ -17,7 +17,9 @@ found in the LICENSE file.
 #include <OpenMesh/Tools/Decimater/ModQuadricT.hh>
 
 #include <vtkCellArray.h>
+#include <vtkDoubleArray.h>
 #include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkPolyDataNormals.h>
@@ -25,10 +27,16 @@ found in the LICENSE file.
 #include <vtkTriangleFilter.h>
 
 #include <algorithm>
+#include <array>
+#include <cstring>
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
 using Mesh = OpenMesh::TriMesh_ArrayKernelT<OpenMesh::DefaultTraitsDouble>;
 
+static_assert(sizeof(Mesh::Point) == 3 * sizeof(double), "Mesh points are expected to be tightly packed triples of doubles");
+
 namespace
 {
   bool IsValidPolyData(vtkPolyData* polyData)
@@ -62,29 +70,137 @@ namespace
     return polyDataNormals->GetOutput();
   }
 
-  Mesh ConvertPolyDataToMesh(vtkPolyData* polyData)
+  /** \brief Read-only view of the points and triangles of a triangulated vtkPolyData.
+    *
+    * Point coordinates and triangle connectivity are accessed directly in the underlying
+    * VTK arrays whenever their memory layout allows it. Only single precision points and
+    * mixed cell arrays fall back to (bulk) copies.
+    */
+  class TriangleMeshView
   {
-    Mesh mesh;
+  public:
+    explicit TriangleMeshView(vtkPolyData* polyData)
+      : m_Points(nullptr),
+        m_Connectivity(nullptr),
+        m_NumberOfPoints(polyData->GetNumberOfPoints()),
+        m_NumberOfTriangles(polyData->GetNumberOfPolys())
+    {
+      auto* pointData = polyData->GetPoints()->GetData();
+
+      if (VTK_DOUBLE == pointData->GetDataType() && 3 == pointData->GetNumberOfComponents())
+      {
+        m_Points = static_cast<const double*>(pointData->GetVoidPointer(0));
+      }
+      else
+      {
+        m_PointBuffer.resize(3 * m_NumberOfPoints);
+
+        for (vtkIdType i = 0; i < m_NumberOfPoints; ++i)
+          pointData->GetTuple(i, &m_PointBuffer[3 * i]);
+
+        m_Points = m_PointBuffer.data();
+      }
+
+      auto* polys = polyData->GetPolys();
+
+      if (polys->IsStorage64Bit() == (sizeof(vtkIdType) == 8) && polys->GetNumberOfConnectivityIds() == 3 * m_NumberOfTriangles)
+      {
+        m_Connectivity = static_cast<const vtkIdType*>(polys->GetConnectivityArray()->GetVoidPointer(0));
+      }
+      else
+      {
+        m_ConnectivityBuffer.reserve(3 * m_NumberOfTriangles);
+
+        vtkIdType numIds;
+        const vtkIdType* ids;
+        auto tempIds = vtkSmartPointer<vtkIdList>::New();
+
+        for (vtkIdType i = 0; i < m_NumberOfTriangles; ++i)
+        {
+          polys->GetCellAtId(i, numIds, ids, tempIds);
+          m_ConnectivityBuffer.insert(m_ConnectivityBuffer.end(), ids, ids + 3);
+        }
+
+        m_Connectivity = m_ConnectivityBuffer.data();
+      }
+    }
+
+    vtkIdType GetNumberOfPoints() const { return m_NumberOfPoints; }
+    vtkIdType GetNumberOfTriangles() const { return m_NumberOfTriangles; }
+    const double* GetPoint(vtkIdType i) const { return m_Points + 3 * i; }
+    const vtkIdType* GetTriangle(vtkIdType i) const { return m_Connectivity + 3 * i; }
+
+  private:
+    const double* m_Points;
+    const vtkIdType* m_Connectivity;
+    vtkIdType m_NumberOfPoints;
+    vtkIdType m_NumberOfTriangles;
+    std::vector<double> m_PointBuffer;
+    std::vector<vtkIdType> m_ConnectivityBuffer;
+  };
+
+  /** \brief Wrap preallocated, tightly packed point coordinates and triangle connectivity into a vtkPolyData.
+    */
+  vtkSmartPointer<vtkPolyData> CreateTrianglePolyData(vtkDoubleArray* coords, vtkIdTypeArray* connectivity)
+  {
+    const auto numTriangles = connectivity->GetNumberOfValues() / 3;
+
+    auto offsets = vtkSmartPointer<vtkIdTypeArray>::New();
+    offsets->SetNumberOfValues(numTriangles + 1);
+    auto* offset = offsets->GetPointer(0);
+
+    for (vtkIdType i = 0; i <= numTriangles; ++i)
+      offset[i] = 3 * i;
+
+    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    polys->SetData(offsets, connectivity);
+
+    auto points = vtkSmartPointer<vtkPoints>::New();
+    points->SetData(coords);
+
+    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    polyData->SetPoints(points);
+    polyData->SetPolys(polys);
+
+    return polyData;
+  }
+
+  vtkSmartPointer<vtkDoubleArray> AllocateCoords(vtkIdType numPoints)
+  {
+    auto coords = vtkSmartPointer<vtkDoubleArray>::New();
+    coords->SetNumberOfComponents(3);
+    coords->SetNumberOfTuples(numPoints);
+    return coords;
+  }
+
+  vtkSmartPointer<vtkIdTypeArray> AllocateConnectivity(vtkIdType numTriangles)
+  {
+    auto connectivity = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivity->SetNumberOfValues(3 * numTriangles);
+    return connectivity;
+  }
 
-    auto* points = polyData->GetPoints();
-    const auto numPoints = points->GetNumberOfPoints();
+  Mesh ConvertPolyDataToMesh(vtkPolyData* polyData)
+  {
+    const TriangleMeshView view(polyData);
+    const auto numPoints = view.GetNumberOfPoints();
+    const auto numTriangles = view.GetNumberOfTriangles();
 
-    for (std::remove_const_t<decltype(numPoints)> i = 0; i < numPoints; ++i)
-      mesh.add_vertex(Mesh::Point(points->GetPoint(i)));
+    Mesh mesh;
+    mesh.reserve(numPoints, 3 * numTriangles / 2, numTriangles);
 
-    auto* polys = polyData->GetPolys();
-    const auto numPolys = polys->GetNumberOfCells();
+    for (vtkIdType i = 0; i < numPoints; ++i)
+      mesh.add_vertex(Mesh::Point(view.GetPoint(i)));
 
-    auto ids = vtkSmartPointer<vtkIdList>::New();
     std::array<Mesh::VertexHandle, 3> vertexHandles;
 
-    for (std::remove_const_t<decltype(numPolys)> i = 0; i < numPolys; ++i)
+    for (vtkIdType i = 0; i < numTriangles; ++i)
     {
-      polys->GetCellAtId(i, ids);
+      const auto* ids = view.GetTriangle(i);
 
-      vertexHandles[0] = Mesh::VertexHandle(static_cast<int>(ids->GetId(0)));
-      vertexHandles[1] = Mesh::VertexHandle(static_cast<int>(ids->GetId(1)));
-      vertexHandles[2] = Mesh::VertexHandle(static_cast<int>(ids->GetId(2)));
+      vertexHandles[0] = Mesh::VertexHandle(static_cast<int>(ids[0]));
+      vertexHandles[1] = Mesh::VertexHandle(static_cast<int>(ids[1]));
+      vertexHandles[2] = Mesh::VertexHandle(static_cast<int>(ids[2]));
 
       mesh.add_face(vertexHandles.data(), 3);
     }
@@ -92,53 +208,283 @@ namespace
     return mesh;
   }
 
+  /** \brief Convert a garbage-collected mesh back to a vtkPolyData.
+    *
+    * The vertices of a garbage-collected mesh are stored contiguously and are copied in one go.
+    */
   vtkSmartPointer<vtkPolyData> ConvertMeshToPolyData(const Mesh& mesh)
   {
-    auto polyData = vtkSmartPointer<vtkPolyData>::New();
+    const auto numVertices = static_cast<vtkIdType>(mesh.n_vertices());
+    auto coords = AllocateCoords(numVertices);
 
-    const auto numVertices = mesh.n_vertices();
-    auto points = vtkSmartPointer<vtkPoints>::New();
-    points->SetNumberOfPoints(numVertices);
+    if (0 < numVertices)
+      std::memcpy(coords->GetPointer(0), mesh.points(), numVertices * sizeof(Mesh::Point));
 
-    for (std::remove_const_t<decltype(numVertices)> i = 0; i < numVertices; ++i)
-      points->SetPoint(i, mesh.point(Mesh::VertexHandle(static_cast<int>(i))).data());
+    const auto numFaces = static_cast<vtkIdType>(mesh.n_faces());
+    auto connectivity = AllocateConnectivity(numFaces);
+    auto* ids = connectivity->GetPointer(0);
 
-    polyData->SetPoints(points);
+    for (const auto& face : mesh.faces())
+    {
+      for (const auto& vertex : mesh.fv_range(face))
+        *ids++ = vertex.idx();
+    }
 
-    const auto numFaces = mesh.n_faces();
-    auto polys = vtkSmartPointer<vtkCellArray>::New();
+    return CreateTrianglePolyData(coords, connectivity);
+  }
+
+  void DecimateMesh(Mesh& mesh, size_t numVertices)
+  {
+    using Decimater = OpenMesh::Decimater::DecimaterT<Mesh>;
+    using HModQuadric = OpenMesh::Decimater::ModQuadricT<Mesh>::Handle;
+
+    Decimater decimater(mesh);
+
+    HModQuadric hModQuadric;
+    decimater.add(hModQuadric);
+    decimater.module(hModQuadric).unset_max_err();
+
+    decimater.initialize();
+    decimater.decimate_to(numVertices);
 
-    auto ids = vtkSmartPointer<vtkIdList>::New();
-    ids->SetNumberOfIds(3);
-    Mesh::CFVIter iter;
+    mesh.garbage_collection();
+  }
 
-    for (std::remove_const_t<decltype(numFaces)> i = 0; i < numFaces; ++i)
+  /** \brief Assign each triangle to one of numPatches slabs along the longest axis of the mesh.
+    *
+    * Slab boundaries are chosen at quantiles of the triangle centroids so that all patches
+    * contain roughly the same number of triangles.
+    */
+  std::vector<unsigned int> PartitionTriangles(const TriangleMeshView& view, unsigned int numPatches)
+  {
+    const auto numPoints = view.GetNumberOfPoints();
+    const auto numTriangles = view.GetNumberOfTriangles();
+
+    std::array<double, 3> minBounds = { view.GetPoint(0)[0], view.GetPoint(0)[1], view.GetPoint(0)[2] };
+    auto maxBounds = minBounds;
+
+    for (vtkIdType i = 1; i < numPoints; ++i)
     {
-      iter = mesh.cfv_iter(Mesh::FaceHandle(static_cast<int>(i)));
+      const auto* point = view.GetPoint(i);
 
-      ids->SetId(0, (iter++)->idx());
-      ids->SetId(1, (iter++)->idx());
-      ids->SetId(2, iter->idx());
+      for (int j = 0; j < 3; ++j)
+      {
+        minBounds[j] = std::min(minBounds[j], point[j]);
+        maxBounds[j] = std::max(maxBounds[j], point[j]);
+      }
+    }
 
-      polys->InsertNextCell(ids);
+    int axis = 0;
+
+    for (int j = 1; j < 3; ++j)
+    {
+      if (maxBounds[j] - minBounds[j] > maxBounds[axis] - minBounds[axis])
+        axis = j;
     }
 
-    polyData->SetPolys(polys);
+    std::vector<double> centroids(numTriangles);
 
-    return polyData;
+    for (vtkIdType i = 0; i < numTriangles; ++i)
+    {
+      const auto* ids = view.GetTriangle(i);
+      centroids[i] = view.GetPoint(ids[0])[axis] + view.GetPoint(ids[1])[axis] + view.GetPoint(ids[2])[axis];
+    }
+
+    auto sortedCentroids = centroids;
+    std::vector<double> splits(numPatches - 1);
+
+    for (unsigned int p = 1; p < numPatches; ++p)
+    {
+      auto nth = sortedCentroids.begin() + (numTriangles * p) / numPatches;
+      std::nth_element(sortedCentroids.begin(), nth, sortedCentroids.end());
+      splits[p - 1] = *nth;
+    }
+
+    std::sort(splits.begin(), splits.end());
+
+    std::vector<unsigned int> patches(numTriangles);
+
+    for (vtkIdType i = 0; i < numTriangles; ++i)
+      patches[i] = static_cast<unsigned int>(std::upper_bound(splits.begin(), splits.end(), centroids[i]) - splits.begin());
+
+    return patches;
   }
 
-  mitk::Surface::Pointer ProcessEachTimeStep(const mitk::Surface* input, bool calculateNormals, bool flipNormals, const std::function<void(Mesh&)>& ProcessMesh)
+  /** \brief Decimate spatial patches of a triangle mesh concurrently and stitch them together again.
+    */
+  vtkSmartPointer<vtkPolyData> DecimatePartitioned(vtkPolyData* polyData, double percent, unsigned int numPatches)
+  {
+    const TriangleMeshView view(polyData);
+    const auto numPoints = view.GetNumberOfPoints();
+    const auto numTriangles = view.GetNumberOfTriangles();
+
+    numPatches = static_cast<unsigned int>(std::min<vtkIdType>(numPatches, numTriangles));
+
+    const auto trianglePatches = PartitionTriangles(view, numPatches);
+
+    // Determine the patch of each vertex. Vertices shared by multiple patches are border vertices.
+    constexpr int Unassigned = -1;
+    constexpr int Border = -2;
+    std::vector<int> vertexPatches(numPoints, Unassigned);
+
+    for (vtkIdType i = 0; i < numTriangles; ++i)
+    {
+      const auto patch = static_cast<int>(trianglePatches[i]);
+      const auto* ids = view.GetTriangle(i);
+
+      for (int j = 0; j < 3; ++j)
+      {
+        auto& vertexPatch = vertexPatches[ids[j]];
+
+        if (Unassigned == vertexPatch)
+        {
+          vertexPatch = patch;
+        }
+        else if (patch != vertexPatch)
+        {
+          vertexPatch = Border;
+        }
+      }
+    }
+
+    std::vector<std::vector<vtkIdType>> patchTriangles(numPatches);
+
+    for (vtkIdType i = 0; i < numTriangles; ++i)
+      patchTriangles[trianglePatches[i]].push_back(i);
+
+    std::vector<Mesh> meshes(numPatches);
+    std::vector<OpenMesh::VPropHandleT<vtkIdType>> globalIdProperties(numPatches);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int patch = 0; patch < static_cast<int>(numPatches); ++patch)
+    {
+      auto& mesh = meshes[patch];
+      auto& globalId = globalIdProperties[patch];
+      const auto& triangles = patchTriangles[patch];
+
+      mesh.add_property(globalId);
+      mesh.request_vertex_status();
+      mesh.reserve(triangles.size(), 3 * triangles.size() / 2, triangles.size());
+
+      std::unordered_map<vtkIdType, Mesh::VertexHandle> localVertices;
+      localVertices.reserve(triangles.size());
+      size_t numBorderVertices = 0;
+      std::array<Mesh::VertexHandle, 3> vertexHandles;
+
+      for (auto triangle : triangles)
+      {
+        const auto* ids = view.GetTriangle(triangle);
+
+        for (int j = 0; j < 3; ++j)
+        {
+          auto iter = localVertices.find(ids[j]);
+
+          if (localVertices.end() == iter)
+          {
+            auto vertexHandle = mesh.add_vertex(Mesh::Point(view.GetPoint(ids[j])));
+            mesh.property(globalId, vertexHandle) = ids[j];
+
+            if (Border == vertexPatches[ids[j]])
+            {
+              mesh.status(vertexHandle).set_locked(true);
+              ++numBorderVertices;
+            }
+
+            iter = localVertices.emplace(ids[j], vertexHandle).first;
+          }
+
+          vertexHandles[j] = iter->second;
+        }
+
+        mesh.add_face(vertexHandles.data(), 3);
+      }
+
+      const auto numInteriorVertices = mesh.n_vertices() - numBorderVertices;
+      DecimateMesh(mesh, numBorderVertices + static_cast<size_t>(numInteriorVertices * percent));
+    }
+
+    // Stitch the patches together. Border vertices keep their global ids and are merged.
+    std::vector<vtkIdType> patchOffsets(numPatches + 1, 0);
+    std::vector<vtkIdType> triangleOffsets(numPatches + 1, 0);
+
+    for (unsigned int patch = 0; patch < numPatches; ++patch)
+    {
+      patchOffsets[patch + 1] = patchOffsets[patch] + static_cast<vtkIdType>(meshes[patch].n_vertices());
+      triangleOffsets[patch + 1] = triangleOffsets[patch] + static_cast<vtkIdType>(meshes[patch].n_faces());
+    }
+
+    std::vector<vtkIdType> outputIds(patchOffsets.back());
+    std::unordered_map<vtkIdType, vtkIdType> borderIds;
+    vtkIdType numOutputPoints = 0;
+
+    for (unsigned int patch = 0; patch < numPatches; ++patch)
+    {
+      const auto& mesh = meshes[patch];
+
+      for (const auto& vertex : mesh.vertices())
+      {
+        auto& outputId = outputIds[patchOffsets[patch] + vertex.idx()];
+
+        if (mesh.status(vertex).locked())
+        {
+          auto iter = borderIds.emplace(mesh.property(globalIdProperties[patch], vertex), numOutputPoints).first;
+          outputId = iter->second;
+
+          if (outputId != numOutputPoints)
+            continue;
+        }
+        else
+        {
+          outputId = numOutputPoints;
+        }
+
+        ++numOutputPoints;
+      }
+    }
+
+    auto coords = AllocateCoords(numOutputPoints);
+    auto connectivity = AllocateConnectivity(triangleOffsets.back());
+    auto* outputPoints = coords->GetPointer(0);
+    auto* outputConnectivity = connectivity->GetPointer(0);
+
+#pragma omp parallel for
+    for (int patch = 0; patch < static_cast<int>(numPatches); ++patch)
+    {
+      const auto& mesh = meshes[patch];
+      const auto* patchIds = &outputIds[patchOffsets[patch]];
+
+      for (const auto& vertex : mesh.vertices())
+        std::memcpy(outputPoints + 3 * patchIds[vertex.idx()], mesh.point(vertex).data(), sizeof(Mesh::Point));
+
+      auto* ids = outputConnectivity + 3 * triangleOffsets[patch];
+
+      for (const auto& face : mesh.faces())
+      {
+        for (const auto& vertex : mesh.fv_range(face))
+          *ids++ = patchIds[vertex.idx()];
+      }
+    }
+
+    return CreateTrianglePolyData(coords, connectivity);
+  }
+
+  /** \brief Apply ProcessPolyData to all time steps of a surface, concurrently if parallelTimeSteps is true.
+    */
+  mitk::Surface::Pointer ProcessEachTimeStep(const mitk::Surface* input, bool calculateNormals, bool flipNormals, bool parallelTimeSteps, const std::function<vtkSmartPointer<vtkPolyData>(vtkPolyData*)>& ProcessPolyData)
   {
     if (nullptr == input || !input->IsInitialized())
       return nullptr;
 
-    auto output = mitk::Surface::New();
     const auto numTimeSteps = input->GetTimeSteps();
+    std::vector<vtkSmartPointer<vtkPolyData>> polyDatas(numTimeSteps);
 
     for (std::remove_const_t<decltype(numTimeSteps)> t = 0; t < numTimeSteps; ++t)
+      polyDatas[t] = input->GetVtkPolyData(t);
+
+#pragma omp parallel for schedule(dynamic) if(parallelTimeSteps)
+    for (int t = 0; t < static_cast<int>(numTimeSteps); ++t)
     {
-      vtkSmartPointer<vtkPolyData> polyData = input->GetVtkPolyData(t);
+      auto& polyData = polyDatas[t];
 
       if (IsValidPolyData(polyData))
       {
@@ -146,40 +492,41 @@ namespace
 
         if (IsValidPolyData(polyData))
         {
-          auto mesh = ConvertPolyDataToMesh(polyData);
-          ProcessMesh(mesh);
-          polyData = ConvertMeshToPolyData(mesh);
+          polyData = ProcessPolyData(polyData);
 
           if (calculateNormals)
             polyData = CalculateNormals(polyData, flipNormals);
 
-          output->SetVtkPolyData(polyData, t);
           continue;
         }
       }
 
-      output->SetVtkPolyData(nullptr, t);
+      polyData = nullptr;
     }
 
+    auto output = mitk::Surface::New();
+
+    for (std::remove_const_t<decltype(numTimeSteps)> t = 0; t < numTimeSteps; ++t)
+      output->SetVtkPolyData(polyDatas[t], t);
+
     return output;
   }
 }
 
-mitk::Surface::Pointer mitk::Remeshing::Decimate(const Surface* input, double percent, bool calculateNormals, bool flipNormals)
+mitk::Surface::Pointer mitk::Remeshing::Decimate(const Surface* input, double percent, bool calculateNormals, bool flipNormals, unsigned int numberOfPatches)
 {
-  return ProcessEachTimeStep(input, calculateNormals, flipNormals, [percent](Mesh& mesh) {
-    using Decimater = OpenMesh::Decimater::DecimaterT<Mesh>;
-    using HModQuadric = OpenMesh::Decimater::ModQuadricT<Mesh>::Handle;
+  percent = std::max(0.0, std::min(percent, 1.0));
 
-    Decimater decimater(mesh);
+  // Only one level is parallelized: patches if a partitioning is requested, time steps otherwise.
+  const bool parallelTimeSteps = numberOfPatches <= 1;
 
-    HModQuadric hModQuadric;
-    decimater.add(hModQuadric);
-    decimater.module(hModQuadric).unset_max_err();
+  return ProcessEachTimeStep(input, calculateNormals, flipNormals, parallelTimeSteps, [percent, numberOfPatches](vtkPolyData* polyData) {
+    if (1 < numberOfPatches)
+      return DecimatePartitioned(polyData, percent, numberOfPatches);
 
-    decimater.initialize();
-    decimater.decimate_to(mesh.n_vertices() * std::max(0.0, std::min(percent, 1.0)));
+    auto mesh = ConvertPolyDataToMesh(polyData);
+    DecimateMesh(mesh, static_cast<size_t>(mesh.n_vertices() * percent));
 
-    mesh.garbage_collection();
+    return ConvertMeshToPolyData(mesh);
   });
 }
@@ -0,0 +1,107 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkRemeshing.h>
+
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkSphereSource.h>
+
+class mitkRemeshingTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkRemeshingTestSuite);
+  MITK_TEST(Decimate_MultipleTimeSteps_DecimatesEachTimeStep);
+  MITK_TEST(Decimate_MultipleTimeStepsWithPatches_DecimatesEachTimeStep);
+  MITK_TEST(Decimate_EmptyTimeStep_KeepsOtherTimeSteps);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Surface::Pointer m_Surface;
+
+  static vtkSmartPointer<vtkPolyData> CreateSphere(int resolution, double radius)
+  {
+    auto sphereSource = vtkSmartPointer<vtkSphereSource>::New();
+    sphereSource->SetThetaResolution(resolution);
+    sphereSource->SetPhiResolution(resolution);
+    sphereSource->SetRadius(radius);
+    sphereSource->Update();
+
+    return sphereSource->GetOutput();
+  }
+
+  void CheckDecimatedTimeSteps(const mitk::Surface *output)
+  {
+    CPPUNIT_ASSERT(output != nullptr);
+    CPPUNIT_ASSERT_EQUAL(m_Surface->GetTimeSteps(), output->GetTimeSteps());
+
+    for (unsigned int t = 0; t < m_Surface->GetTimeSteps(); ++t)
+    {
+      auto *inputPolyData = m_Surface->GetVtkPolyData(t);
+      auto *outputPolyData = output->GetVtkPolyData(t);
+
+      CPPUNIT_ASSERT(outputPolyData != nullptr);
+      CPPUNIT_ASSERT(outputPolyData->GetNumberOfPolys() > 0);
+      CPPUNIT_ASSERT(outputPolyData->GetNumberOfPoints() < inputPolyData->GetNumberOfPoints());
+      CPPUNIT_ASSERT(outputPolyData->GetNumberOfPoints() >= inputPolyData->GetNumberOfPoints() / 4);
+
+      // the time steps must not be mixed up
+      double inputBounds[6];
+      double outputBounds[6];
+      inputPolyData->GetBounds(inputBounds);
+      outputPolyData->GetBounds(outputBounds);
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(inputBounds[1] - inputBounds[0], outputBounds[1] - outputBounds[0], 0.5);
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    m_Surface = mitk::Surface::New();
+    m_Surface->Expand(4);
+
+    for (unsigned int t = 0; t < 4; ++t)
+      m_Surface->SetVtkPolyData(CreateSphere(30 + 10 * t, 10.0 * (t + 1)), t);
+  }
+
+  void tearDown() override { m_Surface = nullptr; }
+
+  void Decimate_MultipleTimeSteps_DecimatesEachTimeStep()
+  {
+    auto output = mitk::Remeshing::Decimate(m_Surface, 0.5);
+    this->CheckDecimatedTimeSteps(output);
+  }
+
+  void Decimate_MultipleTimeStepsWithPatches_DecimatesEachTimeStep()
+  {
+    auto output = mitk::Remeshing::Decimate(m_Surface, 0.5, true, false, 4);
+    this->CheckDecimatedTimeSteps(output);
+  }
+
+  void Decimate_EmptyTimeStep_KeepsOtherTimeSteps()
+  {
+    m_Surface->SetVtkPolyData(vtkSmartPointer<vtkPolyData>::New(), 2);
+
+    auto output = mitk::Remeshing::Decimate(m_Surface, 0.5);
+
+    CPPUNIT_ASSERT(output.IsNotNull());
+    CPPUNIT_ASSERT_EQUAL(m_Surface->GetTimeSteps(), output->GetTimeSteps());
+    CPPUNIT_ASSERT(output->GetVtkPolyData(2) == nullptr || output->GetVtkPolyData(2)->GetNumberOfPoints() == 0);
+
+    for (unsigned int t : {0u, 1u, 3u})
+      CPPUNIT_ASSERT(output->GetVtkPolyData(t)->GetNumberOfPoints() < m_Surface->GetVtkPolyData(t)->GetNumberOfPoints());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkRemeshing)
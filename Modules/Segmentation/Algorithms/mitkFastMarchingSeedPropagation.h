@@ -0,0 +1,141 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef mitkFastMarchingSeedPropagation_h
+#define mitkFastMarchingSeedPropagation_h
+
+#include <itkNumericTraits.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace mitk
+{
+  /** \brief Propagates the fronts of additional seeds into arrival times computed by
+   * itk::FastMarchingImageFilter.
+   *
+   * New seeds can only decrease arrival times, so only the pixels that are reached earlier from
+   * one of the new seeds are visited. Pixel values are computed with the same first order upwind
+   * scheme as used by the ITK filter. Arrival times below the stopping value are equal to the ones
+   * of a fast marching run on all seeds, up to floating point rounding.
+   *
+   * \ingroup Segmentation */
+  template <typename TImage>
+  void PropagateAdditionalFastMarchingSeeds(TImage* arrivalTimes, const TImage* speed,
+    const std::vector<typename TImage::IndexType>& seeds, double stoppingValue)
+  {
+    typedef typename TImage::IndexType IndexType;
+    typedef typename TImage::PixelType PixelType;
+    typedef std::pair<double, IndexType> HeapEntryType;
+
+    struct HeapEntryCompare
+    {
+      bool operator()(const HeapEntryType& a, const HeapEntryType& b) const { return a.first > b.first; }
+    };
+
+    const unsigned int dimension = TImage::ImageDimension;
+    const double largeValue = static_cast<double>(itk::NumericTraits<PixelType>::max()) / 2.0;
+    const auto region = arrivalTimes->GetBufferedRegion();
+    const auto spacing = arrivalTimes->GetSpacing();
+
+    auto solve = [&](const IndexType& index)
+    {
+      const double speedValue = speed->GetPixel(index);
+      if (speedValue <= 0.0)
+        return largeValue;
+
+      // smallest neighbor value and squared inverse spacing per axis
+      std::array<std::pair<double, double>, TImage::ImageDimension> neighbors;
+      unsigned int numberOfNeighbors = 0;
+      for (unsigned int axis = 0; axis < dimension; ++axis)
+      {
+        double minValue = largeValue;
+        for (int offset = -1; offset <= 1; offset += 2)
+        {
+          IndexType neighbor = index;
+          neighbor[axis] += offset;
+          if (region.IsInside(neighbor))
+            minValue = std::min(minValue, static_cast<double>(arrivalTimes->GetPixel(neighbor)));
+        }
+        if (minValue < largeValue)
+          neighbors[numberOfNeighbors++] = std::make_pair(minValue, 1.0 / (spacing[axis] * spacing[axis]));
+      }
+      std::sort(neighbors.begin(), neighbors.begin() + numberOfNeighbors);
+
+      double aa = 0.0;
+      double bb = 0.0;
+      double cc = -1.0 / (speedValue * speedValue);
+      double solution = largeValue;
+      for (unsigned int i = 0; i < numberOfNeighbors && solution >= neighbors[i].first; ++i)
+      {
+        aa += neighbors[i].second;
+        bb += neighbors[i].first * neighbors[i].second;
+        cc += neighbors[i].first * neighbors[i].first * neighbors[i].second;
+
+        const double discriminant = bb * bb - aa * cc;
+        if (discriminant < 0.0)
+          break;
+        solution = (std::sqrt(discriminant) + bb) / aa;
+      }
+      return solution;
+    };
+
+    std::priority_queue<HeapEntryType, std::vector<HeapEntryType>, HeapEntryCompare> trialHeap;
+    for (const auto& seed : seeds)
+    {
+      if (region.IsInside(seed) && arrivalTimes->GetPixel(seed) > 0)
+      {
+        arrivalTimes->SetPixel(seed, 0);
+        trialHeap.push(std::make_pair(0.0, seed));
+      }
+    }
+
+    while (!trialHeap.empty())
+    {
+      const HeapEntryType current = trialHeap.top();
+      trialHeap.pop();
+
+      if (current.first != static_cast<double>(arrivalTimes->GetPixel(current.second)))
+        continue; // outdated entry, the pixel was reached earlier in the meantime
+
+      if (current.first > stoppingValue)
+        break;
+
+      for (unsigned int axis = 0; axis < dimension; ++axis)
+      {
+        for (int offset = -1; offset <= 1; offset += 2)
+        {
+          IndexType neighbor = current.second;
+          neighbor[axis] += offset;
+          if (!region.IsInside(neighbor))
+            continue;
+
+          // compare in pixel precision, so that every accepted update strictly decreases the value
+          const auto value = static_cast<PixelType>(solve(neighbor));
+          if (value < arrivalTimes->GetPixel(neighbor))
+          {
+            arrivalTimes->SetPixel(neighbor, value);
+            trialHeap.push(std::make_pair(static_cast<double>(value), neighbor));
+          }
+        }
+      }
+    }
+
+    arrivalTimes->Modified();
+  }
+}
+
+#endif
@@ -14,15 +14,15 @@ found in the LICENSE file.
 
 #include "mitkImageCast.h"
 #include "mitkImageReadAccessor.h"
-#include "mitkImageTimeSelector.h"
 #include <mitkExtractSliceFilter.h>
 #include <mitkImageAccessByItk.h>
+#include <mitkPixelTypeMultiplex.h>
 //#include <mitkPlaneGeometry.h>
 
 #include <itkCommand.h>
 #include <itkImage.h>
-#include <itkImageSliceConstIteratorWithIndex.h>
 
+#include <algorithm>
 #include <thread>
 
 namespace
@@ -110,6 +110,12 @@ void mitk::SegmentationInterpolationController::SetSegmentationVolume(const Imag
 {
   // clear old information (remove all time steps
   m_SegmentationCountInSlice.clear();
+  m_NonEmptySlices.clear();
+  m_TimeStepScanned.clear();
+  {
+    std::lock_guard<std::mutex> lock(m_SliceImageCacheMutex);
+    m_SliceImageCache.clear();
+  }
 
   // delete this from the list of interpolators
   auto iter = s_InterpolatorForImage.find(segmentation);
@@ -144,9 +150,11 @@ void mitk::SegmentationInterpolationController::SetSegmentationVolume(const Imag
   m_SegmentationModifiedObserverTag.second = true;
 
   m_SegmentationCountInSlice.resize(m_Segmentation->GetTimeSteps());
+  m_NonEmptySlices.resize(m_Segmentation->GetTimeSteps());
   for (unsigned int timeStep = 0; timeStep < m_Segmentation->GetTimeSteps(); ++timeStep)
   {
     m_SegmentationCountInSlice[timeStep].resize(3);
+    m_NonEmptySlices[timeStep].resize(3);
     for (unsigned int dim = 0; dim < 3; ++dim)
     {
       m_SegmentationCountInSlice[timeStep][dim].clear();
@@ -155,19 +163,10 @@ void mitk::SegmentationInterpolationController::SetSegmentationVolume(const Imag
     }
   }
 
-  s_InterpolatorForImage.insert(std::make_pair(m_Segmentation, this));
+  // the time steps are scanned on demand, see EnsureTimeStepScanned()
+  m_TimeStepScanned.assign(m_Segmentation->GetTimeSteps(), false);
 
-  // for all timesteps
-  // scan whole image
-  for (unsigned int timeStep = 0; timeStep < m_Segmentation->GetTimeSteps(); ++timeStep)
-  {
-    ImageTimeSelector::Pointer timeSelector = ImageTimeSelector::New();
-    timeSelector->SetInput(m_Segmentation);
-    timeSelector->SetTimeNr(timeStep);
-    timeSelector->UpdateLargestPossibleRegion();
-    Image::Pointer segmentation3D = timeSelector->GetOutput();
-    AccessFixedDimensionByItk_2(segmentation3D, ScanWholeVolume, 3, m_Segmentation, timeStep);
-  }
+  s_InterpolatorForImage.insert(std::make_pair(m_Segmentation, this));
 
   // PrintStatus();
 
@@ -211,6 +210,14 @@ void mitk::SegmentationInterpolationController::SetChangedVolume(const Image *sl
     return;
   if (sliceDiff->GetDimension() != 3)
     return;
+  if (timeStep >= m_SegmentationCountInSlice.size())
+    return;
+
+  this->InvalidateSliceImageCache(timeStep);
+
+  // a time step that is not scanned yet will see the change when it is scanned
+  if (!m_TimeStepScanned[timeStep])
+    return;
 
   AccessFixedDimensionByItk_1(sliceDiff, ScanChangedVolume, 3, timeStep);
 
@@ -232,6 +239,12 @@ void mitk::SegmentationInterpolationController::SetChangedSlice(const Image *sli
   if (sliceIndex >= m_SegmentationCountInSlice[timeStep][sliceDimension].size())
     return;
 
+  this->InvalidateSliceImageCache(sliceDimension, sliceIndex, timeStep);
+
+  // a time step that is not scanned yet will see the change when it is scanned
+  if (!m_TimeStepScanned[timeStep])
+    return;
+
   unsigned int dim0(0);
   unsigned int dim1(1);
 
@@ -312,6 +325,13 @@ void mitk::SegmentationInterpolationController::ScanChangedSlice(const itk::Imag
   assert((signed)m_SegmentationCountInSlice[timeStep][sliceDimension][sliceIndex] + numberOfPixels >= 0);
   m_SegmentationCountInSlice[timeStep][sliceDimension][sliceIndex] += numberOfPixels;
 
+  this->UpdateNonEmptySlices(timeStep, dim0);
+  this->UpdateNonEmptySlices(timeStep, dim1);
+  if (m_SegmentationCountInSlice[timeStep][sliceDimension][sliceIndex] > 0)
+    m_NonEmptySlices[timeStep][sliceDimension].insert(sliceIndex);
+  else
+    m_NonEmptySlices[timeStep][sliceDimension].erase(sliceIndex);
+
   // MITK_INFO << "scan t=" << timeStep << " from (0,0) to (" << dim0max << "," << dim1max << ") (" << pixelData << "-"
   // << pixelData+dim0max*dim1max-1 <<  ") in slice " << sliceIndex << " found " << numberOfPixels << " pixels" <<
   // std::endl;
@@ -321,83 +341,178 @@ template <typename TPixel, unsigned int VImageDimension>
 void mitk::SegmentationInterpolationController::ScanChangedVolume(const itk::Image<TPixel, VImageDimension> *diffImage,
                                                                   unsigned int timeStep)
 {
-  typedef itk::ImageSliceConstIteratorWithIndex<itk::Image<TPixel, VImageDimension>> IteratorType;
-
-  IteratorType iter(diffImage, diffImage->GetLargestPossibleRegion());
-  iter.SetFirstDirection(0);
-  iter.SetSecondDirection(1);
-
-  int numberOfPixels(0); // number of pixels in this slice that are not 0
+  const auto size = diffImage->GetLargestPossibleRegion().GetSize();
+  const auto dimX = std::min<unsigned int>(size[0], m_SegmentationCountInSlice[timeStep][0].size());
+  const auto dimY = std::min<unsigned int>(size[1], m_SegmentationCountInSlice[timeStep][1].size());
+  const auto dimZ = std::min<unsigned int>(size[2], m_SegmentationCountInSlice[timeStep][2].size());
 
-  typename IteratorType::IndexType index;
-  unsigned int x = 0;
-  unsigned int y = 0;
-  unsigned int z = 0;
+  const TPixel *pixelData = diffImage->GetBufferPointer();
 
-  iter.GoToBegin();
-  while (!iter.IsAtEnd())
+  for (unsigned int z = 0; z < dimZ; ++z)
   {
-    while (!iter.IsAtEndOfSlice())
-    {
-      while (!iter.IsAtEndOfLine())
-      {
-        index = iter.GetIndex();
+    int numberOfPixels(0); // number of pixels in this slice that are not 0
 
-        x = index[0];
-        y = index[1];
-        z = index[2];
+    for (unsigned int y = 0; y < dimY; ++y)
+    {
+      const TPixel *line = pixelData + (static_cast<std::size_t>(z) * size[1] + y) * size[0];
+      int numberOfPixelsInLine(0);
 
-        TPixel value = iter.Get();
+      for (unsigned int x = 0; x < dimX; ++x)
+      {
+        const TPixel value = line[x];
+        if (value == 0)
+          continue;
 
         assert((signed)m_SegmentationCountInSlice[timeStep][0][x] + (signed)value >=
                0); // just for debugging. This must always be true, otherwise some counting is going wrong
-        assert((signed)m_SegmentationCountInSlice[timeStep][1][y] + (signed)value >= 0);
 
         m_SegmentationCountInSlice[timeStep][0][x] =
           static_cast<unsigned int>(m_SegmentationCountInSlice[timeStep][0][x] + value);
-        m_SegmentationCountInSlice[timeStep][1][y] =
-          static_cast<unsigned int>(m_SegmentationCountInSlice[timeStep][1][y] + value);
-
-        numberOfPixels += static_cast<int>(value);
-
-        ++iter;
+        numberOfPixelsInLine += static_cast<int>(value);
       }
-      iter.NextLine();
+
+      assert((signed)m_SegmentationCountInSlice[timeStep][1][y] + numberOfPixelsInLine >= 0);
+      m_SegmentationCountInSlice[timeStep][1][y] += numberOfPixelsInLine;
+      numberOfPixels += numberOfPixelsInLine;
     }
+
     assert((signed)m_SegmentationCountInSlice[timeStep][2][z] + numberOfPixels >= 0);
     m_SegmentationCountInSlice[timeStep][2][z] += numberOfPixels;
-    numberOfPixels = 0;
-
-    iter.NextSlice();
   }
+
+  for (unsigned int dim = 0; dim < 3; ++dim)
+    this->UpdateNonEmptySlices(timeStep, dim);
 }
 
 template <typename DATATYPE>
-void mitk::SegmentationInterpolationController::ScanWholeVolume(const itk::Image<DATATYPE, 3> *,
-                                                                const Image *volume,
-                                                                unsigned int timeStep)
+void mitk::SegmentationInterpolationController::ScanWholeVolume(const PixelType &, unsigned int timeStep)
 {
-  if (!volume)
-    return;
-  if (timeStep >= m_SegmentationCountInSlice.size())
-    return;
+  const unsigned int dimX = m_Segmentation->GetDimension(0);
+  const unsigned int dimY = m_Segmentation->GetDimension(1);
+  const unsigned int dimZ = m_Segmentation->GetDimension(2);
+
+  ImageReadAccessor readAccess(m_Segmentation, m_Segmentation->GetVolumeData(timeStep));
+  const auto *rawVolume =
+    static_cast<const DATATYPE *>(readAccess.GetData()); // we again promise not to change anything, we'll just count
+
+  auto &countInSlice = m_SegmentationCountInSlice[timeStep];
+
+  // The slices are distributed over the threads. Each slice count is written by exactly one thread,
+  // the counts of the other two dimensions are accumulated per thread and summed up afterwards.
+  const unsigned int numberOfThreads = std::max(1u, std::min(std::thread::hardware_concurrency(), dimZ));
+  std::vector<DirtyVectorType> countInX(numberOfThreads, DirtyVectorType(dimX, 0));
+  std::vector<DirtyVectorType> countInY(numberOfThreads, DirtyVectorType(dimY, 0));
 
-  ImageReadAccessor readAccess(volume, volume->GetVolumeData(timeStep));
+  auto scanSlices = [&](unsigned int threadIndex) {
+    auto &threadCountInX = countInX[threadIndex];
+    auto &threadCountInY = countInY[threadIndex];
 
-  for (unsigned int slice = 0; slice < volume->GetDimension(2); ++slice)
+    for (unsigned int z = threadIndex; z < dimZ; z += numberOfThreads)
+    {
+      const DATATYPE *rawSlice = rawVolume + static_cast<std::size_t>(dimX) * dimY * z;
+      unsigned int numberOfPixels = 0;
+
+      for (unsigned int y = 0; y < dimY; ++y)
+      {
+        const DATATYPE *line = rawSlice + static_cast<std::size_t>(dimX) * y;
+        unsigned int numberOfPixelsInLine = 0;
+
+        for (unsigned int x = 0; x < dimX; ++x)
+        {
+          if (line[x] == 0)
+            continue;
+
+          threadCountInX[x] = static_cast<unsigned int>(threadCountInX[x] + line[x]);
+          numberOfPixelsInLine = static_cast<unsigned int>(numberOfPixelsInLine + line[x]);
+        }
+
+        threadCountInY[y] += numberOfPixelsInLine;
+        numberOfPixels += numberOfPixelsInLine;
+      }
+
+      countInSlice[2][z] = numberOfPixels;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
+    threads.emplace_back(scanSlices, threadIndex);
+
+  scanSlices(0);
+
+  for (auto &thread : threads)
+    thread.join();
+
+  countInSlice[0].assign(dimX, 0);
+  countInSlice[1].assign(dimY, 0);
+  for (unsigned int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
   {
-    const auto *rawVolume =
-      static_cast<const DATATYPE *>(readAccess.GetData()); // we again promise not to change anything, we'll just count
-    const DATATYPE *rawSlice = rawVolume + (volume->GetDimension(0) * volume->GetDimension(1) * slice);
+    for (unsigned int x = 0; x < dimX; ++x)
+      countInSlice[0][x] += countInX[threadIndex][x];
+    for (unsigned int y = 0; y < dimY; ++y)
+      countInSlice[1][y] += countInY[threadIndex][y];
+  }
+
+  for (unsigned int dim = 0; dim < 3; ++dim)
+    this->UpdateNonEmptySlices(timeStep, dim);
+}
 
-    ScanChangedSlice<DATATYPE>(nullptr, SetChangedSliceOptions(2, slice, 0, 1, timeStep, rawSlice));
+void mitk::SegmentationInterpolationController::EnsureTimeStepScanned(unsigned int timeStep)
+{
+  std::lock_guard<std::mutex> lock(m_ScanMutex);
+
+  if (m_Segmentation.IsNull() || timeStep >= m_TimeStepScanned.size() || m_TimeStepScanned[timeStep])
+    return;
+
+  mitkPixelTypeMultiplex1(ScanWholeVolume, m_Segmentation->GetPixelType(), timeStep);
+  m_TimeStepScanned[timeStep] = true;
+}
+
+void mitk::SegmentationInterpolationController::UpdateNonEmptySlices(unsigned int timeStep, unsigned int dimension)
+{
+  const auto &countInSlice = m_SegmentationCountInSlice[timeStep][dimension];
+  auto &nonEmptySlices = m_NonEmptySlices[timeStep][dimension];
+
+  nonEmptySlices.clear();
+  for (unsigned int index = 0; index < countInSlice.size(); ++index)
+  {
+    if (countInSlice[index] > 0)
+      nonEmptySlices.insert(nonEmptySlices.end(), index);
   }
 }
 
+bool mitk::SegmentationInterpolationController::GetNeighboringSegmentedSlices(unsigned int sliceDimension,
+                                                                              unsigned int sliceIndex,
+                                                                              unsigned int timeStep,
+                                                                              unsigned int &lowerBound,
+                                                                              unsigned int &upperBound)
+{
+  if (sliceDimension > 2 || timeStep >= m_NonEmptySlices.size())
+    return false;
+
+  this->EnsureTimeStepScanned(timeStep);
+
+  const auto &nonEmptySlices = m_NonEmptySlices[timeStep][sliceDimension];
+
+  auto lower = nonEmptySlices.lower_bound(sliceIndex);
+  if (lower == nonEmptySlices.begin())
+    return false;
+
+  auto upper = nonEmptySlices.upper_bound(sliceIndex);
+  if (upper == nonEmptySlices.end())
+    return false;
+
+  lowerBound = *std::prev(lower);
+  upperBound = *upper;
+  return true;
+}
+
 void mitk::SegmentationInterpolationController::PrintStatus()
 {
   unsigned int timeStep(0); // if needed, put a loop over time steps around everyting, but beware, output will be long
 
+  this->EnsureTimeStepScanned(timeStep);
+
   MITK_INFO << "Interpolator status (timestep 0): dimensions " << m_SegmentationCountInSlice[timeStep][0].size() << " "
             << m_SegmentationCountInSlice[timeStep][1].size() << " " << m_SegmentationCountInSlice[timeStep][2].size()
             << std::endl;
@@ -468,6 +583,8 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
   if (sliceDimension > 2)
     return nullptr;
 
+  this->EnsureTimeStepScanned(timeStep);
+
   if (0 == sliceIndex)
     return nullptr; // First slice, nothing to interpolate
 
@@ -481,35 +598,8 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
 
   unsigned int lowerBound = 0;
   unsigned int upperBound = 0;
-  bool bounds = false;
-
-  for (lowerBound = sliceIndex - 1; ; --lowerBound)
-  {
-    if (m_SegmentationCountInSlice[timeStep][sliceDimension][lowerBound] > 0)
-    {
-      bounds = true;
-      break;
-    }
-
-    if (0 == lowerBound)
-      break;
-  }
 
-  if (!bounds)
-    return nullptr;
-
-  bounds = false;
-
-  for (upperBound = sliceIndex + 1; upperBound <= lastSliceIndex; ++upperBound)
-  {
-    if (m_SegmentationCountInSlice[timeStep][sliceDimension][upperBound] > 0)
-    {
-      bounds = true;
-      break;
-    }
-  }
-
-  if (!bounds)
+  if (!this->GetNeighboringSegmentedSlices(sliceDimension, sliceIndex, timeStep, lowerBound, upperBound))
     return nullptr;
 
   // We have found two neighboring slices with segmentations and made sure that the current slice does not contain anything
@@ -521,7 +611,7 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
   try
   {
     // Extract current slice
-    resultImage = this->ExtractSlice(currentPlane, sliceIndex, timeStep);
+    resultImage = this->ExtractSlice(currentPlane, sliceDimension, sliceIndex, timeStep);
 
     // Creating PlaneGeometry for lower slice
     auto reslicePlane = currentPlane->Clone();
@@ -534,7 +624,7 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
     reslicePlane->SetOrigin(origin);
 
     // Extract lower slice
-    lowerSlice = this->ExtractSlice(reslicePlane, lowerBound, timeStep, true);
+    lowerSlice = this->ExtractSlice(reslicePlane, sliceDimension, lowerBound, timeStep, true);
 
     if (lowerSlice.IsNull())
       return nullptr;
@@ -546,7 +636,7 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
     reslicePlane->SetOrigin(origin);
 
     // Extract the upper slice
-    upperSlice = this->ExtractSlice(reslicePlane, upperBound, timeStep, true);
+    upperSlice = this->ExtractSlice(reslicePlane, sliceDimension, upperBound, timeStep, true);
 
     if (upperSlice.IsNull())
       return nullptr;
@@ -581,10 +671,10 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::Interpolate(unsi
     m_ReferenceImage);
 }
 
-mitk::Image::Pointer mitk::SegmentationInterpolationController::ExtractSlice(const PlaneGeometry* planeGeometry, unsigned int sliceIndex, unsigned int timeStep, bool cache)
+mitk::Image::Pointer mitk::SegmentationInterpolationController::ExtractSlice(const PlaneGeometry* planeGeometry, unsigned int sliceDimension, unsigned int sliceIndex, unsigned int timeStep, bool cache)
 {
   static const auto MAX_CACHE_SIZE = 2 * std::thread::hardware_concurrency();
-  const auto key = std::make_pair(sliceIndex, timeStep);
+  const auto key = std::make_tuple(sliceDimension, sliceIndex, timeStep);
 
   if (cache && m_EnableSliceImageCache)
   {
@@ -614,6 +704,38 @@ mitk::Image::Pointer mitk::SegmentationInterpolationController::ExtractSlice(con
   return extractor->GetOutput();
 }
 
+void mitk::SegmentationInterpolationController::InvalidateSliceImageCache(unsigned int sliceDimension, unsigned int sliceIndex, unsigned int timeStep)
+{
+  std::lock_guard<std::mutex> lock(m_SliceImageCacheMutex);
+
+  // the changed slice intersects all slices of the other two dimensions
+  for (auto iter = m_SliceImageCache.begin(); iter != m_SliceImageCache.end();)
+  {
+    if (std::get<2>(iter->first) == timeStep &&
+        (std::get<0>(iter->first) != sliceDimension || std::get<1>(iter->first) == sliceIndex))
+    {
+      iter = m_SliceImageCache.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+}
+
+void mitk::SegmentationInterpolationController::InvalidateSliceImageCache(unsigned int timeStep)
+{
+  std::lock_guard<std::mutex> lock(m_SliceImageCacheMutex);
+
+  for (auto iter = m_SliceImageCache.begin(); iter != m_SliceImageCache.end();)
+  {
+    if (std::get<2>(iter->first) == timeStep)
+      iter = m_SliceImageCache.erase(iter);
+    else
+      ++iter;
+  }
+}
+
 void mitk::SegmentationInterpolationController::EnableSliceImageCache()
 {
   m_EnableSliceImageCache = true;
@@ -23,6 +23,8 @@ found in the LICENSE file.
 
 #include <map>
 #include <mutex>
+#include <set>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -60,6 +62,11 @@ namespace mitk
     each dimension).
     Each item describes one image dimension, each vector item holds the count of pixels in "its" slice.
 
+    The counts of a time step are computed when they are needed for the first time (i.e. by Interpolate()), so setting
+    a large 3D+t segmentation does not scan all time steps at once. Afterwards they are kept up to date by the
+    difference images passed to SetChangedSlice() and SetChangedVolume(). Additionally the indices of all non-empty
+    slices are kept in sorted sets, so the neighboring segmented slices of a slice can be found in logarithmic time.
+
     $Author$
   */
   class MITKSEGMENTATION_EXPORT SegmentationInterpolationController : public itk::Object
@@ -126,6 +133,23 @@ namespace mitk
                          unsigned int timeStep);
     void SetChangedVolume(const Image *sliceDiff, unsigned int timeStep);
 
+    /**
+      \brief Finds the nearest slices below and above the given slice that contain segmentation pixels.
+
+      \param sliceDimension Number of the dimension which is constant for all pixels of the meant slice.
+
+      \param sliceIndex The slice to start from. It is not considered itself.
+
+      \param timeStep Which time step to use
+
+      \return false if there is no segmented slice on either side.
+    */
+    bool GetNeighboringSegmentedSlices(unsigned int sliceDimension,
+                                       unsigned int sliceIndex,
+                                       unsigned int timeStep,
+                                       unsigned int &lowerBound,
+                                       unsigned int &upperBound);
+
     /**
       \brief Generates an interpolated image for the given slice.
 
@@ -193,6 +217,7 @@ namespace mitk
     // used for implementation
     typedef std::vector<std::vector<DirtyVectorType>> TimeResolvedDirtyVectorType;
     typedef std::map<const Image *, SegmentationInterpolationController *> InterpolatorMapType;
+    typedef std::vector<std::vector<std::set<unsigned int>>> TimeResolvedSliceIndexSetType;
 
     SegmentationInterpolationController(); // purposely hidden
     ~SegmentationInterpolationController() override;
@@ -204,15 +229,28 @@ namespace mitk
     template <typename TPixel, unsigned int VImageDimension>
     void ScanChangedVolume(const itk::Image<TPixel, VImageDimension> *, unsigned int timeStep);
 
+    /// scan of one time step of the segmentation, distributed over several threads
     template <typename DATATYPE>
-    void ScanWholeVolume(const itk::Image<DATATYPE, 3> *, const Image *volume, unsigned int timeStep);
+    void ScanWholeVolume(const PixelType &, unsigned int timeStep);
+
+    /// scans the given time step if this did not happen since the segmentation was set
+    void EnsureTimeStepScanned(unsigned int timeStep);
+
+    /// updates m_NonEmptySlices from the counts of all slices of the given dimension
+    void UpdateNonEmptySlices(unsigned int timeStep, unsigned int dimension);
+
+    /// removes cached slices that are affected by a change of the given slice
+    void InvalidateSliceImageCache(unsigned int sliceDimension, unsigned int sliceIndex, unsigned int timeStep);
+
+    /// removes all cached slices of the given time step
+    void InvalidateSliceImageCache(unsigned int timeStep);
 
     void PrintStatus();
 
     /**
      * Extract a slice and optionally use a caching mechanism if enabled.
     */
-    mitk::Image::Pointer ExtractSlice(const PlaneGeometry* planeGeometry, unsigned int sliceIndex, unsigned int timeStep, bool cache = false);
+    mitk::Image::Pointer ExtractSlice(const PlaneGeometry* planeGeometry, unsigned int sliceDimension, unsigned int sliceIndex, unsigned int timeStep, bool cache = false);
 
     /**
       An array of flags. One for each dimension of the image. A flag is set, when a slice in a certain dimension
@@ -225,6 +263,13 @@ namespace mitk
     */
     TimeResolvedDirtyVectorType m_SegmentationCountInSlice;
 
+    /** Indices of the slices with a count > 0, e.g. m_NonEmptySlices[timeStep][2] holds the non-empty axial slices.*/
+    TimeResolvedSliceIndexSetType m_NonEmptySlices;
+
+    /** Flags which time steps have been scanned since the segmentation was set.*/
+    std::vector<bool> m_TimeStepScanned;
+    std::mutex m_ScanMutex;
+
     static InterpolatorMapType s_InterpolatorForImage;
 
     Image::ConstPointer m_Segmentation;
@@ -234,7 +279,8 @@ namespace mitk
     bool m_2DInterpolationActivated;
 
     bool m_EnableSliceImageCache;
-    std::map<std::pair<unsigned int, unsigned int>, Image::Pointer> m_SliceImageCache;
+    /** Cached slices, the key consists of slice dimension, slice index and time step.*/
+    std::map<std::tuple<unsigned int, unsigned int, unsigned int>, Image::Pointer> m_SliceImageCache;
     std::mutex m_SliceImageCacheMutex;
   };
 
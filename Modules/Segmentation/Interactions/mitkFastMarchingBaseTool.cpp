@@ -20,6 +20,7 @@ found in the LICENSE file.
 
 #include "mitkImageAccessByItk.h"
 
+#include "mitkFastMarchingSeedPropagation.h"
 #include "mitkSegTool2D.h"
 
 #include <mitkImageCast.h>
@@ -31,13 +32,14 @@ found in the LICENSE file.
 #include "itkSigmoidImageFilter.h"
 #include "itkFastMarchingImageFilter.h"
 
+#include <algorithm>
+
 // us
 #include <usGetModuleContext.h>
 #include <usModule.h>
 #include <usModuleContext.h>
 #include <usModuleResource.h>
 
-
 mitk::FastMarchingBaseTool::FastMarchingBaseTool(unsigned int toolDim)
   : AutoSegmentationWithPreviewTool(false, "FastMarchingTool"),
     m_LowerThreshold(0),
@@ -158,6 +160,7 @@ void mitk::FastMarchingBaseTool::Activated()
 void mitk::FastMarchingBaseTool::Deactivated()
 {
   this->ClearSeeds();
+  this->ClearPipelineCache();
 
   this->GetDataStorage()->Remove(m_SeedsAsPointSetNode);
   m_SeedsAsPointSetNode = nullptr;
@@ -221,6 +224,30 @@ void mitk::FastMarchingBaseTool::ClearSeeds()
   }
 }
 
+void mitk::FastMarchingBaseTool::ClearPipelineCache()
+{
+  m_PipelineCache.clear();
+  m_CachedSegmentationInput = nullptr;
+  m_CachedSegmentationInputMTime = 0;
+  m_CachedWorkingPlaneGeometry = nullptr;
+}
+
+void mitk::FastMarchingBaseTool::UpdatePrepare()
+{
+  Superclass::UpdatePrepare();
+
+  const auto segmentationInput = this->GetSegmentationInput();
+  if (segmentationInput != m_CachedSegmentationInput.GetPointer() ||
+      nullptr == segmentationInput || segmentationInput->GetMTime() != m_CachedSegmentationInputMTime ||
+      this->GetWorkingPlaneGeometry() != m_CachedWorkingPlaneGeometry.GetPointer())
+  {
+    this->ClearPipelineCache();
+    m_CachedSegmentationInput = segmentationInput;
+    m_CachedSegmentationInputMTime = nullptr != segmentationInput ? segmentationInput->GetMTime() : 0;
+    m_CachedWorkingPlaneGeometry = this->GetWorkingPlaneGeometry();
+  }
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::FastMarchingBaseTool::DoITKFastMarching(const itk::Image<TPixel, VImageDimension>* inputImage,
   Image* previewImage, unsigned int timeStep, const BaseGeometry* inputGeometry)
@@ -243,10 +270,11 @@ void mitk::FastMarchingBaseTool::DoITKFastMarching(const itk::Image<TPixel, VIma
   typedef typename FastMarchingFilterType::NodeContainer NodeContainer;
   typedef typename FastMarchingFilterType::NodeType NodeType;
 
-  //convert point set seed into trialpoint
-  typename NodeContainer::Pointer trialPoints = NodeContainer::New();
-  trialPoints->Initialize();
+  auto& cache = m_PipelineCache[timeStep];
 
+  //convert point set seeds into indices
+  std::vector<Point3D> seeds;
+  std::vector<itk::Index<VImageDimension>> seedIndices;
   for (auto pos = m_SeedsAsPointSet->Begin(); pos != m_SeedsAsPointSet->End(); ++pos)
   {
     mitk::Point3D clickInIndex;
@@ -258,48 +286,111 @@ void mitk::FastMarchingBaseTool::DoITKFastMarching(const itk::Image<TPixel, VIma
       seedPosition[dim] = clickInIndex[dim];
     }
 
-    NodeType node;
-    const double seedValue = 0.0;
-    node.SetValue(seedValue);
-    node.SetIndex(seedPosition);
-    trialPoints->InsertElement(trialPoints->Size(), node);
+    seeds.push_back(pos->Value());
+    seedIndices.push_back(seedPosition);
+  }
+
+  // the smoothed image only depends on the input
+  auto smoothedImage = dynamic_cast<InternalImageType*>(cache.SmoothedImage.GetPointer());
+  if (nullptr == smoothedImage)
+  {
+    auto smoothFilter = SmoothingFilterType::New();
+    smoothFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
+    smoothFilter->SetTimeStep(0.05);
+    smoothFilter->SetNumberOfIterations(2);
+    smoothFilter->SetConductanceParameter(9.0);
+    smoothFilter->SetInput(inputImage);
+    smoothFilter->Update();
+
+    smoothedImage = smoothFilter->GetOutput();
+    smoothedImage->DisconnectPipeline();
+    cache.SmoothedImage = smoothedImage;
+    cache.GradientImage = nullptr;
   }
 
-  // assemble pipeline
-  auto smoothFilter = SmoothingFilterType::New();
-  smoothFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
-  smoothFilter->SetTimeStep(0.05);
-  smoothFilter->SetNumberOfIterations(2);
-  smoothFilter->SetConductanceParameter(9.0);
-
-  auto gradientMagnitudeFilter = GradientFilterType::New();
-  gradientMagnitudeFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
-  gradientMagnitudeFilter->SetSigma(m_Sigma);
-
-  auto sigmoidFilter = SigmoidFilterType::New();
-  sigmoidFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
-  sigmoidFilter->SetAlpha(m_Alpha);
-  sigmoidFilter->SetBeta(m_Beta);
-  sigmoidFilter->SetOutputMinimum(0.0);
-  sigmoidFilter->SetOutputMaximum(1.0);
-
-  auto fastMarchingFilter = FastMarchingFilterType::New();
-  fastMarchingFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
-  fastMarchingFilter->SetStoppingValue(m_StoppingValue);
-  fastMarchingFilter->SetTrialPoints(trialPoints);
+  auto gradientImage = dynamic_cast<InternalImageType*>(cache.GradientImage.GetPointer());
+  if (nullptr == gradientImage || cache.Sigma != m_Sigma)
+  {
+    auto gradientMagnitudeFilter = GradientFilterType::New();
+    gradientMagnitudeFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
+    gradientMagnitudeFilter->SetSigma(m_Sigma);
+    gradientMagnitudeFilter->SetInput(smoothedImage);
+    gradientMagnitudeFilter->Update();
+
+    gradientImage = gradientMagnitudeFilter->GetOutput();
+    gradientImage->DisconnectPipeline();
+    cache.GradientImage = gradientImage;
+    cache.Sigma = m_Sigma;
+    cache.SpeedImage = nullptr;
+  }
+
+  auto speedImage = dynamic_cast<InternalImageType*>(cache.SpeedImage.GetPointer());
+  if (nullptr == speedImage || cache.Alpha != m_Alpha || cache.Beta != m_Beta)
+  {
+    auto sigmoidFilter = SigmoidFilterType::New();
+    sigmoidFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
+    sigmoidFilter->SetAlpha(m_Alpha);
+    sigmoidFilter->SetBeta(m_Beta);
+    sigmoidFilter->SetOutputMinimum(0.0);
+    sigmoidFilter->SetOutputMaximum(1.0);
+    sigmoidFilter->SetInput(gradientImage);
+    sigmoidFilter->Update();
+
+    speedImage = sigmoidFilter->GetOutput();
+    speedImage->DisconnectPipeline();
+    cache.SpeedImage = speedImage;
+    cache.Alpha = m_Alpha;
+    cache.Beta = m_Beta;
+    cache.ArrivalTimeImage = nullptr;
+  }
+
+  // the cached arrival times can be reused if seeds were only added since they were computed
+  auto arrivalTimeImage = dynamic_cast<InternalImageType*>(cache.ArrivalTimeImage.GetPointer());
+  const bool onlySeedsAdded = nullptr != arrivalTimeImage && cache.StoppingValue == m_StoppingValue &&
+    cache.Seeds.size() <= seeds.size() && std::equal(cache.Seeds.begin(), cache.Seeds.end(), seeds.begin());
+
+  if (onlySeedsAdded)
+  {
+    if (cache.Seeds.size() < seeds.size())
+    {
+      const std::vector<itk::Index<VImageDimension>> addedSeeds(seedIndices.begin() + cache.Seeds.size(), seedIndices.end());
+      mitk::PropagateAdditionalFastMarchingSeeds<InternalImageType>(arrivalTimeImage, speedImage, addedSeeds, m_StoppingValue);
+    }
+  }
+  else
+  {
+    typename NodeContainer::Pointer trialPoints = NodeContainer::New();
+    trialPoints->Initialize();
+
+    for (const auto& seedPosition : seedIndices)
+    {
+      NodeType node;
+      const double seedValue = 0.0;
+      node.SetValue(seedValue);
+      node.SetIndex(seedPosition);
+      trialPoints->InsertElement(trialPoints->Size(), node);
+    }
+
+    auto fastMarchingFilter = FastMarchingFilterType::New();
+    fastMarchingFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
+    fastMarchingFilter->SetStoppingValue(m_StoppingValue);
+    fastMarchingFilter->SetTrialPoints(trialPoints);
+    fastMarchingFilter->SetInput(speedImage);
+    fastMarchingFilter->Update();
+
+    arrivalTimeImage = fastMarchingFilter->GetOutput();
+    arrivalTimeImage->DisconnectPipeline();
+    cache.ArrivalTimeImage = arrivalTimeImage;
+    cache.StoppingValue = m_StoppingValue;
+  }
+  cache.Seeds = seeds;
 
   auto thresholdFilter = ThresholdingFilterType::New();
   thresholdFilter->SetLowerThreshold(m_LowerThreshold);
   thresholdFilter->SetUpperThreshold(m_UpperThreshold);
   thresholdFilter->SetOutsideValue(0);
   thresholdFilter->SetInsideValue(1.0);
-
-  // set up pipeline
-  smoothFilter->SetInput(inputImage);
-  gradientMagnitudeFilter->SetInput(smoothFilter->GetOutput());
-  sigmoidFilter->SetInput(gradientMagnitudeFilter->GetOutput());
-  fastMarchingFilter->SetInput(sigmoidFilter->GetOutput());
-  thresholdFilter->SetInput(fastMarchingFilter->GetOutput());
+  thresholdFilter->SetInput(arrivalTimeImage);
   thresholdFilter->Update();
 
   if (nullptr == this->GetWorkingPlaneGeometry())
@@ -23,6 +23,9 @@ found in the LICENSE file.
 
 #include <MitkSegmentationExports.h>
 
+#include <map>
+#include <vector>
+
 namespace us
 {
   class ModuleResource;
@@ -39,6 +42,12 @@ namespace mitk
     The resulting binary image is seen as a segmentation of an object.
 
     For detailed documentation see ITK Software Guide section 9.3.1 Fast Marching Segmentation.
+
+    The intermediate images of the pipeline are cached per time step. Each stage is only
+    recomputed if a parameter it depends on has changed: changing the threshold only
+    re-thresholds the cached arrival times and adding seed points only propagates the
+    fronts of the new seeds into the cached arrival times. Removing seed points or changing
+    sigma, alpha, beta or the stopping value triggers a complete fast marching.
   */
   class MITKSEGMENTATION_EXPORT FastMarchingBaseTool : public AutoSegmentationWithPreviewTool
   {
@@ -89,8 +98,14 @@ namespace mitk
     /// \brief Delete action of StateMachine pattern
     virtual void OnDelete(StateMachineAction*, InteractionEvent* interactionEvent);
 
+    /** Invalidates the pipeline cache if the segmentation input or the working plane has changed.*/
+    void UpdatePrepare() override;
+
     void DoUpdatePreview(const Image* inputAtTimeStep, const Image* oldSegAtTimeStep, Image* previewImage, TimeStepType timeStep) override;
 
+    /// \brief Releases all cached intermediate images.
+    void ClearPipelineCache();
+
     template <typename TPixel, unsigned int VImageDimension>
     void DoITKFastMarching(const itk::Image<TPixel, VImageDimension>* inputImage,
       Image* segmentation, unsigned int timeStep, const BaseGeometry* inputGeometry);
@@ -105,6 +120,26 @@ namespace mitk
     DataNode::Pointer m_SeedsAsPointSetNode; // used to visualize the seed points
     PointSet::Pointer m_SeedsAsPointSet;
 
+    /** Intermediate results of the pipeline for one time step together with the
+     * parameters they were computed with.*/
+    struct PipelineCache
+    {
+      itk::DataObject::Pointer SmoothedImage;
+      itk::DataObject::Pointer GradientImage;
+      itk::DataObject::Pointer SpeedImage;
+      itk::DataObject::Pointer ArrivalTimeImage;
+      float Sigma = 0;
+      float Alpha = 0;
+      float Beta = 0;
+      float StoppingValue = 0;
+      std::vector<Point3D> Seeds; ///< seeds (in world coordinates) the arrival times were computed for
+    };
+
+    std::map<TimeStepType, PipelineCache> m_PipelineCache;
+    Image::ConstPointer m_CachedSegmentationInput;
+    itk::ModifiedTimeType m_CachedSegmentationInputMTime = 0;
+    PlaneGeometry::ConstPointer m_CachedWorkingPlaneGeometry;
+
   private:
     /** Indicating if the tool is used in 2D mode (just segment the current slice)
      * or 3D mode (segment the whole current volume),*/
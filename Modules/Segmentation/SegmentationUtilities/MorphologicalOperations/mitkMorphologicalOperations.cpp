@@ -19,189 +19,455 @@ found in the LICENSE file.
 #include <itkBinaryMorphologicalClosingImageFilter.h>
 #include <itkBinaryMorphologicalOpeningImageFilter.h>
 #include <mitkImageAccessByItk.h>
-#include <mitkImageCast.h>
-#include <mitkImageReadAccessor.h>
 #include <mitkImageTimeSelector.h>
 
-void mitk::MorphologicalOperations::Closing(mitk::Image::Pointer &image,
-                                            int factor,
-                                            mitk::MorphologicalOperations::StructuralElementType structuralElement)
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace
 {
-  MITK_INFO << "Start Closing...";
+  /** From this radius on, balls and crosses are applied with separable distance computations whose costs do
+   * not depend on the radius. Smaller radii use the ITK filters, which are faster for small structuring elements.*/
+  const int MinimumRadiusForSeparableMorphology = 3;
+
+  typedef std::uint32_t SquaredDistanceType;
+  typedef std::vector<unsigned char> MaskType;
+
+  enum class MorphologyType
+  {
+    Dilation,
+    Erosion,
+    Closing,
+    Opening
+  };
+
+  /** Returns whether the time steps are distributed over the threads. Otherwise they are processed one after
+   * the other and the work within a volume is parallelized by the ITK filters and the distance passes.*/
+  bool ProcessTimeStepsConcurrently(unsigned int timeSteps)
+  {
+#ifdef _OPENMP
+    return timeSteps >= static_cast<unsigned int>(omp_get_max_threads());
+#else
+    (void)timeSteps;
+    return false;
+#endif
+  }
 
-  auto timeSteps = static_cast<int>(image->GetTimeSteps());
+  /** Lets the filter run single-threaded if it is called for one of several concurrently processed time steps.*/
+  void LimitNumberOfThreads(itk::ProcessObject *filter)
+  {
+#ifdef _OPENMP
+    if (omp_in_parallel())
+      filter->SetNumberOfThreads(1);
+#else
+    (void)filter;
+#endif
+  }
 
-  if (timeSteps > 1)
+  /** Applies the operation to every time step of the image. The volumes of the time steps reference the memory
+   * of the image and the operations write their results into the volume they read, so no data is copied back.
+   * The volumes are extracted serially, since the time selector must not be used concurrently.*/
+  void ProcessTimeSteps(mitk::Image::Pointer &image, const std::function<void(mitk::Image::Pointer &)> &operation)
   {
+    const auto timeSteps = image->GetTimeSteps();
+
+    if (timeSteps <= 1)
+    {
+      operation(image);
+      image->Modified();
+      return;
+    }
+
     mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
     timeSelector->SetInput(image);
 
-    for (int t = 0; t < timeSteps; ++t)
+    std::vector<mitk::Image::Pointer> volumes(timeSteps);
+    for (unsigned int t = 0; t < timeSteps; ++t)
     {
-      MITK_INFO << "  Processing time step " << t;
-
       timeSelector->SetTimeNr(t);
       timeSelector->Update();
 
-      mitk::Image::Pointer img3D = timeSelector->GetOutput();
-      img3D->DisconnectPipeline();
+      volumes[t] = timeSelector->GetOutput();
+      volumes[t]->DisconnectPipeline();
+    }
 
-      AccessByItk_3(img3D, itkClosing, img3D, factor, structuralElement);
+    const auto numberOfVolumes = static_cast<int>(timeSteps);
+    std::vector<std::exception_ptr> exceptions(timeSteps);
 
-      mitk::ImageReadAccessor accessor(img3D);
-      image->SetVolume(accessor.GetData(), t);
+#pragma omp parallel for schedule(dynamic) if (ProcessTimeStepsConcurrently(timeSteps))
+    for (int t = 0; t < numberOfVolumes; ++t)
+    {
+      try
+      {
+        operation(volumes[t]);
+      }
+      catch (...)
+      {
+        exceptions[t] = std::current_exception();
+      }
+    }
+
+    for (const auto &exception : exceptions)
+    {
+      if (exception)
+        std::rethrow_exception(exception);
     }
+
+    image->Modified();
   }
-  else
+
+  /** Replaces the pixels of the image by the ones of the filter output, which has the same region.*/
+  template <typename TImage>
+  void WriteResult(const TImage *result, TImage *image)
   {
-    AccessByItk_3(image, itkClosing, image, factor, structuralElement);
+    const auto numberOfPixels = image->GetLargestPossibleRegion().GetNumberOfPixels();
+    std::copy(result->GetBufferPointer(), result->GetBufferPointer() + numberOfPixels, image->GetBufferPointer());
   }
 
-  MITK_INFO << "Finished Closing";
-}
+  /** Computes d(q) = min_p (q - p)^2 + f(p) along all lines of the given axis in place (lower envelope of
+   * parabolas, see Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled Functions"). Values are
+   * clamped to maximum, which is used for pixels that are no source.*/
+  template <unsigned int VDimension>
+  void SquaredDistancePass(std::vector<SquaredDistanceType> &values,
+                           const itk::Size<VDimension> &size,
+                           unsigned int axis,
+                           SquaredDistanceType maximum)
+  {
+    std::size_t stride = 1;
+    for (unsigned int dim = 0; dim < axis; ++dim)
+      stride *= size[dim];
 
-void mitk::MorphologicalOperations::Erode(mitk::Image::Pointer &image,
-                                          int factor,
-                                          mitk::MorphologicalOperations::StructuralElementType structuralElement)
-{
-  MITK_INFO << "Start Erode...";
+    const auto lineLength = static_cast<int>(size[axis]);
+    const auto numberOfLines = static_cast<int>(values.size() / lineLength);
 
-  auto timeSteps = static_cast<int>(image->GetTimeSteps());
+#pragma omp parallel
+    {
+      std::vector<SquaredDistanceType> f(lineLength);
+      std::vector<int> v(lineLength);
+      std::vector<double> z(lineLength + 1);
+
+#pragma omp for
+      for (int line = 0; line < numberOfLines; ++line)
+      {
+        SquaredDistanceType *data = values.data() + (line / stride) * stride * lineLength + (line % stride);
+
+        bool hasSource = false;
+        for (int q = 0; q < lineLength; ++q)
+        {
+          f[q] = data[q * stride];
+          hasSource |= f[q] < maximum;
+        }
+
+        if (!hasSource)
+          continue;
+
+        int k = 0;
+        v[0] = 0;
+        z[0] = -std::numeric_limits<double>::max();
+        z[1] = std::numeric_limits<double>::max();
+
+        for (int q = 1; q < lineLength; ++q)
+        {
+          double s = 0;
+          while (true)
+          {
+            const int p = v[k];
+            s = ((static_cast<double>(f[q]) + static_cast<double>(q) * q) -
+                 (static_cast<double>(f[p]) + static_cast<double>(p) * p)) /
+                (2.0 * (q - p));
+            if (s > z[k])
+              break;
+            --k;
+          }
+          ++k;
+          v[k] = q;
+          z[k] = s;
+          z[k + 1] = std::numeric_limits<double>::max();
+        }
+
+        k = 0;
+        for (int q = 0; q < lineLength; ++q)
+        {
+          while (z[k + 1] < q)
+            ++k;
+
+          const auto offset = static_cast<std::uint64_t>(std::abs(q - v[k]));
+          data[q * stride] = static_cast<SquaredDistanceType>(
+            std::min<std::uint64_t>(offset * offset + f[v[k]], maximum));
+        }
+      }
+    }
+  }
 
-  if (timeSteps > 1)
+  /** Dilates the mask with a ball or a cross of the given radius. Pixels outside of the mask are background.*/
+  template <unsigned int VDimension>
+  MaskType DilateMask(const MaskType &mask,
+                      const itk::Size<VDimension> &size,
+                      const itk::Size<VDimension> &radius,
+                      bool ball)
   {
-    mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
-    timeSelector->SetInput(image);
+    std::vector<SquaredDistanceType> distances(mask.size());
 
-    for (int t = 0; t < timeSteps; ++t)
+    if (ball)
     {
-      MITK_INFO << "  Processing time step " << t;
+      // A ball of radius r contains all offsets with |offset| <= r + 0.5 (see itk::BinaryBallStructuringElement),
+      // which is |offset|^2 <= r^2 + r for integral offsets. All axes of the ball have the same radius or 0.
+      const auto r = static_cast<SquaredDistanceType>(*std::max_element(radius.begin(), radius.end()));
+      const SquaredDistanceType threshold = r * r + r;
+
+      for (std::size_t i = 0; i < mask.size(); ++i)
+        distances[i] = mask[i] ? 0 : threshold + 1;
+
+      for (unsigned int axis = 0; axis < VDimension; ++axis)
+      {
+        if (radius[axis] > 0)
+          SquaredDistancePass<VDimension>(distances, size, axis, threshold + 1);
+      }
+
+      MaskType result(mask.size());
+      for (std::size_t i = 0; i < mask.size(); ++i)
+        result[i] = distances[i] <= threshold;
+      return result;
+    }
 
-      timeSelector->SetTimeNr(t);
-      timeSelector->Update();
+    // A cross is the union of one line per axis, so is its dilation
+    MaskType result(mask);
+    for (unsigned int axis = 0; axis < VDimension; ++axis)
+    {
+      if (radius[axis] == 0)
+        continue;
 
-      mitk::Image::Pointer img3D = timeSelector->GetOutput();
-      img3D->DisconnectPipeline();
+      const auto threshold = static_cast<SquaredDistanceType>(radius[axis] * radius[axis]);
+      for (std::size_t i = 0; i < mask.size(); ++i)
+        distances[i] = mask[i] ? 0 : threshold + 1;
 
-      AccessByItk_3(img3D, itkErode, img3D, factor, structuralElement);
+      SquaredDistancePass<VDimension>(distances, size, axis, threshold + 1);
 
-      mitk::ImageReadAccessor accessor(img3D);
-      image->SetVolume(accessor.GetData(), t);
+      for (std::size_t i = 0; i < mask.size(); ++i)
+        result[i] |= distances[i] <= threshold;
     }
+    return result;
   }
-  else
+
+  /** Erodes the mask with a ball or a cross of the given radius. Pixels outside of the mask are foreground.*/
+  template <unsigned int VDimension>
+  MaskType ErodeMask(const MaskType &mask,
+                     const itk::Size<VDimension> &size,
+                     const itk::Size<VDimension> &radius,
+                     bool ball)
   {
-    AccessByItk_3(image, itkErode, image, factor, structuralElement);
+    MaskType inverse(mask.size());
+    for (std::size_t i = 0; i < mask.size(); ++i)
+      inverse[i] = !mask[i];
+
+    MaskType result = DilateMask<VDimension>(inverse, size, radius, ball);
+    for (auto &value : result)
+      value = !value;
+    return result;
   }
 
-  MITK_INFO << "Finished Erode";
-}
-
-void mitk::MorphologicalOperations::Dilate(mitk::Image::Pointer &image,
-                                           int factor,
-                                           mitk::MorphologicalOperations::StructuralElementType structuralElement)
-{
-  MITK_INFO << "Start Dilate...";
-
-  auto timeSteps = static_cast<int>(image->GetTimeSteps());
-
-  if (timeSteps > 1)
+  template <unsigned int VDimension>
+  itk::Size<VDimension> GetStructuringElementRadius(
+    mitk::MorphologicalOperations::StructuralElementType structuralElementFlag, int factor)
   {
-    mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
-    timeSelector->SetInput(image);
+    unsigned int axes[3] = {0, 1, 2};
+    unsigned int numberOfAxes = 0;
 
-    for (int t = 0; t < timeSteps; ++t)
+    switch (structuralElementFlag)
     {
-      MITK_INFO << "  Processing time step " << t;
-
-      timeSelector->SetTimeNr(t);
-      timeSelector->Update();
-
-      mitk::Image::Pointer img3D = timeSelector->GetOutput();
-      img3D->DisconnectPipeline();
-
-      AccessByItk_3(img3D, itkDilate, img3D, factor, structuralElement);
+      case mitk::MorphologicalOperations::Ball_Axial:
+      case mitk::MorphologicalOperations::Cross_Axial:
+        axes[0] = 0;
+        axes[1] = 1;
+        numberOfAxes = 2;
+        break;
+      case mitk::MorphologicalOperations::Ball_Coronal:
+      case mitk::MorphologicalOperations::Cross_Coronal:
+        axes[0] = 0;
+        axes[1] = 2;
+        numberOfAxes = 2;
+        break;
+      case mitk::MorphologicalOperations::Ball_Sagital:
+      case mitk::MorphologicalOperations::Cross_Sagital:
+        axes[0] = 1;
+        axes[1] = 2;
+        numberOfAxes = 2;
+        break;
+      case mitk::MorphologicalOperations::Ball:
+      case mitk::MorphologicalOperations::Cross:
+        numberOfAxes = 3;
+        break;
+    }
 
-      mitk::ImageReadAccessor accessor(img3D);
-      image->SetVolume(accessor.GetData(), t);
+    itk::Size<VDimension> radius;
+    radius.Fill(0);
+    for (unsigned int i = 0; i < numberOfAxes; ++i)
+    {
+      if (axes[i] < VDimension)
+        radius[axes[i]] = factor;
     }
+    return radius;
   }
-  else
+
+  /** Binary morphology of the foreground value 1 with costs independent of the radius of the structuring element.
+   * The results equal the ones of the corresponding ITK filters as used for small radii and are written into the
+   * image.*/
+  template <typename TPixel, unsigned int VDimension>
+  void SeparableMorphology(itk::Image<TPixel, VDimension> *image,
+                           MorphologyType type,
+                           int factor,
+                           mitk::MorphologicalOperations::StructuralElementType structuralElementFlags)
   {
-    AccessByItk_3(image, itkDilate, image, factor, structuralElement);
-  }
+    const bool ball = (structuralElementFlags & mitk::MorphologicalOperations::Ball) != 0;
+    const auto radius = GetStructuringElementRadius<VDimension>(structuralElementFlags, factor);
+    const auto region = image->GetLargestPossibleRegion();
+    const auto size = region.GetSize();
+    TPixel *buffer = image->GetBufferPointer();
+    const std::size_t numberOfPixels = region.GetNumberOfPixels();
+
+    MaskType mask(numberOfPixels);
+    for (std::size_t i = 0; i < numberOfPixels; ++i)
+      mask[i] = buffer[i] == 1;
+
+    MaskType result;
+    switch (type)
+    {
+      case MorphologyType::Dilation:
+        result = DilateMask<VDimension>(mask, size, radius, ball);
+        break;
+      case MorphologyType::Erosion:
+        result = ErodeMask<VDimension>(mask, size, radius, ball);
+        break;
+      case MorphologyType::Opening:
+        result = DilateMask<VDimension>(ErodeMask<VDimension>(mask, size, radius, ball), size, radius, ball);
+        break;
+      case MorphologyType::Closing:
+      {
+        // like itk::BinaryMorphologicalClosingImageFilter the image is padded by the radius, so that the
+        // dilation can extend beyond the image border before it is eroded again
+        itk::Size<VDimension> paddedSize;
+        std::size_t numberOfPaddedPixels = 1;
+        for (unsigned int dim = 0; dim < VDimension; ++dim)
+        {
+          paddedSize[dim] = size[dim] + 2 * radius[dim];
+          numberOfPaddedPixels *= paddedSize[dim];
+        }
+
+        MaskType paddedMask(numberOfPaddedPixels, 0);
+        for (std::size_t i = 0; i < numberOfPixels; ++i)
+        {
+          std::size_t remainder = i;
+          std::size_t paddedIndex = 0;
+          std::size_t paddedStride = 1;
+          for (unsigned int dim = 0; dim < VDimension; ++dim)
+          {
+            paddedIndex += (remainder % size[dim] + radius[dim]) * paddedStride;
+            remainder /= size[dim];
+            paddedStride *= paddedSize[dim];
+          }
+          paddedMask[paddedIndex] = mask[i];
+        }
+
+        const MaskType paddedResult = ErodeMask<VDimension>(
+          DilateMask<VDimension>(paddedMask, paddedSize, radius, ball), paddedSize, radius, ball);
+
+        result.resize(numberOfPixels);
+        for (std::size_t i = 0; i < numberOfPixels; ++i)
+        {
+          std::size_t remainder = i;
+          std::size_t paddedIndex = 0;
+          std::size_t paddedStride = 1;
+          for (unsigned int dim = 0; dim < VDimension; ++dim)
+          {
+            paddedIndex += (remainder % size[dim] + radius[dim]) * paddedStride;
+            remainder /= size[dim];
+            paddedStride *= paddedSize[dim];
+          }
+          result[i] = paddedResult[paddedIndex] | mask[i];
+        }
+        break;
+      }
+    }
 
-  MITK_INFO << "Finished Dilate";
+    // pixels which are not touched by the operation keep their value, as with the ITK filters
+    const TPixel erodedValue = type == MorphologyType::Erosion ? itk::NumericTraits<TPixel>::NonpositiveMin() : 0;
+    for (std::size_t i = 0; i < numberOfPixels; ++i)
+    {
+      if (result[i])
+        buffer[i] = 1;
+      else if (mask[i])
+        buffer[i] = erodedValue;
+    }
+  }
 }
 
-void mitk::MorphologicalOperations::Opening(mitk::Image::Pointer &image,
+
+void mitk::MorphologicalOperations::Closing(mitk::Image::Pointer &image,
                                             int factor,
                                             mitk::MorphologicalOperations::StructuralElementType structuralElement)
 {
-  MITK_INFO << "Start Opening...";
-
-  auto timeSteps = static_cast<int>(image->GetTimeSteps());
-
-  if (timeSteps > 1)
-  {
-    mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
-    timeSelector->SetInput(image);
+  MITK_INFO << "Start Closing...";
 
-    for (int t = 0; t < timeSteps; ++t)
-    {
-      MITK_INFO << "  Processing time step " << t;
+  ProcessTimeSteps(image, [&](mitk::Image::Pointer &img) {
+    AccessByItk_2(img, itkClosing, factor, structuralElement);
+  });
 
-      timeSelector->SetTimeNr(t);
-      timeSelector->Update();
-
-      mitk::Image::Pointer img3D = timeSelector->GetOutput();
-      img3D->DisconnectPipeline();
+  MITK_INFO << "Finished Closing";
+}
 
-      AccessByItk_3(img3D, itkOpening, img3D, factor, structuralElement);
+void mitk::MorphologicalOperations::Erode(mitk::Image::Pointer &image,
+                                          int factor,
+                                          mitk::MorphologicalOperations::StructuralElementType structuralElement)
+{
+  MITK_INFO << "Start Erode...";
 
-      mitk::ImageReadAccessor accessor(img3D);
-      image->SetVolume(accessor.GetData(), t);
-    }
-  }
-  else
-  {
-    AccessByItk_3(image, itkOpening, image, factor, structuralElement);
-  }
+  ProcessTimeSteps(image, [&](mitk::Image::Pointer &img) {
+    AccessByItk_2(img, itkErode, factor, structuralElement);
+  });
 
-  MITK_INFO << "Finished Opening";
+  MITK_INFO << "Finished Erode";
 }
 
-void mitk::MorphologicalOperations::FillHoles(mitk::Image::Pointer &image)
+void mitk::MorphologicalOperations::Dilate(mitk::Image::Pointer &image,
+                                           int factor,
+                                           mitk::MorphologicalOperations::StructuralElementType structuralElement)
 {
-  MITK_INFO << "Start FillHole...";
+  MITK_INFO << "Start Dilate...";
 
-  auto timeSteps = static_cast<int>(image->GetTimeSteps());
+  ProcessTimeSteps(image, [&](mitk::Image::Pointer &img) {
+    AccessByItk_2(img, itkDilate, factor, structuralElement);
+  });
 
-  if (timeSteps > 1)
-  {
-    mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
-    timeSelector->SetInput(image);
+  MITK_INFO << "Finished Dilate";
+}
 
-    for (int t = 0; t < timeSteps; ++t)
-    {
-      MITK_INFO << "  Processing time step " << t;
+void mitk::MorphologicalOperations::Opening(mitk::Image::Pointer &image,
+                                            int factor,
+                                            mitk::MorphologicalOperations::StructuralElementType structuralElement)
+{
+  MITK_INFO << "Start Opening...";
 
-      timeSelector->SetTimeNr(t);
-      timeSelector->Update();
+  ProcessTimeSteps(image, [&](mitk::Image::Pointer &img) {
+    AccessByItk_2(img, itkOpening, factor, structuralElement);
+  });
 
-      mitk::Image::Pointer img3D = timeSelector->GetOutput();
-      img3D->DisconnectPipeline();
+  MITK_INFO << "Finished Opening";
+}
 
-      AccessByItk_1(img3D, itkFillHoles, img3D);
+void mitk::MorphologicalOperations::FillHoles(mitk::Image::Pointer &image)
+{
+  MITK_INFO << "Start FillHole...";
 
-      mitk::ImageReadAccessor accessor(img3D);
-      image->SetVolume(accessor.GetData(), t);
-    }
-  }
-  else
-  {
-    AccessByItk_1(image, itkFillHoles, image);
-  }
+  ProcessTimeSteps(image, [&](mitk::Image::Pointer &img) { AccessByItk(img, itkFillHoles); });
 
   MITK_INFO << "Finished FillHole";
 }
@@ -209,10 +475,15 @@ void mitk::MorphologicalOperations::FillHoles(mitk::Image::Pointer &image)
 template <typename TPixel, unsigned int VDimension>
 void mitk::MorphologicalOperations::itkClosing(
   itk::Image<TPixel, VDimension> *sourceImage,
-  mitk::Image::Pointer &resultImage,
   int factor,
   mitk::MorphologicalOperations::StructuralElementType structuralElementFlags)
 {
+  if (factor >= MinimumRadiusForSeparableMorphology)
+  {
+    SeparableMorphology<TPixel, VDimension>(sourceImage, MorphologyType::Closing, factor, structuralElementFlags);
+    return;
+  }
+
   typedef itk::Image<TPixel, VDimension> ImageType;
   typedef itk::BinaryBallStructuringElement<TPixel, VDimension> BallType;
   typedef itk::BinaryCrossStructuringElement<TPixel, VDimension> CrossType;
@@ -227,9 +498,10 @@ void mitk::MorphologicalOperations::itkClosing(
     closingFilter->SetKernel(ball);
     closingFilter->SetInput(sourceImage);
     closingFilter->SetForegroundValue(1);
+    LimitNumberOfThreads(closingFilter);
     closingFilter->UpdateLargestPossibleRegion();
 
-    mitk::CastToMitkImage(closingFilter->GetOutput(), resultImage);
+    WriteResult(closingFilter->GetOutput(), sourceImage);
   }
   else
   {
@@ -239,19 +511,25 @@ void mitk::MorphologicalOperations::itkClosing(
     closingFilter->SetKernel(cross);
     closingFilter->SetInput(sourceImage);
     closingFilter->SetForegroundValue(1);
+    LimitNumberOfThreads(closingFilter);
     closingFilter->UpdateLargestPossibleRegion();
 
-    mitk::CastToMitkImage(closingFilter->GetOutput(), resultImage);
+    WriteResult(closingFilter->GetOutput(), sourceImage);
   }
 }
 
 template <typename TPixel, unsigned int VDimension>
 void mitk::MorphologicalOperations::itkErode(
   itk::Image<TPixel, VDimension> *sourceImage,
-  mitk::Image::Pointer &resultImage,
   int factor,
   mitk::MorphologicalOperations::StructuralElementType structuralElementFlags)
 {
+  if (factor >= MinimumRadiusForSeparableMorphology)
+  {
+    SeparableMorphology<TPixel, VDimension>(sourceImage, MorphologyType::Erosion, factor, structuralElementFlags);
+    return;
+  }
+
   typedef itk::Image<TPixel, VDimension> ImageType;
   typedef itk::BinaryBallStructuringElement<TPixel, VDimension> BallType;
   typedef itk::BinaryCrossStructuringElement<TPixel, VDimension> CrossType;
@@ -266,9 +544,10 @@ void mitk::MorphologicalOperations::itkErode(
     erodeFilter->SetKernel(ball);
     erodeFilter->SetInput(sourceImage);
     erodeFilter->SetErodeValue(1);
+    LimitNumberOfThreads(erodeFilter);
     erodeFilter->UpdateLargestPossibleRegion();
 
-    mitk::CastToMitkImage(erodeFilter->GetOutput(), resultImage);
+    WriteResult(erodeFilter->GetOutput(), sourceImage);
   }
   else
   {
@@ -278,19 +557,25 @@ void mitk::MorphologicalOperations::itkErode(
     erodeFilter->SetKernel(cross);
     erodeFilter->SetInput(sourceImage);
     erodeFilter->SetErodeValue(1);
+    LimitNumberOfThreads(erodeFilter);
     erodeFilter->UpdateLargestPossibleRegion();
 
-    mitk::CastToMitkImage(erodeFilter->GetOutput(), resultImage);
+    WriteResult(erodeFilter->GetOutput(), sourceImage);
   }
 }
 
 template <typename TPixel, unsigned int VDimension>
 void mitk::MorphologicalOperations::itkDilate(
   itk::Image<TPixel, VDimension> *sourceImage,
-  mitk::Image::Pointer &resultImage,
   int factor,
   mitk::MorphologicalOperations::StructuralElementType structuralElementFlags)
 {
+  if (factor >= MinimumRadiusForSeparableMorphology)
+  {
+    SeparableMorphology<TPixel, VDimension>(sourceImage, MorphologyType::Dilation, factor, structuralElementFlags);
+    return;
+  }
+
   typedef itk::Image<TPixel, VDimension> ImageType;
   typedef itk::BinaryBallStructuringElement<TPixel, VDimension> BallType;
   typedef itk::BinaryCrossStructuringElement<TPixel, VDimension> CrossType;
@@ -305,9 +590,10 @@ void mitk::MorphologicalOperations::itkDilate(
     dilateFilter->SetKernel(ball);
     dilateFilter->SetInput(sourceImage);
     dilateFilter->SetDilateValue(1);
+    LimitNumberOfThreads(dilateFilter);
     dilateFilter->UpdateLargestPossibleRegion();
 
-    mitk::CastToMitkImage(dilateFilter->GetOutput(), resultImage);
+    WriteResult(dilateFilter->GetOutput(), sourceImage);
   }
   else
   {
@@ -317,19 +603,25 @@ void mitk::MorphologicalOperations::itkDilate(
     dilateFilter->SetKernel(cross);
     dilateFilter->SetInput(sourceImage);
     dilateFilter->SetDilateValue(1);
+    LimitNumberOfThreads(dilateFilter);
     dilateFilter->UpdateLargestPossibleRegion();
 
-    mitk::CastToMitkImage(dilateFilter->GetOutput(), resultImage);
+    WriteResult(dilateFilter->GetOutput(), sourceImage);
   }
 }
 
 template <typename TPixel, unsigned int VDimension>
 void mitk::MorphologicalOperations::itkOpening(
   itk::Image<TPixel, VDimension> *sourceImage,
-  mitk::Image::Pointer &resultImage,
   int factor,
   mitk::MorphologicalOperations::StructuralElementType structuralElementFlags)
 {
+  if (factor >= MinimumRadiusForSeparableMorphology)
+  {
+    SeparableMorphology<TPixel, VDimension>(sourceImage, MorphologyType::Opening, factor, structuralElementFlags);
+    return;
+  }
+
   typedef itk::Image<TPixel, VDimension> ImageType;
   typedef itk::BinaryBallStructuringElement<TPixel, VDimension> BallType;
   typedef itk::BinaryCrossStructuringElement<TPixel, VDimension> CrossType;
@@ -345,9 +637,10 @@ void mitk::MorphologicalOperations::itkOpening(
     openingFilter->SetInput(sourceImage);
     openingFilter->SetForegroundValue(1);
     openingFilter->SetBackgroundValue(0);
+    LimitNumberOfThreads(openingFilter);
     openingFilter->UpdateLargestPossibleRegion();
 
-    mitk::CastToMitkImage(openingFilter->GetOutput(), resultImage);
+    WriteResult(openingFilter->GetOutput(), sourceImage);
   }
   else
   {
@@ -358,15 +651,15 @@ void mitk::MorphologicalOperations::itkOpening(
     openingFilter->SetInput(sourceImage);
     openingFilter->SetForegroundValue(1);
     openingFilter->SetBackgroundValue(0);
+    LimitNumberOfThreads(openingFilter);
     openingFilter->UpdateLargestPossibleRegion();
 
-    mitk::CastToMitkImage(openingFilter->GetOutput(), resultImage);
+    WriteResult(openingFilter->GetOutput(), sourceImage);
   }
 }
 
 template <typename TPixel, unsigned int VDimension>
-void mitk::MorphologicalOperations::itkFillHoles(itk::Image<TPixel, VDimension> *sourceImage,
-                                                 mitk::Image::Pointer &resultImage)
+void mitk::MorphologicalOperations::itkFillHoles(itk::Image<TPixel, VDimension> *sourceImage)
 {
   typedef itk::Image<TPixel, VDimension> ImageType;
   typedef typename itk::BinaryFillholeImageFilter<ImageType> FillHoleFilterType;
@@ -374,9 +667,10 @@ void mitk::MorphologicalOperations::itkFillHoles(itk::Image<TPixel, VDimension>
   typename FillHoleFilterType::Pointer fillHoleFilter = FillHoleFilterType::New();
   fillHoleFilter->SetInput(sourceImage);
   fillHoleFilter->SetForegroundValue(1);
+  LimitNumberOfThreads(fillHoleFilter);
   fillHoleFilter->UpdateLargestPossibleRegion();
 
-  mitk::CastToMitkImage(fillHoleFilter->GetOutput(), resultImage);
+  WriteResult(fillHoleFilter->GetOutput(), sourceImage);
 }
 
 template <class TStructuringElement>
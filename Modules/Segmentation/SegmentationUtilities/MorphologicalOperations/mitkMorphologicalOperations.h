@@ -55,33 +55,31 @@ namespace mitk
 
     ///@{
     /** \brief Perform morphological operation by using corresponding ITK filter.
+     *
+     * The result is written into the source image, which references the memory of the MITK image.
      */
     template <typename TPixel, unsigned int VDimension>
     static void itkClosing(itk::Image<TPixel, VDimension> *sourceImage,
-                           mitk::Image::Pointer &resultImage,
                            int factor,
                            StructuralElementType structuralElement);
 
     template <typename TPixel, unsigned int VDimension>
     static void itkErode(itk::Image<TPixel, VDimension> *sourceImage,
-                         mitk::Image::Pointer &resultImage,
                          int factor,
                          StructuralElementType structuralElement);
 
     template <typename TPixel, unsigned int VDimension>
     static void itkDilate(itk::Image<TPixel, VDimension> *sourceImage,
-                          mitk::Image::Pointer &resultImage,
                           int factor,
                           StructuralElementType structuralElement);
 
     template <typename TPixel, unsigned int VDimension>
     static void itkOpening(itk::Image<TPixel, VDimension> *sourceImage,
-                           mitk::Image::Pointer &resultImage,
                            int factor,
                            StructuralElementType structuralElement);
 
     template <typename TPixel, unsigned int VDimension>
-    static void itkFillHoles(itk::Image<TPixel, VDimension> *sourceImage, mitk::Image::Pointer &resultImage);
+    static void itkFillHoles(itk::Image<TPixel, VDimension> *sourceImage);
     ///@}
   };
 }
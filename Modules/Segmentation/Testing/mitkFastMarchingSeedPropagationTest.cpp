@@ -0,0 +1,173 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Testing
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// other
+#include <itkFastMarchingImageFilter.h>
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <mitkFastMarchingSeedPropagation.h>
+
+#include <algorithm>
+#include <vector>
+
+class mitkFastMarchingSeedPropagationTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkFastMarchingSeedPropagationTestSuite);
+  MITK_TEST(Propagate_2D_EqualsFastMarchingOnAllSeeds);
+  MITK_TEST(Propagate_3D_EqualsFastMarchingOnAllSeeds);
+  MITK_TEST(Propagate_StoppingValue_EqualsFastMarchingBelowStoppingValue);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  // The filter stops at half of the maximum float value by default, so every pixel is reached.
+  static constexpr double NoStoppingValue = 1e30;
+
+  template <unsigned int VDimension>
+  static typename itk::Image<float, VDimension>::Pointer CreateSpeedImage(unsigned int size)
+  {
+    typedef itk::Image<float, VDimension> ImageType;
+
+    typename ImageType::SizeType imageSize;
+    imageSize.Fill(size);
+    typename ImageType::RegionType region;
+    region.SetSize(imageSize);
+
+    // anisotropic spacing, so that the spacing dependent terms of the solver are covered as well
+    typename ImageType::SpacingType spacing;
+    for (unsigned int axis = 0; axis < VDimension; ++axis)
+      spacing[axis] = 1.0 + 0.25 * axis;
+
+    auto image = ImageType::New();
+    image->SetRegions(region);
+    image->SetSpacing(spacing);
+    image->Allocate();
+
+    // a slow band across the first axis with a gap and a low speed corner, so that the fronts of the seeds
+    // meet along curved boundaries
+    for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+    {
+      const auto index = it.GetIndex();
+      const auto x = static_cast<unsigned int>(index[0]);
+      const auto y = static_cast<unsigned int>(index[1]);
+
+      float speed = 1.0f;
+      if (x >= size / 2 - 1 && x <= size / 2 + 1 && y > size / 4)
+        speed = 0.1f;
+      else if (x < size / 4 && y >= (3 * size) / 4)
+        speed = 0.4f;
+
+      it.Set(speed);
+    }
+
+    return image;
+  }
+
+  template <unsigned int VDimension>
+  static typename itk::Image<float, VDimension>::Pointer MarchFromSeeds(
+    itk::Image<float, VDimension> *speed, const std::vector<itk::Index<VDimension>> &seeds, double stoppingValue)
+  {
+    typedef itk::Image<float, VDimension> ImageType;
+    typedef itk::FastMarchingImageFilter<ImageType, ImageType> FastMarchingFilterType;
+    typedef typename FastMarchingFilterType::NodeContainer NodeContainer;
+    typedef typename FastMarchingFilterType::NodeType NodeType;
+
+    auto trialPoints = NodeContainer::New();
+    trialPoints->Initialize();
+
+    for (const auto &seed : seeds)
+    {
+      NodeType node;
+      node.SetValue(0.0);
+      node.SetIndex(seed);
+      trialPoints->InsertElement(trialPoints->Size(), node);
+    }
+
+    auto fastMarchingFilter = FastMarchingFilterType::New();
+    if (stoppingValue < NoStoppingValue)
+      fastMarchingFilter->SetStoppingValue(stoppingValue);
+    fastMarchingFilter->SetTrialPoints(trialPoints);
+    fastMarchingFilter->SetInput(speed);
+    fastMarchingFilter->Update();
+
+    typename ImageType::Pointer arrivalTimes = fastMarchingFilter->GetOutput();
+    arrivalTimes->DisconnectPipeline();
+    return arrivalTimes;
+  }
+
+  // Marches from the first seed, propagates the remaining ones incrementally and compares the result with a
+  // fast marching run on all seeds. Only arrival times below the stopping value are compared, because the
+  // values beyond the front depend on where the march stopped.
+  template <unsigned int VDimension>
+  static void CompareWithFastMarchingOnAllSeeds(unsigned int size,
+                                                const std::vector<itk::Index<VDimension>> &seeds,
+                                                double stoppingValue)
+  {
+    typedef itk::Image<float, VDimension> ImageType;
+
+    auto speed = CreateSpeedImage<VDimension>(size);
+
+    const std::vector<itk::Index<VDimension>> firstSeed(seeds.begin(), seeds.begin() + 1);
+    const std::vector<itk::Index<VDimension>> addedSeeds(seeds.begin() + 1, seeds.end());
+
+    auto incremental = MarchFromSeeds<VDimension>(speed, firstSeed, stoppingValue);
+    mitk::PropagateAdditionalFastMarchingSeeds<ImageType>(incremental, speed, addedSeeds, stoppingValue);
+
+    auto reference = MarchFromSeeds<VDimension>(speed, seeds, stoppingValue);
+
+    // the values of pixels close to the stopping value may end up on either side of it due to rounding
+    const double margin = 1e-3 * stoppingValue;
+    unsigned int numberOfComparedPixels = 0;
+
+    itk::ImageRegionConstIterator<ImageType> incrementalIt(incremental, incremental->GetLargestPossibleRegion());
+    itk::ImageRegionConstIterator<ImageType> referenceIt(reference, reference->GetLargestPossibleRegion());
+    for (; !referenceIt.IsAtEnd(); ++referenceIt, ++incrementalIt)
+    {
+      const double expected = referenceIt.Get();
+      const double actual = incrementalIt.Get();
+
+      if (expected >= stoppingValue - margin && actual >= stoppingValue - margin)
+        continue;
+
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Incrementally propagated arrival time differs from fast marching",
+                                           expected, actual, 1e-3 * std::max(1.0, expected));
+      ++numberOfComparedPixels;
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("No arrival times were compared", numberOfComparedPixels > 0);
+  }
+
+public:
+  void Propagate_2D_EqualsFastMarchingOnAllSeeds()
+  {
+    const std::vector<itk::Index<2>> seeds = {{{5, 5}}, {{34, 30}}, {{30, 8}}};
+    CompareWithFastMarchingOnAllSeeds<2>(40, seeds, NoStoppingValue);
+  }
+
+  void Propagate_3D_EqualsFastMarchingOnAllSeeds()
+  {
+    const std::vector<itk::Index<3>> seeds = {{{3, 3, 3}}, {{19, 17, 12}}};
+    CompareWithFastMarchingOnAllSeeds<3>(24, seeds, NoStoppingValue);
+  }
+
+  void Propagate_StoppingValue_EqualsFastMarchingBelowStoppingValue()
+  {
+    // the fronts of the seeds overlap before the march stops
+    const std::vector<itk::Index<2>> seeds = {{{5, 5}}, {{16, 10}}, {{34, 30}}};
+    CompareWithFastMarchingOnAllSeeds<2>(40, seeds, 12.0);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkFastMarchingSeedPropagation)
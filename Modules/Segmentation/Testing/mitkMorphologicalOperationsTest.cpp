@@ -0,0 +1,245 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Testing
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// other
+#include <itkBinaryBallStructuringElement.h>
+#include <itkBinaryCrossStructuringElement.h>
+#include <itkBinaryDilateImageFilter.h>
+#include <itkBinaryErodeImageFilter.h>
+#include <itkBinaryMorphologicalClosingImageFilter.h>
+#include <itkBinaryMorphologicalOpeningImageFilter.h>
+#include <mitkImageCast.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkMorphologicalOperations.h>
+#include <mitkTool.h>
+
+class mitkMorphologicalOperationsTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkMorphologicalOperationsTestSuite);
+  MITK_TEST(Dilate_LargeRadius_EqualsITKFilter);
+  MITK_TEST(Erode_LargeRadius_EqualsITKFilter);
+  MITK_TEST(Closing_LargeRadius_EqualsITKFilter);
+  MITK_TEST(Opening_LargeRadius_EqualsITKFilter);
+  MITK_TEST(Dilate_TimeSteps_EqualsVolumes);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::Tool::DefaultSegmentationDataType PixelType;
+  typedef itk::Image<PixelType, 3> ImageType;
+  typedef itk::BinaryBallStructuringElement<PixelType, 3> BallType;
+  typedef itk::BinaryCrossStructuringElement<PixelType, 3> CrossType;
+
+  ImageType::Pointer m_Segmentation;
+
+  // The operations switch to radius independent algorithms for large radii, which have to yield the results of
+  // the ITK filters used before.
+  static const int Radius = 5;
+
+  template <class TStructuringElement>
+  static TStructuringElement CreateStructuringElement(mitk::MorphologicalOperations::StructuralElementType flag)
+  {
+    TStructuringElement structuringElement;
+    typename TStructuringElement::SizeType size;
+    size.Fill(0);
+    if (flag == mitk::MorphologicalOperations::Ball || flag == mitk::MorphologicalOperations::Cross)
+    {
+      size.Fill(Radius);
+    }
+    else
+    {
+      // axial
+      size[0] = Radius;
+      size[1] = Radius;
+    }
+    structuringElement.SetRadius(size);
+    structuringElement.CreateStructuringElement();
+    return structuringElement;
+  }
+
+  template <class TFilter>
+  static ImageType::Pointer RunFilter(TFilter *filter, const ImageType *input)
+  {
+    filter->SetInput(input);
+    filter->UpdateLargestPossibleRegion();
+    ImageType::Pointer output = filter->GetOutput();
+    output->DisconnectPipeline();
+    return output;
+  }
+
+  template <class TStructuringElement>
+  static ImageType::Pointer ReferenceResult(const std::string &operation,
+                                            const ImageType *input,
+                                            mitk::MorphologicalOperations::StructuralElementType flag)
+  {
+    const auto kernel = CreateStructuringElement<TStructuringElement>(flag);
+
+    if (operation == "Dilate")
+    {
+      auto filter = itk::BinaryDilateImageFilter<ImageType, ImageType, TStructuringElement>::New();
+      filter->SetKernel(kernel);
+      filter->SetDilateValue(1);
+      return RunFilter(filter.GetPointer(), input);
+    }
+    if (operation == "Erode")
+    {
+      auto filter = itk::BinaryErodeImageFilter<ImageType, ImageType, TStructuringElement>::New();
+      filter->SetKernel(kernel);
+      filter->SetErodeValue(1);
+      return RunFilter(filter.GetPointer(), input);
+    }
+    if (operation == "Closing")
+    {
+      auto filter = itk::BinaryMorphologicalClosingImageFilter<ImageType, ImageType, TStructuringElement>::New();
+      filter->SetKernel(kernel);
+      filter->SetForegroundValue(1);
+      return RunFilter(filter.GetPointer(), input);
+    }
+    auto filter = itk::BinaryMorphologicalOpeningImageFilter<ImageType, ImageType, TStructuringElement>::New();
+    filter->SetKernel(kernel);
+    filter->SetForegroundValue(1);
+    filter->SetBackgroundValue(0);
+    return RunFilter(filter.GetPointer(), input);
+  }
+
+  void TestOperation(const std::string &operation)
+  {
+    const mitk::MorphologicalOperations::StructuralElementType flags[] = {mitk::MorphologicalOperations::Ball,
+                                                                          mitk::MorphologicalOperations::Ball_Axial,
+                                                                          mitk::MorphologicalOperations::Cross,
+                                                                          mitk::MorphologicalOperations::Cross_Axial};
+
+    for (const auto flag : flags)
+    {
+      const ImageType::Pointer reference = (flag & mitk::MorphologicalOperations::Ball)
+                                             ? ReferenceResult<BallType>(operation, m_Segmentation, flag)
+                                             : ReferenceResult<CrossType>(operation, m_Segmentation, flag);
+
+      mitk::Image::Pointer image;
+      mitk::CastToMitkImage(m_Segmentation, image);
+
+      if (operation == "Dilate")
+        mitk::MorphologicalOperations::Dilate(image, Radius, flag);
+      else if (operation == "Erode")
+        mitk::MorphologicalOperations::Erode(image, Radius, flag);
+      else if (operation == "Closing")
+        mitk::MorphologicalOperations::Closing(image, Radius, flag);
+      else
+        mitk::MorphologicalOperations::Opening(image, Radius, flag);
+
+      ImageType::Pointer result;
+      mitk::CastToItkImage(image, result);
+
+      const auto numberOfPixels = m_Segmentation->GetLargestPossibleRegion().GetNumberOfPixels();
+      const PixelType *resultBuffer = result->GetBufferPointer();
+      const PixelType *referenceBuffer = reference->GetBufferPointer();
+
+      unsigned int numberOfDifferences = 0;
+      for (std::size_t i = 0; i < numberOfPixels; ++i)
+      {
+        if (resultBuffer[i] != referenceBuffer[i])
+          ++numberOfDifferences;
+      }
+
+      CPPUNIT_ASSERT_EQUAL_MESSAGE(operation + " differs from the ITK filter.", 0u, numberOfDifferences);
+    }
+  }
+
+public:
+  void setUp() override
+  {
+    // A few overlapping boxes and a thin line, so that all operations change the segmentation and touch
+    // the image border
+    ImageType::SizeType size = {{48, 40, 32}};
+    m_Segmentation = ImageType::New();
+    m_Segmentation->SetRegions(size);
+    m_Segmentation->Allocate();
+    m_Segmentation->FillBuffer(0);
+
+    ImageType::IndexType index;
+    for (index[2] = 0; index[2] < 32; ++index[2])
+    {
+      for (index[1] = 0; index[1] < 40; ++index[1])
+      {
+        for (index[0] = 0; index[0] < 48; ++index[0])
+        {
+          const bool inFirstBox = index[0] >= 4 && index[0] < 20 && index[1] >= 6 && index[1] < 30 && index[2] < 14;
+          const bool inSecondBox =
+            index[0] >= 24 && index[0] < 46 && index[1] >= 20 && index[1] < 40 && index[2] >= 10 && index[2] < 28;
+          const bool onLine = index[1] == 10 && index[2] == 20;
+
+          if (inFirstBox || inSecondBox || onLine)
+            m_Segmentation->SetPixel(index, 1);
+        }
+      }
+    }
+  }
+
+  void tearDown() override { m_Segmentation = nullptr; }
+
+  void Dilate_LargeRadius_EqualsITKFilter() { TestOperation("Dilate"); }
+
+  void Erode_LargeRadius_EqualsITKFilter() { TestOperation("Erode"); }
+
+  void Closing_LargeRadius_EqualsITKFilter() { TestOperation("Closing"); }
+
+  void Opening_LargeRadius_EqualsITKFilter() { TestOperation("Opening"); }
+
+  void Dilate_TimeSteps_EqualsVolumes()
+  {
+    // the time steps are processed independently of each other and written into the image in place
+    ImageType::Pointer empty = ImageType::New();
+    empty->SetRegions(m_Segmentation->GetLargestPossibleRegion());
+    empty->Allocate();
+    empty->FillBuffer(0);
+
+    const ImageType *volumes[] = {m_Segmentation, empty, m_Segmentation, empty, m_Segmentation};
+    const unsigned int timeSteps = 5;
+    const auto numberOfPixels = m_Segmentation->GetLargestPossibleRegion().GetNumberOfPixels();
+
+    mitk::Image::Pointer segmentation3D;
+    mitk::CastToMitkImage(m_Segmentation, segmentation3D);
+
+    mitk::Image::Pointer image = mitk::Image::New();
+    image->Initialize(segmentation3D->GetPixelType(), *segmentation3D->GetGeometry(), 1, timeSteps);
+    for (unsigned int t = 0; t < timeSteps; ++t)
+      image->SetVolume(volumes[t]->GetBufferPointer(), t);
+
+    for (const int radius : {1, Radius})
+    {
+      mitk::Image::Pointer result = image->Clone();
+      mitk::MorphologicalOperations::Dilate(result, radius, mitk::MorphologicalOperations::Ball);
+
+      CPPUNIT_ASSERT_EQUAL(timeSteps, result->GetTimeSteps());
+
+      for (unsigned int t = 0; t < timeSteps; ++t)
+      {
+        mitk::Image::Pointer volume;
+        mitk::CastToMitkImage(volumes[t], volume);
+        mitk::MorphologicalOperations::Dilate(volume, radius, mitk::MorphologicalOperations::Ball);
+
+        mitk::ImageReadAccessor resultAccessor(result, result->GetVolumeData(t));
+        mitk::ImageReadAccessor referenceAccessor(volume);
+        const auto *resultBuffer = static_cast<const PixelType *>(resultAccessor.GetData());
+        const auto *referenceBuffer = static_cast<const PixelType *>(referenceAccessor.GetData());
+
+        CPPUNIT_ASSERT_MESSAGE("Time step differs from the dilated volume.",
+                               std::equal(referenceBuffer, referenceBuffer + numberOfPixels, resultBuffer));
+      }
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkMorphologicalOperations)
@@ -31,6 +31,7 @@ class mitkSegmentationInterpolationTestSuite : public mitk::TestFixture
   MITK_TEST(Equal_Axial_TestInterpolationAndReferenceInterpolation_ReturnsTrue);
   MITK_TEST(Equal_Frontal_TestInterpolationAndReferenceInterpolation_ReturnsTrue);
   MITK_TEST(Equal_Sagittal_TestInterpolationAndReferenceInterpolation_ReturnsTrue);
+  MITK_TEST(GetNeighboringSegmentedSlices_AfterChangedVolume_ReturnsUpdatedSlices);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -199,6 +200,49 @@ public:
     mitk::SliceNavigationController::ViewDirection viewDirection = mitk::SliceNavigationController::Sagittal;
     testRoutine(viewDirection);
   }
+
+  void GetNeighboringSegmentedSlices_AfterChangedVolume_ReturnsUpdatedSlices()
+  {
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Tool::DefaultSegmentationDataType, 3> writeAccessor(m_SegmentationImage);
+      itk::Index<3> index = {{10, 20, 5}};
+      writeAccessor.SetPixelByIndexSafe(index, 1);
+      index[2] = 30;
+      writeAccessor.SetPixelByIndexSafe(index, 1);
+    }
+
+    m_InterpolationController->SetSegmentationVolume(m_SegmentationImage);
+
+    unsigned int lowerBound = 0;
+    unsigned int upperBound = 0;
+    CPPUNIT_ASSERT(m_InterpolationController->GetNeighboringSegmentedSlices(2, 20, 0, lowerBound, upperBound));
+    CPPUNIT_ASSERT_EQUAL(5u, lowerBound);
+    CPPUNIT_ASSERT_EQUAL(30u, upperBound);
+    CPPUNIT_ASSERT(!m_InterpolationController->GetNeighboringSegmentedSlices(2, 5, 0, lowerBound, upperBound));
+    CPPUNIT_ASSERT(!m_InterpolationController->GetNeighboringSegmentedSlices(0, 10, 0, lowerBound, upperBound));
+
+    // add a pixel in slice 12 and remove the one in slice 30 via a (signed) difference volume
+    mitk::Image::Pointer diffImage = mitk::Image::New();
+    diffImage->Initialize(mitk::MakeScalarPixelType<short>(), 3, m_SegmentationImage->GetDimensions());
+    {
+      mitk::ImageWriteAccessor diffAccessor(diffImage);
+      memset(diffAccessor.GetData(), 0, diffImage->GetDimension(0) * diffImage->GetDimension(1) *
+                                          diffImage->GetDimension(2) * sizeof(short));
+    }
+    {
+      mitk::ImagePixelWriteAccessor<short, 3> diffAccessor(diffImage);
+      itk::Index<3> index = {{10, 20, 12}};
+      diffAccessor.SetPixelByIndexSafe(index, 1);
+      index[2] = 30;
+      diffAccessor.SetPixelByIndexSafe(index, -1);
+    }
+    m_InterpolationController->SetChangedVolume(diffImage, 0);
+
+    CPPUNIT_ASSERT(m_InterpolationController->GetNeighboringSegmentedSlices(2, 8, 0, lowerBound, upperBound));
+    CPPUNIT_ASSERT_EQUAL(5u, lowerBound);
+    CPPUNIT_ASSERT_EQUAL(12u, upperBound);
+    CPPUNIT_ASSERT(!m_InterpolationController->GetNeighboringSegmentedSlices(2, 20, 0, lowerBound, upperBound));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkSegmentationInterpolation)
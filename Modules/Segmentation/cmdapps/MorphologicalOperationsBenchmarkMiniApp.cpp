@@ -0,0 +1,160 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// std includes
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// CTK includes
+#include "mitkCommandLineParser.h"
+
+// MITK includes
+#include <mitkImageWriteAccessor.h>
+#include <mitkMorphologicalOperations.h>
+#include <mitkTool.h>
+
+/** \brief MiniApp that measures the run time of the morphological operations on a synthetic 3D+t segmentation
+ *
+ * Every time step contains a few boxes whose position depends on the time step. Each operation is applied to a
+ * fresh copy of the segmentation for the given number of repetitions and the mean run time is reported.
+ * Run it with OMP_NUM_THREADS=1 to compare with single-threaded processing.
+ */
+
+namespace
+{
+  mitk::Image::Pointer CreateSegmentation(unsigned int size, unsigned int timeSteps)
+  {
+    typedef mitk::Tool::DefaultSegmentationDataType PixelType;
+
+    const unsigned int dimensions[] = {size, size, size, timeSteps};
+    mitk::Image::Pointer segmentation = mitk::Image::New();
+    segmentation->Initialize(mitk::MakeScalarPixelType<PixelType>(), 4, dimensions);
+
+    mitk::ImageWriteAccessor accessor(segmentation);
+    auto *buffer = static_cast<PixelType *>(accessor.GetData());
+
+    for (unsigned int t = 0; t < timeSteps; ++t)
+    {
+      const unsigned int shift = (t * size) / (4 * timeSteps);
+      for (unsigned int z = 0; z < size; ++z)
+      {
+        for (unsigned int y = 0; y < size; ++y)
+        {
+          for (unsigned int x = 0; x < size; ++x)
+          {
+            const bool inFirstBox = x >= size / 8 + shift && x < size / 2 + shift && y >= size / 8 && y < size / 2 &&
+                                    z >= size / 4 && z < (3 * size) / 4;
+            const bool inSecondBox = x >= (5 * size) / 8 && y >= size / 2 + shift / 2 && z < size / 3;
+            const bool onLine = y == size / 2 && z == size / 2;
+
+            *buffer++ = (inFirstBox || inSecondBox || onLine) ? 1 : 0;
+          }
+        }
+      }
+    }
+
+    return segmentation;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  mitkCommandLineParser parser;
+
+  parser.setCategory("Segmentation Tools");
+  parser.setTitle("Morphological Operations Benchmark");
+  parser.setDescription("MiniApp that measures the run time of the morphological operations on a synthetic 3D+t segmentation.");
+  parser.setContributor("DKFZ MIC");
+
+  parser.setArgumentPrefix("--", "-");
+  parser.beginGroup("Optional parameters");
+  parser.addArgument("size", "s", mitkCommandLineParser::Int, "Size", "Number of voxels along each axis (default: 128)");
+  parser.addArgument("timesteps", "t", mitkCommandLineParser::Int, "Time steps", "Number of time steps (default: 8)");
+  parser.addArgument("radius", "r", mitkCommandLineParser::Int, "Radius", "Radius of the structuring element (default: 5)");
+  parser.addArgument("repetitions", "n", mitkCommandLineParser::Int, "Repetitions", "Number of runs per operation (default: 3)");
+  parser.addArgument("help", "h", mitkCommandLineParser::Bool, "Help:", "Show this help text");
+  parser.endGroup();
+
+  std::map<std::string, us::Any> parsedArgs = parser.parseArguments(argc, argv);
+
+  if (parsedArgs.count("help") || parsedArgs.count("h"))
+  {
+    std::cout << parser.helpText();
+    return EXIT_SUCCESS;
+  }
+
+  int size = 128;
+  int timeSteps = 8;
+  int radius = 5;
+  int repetitions = 3;
+
+  if (parsedArgs.count("size"))
+    size = us::any_cast<int>(parsedArgs["size"]);
+  if (parsedArgs.count("timesteps"))
+    timeSteps = us::any_cast<int>(parsedArgs["timesteps"]);
+  if (parsedArgs.count("radius"))
+    radius = us::any_cast<int>(parsedArgs["radius"]);
+  if (parsedArgs.count("repetitions"))
+    repetitions = us::any_cast<int>(parsedArgs["repetitions"]);
+
+  if (size < 1 || timeSteps < 1 || radius < 0 || repetitions < 1)
+  {
+    std::cerr << "Size, time steps and repetitions have to be positive, the radius must not be negative." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef std::function<void(mitk::Image::Pointer &)> OperationType;
+  const auto structuringElement = mitk::MorphologicalOperations::Ball;
+  const std::vector<std::pair<std::string, OperationType>> operations = {
+    {"Dilate", [&](mitk::Image::Pointer &image) { mitk::MorphologicalOperations::Dilate(image, radius, structuringElement); }},
+    {"Erode", [&](mitk::Image::Pointer &image) { mitk::MorphologicalOperations::Erode(image, radius, structuringElement); }},
+    {"Closing", [&](mitk::Image::Pointer &image) { mitk::MorphologicalOperations::Closing(image, radius, structuringElement); }},
+    {"Opening", [&](mitk::Image::Pointer &image) { mitk::MorphologicalOperations::Opening(image, radius, structuringElement); }},
+    {"FillHoles", [](mitk::Image::Pointer &image) { mitk::MorphologicalOperations::FillHoles(image); }}};
+
+  try
+  {
+    const mitk::Image::Pointer segmentation = CreateSegmentation(size, timeSteps);
+
+    std::cout << "Segmentation of " << size << "^3 voxels with " << timeSteps << " time steps, radius " << radius
+              << std::endl;
+
+    for (const auto &operation : operations)
+    {
+      double milliseconds = 0.0;
+      for (int i = 0; i < repetitions; ++i)
+      {
+        mitk::Image::Pointer image = segmentation->Clone();
+
+        const auto start = std::chrono::steady_clock::now();
+        operation.second(image);
+        milliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+      }
+
+      std::cout << operation.first << ": " << milliseconds / repetitions << " ms" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+  }
+  catch (const std::exception &e)
+  {
+    MITK_ERROR << e.what();
+    return EXIT_FAILURE;
+  }
+  catch (...)
+  {
+    MITK_ERROR << "Unexpected error encountered.";
+    return EXIT_FAILURE;
+  }
+}
@@ -14,6 +14,7 @@ found in the LICENSE file.
 #include <mitkCreateDistanceImageFromSurfaceFilter.h>
 #include <mitkIOUtil.h>
 #include <mitkImageAccessByItk.h>
+#include <mitkImageCast.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
@@ -26,6 +27,7 @@ class mitkCreateDistanceImageFromSurfaceFilterTestSuite : public mitk::TestFixtu
   // Basically tests the same as the other test below
   // MITK_TEST(TestCreateDistanceImageForLiver);
   MITK_TEST(TestCreateDistanceImageForTube);
+  MITK_TEST(TestLocalInterpolationForTube);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -128,6 +130,72 @@ public:
     CPPUNIT_ASSERT_MESSAGE("HolesDistanceImages are not equal!",
                            mitk::Equal(*(holesDistanceImageReference), *(holeDistanceImage), 0.0001, true));
   }
+
+  void TestLocalInterpolationForTube()
+  {
+    unsigned int NUMBER_OF_TUBE_CONTOURS = 5;
+
+    for (unsigned int i = 0; i < NUMBER_OF_TUBE_CONTOURS; ++i)
+    {
+      std::stringstream s;
+      s << "SurfaceInterpolation/InterpolateWithHoles/ContourWithHoles_";
+      s << i;
+      s << ".vtk";
+      mitk::Surface::Pointer contour = mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath(s.str()));
+      contourList.push_back(contour);
+    }
+
+    mitk::Image::Pointer segmentationImage =
+      mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("SurfaceInterpolation/Reference/SegmentationWithHoles.nrrd"));
+
+    mitk::ComputeContourSetNormalsFilter::Pointer normalsFilter = mitk::ComputeContourSetNormalsFilter::New();
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer interpolateSurfaceFilter =
+      mitk::CreateDistanceImageFromSurfaceFilter::New();
+
+    normalsFilter->SetSegmentationBinaryImage(segmentationImage);
+    itk::ImageBase<3>::Pointer itkImage = itk::ImageBase<3>::New();
+    AccessFixedDimensionByItk_1(segmentationImage, GetImageBase, 3, itkImage);
+    interpolateSurfaceFilter->SetReferenceImage(itkImage.GetPointer());
+
+    for (unsigned int j = 0; j < contourList.size(); j++)
+    {
+      normalsFilter->SetInput(j, contourList.at(j));
+      interpolateSurfaceFilter->SetInput(j, normalsFilter->GetOutput(j));
+    }
+
+    // force the partition of unity
+    interpolateSurfaceFilter->SetMaximumNumberOfCentersForGlobalInterpolation(0);
+    interpolateSurfaceFilter->Update();
+
+    mitk::Image::Pointer localDistanceImage = interpolateSurfaceFilter->GetOutput()->Clone();
+    mitk::Image::Pointer holesDistanceImageReference =
+      mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("SurfaceInterpolation/Reference/HolesDistanceImage.nrrd"));
+
+    typedef mitk::CreateDistanceImageFromSurfaceFilter::DistanceImageType DistanceImageType;
+    DistanceImageType::Pointer localImage, referenceImage;
+    mitk::CastToItkImage(localDistanceImage, localImage);
+    mitk::CastToItkImage(holesDistanceImageReference, referenceImage);
+
+    CPPUNIT_ASSERT_MESSAGE("Distance images have the same size",
+                           localImage->GetLargestPossibleRegion() == referenceImage->GetLargestPossibleRegion());
+
+    // the local interpolation may differ slightly from the global one, but it has to separate inside and outside
+    // in the same way
+    const auto numberOfPixels = localImage->GetLargestPossibleRegion().GetNumberOfPixels();
+    unsigned int numberOfDifferentSigns = 0;
+    for (unsigned int i = 0; i < numberOfPixels; ++i)
+    {
+      if ((localImage->GetBufferPointer()[i] < 0) != (referenceImage->GetBufferPointer()[i] < 0))
+        ++numberOfDifferentSigns;
+    }
+    CPPUNIT_ASSERT_MESSAGE("Local and global interpolation agree", numberOfDifferentSigns < numberOfPixels / 100);
+
+    // an update without changed contours reuses all local interpolants
+    interpolateSurfaceFilter->Modified();
+    interpolateSurfaceFilter->Update();
+    CPPUNIT_ASSERT_MESSAGE("Update with reused interpolants gives the same result",
+                           mitk::Equal(*localDistanceImage, *(interpolateSurfaceFilter->GetOutput()), mitk::eps, true));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkCreateDistanceImageFromSurfaceFilter)
@@ -16,13 +16,38 @@ found in the LICENSE file.
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkPointLocator.h"
 #include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
 
 #include "itkImageRegionIteratorWithIndex.h"
 #include "itkNeighborhoodIterator.h"
 
+#include <array>
+#include <algorithm>
+#include <cmath>
 #include <queue>
+#include <set>
+
+namespace
+{
+  // Upper bound for the number of centers within one grid cell of the partition of unity
+  const unsigned int MaximumNumberOfCentersPerCell = 150;
+  // Each local interpolant uses at least this number of centers, its support is enlarged if necessary
+  const unsigned int MinimumNumberOfCentersPerInterpolant = 30;
+  // Support radius of a local interpolant relative to the half diagonal of its cell
+  const double InterpolantOverlap = 1.25;
+
+  // Wendland's compactly supported C2 function, used to blend the local interpolants
+  double WendlandWeight(double r)
+  {
+    if (r >= 1.0)
+      return 0.0;
+    const double t = 1.0 - r;
+    return t * t * t * t * (4.0 * r + 1.0);
+  }
+}
 
 void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 {
@@ -105,7 +130,11 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 }
 
 mitk::CreateDistanceImageFromSurfaceFilter::CreateDistanceImageFromSurfaceFilter()
-  : m_DistanceImageSpacing(0.0), m_DistanceImageDefaultBufferValue(0.0)
+  : m_UseLocalInterpolation(false),
+    m_MaximumNumberOfCentersForGlobalInterpolation(3000),
+    m_CellSize(0.0),
+    m_DistanceImageSpacing(0.0),
+    m_DistanceImageDefaultBufferValue(0.0)
 {
   m_DistanceImageVolume = 50000;
   this->m_UseProgressBar = false;
@@ -125,15 +154,28 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
   this->CreateEmptyDistanceImage();
 
   // First of all we have to build the equation-system from the existing contour-edge-points
-  this->CreateSolutionMatrixAndFunctionValues();
+  this->CreateAuxiliaryCentersAndFunctionValues();
 
-  if (this->m_UseProgressBar)
-    mitk::ProgressBar::GetInstance()->Progress(1);
+  m_UseLocalInterpolation = m_Centers.size() > m_MaximumNumberOfCentersForGlobalInterpolation;
+  if (m_UseLocalInterpolation)
+  {
+    this->CreateLocalInterpolants();
 
-  m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+    if (this->m_UseProgressBar)
+      mitk::ProgressBar::GetInstance()->Progress(3);
+  }
+  else
+  {
+    this->CreateSolutionMatrix();
 
-  if (this->m_UseProgressBar)
-    mitk::ProgressBar::GetInstance()->Progress(2);
+    if (this->m_UseProgressBar)
+      mitk::ProgressBar::GetInstance()->Progress(1);
+
+    m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+
+    if (this->m_UseProgressBar)
+      mitk::ProgressBar::GetInstance()->Progress(2);
+  }
 
   // The last step is to create the distance map with the interpolated distance function
   this->FillDistanceImage();
@@ -143,6 +185,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
 
   m_Centers.clear();
   m_Normals.clear();
+  m_LocalInterpolantsPerCell.clear();
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
@@ -168,6 +211,8 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
   PointType currentPoint;
   PointType normal;
 
+  std::set<std::array<double, 3>> existingCenters;
+
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
     auto currentSurface = this->GetInput(i);
@@ -199,9 +244,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
         currentPoint.copy_in(p);
 
-        int count = std::count(m_Centers.begin(), m_Centers.end(), currentPoint);
-
-        if (count == 0)
+        if (existingCenters.insert({{p[0], p[1], p[2]}}).second)
         {
           double currentNormal[3];
           currentCellNormals->GetTuple(cell[j], currentNormal);
@@ -218,7 +261,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
   }     // end for all outputs
 }
 
-void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunctionValues()
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateAuxiliaryCentersAndFunctionValues()
 {
   // For we can now calculate the exact size of the centers we initialize the data structures
   unsigned int numberOfCenters = m_Centers.size();
@@ -260,9 +303,12 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
 
     m_FunctionValues[numberOfCenters * 2 + i] = m_DistanceImageSpacing;
   }
+}
 
-  // Now we have created all centers and all function values. Next step is to create the solution matrix
-  numberOfCenters = m_Centers.size();
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrix()
+{
+  // All centers and all function values are created. Next step is to create the solution matrix
+  unsigned int numberOfCenters = m_Centers.size();
 
   m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
 
@@ -419,8 +465,223 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   CastToMitkImage(m_DistanceImageITK, resultImage);
 }
 
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateLocalInterpolants()
+{
+  // Keep the interpolants of the last update, so that unchanged ones need not be solved again
+  std::unordered_map<CellKeyType, LocalInterpolant> previousInterpolants;
+  const double previousCellSize = m_CellSize;
+  for (auto &interpolant : m_LocalInterpolants)
+    previousInterpolants.emplace(interpolant.CellKey, std::move(interpolant));
+  m_LocalInterpolants.clear();
+  m_LocalInterpolantsPerCell.clear();
+
+  // The cell size is the largest power of two (in mm) for which no cell contains too many centers. Using
+  // powers of two keeps the grid stable between updates, which is the precondition to reuse interpolants.
+  double xmin[3], xmax[3];
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    xmin[dim] = xmax[dim] = m_Centers.at(0)[dim];
+  }
+  for (const auto &center : m_Centers)
+  {
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      xmin[dim] = std::min(xmin[dim], center[dim]);
+      xmax[dim] = std::max(xmax[dim], center[dim]);
+    }
+  }
+  const double diagonal = std::sqrt((xmax[0] - xmin[0]) * (xmax[0] - xmin[0]) + (xmax[1] - xmin[1]) * (xmax[1] - xmin[1]) +
+                                    (xmax[2] - xmin[2]) * (xmax[2] - xmin[2]));
+
+  m_CellSize = std::pow(2.0, std::ceil(std::log2(std::max(diagonal, m_DistanceImageSpacing))));
+  while (m_CellSize > m_DistanceImageSpacing)
+  {
+    std::unordered_map<CellKeyType, unsigned int> centersPerCell;
+    unsigned int maximumNumberOfCenters = 0;
+    for (const auto &center : m_Centers)
+      maximumNumberOfCenters = std::max(maximumNumberOfCenters, ++centersPerCell[this->GetCellKey(center)]);
+
+    if (maximumNumberOfCenters <= MaximumNumberOfCentersPerCell)
+      break;
+    m_CellSize /= 2.0;
+  }
+
+  if (m_CellSize != previousCellSize)
+    previousInterpolants.clear();
+
+  auto centerPoints = vtkSmartPointer<vtkPoints>::New();
+  centerPoints->SetNumberOfPoints(m_Centers.size());
+  for (vtkIdType i = 0; i < static_cast<vtkIdType>(m_Centers.size()); ++i)
+    centerPoints->SetPoint(i, m_Centers[i].data_block());
+
+  auto centerPolyData = vtkSmartPointer<vtkPolyData>::New();
+  centerPolyData->SetPoints(centerPoints);
+
+  auto locator = vtkSmartPointer<vtkPointLocator>::New();
+  locator->SetDataSet(centerPolyData);
+  locator->BuildLocator();
+
+  // Create one interpolant per cell overlapping the distance image
+  double imageBounds[2][3];
+  const auto region = m_DistanceImageITK->GetLargestPossibleRegion();
+  for (unsigned int corner = 0; corner < 8; ++corner)
+  {
+    DistanceImageType::IndexType cornerIndex = region.GetIndex();
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      if (corner & (1u << dim))
+        cornerIndex[dim] += region.GetSize(dim) - 1;
+    }
+
+    DistanceImageType::PointType cornerPoint;
+    m_DistanceImageITK->TransformIndexToPhysicalPoint(cornerIndex, cornerPoint);
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+      imageBounds[0][dim] = corner == 0 ? cornerPoint[dim] : std::min(imageBounds[0][dim], cornerPoint[dim]);
+      imageBounds[1][dim] = corner == 0 ? cornerPoint[dim] : std::max(imageBounds[1][dim], cornerPoint[dim]);
+    }
+  }
+
+  const long firstCell[3] = {static_cast<long>(std::floor(imageBounds[0][0] / m_CellSize)),
+                             static_cast<long>(std::floor(imageBounds[0][1] / m_CellSize)),
+                             static_cast<long>(std::floor(imageBounds[0][2] / m_CellSize))};
+  const long lastCell[3] = {static_cast<long>(std::floor(imageBounds[1][0] / m_CellSize)),
+                            static_cast<long>(std::floor(imageBounds[1][1] / m_CellSize)),
+                            static_cast<long>(std::floor(imageBounds[1][2] / m_CellSize))};
+  const double minimumRadius = InterpolantOverlap * 0.5 * std::sqrt(3.0) * m_CellSize;
+
+  auto ids = vtkSmartPointer<vtkIdList>::New();
+  std::vector<vtkIdType> sortedIds;
+
+  for (long z = firstCell[2]; z <= lastCell[2]; ++z)
+  {
+    for (long y = firstCell[1]; y <= lastCell[1]; ++y)
+    {
+      for (long x = firstCell[0]; x <= lastCell[0]; ++x)
+      {
+        LocalInterpolant interpolant;
+        interpolant.CellKey = GetCellKey(x, y, z);
+        interpolant.Center[0] = (x + 0.5) * m_CellSize;
+        interpolant.Center[1] = (y + 0.5) * m_CellSize;
+        interpolant.Center[2] = (z + 0.5) * m_CellSize;
+
+        // enlarge the support until it contains enough centers, e.g. in the gap between two contours
+        interpolant.Radius = minimumRadius;
+        locator->FindClosestNPoints(
+          std::min<int>(MinimumNumberOfCentersPerInterpolant, m_Centers.size()), interpolant.Center.data_block(), ids);
+        for (vtkIdType i = 0; i < ids->GetNumberOfIds(); ++i)
+        {
+          interpolant.Radius =
+            std::max(interpolant.Radius, (m_Centers[ids->GetId(i)] - interpolant.Center).two_norm() * 1.01);
+        }
+        locator->FindPointsWithinRadius(interpolant.Radius, interpolant.Center.data_block(), ids);
+
+        // sort the centers by their coordinates, so that they can be compared to the previous update
+        sortedIds.assign(ids->GetPointer(0), ids->GetPointer(0) + ids->GetNumberOfIds());
+        std::sort(sortedIds.begin(), sortedIds.end(), [this](vtkIdType a, vtkIdType b) {
+          return std::lexicographical_compare(
+            m_Centers[a].begin(), m_Centers[a].end(), m_Centers[b].begin(), m_Centers[b].end());
+        });
+
+        const auto numberOfCenters = static_cast<unsigned int>(sortedIds.size());
+        interpolant.Centers.resize(numberOfCenters);
+        interpolant.FunctionValues.resize(numberOfCenters);
+        for (unsigned int i = 0; i < numberOfCenters; ++i)
+        {
+          interpolant.Centers[i] = m_Centers[sortedIds[i]];
+          interpolant.FunctionValues[i] = m_FunctionValues[sortedIds[i]];
+        }
+
+        auto previous = previousInterpolants.find(interpolant.CellKey);
+        if (previous != previousInterpolants.end() && previous->second.Centers == interpolant.Centers &&
+            previous->second.FunctionValues == interpolant.FunctionValues)
+        {
+          interpolant.Weights = std::move(previous->second.Weights);
+        }
+        else
+        {
+          // Same RBF as for the global interpolation: Phi(r) = r
+          Eigen::MatrixXd solutionMatrix(numberOfCenters, numberOfCenters);
+          for (unsigned int i = 0; i < numberOfCenters; ++i)
+          {
+            for (unsigned int j = 0; j < numberOfCenters; ++j)
+              solutionMatrix(i, j) = (interpolant.Centers[i] - interpolant.Centers[j]).two_norm();
+          }
+          interpolant.Weights = solutionMatrix.partialPivLu().solve(interpolant.FunctionValues);
+        }
+
+        // register the interpolant in all cells its support overlaps
+        const auto index = static_cast<unsigned int>(m_LocalInterpolants.size());
+        long supportFirstCell[3], supportLastCell[3];
+        for (unsigned int dim = 0; dim < 3; ++dim)
+        {
+          supportFirstCell[dim] = static_cast<long>(std::floor((interpolant.Center[dim] - interpolant.Radius) / m_CellSize));
+          supportLastCell[dim] = static_cast<long>(std::floor((interpolant.Center[dim] + interpolant.Radius) / m_CellSize));
+        }
+        for (long sz = supportFirstCell[2]; sz <= supportLastCell[2]; ++sz)
+        {
+          for (long sy = supportFirstCell[1]; sy <= supportLastCell[1]; ++sy)
+          {
+            for (long sx = supportFirstCell[0]; sx <= supportLastCell[0]; ++sx)
+              m_LocalInterpolantsPerCell[GetCellKey(sx, sy, sz)].push_back(index);
+          }
+        }
+
+        m_LocalInterpolants.push_back(std::move(interpolant));
+      }
+    }
+  }
+}
+
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateLocalDistanceValue(const PointType &p) const
+{
+  auto cell = m_LocalInterpolantsPerCell.find(this->GetCellKey(p));
+  if (cell == m_LocalInterpolantsPerCell.end())
+    return m_DistanceImageDefaultBufferValue;
+
+  double weightedSum = 0.0;
+  double sumOfWeights = 0.0;
+  for (auto index : cell->second)
+  {
+    const LocalInterpolant &interpolant = m_LocalInterpolants[index];
+    const double weight = WendlandWeight((p - interpolant.Center).two_norm() / interpolant.Radius);
+    if (weight <= 0.0)
+      continue;
+
+    double distanceValue = 0.0;
+    for (unsigned int i = 0; i < interpolant.Centers.size(); ++i)
+      distanceValue += (p - interpolant.Centers[i]).two_norm() * interpolant.Weights[i];
+
+    weightedSum += weight * distanceValue;
+    sumOfWeights += weight;
+  }
+
+  return sumOfWeights > 0.0 ? weightedSum / sumOfWeights : m_DistanceImageDefaultBufferValue;
+}
+
+mitk::CreateDistanceImageFromSurfaceFilter::CellKeyType mitk::CreateDistanceImageFromSurfaceFilter::GetCellKey(
+  const PointType &p) const
+{
+  return GetCellKey(static_cast<long>(std::floor(p[0] / m_CellSize)),
+                    static_cast<long>(std::floor(p[1] / m_CellSize)),
+                    static_cast<long>(std::floor(p[2] / m_CellSize)));
+}
+
+mitk::CreateDistanceImageFromSurfaceFilter::CellKeyType mitk::CreateDistanceImageFromSurfaceFilter::GetCellKey(long x,
+                                                                                                               long y,
+                                                                                                               long z)
+{
+  // 21 bits per dimension
+  const CellKeyType offset = 1 << 20;
+  return ((static_cast<CellKeyType>(x) + offset) << 42) | ((static_cast<CellKeyType>(y) + offset) << 21) |
+         (static_cast<CellKeyType>(z) + offset);
+}
+
 double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointType p)
 {
+  if (m_UseLocalInterpolation)
+    return this->CalculateLocalDistanceValue(p);
+
   double distanceValue(0);
   PointType p1;
   PointType p2;
@@ -520,6 +781,10 @@ void mitk::CreateDistanceImageFromSurfaceFilter::Reset()
   this->SetNumberOfIndexedInputs(0);
   this->SetNumberOfIndexedOutputs(1);
 
+  m_LocalInterpolants.clear();
+  m_LocalInterpolantsPerCell.clear();
+  m_CellSize = 0.0;
+
   mitk::Image::Pointer output = mitk::Image::New();
   this->SetNthOutput(0, output.GetPointer());
 }
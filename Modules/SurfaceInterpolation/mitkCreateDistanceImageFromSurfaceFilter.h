@@ -25,6 +25,8 @@ found in the LICENSE file.
 
 #include <Eigen/Dense>
 
+#include <unordered_map>
+
 namespace mitk
 {
   /**
@@ -57,6 +59,13 @@ namespace mitk
          adjusted by calling SetDistanceImageVolume(unsigned int volume) which specifies the number ob pixels enclosed
   by the image.
 
+         For a small number of centers a single global RBF system is solved. Since its costs grow cubically with the
+         number of centers, larger contour sets are interpolated with a partition of unity: Space is divided into a
+         regular grid of cells, an RBF interpolant is fitted to the centers around each cell and the interpolants are
+         blended with compactly supported weights. The local systems are small and independent, so the costs grow
+         linearly with the number of contours. Local interpolants whose centers did not change since the last update
+         (e.g. far away from a newly added contour) are reused without solving their system again.
+
   \ingroup Process
 
   $Author: fetzer$
@@ -99,6 +108,14 @@ namespace mitk
     */
     itkSetMacro(DistanceImageVolume, unsigned int);
 
+    /**
+    \brief Set the maximum number of centers (including the generated points inside and outside of the surface)
+           for which a single global interpolation is computed. Above this number the distance function is blended
+           from local interpolants. The default is 3000.
+    */
+    itkSetMacro(MaximumNumberOfCentersForGlobalInterpolation, unsigned int);
+    itkGetMacro(MaximumNumberOfCentersForGlobalInterpolation, unsigned int);
+
     void PrintEquationSystem();
 
     // Resets the filter, i.e. removes all inputs and outputs
@@ -127,9 +144,34 @@ namespace mitk
     void GenerateOutputInformation() override;
 
   private:
-    void CreateSolutionMatrixAndFunctionValues();
+    typedef long long CellKeyType;
+
+    /**
+    * \brief RBF interpolant of the centers within a sphere around a grid cell.
+    */
+    struct LocalInterpolant
+    {
+      CellKeyType CellKey;
+      PointType Center;
+      double Radius;
+      CenterList Centers;
+      Eigen::VectorXd FunctionValues;
+      Eigen::VectorXd Weights;
+    };
+
+    void CreateAuxiliaryCentersAndFunctionValues();
+    void CreateSolutionMatrix();
     double CalculateDistanceValue(PointType p);
 
+    /**
+    * \brief Fits the local interpolants for all grid cells overlapping the distance image. Interpolants of the
+    * previous update with identical centers and function values are reused.
+    */
+    void CreateLocalInterpolants();
+    double CalculateLocalDistanceValue(const PointType &p) const;
+    CellKeyType GetCellKey(const PointType &p) const;
+    static CellKeyType GetCellKey(long x, long y, long z);
+
     void FillDistanceImage();
 
     /**
@@ -162,6 +204,12 @@ namespace mitk
     Eigen::VectorXd m_FunctionValues;
     Eigen::VectorXd m_Weights;
 
+    bool m_UseLocalInterpolation;
+    unsigned int m_MaximumNumberOfCentersForGlobalInterpolation;
+    double m_CellSize;
+    std::vector<LocalInterpolant> m_LocalInterpolants;
+    std::unordered_map<CellKeyType, std::vector<unsigned int>> m_LocalInterpolantsPerCell;
+
     DistanceImageType::Pointer m_DistanceImageITK;
     itk::ImageBase<3>::Pointer m_ReferenceImage;
 
@@ -15,6 +15,7 @@ found in the LICENSE file.
 
 #include <mitkImage.h>
 #include <mitkImagePixelReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
 #include <mitkImageGenerator.h>
 #include <mitkSurface.h>
 #include <mitkToFProcessingCommon.h>
@@ -22,6 +23,7 @@ found in the LICENSE file.
 #include <mitkToFTestingCommon.h>
 #include <mitkIOUtil.h>
 
+#include <vtkCellArray.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
 #include <vtkSmartPointer.h>
@@ -375,6 +377,41 @@ int mitkToFDistanceImageToSurfaceFilterTest(int /* argc */, char* /*argv*/[])
   }
   MITK_TEST_CONDITION_REQUIRED(compareToInput,"Testing backward transformation compared to original image with interpixeldistance");
 
+  //Topology test: the cells only change if the set of valid pixels changes
+  mitk::Image::Pointer topologyImage = mitk::ImageGenerator::GenerateGradientImage<float>(dimX,dimY,1,1);
+  {
+    mitk::ImageWriteAccessor writeAccess(topologyImage, topologyImage->GetSliceData());
+    float* distances = static_cast<float*>(writeAccess.GetData());
+    for (unsigned int i = 0; i < dimX*dimY; ++i)
+      distances[i] = 1000.0f + (i % 7);
+  }
+  mitk::ToFDistanceImageToSurfaceFilter::Pointer topologyFilter = mitk::ToFDistanceImageToSurfaceFilter::New();
+  topologyFilter->SetInput(topologyImage, cameraIntrinsics);
+  topologyFilter->Update();
+  vtkSmartPointer<vtkPolyData> firstMesh = topologyFilter->GetOutput()->GetVtkPolyData();
+  MITK_TEST_CONDITION_REQUIRED(firstMesh->GetNumberOfPoints() == dimX*dimY, "Testing number of points of fully valid image");
+  MITK_TEST_CONDITION_REQUIRED(firstMesh->GetNumberOfPolys() == 2*(dimX-1)*(dimY-1), "Testing number of triangles of fully valid image");
+  vtkSmartPointer<vtkCellArray> firstPolys = firstMesh->GetPolys();
+
+  {
+    mitk::ImageWriteAccessor writeAccess(topologyImage, topologyImage->GetSliceData());
+    static_cast<float*>(writeAccess.GetData())[5] = 502.5f; // half of the former distance
+  }
+  topologyImage->Modified();
+  topologyFilter->Update();
+  MITK_TEST_CONDITION_REQUIRED(topologyFilter->GetOutput()->GetVtkPolyData()->GetPolys() == firstPolys, "Testing reuse of topology if valid pixels did not change");
+  MITK_TEST_CONDITION_REQUIRED(mitk::Equal(topologyFilter->GetOutput()->GetVtkPolyData()->GetPoint(5)[2] * 2.0, firstMesh->GetPoint(5)[2], 1e-9), "Testing update of points if topology is reused");
+
+  {
+    mitk::ImageWriteAccessor writeAccess(topologyImage, topologyImage->GetSliceData());
+    static_cast<float*>(writeAccess.GetData())[dimX + 1] = 0.0f;
+  }
+  topologyImage->Modified();
+  topologyFilter->Update();
+  vtkPolyData* changedMesh = topologyFilter->GetOutput()->GetVtkPolyData();
+  MITK_TEST_CONDITION_REQUIRED(changedMesh->GetNumberOfPoints() == dimX*dimY - 1, "Testing number of points with one invalid pixel");
+  MITK_TEST_CONDITION_REQUIRED(changedMesh->GetNumberOfPolys() == 2*(dimX-1)*(dimY-1) - 8, "Testing number of triangles with one invalid pixel");
+
   //clean up
   delete[] point;
   //  expectedResult->Delete();
@@ -22,15 +22,34 @@ found in the LICENSE file.
 #include <vtkPolyData.h>
 #include <vtkPointData.h>
 #include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdTypeArray.h>
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <numeric>
 #include <vtkMath.h>
 
+namespace
+{
+  vtkSmartPointer<vtkCellArray> CreateCellArray(vtkIdType cellSize, const std::vector<vtkIdType>& connectivity)
+  {
+    vtkSmartPointer<vtkIdTypeArray> connectivityArray = vtkSmartPointer<vtkIdTypeArray>::New();
+    connectivityArray->SetNumberOfValues(connectivity.size());
+    std::copy(connectivity.begin(), connectivity.end(), connectivityArray->GetPointer(0));
+
+    vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+    cells->SetData(cellSize, connectivityArray);
+    return cells;
+  }
+}
+
 mitk::ToFDistanceImageToSurfaceFilter::ToFDistanceImageToSurfaceFilter() :
   m_IplScalarImage(nullptr), m_CameraIntrinsics(), m_TextureImageWidth(0), m_TextureImageHeight(0), m_InterPixelDistance(), m_TextureIndex(0),
-  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0)
+  m_GenerateTriangularMesh(true), m_TriangulationThreshold(0.0), m_CachedTopologyIsTriangulated(false)
 {
   m_InterPixelDistance.Fill(0.045);
   m_CameraIntrinsics = mitk::CameraIntrinsics::New();
@@ -85,6 +104,98 @@ mitk::Image* mitk::ToFDistanceImageToSurfaceFilter::GetInput( unsigned int idx )
   return static_cast< mitk::Image*>(this->ProcessObject::GetInput(idx));
 }
 
+void mitk::ToFDistanceImageToSurfaceFilter::UpdateBackprojectionCache(int xDimension, int yDimension, const mitk::Point3D& origin, const mitk::Vector3D& spacing)
+{
+  const double parameters[10] = { m_CameraIntrinsics->GetFocalLengthX(), m_CameraIntrinsics->GetFocalLengthY(),
+    m_CameraIntrinsics->GetPrincipalPointX(), m_CameraIntrinsics->GetPrincipalPointY(),
+    m_InterPixelDistance[0], m_InterPixelDistance[1], origin[0], origin[1], spacing[0], spacing[1] };
+
+  BackprojectionCache& cache = m_BackprojectionCache;
+  if (cache.XDimension == xDimension && cache.YDimension == yDimension && cache.ReconstructionMode == m_ReconstructionMode &&
+      std::equal(parameters, parameters + 10, cache.Parameters))
+  {
+    return;
+  }
+
+  cache.XDimension = xDimension;
+  cache.YDimension = yDimension;
+  cache.ReconstructionMode = m_ReconstructionMode;
+  std::copy(parameters, parameters + 10, cache.Parameters);
+
+  const double focalLengthX = parameters[0];
+  const double focalLengthY = parameters[1];
+  const double principalPointX = parameters[2];
+  const double principalPointY = parameters[3];
+  //convert focallength from pixel to mm
+  const double focalLengthInMm = (focalLengthX*m_InterPixelDistance[0]+focalLengthY*m_InterPixelDistance[1])/2.0;
+
+  /** Here we have to incorporate spacing and origin to allow processing of cropped/resampled images
+  * Usually origin will be [0, 0, 0] and spacing will be [1, 1, 1], but just in case the image is moved
+  * due to cropping or the spacing differes due to up- or downsampling.
+  * The terms are computed exactly as in ToFProcessingCommon, hence the results are identical. */
+  cache.ColumnTerms.resize(xDimension);
+  for (int i = 0; i < xDimension; ++i)
+  {
+    unsigned int completeIndexX = i*spacing[0]+origin[0];
+    switch (m_ReconstructionMode)
+    {
+    case WithInterPixelDistance:
+      cache.ColumnTerms[i] = (completeIndexX - principalPointX) * m_InterPixelDistance[0];
+      break;
+    default:
+      cache.ColumnTerms[i] = completeIndexX - principalPointX;
+    }
+  }
+
+  cache.RowTerms.resize(yDimension);
+  for (int j = 0; j < yDimension; ++j)
+  {
+    unsigned int completeIndexY = j*spacing[1]+origin[1];
+    switch (m_ReconstructionMode)
+    {
+    case WithOutInterPixelDistance:
+      cache.RowTerms[j] = (completeIndexY - principalPointY) * (focalLengthX / focalLengthY);
+      break;
+    case WithInterPixelDistance:
+      cache.RowTerms[j] = (completeIndexY - principalPointY) * m_InterPixelDistance[1];
+      break;
+    default:
+      cache.RowTerms[j] = completeIndexY - principalPointY;
+    }
+  }
+
+  switch (m_ReconstructionMode)
+  {
+  case WithOutInterPixelDistance:
+    cache.ZTerm = focalLengthX;
+    break;
+  case WithInterPixelDistance:
+    cache.ZTerm = focalLengthInMm;
+    break;
+  default:
+    cache.ZTerm = 1.0;
+  }
+
+  if (m_ReconstructionMode == Kinect)
+  {
+    cache.PixelDenominators.clear();
+    return;
+  }
+
+  //distance from pinhole to pixel
+  cache.PixelDenominators.resize(static_cast<std::size_t>(xDimension) * yDimension);
+  for (int j = 0; j < yDimension; ++j)
+  {
+    const double rowTerm = cache.RowTerms[j];
+    double* denominators = cache.PixelDenominators.data() + static_cast<std::size_t>(j) * xDimension;
+    for (int i = 0; i < xDimension; ++i)
+    {
+      const double columnTerm = cache.ColumnTerms[i];
+      denominators[i] = sqrt(columnTerm*columnTerm + rowTerm*rowTerm + cache.ZTerm*cache.ZTerm);
+    }
+  }
+}
+
 void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
 {
   mitk::Surface::Pointer output = this->GetOutput();
@@ -92,33 +203,17 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
   mitk::Image::Pointer input = this->GetInput();
   assert(input);
   // mesh points
-  int xDimension = input->GetDimension(0);
-  int yDimension = input->GetDimension(1);
-  unsigned int size = xDimension*yDimension; //size of the image-array
-  std::vector<bool> isPointValid;
-  isPointValid.resize(size);
-  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-  points->SetDataTypeToDouble();
-  vtkSmartPointer<vtkCellArray> polys = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkCellArray> vertices = vtkSmartPointer<vtkCellArray>::New();
-  vtkSmartPointer<vtkFloatArray> scalarArray = vtkSmartPointer<vtkFloatArray>::New();
-  vtkSmartPointer<vtkFloatArray> textureCoords = vtkSmartPointer<vtkFloatArray>::New();
-  textureCoords->SetNumberOfComponents(2);
-  textureCoords->Allocate(size);
+  const int xDimension = input->GetDimension(0);
+  const int yDimension = input->GetDimension(1);
+  const unsigned int size = xDimension*yDimension; //size of the image-array
 
-  //Make a vtkIdList to save the ID's of the polyData corresponding to the image
-  //pixel ID's. See below for more documentation.
-  m_VertexIdList = vtkSmartPointer<vtkIdList>::New();
-  //Allocate the object once else it would automatically allocate new memory
-  //for every vertex and perform a copy which is expensive.
-  m_VertexIdList->Allocate(size);
-  m_VertexIdList->SetNumberOfIds(size);
-  for(unsigned int i = 0; i < size; ++i)
+  if (m_ReconstructionMode != WithOutInterPixelDistance && m_ReconstructionMode != WithInterPixelDistance && m_ReconstructionMode != Kinect)
   {
-    m_VertexIdList->SetId(i, 0);
+    MITK_ERROR << "Incorrect reconstruction mode!";
   }
 
-  float* scalarFloatData = nullptr;
+  const float* scalarFloatData = nullptr;
+  std::unique_ptr<ImageReadAccessor> textureAcc;
 
   if (this->m_IplScalarImage) // if scalar image is defined use it for texturing
   {
@@ -126,177 +221,205 @@ void mitk::ToFDistanceImageToSurfaceFilter::GenerateData()
   }
   else if (this->GetInput(m_TextureIndex)) // otherwise use intensity image (input(2))
   {
-    ImageReadAccessor inputAcc(this->GetInput(m_TextureIndex));
-    scalarFloatData = (float*)inputAcc.GetData();
+    textureAcc = std::make_unique<ImageReadAccessor>(this->GetInput(m_TextureIndex));
+    scalarFloatData = (const float*)textureAcc->GetData();
   }
 
   ImageReadAccessor inputAcc(input, input->GetSliceData(0,0,0));
-  float* inputFloatData = (float*)inputAcc.GetData();
-  //calculate world coordinates
-  mitk::ToFProcessingCommon::ToFPoint2D focalLengthInPixelUnits;
-  mitk::ToFProcessingCommon::ToFScalarType focalLengthInMm;
-  if((m_ReconstructionMode == WithOutInterPixelDistance) || (m_ReconstructionMode == Kinect))
-  {
-    focalLengthInPixelUnits[0] = m_CameraIntrinsics->GetFocalLengthX();
-    focalLengthInPixelUnits[1] = m_CameraIntrinsics->GetFocalLengthY();
-    focalLengthInMm = 0.0;
-  }
-  else if( m_ReconstructionMode == WithInterPixelDistance)
-  {
-    //convert focallength from pixel to mm
-    focalLengthInPixelUnits[0] = 0.0;
-    focalLengthInPixelUnits[1] = 0.0;
-    focalLengthInMm = (m_CameraIntrinsics->GetFocalLengthX()*m_InterPixelDistance[0]+m_CameraIntrinsics->GetFocalLengthY()*m_InterPixelDistance[1])/2.0;
-  }
-  else
-  {
-    focalLengthInPixelUnits[0] = 0.0;
-    focalLengthInPixelUnits[1] = 0.0;
-    focalLengthInMm = 0.0;
-  }
-
-  mitk::ToFProcessingCommon::ToFPoint2D principalPoint;
-  principalPoint[0] = m_CameraIntrinsics->GetPrincipalPointX();
-  principalPoint[1] = m_CameraIntrinsics->GetPrincipalPointY();
+  const float* inputFloatData = (const float*)inputAcc.GetData();
 
   mitk::Point3D origin = input->GetGeometry()->GetOrigin();
   mitk::Vector3D spacing = input->GetGeometry()->GetSpacing();
+  this->UpdateBackprojectionCache(xDimension, yDimension, origin, spacing);
+  const BackprojectionCache& cache = m_BackprojectionCache;
+
+  // first pass: find the valid pixels and count them per row, so that every row knows the
+  // ID of its first vertex and the rows can be processed independently afterwards
+  std::vector<unsigned char> validPixels(size);
+  std::vector<vtkIdType> rowOffsets(yDimension + 1, 0);
 
-  for (int j=0; j<yDimension; j++)
+#pragma omp parallel for
+  for (int j = 0; j < yDimension; ++j)
   {
-    for (int i=0; i<xDimension; i++)
+    const float* distances = inputFloatData + static_cast<std::size_t>(j) * xDimension;
+    unsigned char* valid = validPixels.data() + static_cast<std::size_t>(j) * xDimension;
+    vtkIdType numberOfValidPixels = 0;
+    for (int i = 0; i < xDimension; ++i)
     {
-      unsigned int pixelID = i+j*xDimension;
+      //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
+      valid[i] = distances[i] > mitk::eps ? 1 : 0;
+      numberOfValidPixels += valid[i];
+    }
+    rowOffsets[j + 1] = numberOfValidPixels;
+   }
 
-      mitk::ToFProcessingCommon::ToFScalarType distance = (double)inputFloatData[pixelID];
+  for (int j = 0; j < yDimension; ++j)
+    rowOffsets[j + 1] += rowOffsets[j];
+  const vtkIdType numberOfPoints = rowOffsets[yDimension];
 
-      /** Here we have to incorporate spacing and origin to allow processing of cropped/resampled images
-      * Usually origin will be [0, 0, 0] and spacing will be [1, 1, 1], but just in case the image is moved
-      * due to cropping or the spacing differes due to up- or downsampling.*/
-      unsigned int completeIndexX = i*spacing[0]+origin[0];
-      unsigned int completeIndexY = j*spacing[1]+origin[1];
+  // allocate all arrays once, the second pass writes into them directly
+  vtkSmartPointer<vtkDoubleArray> pointArray = vtkSmartPointer<vtkDoubleArray>::New();
+  pointArray->SetNumberOfComponents(3);
+  pointArray->SetNumberOfTuples(numberOfPoints);
+  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  points->SetData(pointArray);
 
-      mitk::ToFProcessingCommon::ToFPoint3D cartesianCoordinates;
-      switch (m_ReconstructionMode)
-      {
-      case WithOutInterPixelDistance:
-      {
-        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,focalLengthInPixelUnits,principalPoint);
-        break;
-      }
-      case WithInterPixelDistance:
-      {
-        cartesianCoordinates = mitk::ToFProcessingCommon::IndexToCartesianCoordinatesWithInterpixdist(completeIndexX,completeIndexY,distance,focalLengthInMm,m_InterPixelDistance,principalPoint);
-        break;
-      }
-      case Kinect:
+  vtkSmartPointer<vtkFloatArray> scalarArray = vtkSmartPointer<vtkFloatArray>::New();
+  if (scalarFloatData)
+    scalarArray->SetNumberOfTuples(numberOfPoints);
+
+  vtkSmartPointer<vtkFloatArray> textureCoords = vtkSmartPointer<vtkFloatArray>::New();
+  textureCoords->SetNumberOfComponents(2);
+  textureCoords->SetNumberOfTuples(numberOfPoints);
+
+  //Make a vtkIdList to save the ID's of the polyData corresponding to the image
+  //pixel ID's. VTK would insert empty points into the polydata if we inserted the
+  //points at their pixel ID's, hence the points of valid pixels are stored
+  //consecutively and the mapping is saved in the vertexIdList (0 for invalid pixels).
+  m_VertexIdList = vtkSmartPointer<vtkIdList>::New();
+  m_VertexIdList->SetNumberOfIds(size);
+
+  double* pointData = pointArray->GetPointer(0);
+  float* scalarData = scalarFloatData ? scalarArray->GetPointer(0) : nullptr;
+  float* textureData = textureCoords->GetPointer(0);
+  vtkIdType* vertexIds = m_VertexIdList->GetPointer(0);
+
+  // second pass: backprojection of the valid pixels
+#pragma omp parallel for
+  for (int j = 0; j < yDimension; ++j)
+  {
+    const std::size_t rowStart = static_cast<std::size_t>(j) * xDimension;
+    const float* distances = inputFloatData + rowStart;
+    const unsigned char* valid = validPixels.data() + rowStart;
+    const double* denominators = cache.PixelDenominators.empty() ? nullptr : cache.PixelDenominators.data() + rowStart;
+    const double rowTerm = cache.RowTerms[j];
+    //don't flip. we don't need to flip.
+    const float yNorm = ((float)j)/yDimension;
+
+    vtkIdType id = rowOffsets[j];
+    for (int i = 0; i < xDimension; ++i)
+    {
+      if (!valid[i])
       {
-        cartesianCoordinates = mitk::ToFProcessingCommon::KinectIndexToCartesianCoordinates(completeIndexX,completeIndexY,distance,focalLengthInPixelUnits,principalPoint);
-        break;
+        vertexIds[rowStart + i] = 0;
+        continue;
       }
-      default:
+
+      const double distance = distances[i];
+      double* point = pointData + 3 * id;
+      if (denominators)
       {
-        MITK_ERROR << "Incorrect reconstruction mode!";
-      }
+        point[0] = distance * cache.ColumnTerms[i] / denominators[i];
+        point[1] = distance * rowTerm / denominators[i];
+        point[2] = distance * cache.ZTerm / denominators[i];
       }
-      //Epsilon here, because we may have small float values like 0.00000001 which in fact represents 0.
-      if (distance<=mitk::eps)
+      else
       {
-        isPointValid[pixelID] = false;
+        point[0] = distance * cache.ColumnTerms[i] / cache.Parameters[0];
+        point[1] = distance * rowTerm / cache.Parameters[1];
+        point[2] = distance;
       }
-      else
+
+      vertexIds[rowStart + i] = id;
+
+      //Scalar values are necessary for mapping colors/texture onto the surface
+      if (scalarData)
+        scalarData[id] = scalarFloatData[rowStart + i];
+
+      //These Texture Coordinates will map color pixel and vertices 1:1 (e.g. for Kinect).
+      textureData[2 * id] = ((float)i)/xDimension; // correct video texture scale for kinect
+      textureData[2 * id + 1] = yNorm;
+      ++id;
+    }
+   }
+
+  // Without triangulation threshold the topology only depends on the valid pixels,
+  // so the cells of the last frame can be reused if they did not change.
+  const bool topologyDependsOnPoints = m_GenerateTriangularMesh && !mitk::Equal(m_TriangulationThreshold, 0.0);
+  const bool reuseTopology = !topologyDependsOnPoints && m_CachedPolys != nullptr &&
+    m_CachedTopologyIsTriangulated == m_GenerateTriangularMesh && validPixels == m_ValidPixels;
+
+  if (!reuseTopology)
+  {
+    std::vector<vtkIdType> polyConnectivity;
+    std::vector<vtkIdType> vertexConnectivity;
+
+    if (m_GenerateTriangularMesh)
+    {
+      polyConnectivity.reserve(6 * static_cast<std::size_t>(numberOfPoints));
+
+      //We can only start triangulation if we are at vertex (1,1),
+      //because we need the other 3 vertices near this one.
+      for (int j = 1; j < yDimension; ++j)
       {
-        isPointValid[pixelID] = true;
-        //VTK would insert empty points into the polydata if we use
-        //points->InsertPoint(pixelID, cartesianCoordinates.GetDataPointer()).
-        //If we use points->InsertNextPoint(...) instead, the ID's do not
-        //correspond to the image pixel ID's. Thus, we have to save them
-        //in the vertexIdList.
-        m_VertexIdList->SetId(pixelID, points->InsertNextPoint(cartesianCoordinates.GetDataPointer()));
-
-        if (m_GenerateTriangularMesh)
+        for (int i = 1; i < xDimension; ++i)
         {
-          if((i >= 1) && (j >= 1))
+          //This little piece of art explains the ID's:
+          //
+          // P(x_1y_1)---P(xy_1)
+          // |           |
+          // |           |
+          // |           |
+          // P(x_1y)-----P(xy)
+          //
+          //To go one pixel line back in the image array, we have to
+          //subtract 1x xDimension.
+          const std::size_t xy = i+j*xDimension;
+          const std::size_t x_1y = xy-1;
+          const std::size_t xy_1 = xy-xDimension;
+          const std::size_t x_1y_1 = xy_1-1;
+
+          if (!(validPixels[xy]&&validPixels[x_1y]&&validPixels[x_1y_1]&&validPixels[xy_1])) // check if points of cell are valid
+            continue;
+
+          //Find the corresponding vertex ID's in the saved vertexIdList:
+          const vtkIdType xyV = vertexIds[xy];
+          const vtkIdType x_1yV = vertexIds[x_1y];
+          const vtkIdType xy_1V = vertexIds[xy_1];
+          const vtkIdType x_1y_1V = vertexIds[x_1y_1];
+
+          if (topologyDependsOnPoints)
           {
-            //This little piece of art explains the ID's:
-            //
-            // P(x_1y_1)---P(xy_1)
-            // |           |
-            // |           |
-            // |           |
-            // P(x_1y)-----P(xy)
-            //
-            //We can only start triangulation if we are at vertex (1,1),
-            //because we need the other 3 vertices near this one.
-            //To go one pixel line back in the image array, we have to
-            //subtract 1x xDimension.
-            vtkIdType xy = pixelID;
-            vtkIdType x_1y = pixelID-1;
-            vtkIdType xy_1 = pixelID-xDimension;
-            vtkIdType x_1y_1 = xy_1-1;
-
-            //Find the corresponding vertex ID's in the saved vertexIdList:
-            vtkIdType xyV = m_VertexIdList->GetId(xy);
-            vtkIdType x_1yV = m_VertexIdList->GetId(x_1y);
-            vtkIdType xy_1V = m_VertexIdList->GetId(xy_1);
-            vtkIdType x_1y_1V = m_VertexIdList->GetId(x_1y_1);
-
-            if (isPointValid[xy]&&isPointValid[x_1y]&&isPointValid[x_1y_1]&&isPointValid[xy_1]) // check if points of cell are valid
+            const double* pointXY = pointData + 3 * xyV;
+            const double* pointX_1Y = pointData + 3 * x_1yV;
+            const double* pointXY_1 = pointData + 3 * xy_1V;
+            const double* pointX_1Y_1 = pointData + 3 * x_1y_1V;
+
+            if (!((vtkMath::Distance2BetweenPoints(pointXY, pointX_1Y) <= m_TriangulationThreshold)
+                  && (vtkMath::Distance2BetweenPoints(pointXY, pointXY_1) <= m_TriangulationThreshold)
+                  && (vtkMath::Distance2BetweenPoints(pointX_1Y, pointX_1Y_1) <= m_TriangulationThreshold)
+                  && (vtkMath::Distance2BetweenPoints(pointXY_1, pointX_1Y_1) <= m_TriangulationThreshold)))
             {
-              double pointXY[3], pointX_1Y[3], pointXY_1[3], pointX_1Y_1[3];
-
-              points->GetPoint(xyV, pointXY);
-              points->GetPoint(x_1yV, pointX_1Y);
-              points->GetPoint(xy_1V, pointXY_1);
-              points->GetPoint(x_1y_1V, pointX_1Y_1);
-
-              if( (mitk::Equal(m_TriangulationThreshold, 0.0)) || ((vtkMath::Distance2BetweenPoints(pointXY, pointX_1Y) <= m_TriangulationThreshold)
-                                                                   && (vtkMath::Distance2BetweenPoints(pointXY, pointXY_1) <= m_TriangulationThreshold)
-                                                                   && (vtkMath::Distance2BetweenPoints(pointX_1Y, pointX_1Y_1) <= m_TriangulationThreshold)
-                                                                   && (vtkMath::Distance2BetweenPoints(pointXY_1, pointX_1Y_1) <= m_TriangulationThreshold)))
-              {
-                polys->InsertNextCell(3);
-                polys->InsertCellPoint(x_1yV);
-                polys->InsertCellPoint(xyV);
-                polys->InsertCellPoint(x_1y_1V);
-
-                polys->InsertNextCell(3);
-                polys->InsertCellPoint(x_1y_1V);
-                polys->InsertCellPoint(xyV);
-                polys->InsertCellPoint(xy_1V);
-              }
-              else
-              {
-                //We dont want triangulation, but we want to keep the vertex
-                vertices->InsertNextCell(1);
-                vertices->InsertCellPoint(xyV);
-              }
+              //We dont want triangulation, but we want to keep the vertex
+              vertexConnectivity.push_back(xyV);
+              continue;
             }
           }
+
+          polyConnectivity.insert(polyConnectivity.end(), { x_1yV, xyV, x_1y_1V, x_1y_1V, xyV, xy_1V });
         }
-        else
-        {
-          //We dont want triangulation, we only want vertices
-          vertices->InsertNextCell(1);
-          vertices->InsertCellPoint(m_VertexIdList->GetId(pixelID));
-        }
-        //Scalar values are necessary for mapping colors/texture onto the surface
-        if (scalarFloatData)
-        {
-          scalarArray->InsertTuple1(m_VertexIdList->GetId(pixelID), scalarFloatData[pixelID]);
-        }
-        //These Texture Coordinates will map color pixel and vertices 1:1 (e.g. for Kinect).
-        float xNorm = (((float)i)/xDimension);// correct video texture scale for kinect
-        float yNorm = ((float)j)/yDimension; //don't flip. we don't need to flip.
-        textureCoords->InsertTuple2(m_VertexIdList->GetId(pixelID), xNorm, yNorm);
       }
     }
+    else
+    {
+      //We dont want triangulation, we only want vertices
+      vertexConnectivity.resize(numberOfPoints);
+      std::iota(vertexConnectivity.begin(), vertexConnectivity.end(), 0);
+    }
+
+    m_CachedPolys = CreateCellArray(3, polyConnectivity);
+    m_CachedVertices = CreateCellArray(1, vertexConnectivity);
+    m_CachedTopologyIsTriangulated = m_GenerateTriangularMesh;
+    if (topologyDependsOnPoints)
+      m_ValidPixels.clear(); // the cells depend on the points, never reuse them
+    else
+      m_ValidPixels.swap(validPixels);
   }
 
   vtkSmartPointer<vtkPolyData> mesh = vtkSmartPointer<vtkPolyData>::New();
   mesh->SetPoints(points);
-  mesh->SetPolys(polys);
-  mesh->SetVerts(vertices);
+  mesh->SetPolys(m_CachedPolys);
+  mesh->SetVerts(m_CachedVertices);
   //Pass the scalars to the polydata (if they were set).
   if (scalarArray->GetNumberOfTuples()>0)
   {
@@ -23,6 +23,9 @@ found in the LICENSE file.
 
 #include <vtkSmartPointer.h>
 #include <vtkIdList.h>
+#include <vtkCellArray.h>
+
+#include <vector>
 
 namespace mitk
 {
@@ -38,6 +41,12 @@ namespace mitk
   * The definition of the image plane and its coordinate systems (pixel and mm) is depicted in the following image
   * \image html Modules/ToFProcessing/Documentation/ImagePlane.png
   *
+  * For every reconstruction mode the cartesian coordinates are linear in the measured distance. The
+  * distance independent terms of each pixel are computed once and reused as long as image size, geometry
+  * and camera parameters do not change. The points are computed in parallel and written directly into
+  * preallocated VTK arrays. Without triangulation threshold the mesh topology only depends on which pixels
+  * are valid, so it is reused for consecutive frames with the same set of valid pixels.
+  *
   * @ingroup SurfaceFilters
   * @ingroup ToFProcessing
   */
@@ -168,6 +177,12 @@ namespace mitk
     */
     void CreateOutputsForAllInputs();
 
+    /**
+    * \brief Recomputes the distance independent terms of the backprojection if image size, geometry
+    * or camera parameters changed since the last call.
+    */
+    void UpdateBackprojectionCache(int xDimension, int yDimension, const mitk::Point3D& origin, const mitk::Vector3D& spacing);
+
     IplImage* m_IplScalarImage; ///< Scalar image used for surface texturing
 
     mitk::CameraIntrinsics::Pointer m_CameraIntrinsics; ///< Specifies the intrinsic parameters
@@ -185,6 +200,30 @@ namespace mitk
 
     double m_TriangulationThreshold;
 
+    /**
+    * \brief Distance independent terms of the backprojection, see UpdateBackprojectionCache().
+    *
+    * The cartesian coordinates of pixel (i,j) are distance * m_ColumnTerms[i] / m_PixelDenominators[i+j*xDimension] etc.
+    * In Kinect mode the denominators are the focal lengths and m_PixelDenominators is empty.
+    */
+    struct BackprojectionCache
+    {
+      int XDimension = 0;
+      int YDimension = 0;
+      ReconstructionModeType ReconstructionMode = WithInterPixelDistance;
+      double Parameters[10] = {}; ///< focal lengths, principal point, inter pixel distance, origin and spacing the cache was computed for
+      std::vector<double> ColumnTerms;
+      std::vector<double> RowTerms;
+      std::vector<double> PixelDenominators;
+      double ZTerm = 0.0;
+    };
+    BackprojectionCache m_BackprojectionCache;
+
+    std::vector<unsigned char> m_ValidPixels; ///< valid pixel mask of the last frame, determines the cached topology
+    vtkSmartPointer<vtkCellArray> m_CachedPolys; ///< triangles of the last frame, reused if the valid pixels did not change
+    vtkSmartPointer<vtkCellArray> m_CachedVertices; ///< vertices of the last frame, reused if the valid pixels did not change
+    bool m_CachedTopologyIsTriangulated; ///< m_GenerateTriangularMesh of the cached topology
+
   };
 } //END mitk namespace
 #endif
@@ -19,6 +19,7 @@ found in the LICENSE file.
 #include <mitkDataInteractor.h>
 
 #include "mitkTubeGraph.h"
+#include "mitkTubeGraphPicker.h"
 #include "mitkTubeGraphProperty.h"
 
 namespace mitk
@@ -117,6 +118,7 @@ namespace mitk
     ActivationMode m_ActivationMode;
     ActionMode m_ActionMode;
     mitk::TubeElement *m_LastPickedElement = nullptr;
+    TubeGraphPicker m_TubeGraphPicker;
   };
 }
 #endif
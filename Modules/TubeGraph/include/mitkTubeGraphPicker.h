@@ -19,6 +19,8 @@ found in the LICENSE file.
 #include "mitkTubeGraph.h"
 #include "mitkTubeGraphProperty.h"
 
+#include <vector>
+
 namespace mitk
 {
   class MITKTUBEGRAPH_EXPORT TubeGraphPicker
@@ -31,13 +33,57 @@ namespace mitk
 
     std::pair<mitk::TubeGraph::TubeDescriptorType, mitk::TubeElement *> GetPickedTube(const Point3D pickedPosition);
 
+    /**
+    * Returns all visible tubes, which have an element whose surface is closer than radius to the given world
+    * position. Distances are measured in the coordinate system of the tube elements.
+    */
+    std::vector<mitk::TubeGraph::TubeDescriptorType> GetTubesInRange(const Point3D position, ScalarType radius);
+
     TubeGraphPicker();
     virtual ~TubeGraphPicker();
 
   protected:
+    /**
+    * Element of the tube graph, stored in the order the graph is traversed by the picking.
+    */
+    struct PickableElement
+    {
+      Point3D Coordinates;
+      float Radius;
+      std::size_t Order;
+      TubeGraph::TubeDescriptorType Tube;
+      TubeElement *Element;
+    };
+
+    /**
+    * Node of the bounding volume hierarchy over the element spheres. The box bounds the element coordinates,
+    * MaximalRadius the element radii. Inner nodes have Count == 0 and their children at FirstChild and
+    * FirstChild + 1, leaves contain the elements [First, First + Count).
+    */
+    struct BoundingVolumeNode
+    {
+      Point3D Minimum;
+      Point3D Maximum;
+      float MaximalRadius;
+      std::size_t First;
+      std::size_t Count;
+      std::size_t FirstChild;
+    };
+
+    /**
+    * (Re)builds the bounding volume hierarchy if the tube graph was modified since the last build.
+    */
+    void UpdateBoundingVolumeHierarchy();
+    void BuildBoundingVolumeNode(std::size_t nodeIndex, std::size_t first, std::size_t count);
+    static ScalarType DistanceToNode(const BoundingVolumeNode &node, const Point3D &position);
+
     Point3D m_WorldPosition;
     TubeGraph::ConstPointer m_TubeGraph;
     TubeGraphProperty::Pointer m_TubeGraphProperty;
+
+    std::vector<PickableElement> m_Elements;
+    std::vector<BoundingVolumeNode> m_Nodes;
+    itk::ModifiedTimeType m_BuildTime;
   };
 
 } // namespace
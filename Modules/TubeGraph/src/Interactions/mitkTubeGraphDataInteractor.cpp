@@ -16,8 +16,6 @@ found in the LICENSE file.
 #include <mitkInteractionPositionEvent.h>
 #include <mitkStatusBar.h>
 
-#include "mitkTubeGraphPicker.h"
-
 #include <vtkCamera.h>
 #include <vtkInteractorStyle.h>
 #include <vtkPointData.h>
@@ -62,6 +60,9 @@ void mitk::TubeGraphDataInteractor::DataNodeChanged()
   }
   else
     m_TubeGraph = nullptr;
+
+  // the picker keeps its spatial index until the tube graph changes
+  m_TubeGraphPicker.SetTubeGraph(m_TubeGraph);
 }
 
 bool mitk::TubeGraphDataInteractor::CheckOverTube(const InteractionEvent *interactionEvent)
@@ -70,10 +71,10 @@ bool mitk::TubeGraphDataInteractor::CheckOverTube(const InteractionEvent *intera
   if (positionEvent == nullptr)
     return false;
 
-  auto *picker = new mitk::TubeGraphPicker();
-  picker->SetTubeGraph(m_TubeGraph);
+  if (m_TubeGraph.IsNull())
+    return false;
 
-  auto pickedTube = picker->GetPickedTube(positionEvent->GetPositionInWorld());
+  auto pickedTube = m_TubeGraphPicker.GetPickedTube(positionEvent->GetPositionInWorld());
 
   TubeGraph::TubeDescriptorType tubeDescriptor = pickedTube.first;
 
@@ -12,7 +12,18 @@ found in the LICENSE file.
 
 #include "mitkTubeGraphPicker.h"
 
-mitk::TubeGraphPicker::TubeGraphPicker()
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+
+namespace
+{
+  /** Maximal number of elements in a leaf of the bounding volume hierarchy.*/
+  const std::size_t MAXIMAL_LEAF_SIZE = 8;
+}
+
+mitk::TubeGraphPicker::TubeGraphPicker() : m_BuildTime(0)
 {
   m_WorldPosition.Fill(0.0);
 }
@@ -21,9 +32,126 @@ mitk::TubeGraphPicker::~TubeGraphPicker() {}
 
 void mitk::TubeGraphPicker::SetTubeGraph(const mitk::TubeGraph *tubeGraph)
 {
+  if (m_TubeGraph != tubeGraph)
+  {
+    m_Elements.clear();
+    m_Nodes.clear();
+    m_BuildTime = 0;
+  }
+
   m_TubeGraph = tubeGraph;
-  m_TubeGraphProperty =
-    dynamic_cast<TubeGraphProperty *>(m_TubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
+  m_TubeGraphProperty = nullptr;
+  if (m_TubeGraph.IsNotNull())
+    m_TubeGraphProperty =
+      dynamic_cast<TubeGraphProperty *>(m_TubeGraph->GetProperty("Tube Graph.Visualization Information").GetPointer());
+}
+
+void mitk::TubeGraphPicker::UpdateBoundingVolumeHierarchy()
+{
+  if (m_BuildTime != 0 && m_TubeGraph->GetMTime() <= m_BuildTime)
+    return;
+
+  m_Elements.clear();
+  m_Nodes.clear();
+
+  std::vector<mitk::TubeGraphEdge> allEdges = m_TubeGraph->GetVectorOfAllEdges();
+  for (auto edge = allEdges.begin(); edge != allEdges.end(); ++edge)
+  {
+    std::pair<mitk::TubeGraphVertex, mitk::TubeGraphVertex> soureTargetPair =
+      m_TubeGraph->GetVerticesOfAnEdge(m_TubeGraph->GetEdgeDescriptor(*edge));
+
+    TubeGraph::TubeDescriptorType tubeId(m_TubeGraph->GetVertexDescriptor(soureTargetPair.first),
+                                         m_TubeGraph->GetVertexDescriptor(soureTargetPair.second));
+
+    std::vector<mitk::TubeElement *> allElements = edge->GetElementVector();
+    for (unsigned int index = 0; index < edge->GetNumberOfElements(); index++)
+    {
+      PickableElement element;
+      element.Coordinates = allElements[index]->GetCoordinates();
+      if (dynamic_cast<mitk::CircularProfileTubeElement *>(allElements[index]))
+        element.Radius = ((dynamic_cast<mitk::CircularProfileTubeElement *>(allElements[index]))->GetDiameter()) / 2;
+      else
+        element.Radius = 0;
+      element.Order = m_Elements.size();
+      element.Tube = tubeId;
+      element.Element = allElements[index];
+      m_Elements.push_back(element);
+    }
+  }
+
+  if (!m_Elements.empty())
+  {
+    m_Nodes.reserve(4 * m_Elements.size() / MAXIMAL_LEAF_SIZE + 1);
+    m_Nodes.resize(1);
+    this->BuildBoundingVolumeNode(0, 0, m_Elements.size());
+  }
+
+  m_BuildTime = m_TubeGraph->GetMTime();
+}
+
+void mitk::TubeGraphPicker::BuildBoundingVolumeNode(std::size_t nodeIndex, std::size_t first, std::size_t count)
+{
+  BoundingVolumeNode node;
+  node.Minimum = m_Elements[first].Coordinates;
+  node.Maximum = m_Elements[first].Coordinates;
+  node.MaximalRadius = 0;
+  for (std::size_t i = first; i < first + count; ++i)
+  {
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      node.Minimum[d] = std::min(node.Minimum[d], m_Elements[i].Coordinates[d]);
+      node.Maximum[d] = std::max(node.Maximum[d], m_Elements[i].Coordinates[d]);
+    }
+    node.MaximalRadius = std::max(node.MaximalRadius, m_Elements[i].Radius);
+  }
+  node.First = first;
+  node.Count = count;
+  node.FirstChild = 0;
+
+  if (count <= MAXIMAL_LEAF_SIZE)
+  {
+    m_Nodes[nodeIndex] = node;
+    return;
+  }
+
+  // split at the median of the longest axis of the box
+  unsigned int axis = 0;
+  for (unsigned int d = 1; d < 3; ++d)
+  {
+    if (node.Maximum[d] - node.Minimum[d] > node.Maximum[axis] - node.Minimum[axis])
+      axis = d;
+  }
+
+  const std::size_t half = count / 2;
+  std::nth_element(m_Elements.begin() + first,
+                   m_Elements.begin() + first + half,
+                   m_Elements.begin() + first + count,
+                   [axis](const PickableElement &a, const PickableElement &b) {
+                     return a.Coordinates[axis] < b.Coordinates[axis];
+                   });
+
+  node.Count = 0;
+  node.FirstChild = m_Nodes.size();
+  m_Nodes[nodeIndex] = node;
+  m_Nodes.resize(m_Nodes.size() + 2);
+
+  this->BuildBoundingVolumeNode(node.FirstChild, first, half);
+  this->BuildBoundingVolumeNode(node.FirstChild + 1, first + half, count - half);
+}
+
+mitk::ScalarType mitk::TubeGraphPicker::DistanceToNode(const BoundingVolumeNode &node, const Point3D &position)
+{
+  ScalarType squaredDistance = 0;
+  for (unsigned int d = 0; d < 3; ++d)
+  {
+    ScalarType difference = 0;
+    if (position[d] < node.Minimum[d])
+      difference = node.Minimum[d] - position[d];
+    else if (position[d] > node.Maximum[d])
+      difference = position[d] - node.Maximum[d];
+    squaredDistance += difference * difference;
+  }
+  return std::sqrt(squaredDistance);
 }
 
 /**
@@ -38,56 +166,121 @@ std::pair<mitk::TubeGraph::TubeDescriptorType, mitk::TubeElement *> mitk::TubeGr
     mitk::TubeElement *nullPointer = nullptr;
     return std::pair<mitk::TubeGraph::TubeDescriptorType, mitk::TubeElement *>(TubeGraph::ErrorId, nullPointer);
   }
-  m_WorldPosition = pickedPosition;
 
-  Point3D currentPosition;
+  this->UpdateBoundingVolumeHierarchy();
+
+  // calculate point->point distance
+  itk::Index<3> worldIndex;
+  m_TubeGraph->GetGeometry()->WorldToIndex(pickedPosition, worldIndex);
+
+  m_WorldPosition[0] = worldIndex[0];
+  m_WorldPosition[1] = worldIndex[1];
+  m_WorldPosition[2] = worldIndex[2];
+
   ScalarType closestDistance = itk::NumericTraits<ScalarType>::max();
-  ScalarType currentDistance = itk::NumericTraits<ScalarType>::max();
-  float currentRadius = 0;
+  const PickableElement *closestElement = nullptr;
 
-  TubeGraph::TubeDescriptorType currentTubeId(TubeGraph::ErrorId);
-  TubeGraph::TubeDescriptorType tubeId(TubeGraph::ErrorId);
-  TubeElement *tubeElement;
+  // visibility is checked only for elements close enough to be picked
+  std::map<TubeGraph::TubeDescriptorType, bool> tubeVisibility;
+  auto isTubeVisible = [&](const TubeGraph::TubeDescriptorType &tube) {
+    auto visibility = tubeVisibility.find(tube);
+    if (visibility == tubeVisibility.end())
+      visibility =
+        tubeVisibility.emplace(tube, m_TubeGraphProperty.IsNull() || m_TubeGraphProperty->IsTubeVisible(tube)).first;
+    return visibility->second;
+  };
 
-  // iterate over all edges and find the edge, which element is near by the clicked point
-  std::vector<mitk::TubeGraphEdge> allEdges = m_TubeGraph->GetVectorOfAllEdges();
-  for (auto edge = allEdges.begin(); edge != allEdges.end(); ++edge)
+  // find the element with the closest center that is closer than one unit to its surface. On equal distances
+  // the element that comes first in the graph wins.
+  std::vector<std::size_t> stack;
+  if (!m_Nodes.empty())
+    stack.push_back(0);
+  while (!stack.empty())
   {
-    std::pair<mitk::TubeGraphVertex, mitk::TubeGraphVertex> soureTargetPair =
-      m_TubeGraph->GetVerticesOfAnEdge(m_TubeGraph->GetEdgeDescriptor(*edge));
+    const BoundingVolumeNode &node = m_Nodes[stack.back()];
+    stack.pop_back();
+
+    const ScalarType nodeDistance = DistanceToNode(node, m_WorldPosition);
+    if (nodeDistance - node.MaximalRadius >= 1.0 || nodeDistance > closestDistance)
+      continue;
+
+    if (node.Count == 0)
+    {
+      stack.push_back(node.FirstChild);
+      stack.push_back(node.FirstChild + 1);
+      continue;
+    }
 
-    currentTubeId = TubeGraph::TubeDescriptorType(m_TubeGraph->GetVertexDescriptor(soureTargetPair.first),
-                                                  m_TubeGraph->GetVertexDescriptor(soureTargetPair.second));
-    // check if the tube is visible, if not pass this tube. User can not choose a tube, which he can't see
-    if (m_TubeGraphProperty->IsTubeVisible(currentTubeId))
+    for (std::size_t i = node.First; i < node.First + node.Count; ++i)
     {
-      std::vector<mitk::TubeElement *> allElements = edge->GetElementVector();
-      for (unsigned int index = 0; index < edge->GetNumberOfElements(); index++)
-      {
-        currentPosition = allElements[index]->GetCoordinates();
-        if (dynamic_cast<mitk::CircularProfileTubeElement *>(allElements[index]))
-          currentRadius = ((dynamic_cast<mitk::CircularProfileTubeElement *>(allElements[index]))->GetDiameter()) / 2;
-        else
-          currentRadius = 0;
-
-        // calculate point->point distance
-        itk::Index<3> worldIndex;
-        m_TubeGraph->GetGeometry()->WorldToIndex(pickedPosition, worldIndex);
-
-        m_WorldPosition[0] = worldIndex[0];
-        m_WorldPosition[1] = worldIndex[1];
-        m_WorldPosition[2] = worldIndex[2];
-
-        currentDistance = m_WorldPosition.EuclideanDistanceTo(currentPosition);
-        if (currentDistance < closestDistance && (currentDistance - currentRadius) < 1.0)
-        {
-          closestDistance = currentDistance;
-          tubeId = currentTubeId;
-          tubeElement = allElements[index];
-        }
-      }
+      const PickableElement &element = m_Elements[i];
+      const ScalarType currentDistance = m_WorldPosition.EuclideanDistanceTo(element.Coordinates);
+      if ((currentDistance - element.Radius) >= 1.0 || currentDistance > closestDistance)
+        continue;
+      if (currentDistance == closestDistance && closestElement != nullptr && element.Order > closestElement->Order)
+        continue;
+      // check if the tube is visible, if not pass this tube. User can not choose a tube, which he can't see
+      if (!isTubeVisible(element.Tube))
+        continue;
+
+      closestDistance = currentDistance;
+      closestElement = &element;
     }
   }
 
-  return std::make_pair(tubeId, tubeElement);
+  if (closestElement == nullptr)
+    return std::pair<mitk::TubeGraph::TubeDescriptorType, mitk::TubeElement *>(TubeGraph::ErrorId, nullptr);
+
+  return std::make_pair(closestElement->Tube, closestElement->Element);
+}
+
+std::vector<mitk::TubeGraph::TubeDescriptorType> mitk::TubeGraphPicker::GetTubesInRange(const Point3D position,
+                                                                                        ScalarType radius)
+{
+  std::vector<TubeGraph::TubeDescriptorType> result;
+  if (!m_TubeGraph)
+  {
+    MITK_ERROR << "mitk::TubeGraphPicker: No tube graph available. Please set an input!" << std::endl;
+    return result;
+  }
+
+  this->UpdateBoundingVolumeHierarchy();
+
+  Point3D elementPosition;
+  m_TubeGraph->GetGeometry()->WorldToIndex(position, elementPosition);
+
+  std::set<TubeGraph::TubeDescriptorType> tubes;
+  std::vector<std::size_t> stack;
+  if (!m_Nodes.empty())
+    stack.push_back(0);
+  while (!stack.empty())
+  {
+    const BoundingVolumeNode &node = m_Nodes[stack.back()];
+    stack.pop_back();
+
+    if (DistanceToNode(node, elementPosition) - node.MaximalRadius > radius)
+      continue;
+
+    if (node.Count == 0)
+    {
+      stack.push_back(node.FirstChild);
+      stack.push_back(node.FirstChild + 1);
+      continue;
+    }
+
+    for (std::size_t i = node.First; i < node.First + node.Count; ++i)
+    {
+      const PickableElement &element = m_Elements[i];
+      if (elementPosition.EuclideanDistanceTo(element.Coordinates) - element.Radius <= radius)
+        tubes.insert(element.Tube);
+    }
+  }
+
+  for (const auto &tube : tubes)
+  {
+    if (m_TubeGraphProperty.IsNull() || m_TubeGraphProperty->IsTubeVisible(tube))
+      result.push_back(tube);
+  }
+
+  return result;
 }
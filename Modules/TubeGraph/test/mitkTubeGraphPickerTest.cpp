@@ -0,0 +1,340 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+// Testing
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+// other
+#include <mitkCircularProfileTubeElement.h>
+#include <mitkGeometry3D.h>
+#include <mitkTubeGraph.h>
+#include <mitkTubeGraphPicker.h>
+#include <mitkTubeGraphProperty.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+class mitkTubeGraphPickerTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkTubeGraphPickerTestSuite);
+  MITK_TEST(GetPickedTube_RandomPositions_EqualsBruteForce);
+  MITK_TEST(GetPickedTube_EqualDistances_FirstElementWins);
+  MITK_TEST(GetPickedTube_InvisibleTube_IsNotPicked);
+  MITK_TEST(GetPickedTube_GraphModified_FindsNewTube);
+  MITK_TEST(GetTubesInRange_RandomPositions_EqualsBruteForce);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::TubeGraph::TubeDescriptorType TubeDescriptorType;
+  typedef std::pair<TubeDescriptorType, mitk::TubeElement *> PickResultType;
+
+  mitk::TubeGraph::Pointer m_TubeGraph;
+  mitk::TubeGraphProperty::Pointer m_TubeGraphProperty;
+  std::vector<std::unique_ptr<mitk::CircularProfileTubeElement>> m_TubeElements;
+  std::vector<std::unique_ptr<mitk::TubeGraphProperty::LabelGroup::Label>> m_Labels;
+  mitk::TubeGraphProperty::LabelGroup::Label *m_HiddenLabel;
+
+  // The graph and its property do not own the tube elements and labels, so the fixture keeps them.
+  mitk::CircularProfileTubeElement *CreateElement(double x, double y, double z, float diameter)
+  {
+    m_TubeElements.emplace_back(new mitk::CircularProfileTubeElement(x, y, z, diameter));
+    return m_TubeElements.back().get();
+  }
+
+  mitk::TubeGraph::VertexDescriptorType AddVertex(double x, double y, double z)
+  {
+    return m_TubeGraph->AddVertex(mitk::TubeGraphVertex(this->CreateElement(x, y, z, 2.0f)));
+  }
+
+  void AddTube(mitk::TubeGraph::VertexDescriptorType source,
+               mitk::TubeGraph::VertexDescriptorType target,
+               const std::vector<mitk::TubeElement *> &elements)
+  {
+    mitk::TubeGraphEdge edge;
+    edge.SetElementVector(elements);
+    m_TubeGraph->AddEdge(source, target, edge);
+  }
+
+  TubeDescriptorType GetTubeDescriptor(const mitk::TubeGraphEdge &edge) const
+  {
+    const auto vertices = m_TubeGraph->GetVerticesOfAnEdge(m_TubeGraph->GetEdgeDescriptor(edge));
+    return TubeDescriptorType(m_TubeGraph->GetVertexDescriptor(vertices.first),
+                              m_TubeGraph->GetVertexDescriptor(vertices.second));
+  }
+
+  void HideTube(const TubeDescriptorType &tube)
+  {
+    auto tubesToLabels = m_TubeGraphProperty->GetTubesToLabels();
+    tubesToLabels[mitk::TubeGraphProperty::TubeToLabelGroupType(tube, "Visibility")] = m_HiddenLabel->labelName;
+    m_TubeGraphProperty->SetTubesToLabels(tubesToLabels);
+  }
+
+  // Builds a random tree of tubes with elements on integer positions, so that picked positions, which are
+  // rounded to indices, often have equal distances to several elements.
+  void CreateRandomTubeGraph(std::mt19937 &generator)
+  {
+    std::uniform_int_distribution<int> coordinate(0, 60);
+    std::uniform_int_distribution<int> step(-2, 2);
+    std::uniform_int_distribution<int> numberOfElements(5, 40);
+    std::uniform_real_distribution<float> diameter(0.0f, 6.0f);
+
+    std::vector<mitk::TubeGraph::VertexDescriptorType> vertices;
+    vertices.push_back(this->AddVertex(coordinate(generator), coordinate(generator), coordinate(generator)));
+
+    for (unsigned int i = 1; i < 40; ++i)
+    {
+      const auto source = vertices[std::uniform_int_distribution<std::size_t>(0, vertices.size() - 1)(generator)];
+      const mitk::Point3D start = m_TubeGraph->GetVertex(source).GetTubeElement()->GetCoordinates();
+
+      std::vector<mitk::TubeElement *> elements;
+      mitk::Point3D position = start;
+      const int count = numberOfElements(generator);
+      for (int j = 0; j < count; ++j)
+      {
+        for (unsigned int d = 0; d < 3; ++d)
+          position[d] += step(generator);
+        elements.push_back(this->CreateElement(position[0], position[1], position[2], diameter(generator)));
+      }
+
+      const auto target = this->AddVertex(position[0], position[1], position[2]);
+      this->AddTube(source, target, elements);
+      vertices.push_back(target);
+    }
+
+    // hide every fifth tube
+    const auto edges = m_TubeGraph->GetVectorOfAllEdges();
+    for (std::size_t i = 0; i < edges.size(); i += 5)
+      this->HideTube(this->GetTubeDescriptor(edges[i]));
+  }
+
+  // Linear scan over all elements in graph order, as the picker worked before the bounding volume hierarchy.
+  PickResultType BruteForcePick(const mitk::Point3D &pickedPosition) const
+  {
+    itk::Index<3> worldIndex;
+    m_TubeGraph->GetGeometry()->WorldToIndex(pickedPosition, worldIndex);
+    mitk::Point3D position;
+    for (unsigned int d = 0; d < 3; ++d)
+      position[d] = worldIndex[d];
+
+    PickResultType result(mitk::TubeGraph::ErrorId, nullptr);
+    mitk::ScalarType closestDistance = itk::NumericTraits<mitk::ScalarType>::max();
+
+    auto edges = m_TubeGraph->GetVectorOfAllEdges();
+    for (auto &edge : edges)
+    {
+      const auto tube = this->GetTubeDescriptor(edge);
+      if (!m_TubeGraphProperty->IsTubeVisible(tube))
+        continue;
+
+      for (auto *element : edge.GetElementVector())
+      {
+        const auto radius = dynamic_cast<mitk::CircularProfileTubeElement *>(element)->GetDiameter() / 2;
+        const auto distance = position.EuclideanDistanceTo(element->GetCoordinates());
+        if (distance < closestDistance && distance - radius < 1.0)
+        {
+          closestDistance = distance;
+          result = PickResultType(tube, element);
+        }
+      }
+    }
+
+    return result;
+  }
+
+  std::vector<TubeDescriptorType> BruteForceTubesInRange(const mitk::Point3D &worldPosition,
+                                                         mitk::ScalarType range) const
+  {
+    mitk::Point3D position;
+    m_TubeGraph->GetGeometry()->WorldToIndex(worldPosition, position);
+
+    std::set<TubeDescriptorType> tubes;
+    auto edges = m_TubeGraph->GetVectorOfAllEdges();
+    for (auto &edge : edges)
+    {
+      const auto tube = this->GetTubeDescriptor(edge);
+      if (!m_TubeGraphProperty->IsTubeVisible(tube))
+        continue;
+
+      for (auto *element : edge.GetElementVector())
+      {
+        const auto radius = dynamic_cast<mitk::CircularProfileTubeElement *>(element)->GetDiameter() / 2;
+        if (position.EuclideanDistanceTo(element->GetCoordinates()) - radius <= range)
+          tubes.insert(tube);
+      }
+    }
+
+    return std::vector<TubeDescriptorType>(tubes.begin(), tubes.end());
+  }
+
+  static mitk::Point3D CreatePoint(double x, double y, double z)
+  {
+    mitk::Point3D point;
+    point[0] = x;
+    point[1] = y;
+    point[2] = z;
+    return point;
+  }
+
+public:
+  void setUp() override
+  {
+    // identity geometry, so that world coordinates equal the element coordinates
+    m_TubeGraph = mitk::TubeGraph::New();
+    m_TubeGraph->SetGeometry(mitk::Geometry3D::New());
+    m_TubeGraphProperty = mitk::TubeGraphProperty::New();
+
+    // tubes without a label are visible, tubes with the hidden label are not
+    auto *labelGroup = new mitk::TubeGraphProperty::LabelGroup();
+    labelGroup->labelGroupName = "Visibility";
+    for (const auto &name : {"Undefined", "Hidden"})
+    {
+      m_Labels.emplace_back(new mitk::TubeGraphProperty::LabelGroup::Label());
+      m_Labels.back()->labelName = name;
+      m_Labels.back()->isVisible = m_Labels.size() == 1;
+      labelGroup->labels.push_back(m_Labels.back().get());
+    }
+    m_HiddenLabel = m_Labels.back().get();
+    m_TubeGraphProperty->AddLabelGroup(labelGroup, 0);
+
+    m_TubeGraph->SetProperty("Tube Graph.Visualization Information", m_TubeGraphProperty);
+  }
+
+  void tearDown() override
+  {
+    m_TubeGraph = nullptr;
+    m_TubeGraphProperty = nullptr;
+    m_TubeElements.clear();
+    m_Labels.clear();
+  }
+
+  void GetPickedTube_RandomPositions_EqualsBruteForce()
+  {
+    std::mt19937 generator(42);
+    this->CreateRandomTubeGraph(generator);
+
+    mitk::TubeGraphPicker picker;
+    picker.SetTubeGraph(m_TubeGraph);
+
+    std::uniform_real_distribution<double> coordinate(-10.0, 70.0);
+    unsigned int numberOfHits = 0;
+    for (unsigned int i = 0; i < 5000; ++i)
+    {
+      const auto position = CreatePoint(coordinate(generator), coordinate(generator), coordinate(generator));
+      const auto expected = this->BruteForcePick(position);
+      const auto actual = picker.GetPickedTube(position);
+
+      CPPUNIT_ASSERT_MESSAGE("Picked tube differs from brute force picking", expected.first == actual.first);
+      CPPUNIT_ASSERT_MESSAGE("Picked element differs from brute force picking", expected.second == actual.second);
+      if (actual.second != nullptr)
+        ++numberOfHits;
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("No tube was picked", numberOfHits > 0);
+  }
+
+  void GetPickedTube_EqualDistances_FirstElementWins()
+  {
+    auto *first = this->CreateElement(-2.0, 0.0, 0.0, 4.0f);
+    auto *second = this->CreateElement(2.0, 0.0, 0.0, 4.0f);
+    this->AddTube(this->AddVertex(-4.0, 0.0, 0.0), this->AddVertex(-3.0, 0.0, 0.0), {first});
+    this->AddTube(this->AddVertex(3.0, 0.0, 0.0), this->AddVertex(4.0, 0.0, 0.0), {second});
+
+    auto edges = m_TubeGraph->GetVectorOfAllEdges();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), edges.size());
+    const auto *expected = edges[0].GetTubeElement(0) == first ? first : second;
+
+    mitk::TubeGraphPicker picker;
+    picker.SetTubeGraph(m_TubeGraph);
+    const auto picked = picker.GetPickedTube(CreatePoint(0.0, 0.0, 0.0));
+
+    CPPUNIT_ASSERT_MESSAGE("The element that comes first in the graph was not picked", picked.second == expected);
+    CPPUNIT_ASSERT_MESSAGE("Picked tube does not match the element", picked.first == this->GetTubeDescriptor(edges[0]));
+  }
+
+  void GetPickedTube_InvisibleTube_IsNotPicked()
+  {
+    auto *nearElement = this->CreateElement(1.0, 0.0, 0.0, 2.0f);
+    auto *farElement = this->CreateElement(-3.0, 0.0, 0.0, 8.0f);
+    this->AddTube(this->AddVertex(1.0, 5.0, 0.0), this->AddVertex(1.0, 10.0, 0.0), {nearElement});
+    this->AddTube(this->AddVertex(-3.0, 5.0, 0.0), this->AddVertex(-3.0, 10.0, 0.0), {farElement});
+
+    mitk::TubeGraphPicker picker;
+    picker.SetTubeGraph(m_TubeGraph);
+    CPPUNIT_ASSERT_MESSAGE("Closest element was not picked",
+                           picker.GetPickedTube(CreatePoint(0.0, 0.0, 0.0)).second == nearElement);
+
+    auto edges = m_TubeGraph->GetVectorOfAllEdges();
+    for (auto &edge : edges)
+    {
+      if (edge.GetTubeElement(0) == nearElement)
+        this->HideTube(this->GetTubeDescriptor(edge));
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Element of an invisible tube was picked",
+                           picker.GetPickedTube(CreatePoint(0.0, 0.0, 0.0)).second == farElement);
+
+    const auto tubesInRange = picker.GetTubesInRange(CreatePoint(0.0, 0.0, 0.0), 5.0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Invisible tube was returned in range", std::size_t(1), tubesInRange.size());
+  }
+
+  void GetPickedTube_GraphModified_FindsNewTube()
+  {
+    auto *element = this->CreateElement(0.0, 0.0, 0.0, 2.0f);
+    this->AddTube(this->AddVertex(0.0, 5.0, 0.0), this->AddVertex(0.0, 10.0, 0.0), {element});
+
+    mitk::TubeGraphPicker picker;
+    picker.SetTubeGraph(m_TubeGraph);
+    CPPUNIT_ASSERT_MESSAGE("Element was not picked", picker.GetPickedTube(CreatePoint(0.0, 0.0, 0.0)).second == element);
+    CPPUNIT_ASSERT_MESSAGE("Element out of reach was picked",
+                           picker.GetPickedTube(CreatePoint(20.0, 0.0, 0.0)).second == nullptr);
+
+    // adding a tube modifies the graph, so the hierarchy has to be rebuilt
+    auto *newElement = this->CreateElement(20.0, 0.0, 0.0, 2.0f);
+    this->AddTube(this->AddVertex(20.0, 5.0, 0.0), this->AddVertex(20.0, 10.0, 0.0), {newElement});
+
+    CPPUNIT_ASSERT_MESSAGE("Element of the new tube was not picked",
+                           picker.GetPickedTube(CreatePoint(20.0, 0.0, 0.0)).second == newElement);
+  }
+
+  void GetTubesInRange_RandomPositions_EqualsBruteForce()
+  {
+    std::mt19937 generator(7);
+    this->CreateRandomTubeGraph(generator);
+
+    mitk::TubeGraphPicker picker;
+    picker.SetTubeGraph(m_TubeGraph);
+
+    std::uniform_real_distribution<double> coordinate(-10.0, 70.0);
+    std::uniform_real_distribution<double> range(0.0, 15.0);
+    unsigned int numberOfHits = 0;
+    for (unsigned int i = 0; i < 2000; ++i)
+    {
+      const auto position = CreatePoint(coordinate(generator), coordinate(generator), coordinate(generator));
+      const double radius = range(generator);
+
+      const auto expected = this->BruteForceTubesInRange(position, radius);
+      const auto actual = picker.GetTubesInRange(position, radius);
+
+      CPPUNIT_ASSERT_MESSAGE("Tubes in range differ from brute force search", expected == actual);
+      if (!actual.empty())
+        ++numberOfHits;
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("No tube was in range", numberOfHits > 0);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkTubeGraphPicker)
@@ -0,0 +1,171 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkUSImageRecorder.h"
+#include "mitkUSImageRecordingPlayer.h"
+#include "mitkUSImageLoggingFilter.h"
+#include <mitkTestingMacros.h>
+#include <mitkTestFixture.h>
+#include <mitkIOUtil.h>
+#include <mitkImageGenerator.h>
+#include <mitkImageReadAccessor.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+class mitkUSImageRecorderTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkUSImageRecorderTestSuite);
+  MITK_TEST(TestRecordAndPlayBack);
+  MITK_TEST(TestMismatchingImageDropped);
+  MITK_TEST(TestRecordingWithoutIndex);
+  MITK_TEST(TestLoggingFilterRecording);
+  MITK_TEST(TestLoggingFilterUnwritableFile);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+
+  std::string m_FileName;
+  std::vector<mitk::Image::Pointer> m_Images;
+
+  static bool ImagesHaveEqualData(const mitk::Image* image1, const mitk::Image* image2)
+  {
+    mitk::ImageReadAccessor accessor1(image1);
+    mitk::ImageReadAccessor accessor2(image2);
+    const std::size_t size = image1->GetDimension(0) * image1->GetDimension(1) * image1->GetDimension(2) * image1->GetPixelType().GetSize();
+    return 0 == std::memcmp(accessor1.GetData(), accessor2.GetData(), size);
+  }
+
+public:
+
+  void setUp() override
+  {
+    m_FileName = mitk::IOUtil::CreateTemporaryFile("USImageRecorderTest_XXXXXX.usrec");
+    m_Images.clear();
+    for (unsigned int i = 0; i < 5; ++i)
+      m_Images.push_back(mitk::ImageGenerator::GenerateRandomImage<unsigned char>(64, 48, 1, 1, 0.2, 0.3, 1.0));
+  }
+
+  void tearDown() override
+  {
+    m_Images.clear();
+    std::remove(m_FileName.c_str());
+  }
+
+  void TestRecordAndPlayBack()
+  {
+    mitk::USImageRecorder::Pointer recorder = mitk::USImageRecorder::New();
+    recorder->Start(m_FileName, m_Images[0]);
+    for (unsigned int i = 0; i < m_Images.size(); ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Frame is added to the ring", recorder->AddFrame(m_Images[i], 10.0 * i));
+      if (i == 2)
+        recorder->AddMessageToLastFrame("message");
+    }
+    recorder->Stop();
+
+    CPPUNIT_ASSERT_EQUAL(5u, recorder->GetNumberOfFrames());
+    CPPUNIT_ASSERT_EQUAL(0u, recorder->GetNumberOfDroppedFrames());
+
+    mitk::USImageRecordingPlayer::Pointer player = mitk::USImageRecordingPlayer::New();
+    player->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(5u, player->GetNumberOfFrames());
+
+    for (unsigned int i = 0; i < m_Images.size(); ++i)
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL(10.0 * i, player->GetTimeStamp(i), 1e-12);
+      CPPUNIT_ASSERT_EQUAL(std::string(i == 2 ? "message" : ""), player->GetMessage(i));
+
+      mitk::Image::Pointer frame = player->GetFrame(i);
+      CPPUNIT_ASSERT_MESSAGE("Pixel type is restored", frame->GetPixelType() == m_Images[i]->GetPixelType());
+      CPPUNIT_ASSERT_MESSAGE("Spacing is restored", mitk::Equal(frame->GetGeometry()->GetSpacing(), m_Images[i]->GetGeometry()->GetSpacing()));
+      CPPUNIT_ASSERT_MESSAGE("Pixel data is restored", ImagesHaveEqualData(frame, m_Images[i]));
+    }
+  }
+
+  void TestMismatchingImageDropped()
+  {
+    mitk::USImageRecorder::Pointer recorder = mitk::USImageRecorder::New();
+    recorder->Start(m_FileName, m_Images[0]);
+
+    mitk::Image::Pointer largerImage = mitk::ImageGenerator::GenerateRandomImage<unsigned char>(128, 48, 1, 1, 0.2, 0.3, 1.0);
+    CPPUNIT_ASSERT_MESSAGE("Frame of different size is dropped", !recorder->AddFrame(largerImage, 0.0));
+    recorder->Stop();
+
+    CPPUNIT_ASSERT_EQUAL(0u, recorder->GetNumberOfFrames());
+    CPPUNIT_ASSERT_EQUAL(1u, recorder->GetNumberOfDroppedFrames());
+    CPPUNIT_ASSERT_MESSAGE("No frames are added after stopping", !recorder->AddFrame(m_Images[0], 0.0));
+  }
+
+  void TestRecordingWithoutIndex()
+  {
+    mitk::USImageRecorder::Pointer recorder = mitk::USImageRecorder::New();
+    recorder->Start(m_FileName, m_Images[0]);
+    for (unsigned int i = 0; i < m_Images.size(); ++i)
+      recorder->AddFrame(m_Images[i], static_cast<double>(i));
+    recorder->Stop();
+
+    // cut off the index and footer as if the application had crashed during recording
+    std::ifstream input(m_FileName, std::ios::binary);
+    std::vector<char> content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+
+    const std::size_t indexSize = 4 + 4 + m_Images.size() * (8 + 4 + 8 + 4) + 8 + 8;
+
+    std::ofstream output(m_FileName, std::ios::binary | std::ios::trunc);
+    output.write(content.data(), content.size() - indexSize);
+    output.close();
+
+    mitk::USImageRecordingPlayer::Pointer player = mitk::USImageRecordingPlayer::New();
+    player->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(5u, player->GetNumberOfFrames());
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(4.0, player->GetTimeStamp(4), 1e-12);
+    CPPUNIT_ASSERT_MESSAGE("Pixel data is restored", ImagesHaveEqualData(player->GetFrame(4), m_Images[4]));
+  }
+
+  void TestLoggingFilterRecording()
+  {
+    mitk::USImageLoggingFilter::Pointer filter = mitk::USImageLoggingFilter::New();
+    filter->StartRecording(m_FileName);
+    CPPUNIT_ASSERT(filter->IsRecording());
+
+    for (unsigned int i = 0; i < m_Images.size(); ++i)
+    {
+      filter->SetInput(m_Images[i]);
+      filter->Update();
+    }
+    filter->AddMessageToCurrentImage("last");
+    filter->StopRecording();
+    CPPUNIT_ASSERT(!filter->IsRecording());
+
+    mitk::USImageRecordingPlayer::Pointer player = mitk::USImageRecordingPlayer::New();
+    player->Open(m_FileName);
+    CPPUNIT_ASSERT_EQUAL(5u, player->GetNumberOfFrames());
+    CPPUNIT_ASSERT_EQUAL(std::string("last"), player->GetMessage(4));
+    CPPUNIT_ASSERT_MESSAGE("Pixel data is restored", ImagesHaveEqualData(player->GetFrame(0), m_Images[0]));
+  }
+
+  void TestLoggingFilterUnwritableFile()
+  {
+    // the temporary file is not a directory, hence no file can be created in it
+    mitk::USImageLoggingFilter::Pointer filter = mitk::USImageLoggingFilter::New();
+    CPPUNIT_ASSERT_THROW(filter->StartRecording(m_FileName + "/recording.usrec"), mitk::Exception);
+    CPPUNIT_ASSERT(!filter->IsRecording());
+
+    // the pipeline keeps working without recording
+    filter->SetInput(m_Images[0]);
+    CPPUNIT_ASSERT_NO_THROW(filter->Update());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkUSImageRecorder)
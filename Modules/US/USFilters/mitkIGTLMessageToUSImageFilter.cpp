@@ -14,7 +14,69 @@ found in the LICENSE file.
 #include <igtlImageMessage.h>
 #include <itkByteSwapper.h>
 
-#include <vtkSmartPointer.h>
+#include <memory>
+#include <mutex>
+
+namespace
+{
+  // Number of free pixel buffers that are kept for reuse, enough for the consumer to hold
+  // on to the current image while the next one is received.
+  const std::size_t IMAGE_POOL_SIZE = 3;
+
+  // OpenIGTLink image messages always describe three dimensional images
+  const unsigned int IMAGE_DIMENSION = 3;
+
+  template <typename TPixel>
+  void SwapToSystemByteOrder(TPixel* data, size_t numberOfPixels, bool big_endian)
+  {
+    // Even though this method is called "FromSystemToBigEndian", it also swaps
+    // "FromBigEndianToSystem".
+    // This makes sense, but might be confusing at first glance.
+    if (big_endian)
+      itk::ByteSwapper<TPixel>::SwapRangeFromSystemToBigEndian(data, numberOfPixels);
+    else
+      itk::ByteSwapper<TPixel>::SwapRangeFromSystemToLittleEndian(data, numberOfPixels);
+  }
+}
+
+class mitk::IGTLMessageToUSImageFilter::ImageBufferPool
+{
+public:
+  /** Returns a free buffer of the given size or allocates a new one.*/
+  char* Acquire(std::size_t size)
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for (auto it = m_FreeBuffers.begin(); it != m_FreeBuffers.end(); ++it)
+    {
+      if (it->second == size)
+      {
+        char* buffer = it->first.release();
+        m_FreeBuffers.erase(it);
+        return buffer;
+      }
+    }
+
+    return new char[size];
+  }
+
+  /** Takes back a buffer no image data item references anymore. Items may be deleted by any thread.*/
+  void Release(char* buffer, std::size_t size)
+  {
+    std::unique_ptr<char[]> releasedBuffer(buffer);
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // keep the most recently released buffers, e.g. the ones of the current image size
+    if (m_FreeBuffers.size() >= IMAGE_POOL_SIZE)
+      m_FreeBuffers.erase(m_FreeBuffers.begin());
+
+    m_FreeBuffers.emplace_back(std::move(releasedBuffer), size);
+  }
+
+private:
+  std::mutex m_Mutex;
+  std::vector<std::pair<std::unique_ptr<char[]>, std::size_t>> m_FreeBuffers;
+};
 
 void mitk::IGTLMessageToUSImageFilter::GetNextRawImage(
   std::vector<mitk::Image::Pointer>& imgVector)
@@ -80,30 +142,22 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
   igtl::ImageMessage* msg,
   bool big_endian)
 {
-  typedef itk::Image<TPixel, 3> ImageType;
-
-  typename ImageType::Pointer output = ImageType::New();
-  typename ImageType::RegionType region;
-  typename ImageType::RegionType::SizeType size;
-  typename ImageType::RegionType::IndexType index;
-  typename ImageType::SpacingType spacing;
-  typename ImageType::PointType origin;
-
   // Copy dimensions
-  int dims[3];
+  int dims[IMAGE_DIMENSION];
   msg->GetDimensions(dims);
+  unsigned int dimensions[IMAGE_DIMENSION];
   size_t num_pixel = 1;
-  for (size_t i = 0; i < 3; i++)
+  for (size_t i = 0; i < IMAGE_DIMENSION; i++)
   {
-    size[i] = dims[i];
+    dimensions[i] = dims[i];
     num_pixel *= dims[i];
   }
 
   // Handle subvolume information. We want the subvolume to be the whole image
   // for now.
-  int sdims[3], offs[3];
+  int sdims[IMAGE_DIMENSION], offs[IMAGE_DIMENSION];
   msg->GetSubVolume(sdims, offs);
-  for (size_t i = 0; i < 3; i++)
+  for (size_t i = 0; i < IMAGE_DIMENSION; i++)
   {
     if (offs[i] != 0 || sdims[i] != dims[i])
     {
@@ -112,61 +166,45 @@ void mitk::IGTLMessageToUSImageFilter::Initiate(mitk::Image::Pointer& img,
     }
   }
 
-  index.Fill(0);
-
-  float matF[4][4];
-  msg->GetMatrix(matF);
-  vtkSmartPointer<vtkMatrix4x4> vtkMatrix = vtkSmartPointer<vtkMatrix4x4>::New();
-
-  for (size_t i = 0; i < 4; ++i)
-    for (size_t j = 0; j < 4; ++j)
-      vtkMatrix->SetElement(i, j, matF[i][j]);
-
-  float spacingMsg[3];
-
+  float spacingMsg[IMAGE_DIMENSION];
   msg->GetSpacing(spacingMsg);
 
-  for (int i = 0; i < 3; ++i)
+  mitk::Vector3D spacing;
+  for (unsigned int i = 0; i < IMAGE_DIMENSION; ++i)
     spacing[i] = spacingMsg[i];
 
-  region.SetSize(size);
-  region.SetIndex(index);
-  output->SetRegions(region);
-  output->SetSpacing(spacing);
-  output->Allocate();
+  const mitk::PixelType pixelType = mitk::MakeScalarPixelType<TPixel>();
+  const TPixel* in = (const TPixel*)msg->GetScalarPointer();
 
-  TPixel* in = (TPixel*)msg->GetScalarPointer();
-  TPixel* out = (TPixel*)output->GetBufferPointer();
-  memcpy(out, in, num_pixel * sizeof(TPixel));
-  if (big_endian)
-  {
-    // Even though this method is called "FromSystemToBigEndian", it also swaps
-    // "FromBigEndianToSystem".
-    // This makes sense, but might be confusing at first glance.
-    itk::ByteSwapper<TPixel>::SwapRangeFromSystemToBigEndian(out, num_pixel);
-  }
-  else
-  {
-    itk::ByteSwapper<TPixel>::SwapRangeFromSystemToLittleEndian(out, num_pixel);
-  }
+  // every frame gets a new image, only its pixel buffer is reused once all data items of
+  // an earlier frame were deleted
+  const std::size_t bufferSize = num_pixel * sizeof(TPixel);
+  char* buffer = m_BufferPool->Acquire(bufferSize);
+  memcpy(buffer, in, bufferSize);
+  SwapToSystemByteOrder(reinterpret_cast<TPixel*>(buffer), num_pixel, big_endian);
 
   img = mitk::Image::New();
-  img->InitializeByItk(output.GetPointer());
-  img->SetVolume(output->GetBufferPointer());
-  //img->GetGeometry()->SetIndexToWorldTransformByVtkMatrix(vtkMatrix);
-  m_previousImage = img;
+  img->Initialize(pixelType, IMAGE_DIMENSION, dimensions);
 
-  float iorigin[3];
-  msg->GetOrigin(iorigin);
-  for (size_t i = 0; i < 3; i++)
+  if (!img->SetImportChannel(buffer, 0, mitk::Image::ReferenceMemory))
   {
-    origin[i] = iorigin[i];
+    m_BufferPool->Release(buffer, bufferSize);
+    mitkThrow() << "Could not import the pixels of the OpenIGTLink image message";
   }
-  output->SetOrigin(origin);
+
+  // the buffer goes back to the pool when the last data item referencing it is deleted, which
+  // may be later than the image, e.g. for volumes of a time selector or vtkImageData accessors
+  std::shared_ptr<ImageBufferPool> bufferPool = m_BufferPool;
+  img->GetChannelData(0)->SetDataOwner(std::shared_ptr<void>(
+    buffer, [bufferPool, bufferSize](void* b) { bufferPool->Release(static_cast<char*>(b), bufferSize); }));
+
+  img->GetGeometry()->SetSpacing(spacing);
+  m_previousImage = img;
 }
 
 mitk::IGTLMessageToUSImageFilter::IGTLMessageToUSImageFilter()
-  : m_upstream(nullptr)
+  : m_upstream(nullptr),
+    m_BufferPool(std::make_shared<ImageBufferPool>())
 {
   MITK_DEBUG << "Instantiated this (" << this << ") mitkIGTMessageToUSImageFilter\n";
 }
@@ -19,6 +19,8 @@ found in the LICENSE file.
 #include <mitkIGTLMessageSource.h>
 #include <igtlImageMessage.h>
 
+#include <memory>
+
 namespace mitk
 {
   class MITKUS_EXPORT IGTLMessageToUSImageFilter : public USImageSource
@@ -62,10 +64,25 @@ namespace mitk
   private:
     mitk::IGTLMessageSource* m_upstream;
     mitk::Image::Pointer m_previousImage;
+
+    /**
+     * \brief Pixel buffers that are reused for the output images.
+     *
+     * A buffer is acquired for every new output image and released when the last image
+     * data item referencing it is deleted, so data still held by consumers is never
+     * overwritten.
+     */
+    class ImageBufferPool;
+    std::shared_ptr<ImageBufferPool> m_BufferPool;
+
     /**
      * \brief Templated method to copy the data of the OIGTL message to the image, depending
      * on the pixel type contained in the message.
      *
+     * The pixels are copied from the message body once, directly into the buffer of a new
+     * output image. The buffer is taken from the buffer pool and returned to it when the
+     * last image data item referencing it is deleted.
+     *
      * \param img the image to fill with the data from msg
      * \param msg the OIGTL message to copy the data from
      * \param big_endian whether the data is in big endian byte order
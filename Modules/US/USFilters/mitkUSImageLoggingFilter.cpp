@@ -22,12 +22,14 @@ found in the LICENSE file.
 
 
 mitk::USImageLoggingFilter::USImageLoggingFilter() : m_SystemTimeClock(RealTimeClock::New()),
-                                                     m_ImageExtension(".nrrd")
+                                                     m_ImageExtension(".nrrd"),
+                                                     m_RecordingRingSize(32)
 {
 }
 
 mitk::USImageLoggingFilter::~USImageLoggingFilter()
 {
+  this->StopRecording();
 }
 
 void mitk::USImageLoggingFilter::GenerateData()
@@ -41,6 +43,15 @@ void mitk::USImageLoggingFilter::GenerateData()
     return;
     }
 
+  if (!m_RecordingFileName.empty())
+  {
+    //the recorder copies the image once into its ring, no clone is needed
+    if (!m_Recorder->IsRecording())
+      m_Recorder->Start(inputImage);
+    m_Recorder->AddFrame(inputImage, m_SystemTimeClock->GetCurrentStamp());
+    return;
+  }
+
   //a clone is needed for a output and to store it.
   mitk::Image::Pointer inputClone = inputImage->Clone();
 
@@ -79,9 +90,45 @@ void mitk::USImageLoggingFilter::GenerateData()
 
 void mitk::USImageLoggingFilter::AddMessageToCurrentImage(std::string message)
 {
+  if (this->IsRecording())
+  {
+    m_Recorder->AddMessageToLastFrame(message);
+    return;
+  }
+
   m_LoggedMessages.insert(std::make_pair(static_cast<int>(m_LoggedImages.size()-1),message));
 }
 
+void mitk::USImageLoggingFilter::StartRecording(const std::string& fileName)
+{
+  if (this->IsRecording())
+    mitkThrow() << "Recording is already running.";
+
+  if (fileName.empty())
+    mitkThrow() << "Cannot start recording without a file name.";
+
+  // open the file right away, so an unwritable path is reported once to the caller
+  // instead of on every frame of the pipeline update
+  auto recorder = mitk::USImageRecorder::New();
+  recorder->SetRingSize(m_RecordingRingSize);
+  recorder->Open(fileName);
+
+  m_Recorder = recorder;
+  m_RecordingFileName = fileName;
+}
+
+void mitk::USImageLoggingFilter::StopRecording()
+{
+  if (m_Recorder.IsNotNull())
+    m_Recorder->Stop();
+  m_RecordingFileName.clear();
+}
+
+bool mitk::USImageLoggingFilter::IsRecording() const
+{
+  return !m_RecordingFileName.empty();
+}
+
 void mitk::USImageLoggingFilter::SaveImages(std::string path)
 {
 std::vector<std::string> dummy1;
@@ -17,6 +17,7 @@ found in the LICENSE file.
 #include <MitkUSExports.h>
 #include <mitkImageToImageFilter.h>
 #include <mitkRealTimeClock.h>
+#include "mitkUSImageRecorder.h"
 
 
 namespace mitk {
@@ -25,6 +26,10 @@ namespace mitk {
    *  add messages. All data (images, timestamps and messages) is written to the harddisc when
    *  the method SaveImages(...) is called.
    *
+   *  For long acquisitions StartRecording(...) can be used instead: the frames are then streamed
+   *  compressed to a single file by a mitk::USImageRecorder and not kept in memory. Such a recording
+   *  can be read by mitk::USImageRecordingPlayer.
+   *
    *  Caution: only supports logging of one input at the moment, multiple inputs are ignored!
    *
    *  \ingroup US
@@ -72,6 +77,28 @@ namespace mitk {
      */
     bool SetImageFilesExtension(std::string extension);
 
+    /** Starts streaming all following images to the given file instead of keeping clones in memory.
+     *  The file is opened immediately, the header is written with the first image, whose pixel type
+     *  and size have to be kept for the whole recording.
+     *  @throw mitk::Exception Throws an exception if a recording is already running or the file
+     *                         cannot be opened.
+     */
+    void StartRecording(const std::string& fileName);
+
+    /** Writes all pending images of the recording and closes the file. */
+    void StopRecording();
+
+    bool IsRecording() const;
+
+    /** Sets the number of images that may wait for compression during a recording (default: 32).
+     *  If the recording cannot keep up, further images are dropped.
+     */
+    itkSetMacro(RecordingRingSize, unsigned int);
+    itkGetConstMacro(RecordingRingSize, unsigned int);
+
+    /** Returns the recorder of the current or last recording, e.g. to query the number of dropped frames. */
+    itkGetConstObjectMacro(Recorder, mitk::USImageRecorder);
+
 
   protected:
     USImageLoggingFilter();
@@ -85,6 +112,11 @@ namespace mitk {
     std::vector<double> m_LoggedMITKSystemTimes; ///< Logged system times for every logged image
     std::string m_ImageExtension; ///< stores the image extension, default is ".nrrd"
 
+    //members for recording
+    mitk::USImageRecorder::Pointer m_Recorder; ///< streams the images to disc while recording
+    std::string m_RecordingFileName; ///< file of the recording, empty if not recording
+    unsigned int m_RecordingRingSize; ///< number of images that may wait for compression
+
   };
 } // namespace mitk
 #endif /* MITKUSImageSource_H_HEADER_INCLUDED_ */
@@ -0,0 +1,278 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkUSImageRecorder.h"
+#include <mitkExceptionMacro.h>
+#include <mitkImageReadAccessor.h>
+
+#include <lz4.h>
+
+#include <algorithm>
+#include <cstring>
+
+const char mitk::USImageRecorder::FileFormat::HeaderMagic[8] = { 'M', 'I', 'T', 'K', 'U', 'S', 'R', 'C' };
+const char mitk::USImageRecorder::FileFormat::FooterMagic[8] = { 'M', 'I', 'T', 'K', 'U', 'S', 'I', 'X' };
+const uint32_t mitk::USImageRecorder::FileFormat::Version;
+const uint32_t mitk::USImageRecorder::FileFormat::ChunkMagic;
+const uint32_t mitk::USImageRecorder::FileFormat::IndexMagic;
+
+namespace
+{
+  template <typename T>
+  void WriteValue(std::ostream& stream, const T& value)
+  {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+}
+
+mitk::USImageRecorder::USImageRecorder()
+  : m_RingSize(32),
+    m_FrameSize(0),
+    m_FirstPendingSlot(0),
+    m_NumberOfPendingSlots(0),
+    m_StopThread(false),
+    m_NumberOfFrames(0),
+    m_NumberOfDroppedFrames(0)
+{
+  m_Dimensions[0] = m_Dimensions[1] = m_Dimensions[2] = 0;
+}
+
+mitk::USImageRecorder::~USImageRecorder()
+{
+  this->Stop();
+}
+
+void mitk::USImageRecorder::Open(const std::string& fileName)
+{
+  if (this->IsRecording())
+    mitkThrow() << "Recording is already running.";
+
+  if (m_File.is_open())
+    m_File.close();
+
+  m_File.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_File.is_open())
+    mitkThrow() << "Cannot open " << fileName << " for recording.";
+}
+
+void mitk::USImageRecorder::Start(const std::string& fileName, const mitk::Image* referenceImage)
+{
+  this->Open(fileName);
+  this->Start(referenceImage);
+}
+
+void mitk::USImageRecorder::Start(const mitk::Image* referenceImage)
+{
+  if (this->IsRecording())
+    mitkThrow() << "Recording is already running.";
+
+  if (!m_File.is_open())
+    mitkThrow() << "Cannot start recording without an open file.";
+
+  if (nullptr == referenceImage || !referenceImage->IsInitialized())
+    mitkThrow() << "Cannot start recording without a valid reference image.";
+
+  m_PixelType = std::make_unique<mitk::PixelType>(referenceImage->GetPixelType());
+  for (unsigned int i = 0; i < 3; ++i)
+    m_Dimensions[i] = referenceImage->GetDimension(i);
+  m_FrameSize = static_cast<std::size_t>(m_Dimensions[0]) * m_Dimensions[1] * m_Dimensions[2] * m_PixelType->GetSize();
+
+  this->WriteHeader(referenceImage);
+
+  // allocate all slots up front, the ring is reused for the whole recording
+  m_Ring.assign(std::max(m_RingSize, 1u), Slot());
+  for (auto& slot : m_Ring)
+    slot.Data.resize(m_FrameSize);
+
+  m_FirstPendingSlot = 0;
+  m_NumberOfPendingSlots = 0;
+  m_NumberOfFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_Index.clear();
+  m_Messages.clear();
+  m_StopThread = false;
+
+  m_Thread = std::thread(&USImageRecorder::Run, this);
+}
+
+void mitk::USImageRecorder::Stop()
+{
+  if (!m_Thread.joinable())
+  {
+    if (m_File.is_open())
+      m_File.close();
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_StopThread = true;
+  }
+  m_FrameAdded.notify_one();
+  m_Thread.join();
+
+  this->WriteIndex();
+  m_File.close();
+
+  // release the memory of the ring
+  std::vector<Slot>().swap(m_Ring);
+}
+
+bool mitk::USImageRecorder::IsRecording() const
+{
+  return m_Thread.joinable();
+}
+
+bool mitk::USImageRecorder::AddFrame(const mitk::Image* image, double timeStamp)
+{
+  if (!this->IsRecording() || nullptr == image || !image->IsInitialized())
+    return false;
+
+  if (image->GetPixelType() != *m_PixelType || image->GetDimension(0) != m_Dimensions[0] ||
+      image->GetDimension(1) != m_Dimensions[1] || image->GetDimension(2) != m_Dimensions[2])
+  {
+    MITK_WARN << "Image does not match pixel type and size of the recording. Frame is dropped.";
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ++m_NumberOfDroppedFrames;
+    return false;
+  }
+
+  std::unique_lock<std::mutex> lock(m_Mutex);
+
+  if (m_NumberOfPendingSlots == m_Ring.size())
+  {
+    ++m_NumberOfDroppedFrames;
+    return false;
+  }
+
+  Slot& slot = m_Ring[(m_FirstPendingSlot + m_NumberOfPendingSlots) % m_Ring.size()];
+  lock.unlock();
+
+  // the slot is not pending yet, hence the worker does not touch it
+  {
+    mitk::ImageReadAccessor accessor(image, image->GetVolumeData(0));
+    std::memcpy(slot.Data.data(), accessor.GetData(), m_FrameSize);
+  }
+
+  lock.lock();
+  slot.TimeStamp = timeStamp;
+  slot.FrameIndex = m_NumberOfFrames++;
+  ++m_NumberOfPendingSlots;
+  lock.unlock();
+
+  m_FrameAdded.notify_one();
+  return true;
+}
+
+void mitk::USImageRecorder::AddMessageToLastFrame(const std::string& message)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  if (m_NumberOfFrames > 0)
+    m_Messages[m_NumberOfFrames - 1] = message;
+}
+
+unsigned int mitk::USImageRecorder::GetNumberOfFrames() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfFrames;
+}
+
+unsigned int mitk::USImageRecorder::GetNumberOfDroppedFrames() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumberOfDroppedFrames;
+}
+
+void mitk::USImageRecorder::Run()
+{
+  std::vector<char> compressed(LZ4_compressBound(static_cast<int>(m_FrameSize)));
+
+  while (true)
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_FrameAdded.wait(lock, [this]() { return m_StopThread || m_NumberOfPendingSlots > 0; });
+
+    if (m_NumberOfPendingSlots == 0)
+      return; // stopped and all frames are written
+
+    const Slot& slot = m_Ring[m_FirstPendingSlot];
+    lock.unlock();
+
+    const int compressedSize = LZ4_compress_default(slot.Data.data(), compressed.data(),
+      static_cast<int>(m_FrameSize), static_cast<int>(compressed.size()));
+
+    if (compressedSize <= 0)
+    {
+      MITK_ERROR << "LZ4 compression failed!";
+    }
+    else
+    {
+      m_Index.push_back({ static_cast<uint64_t>(m_File.tellp()), slot.FrameIndex, slot.TimeStamp });
+
+      WriteValue(m_File, FileFormat::ChunkMagic);
+      WriteValue(m_File, slot.FrameIndex);
+      WriteValue(m_File, slot.TimeStamp);
+      WriteValue(m_File, static_cast<uint32_t>(m_FrameSize));
+      WriteValue(m_File, static_cast<uint32_t>(compressedSize));
+      m_File.write(compressed.data(), compressedSize);
+    }
+
+    lock.lock();
+    m_FirstPendingSlot = (m_FirstPendingSlot + 1) % m_Ring.size();
+    --m_NumberOfPendingSlots;
+  }
+}
+
+void mitk::USImageRecorder::WriteHeader(const mitk::Image* referenceImage)
+{
+  const auto* geometry = referenceImage->GetGeometry();
+  const auto spacing = geometry->GetSpacing();
+  const auto origin = geometry->GetOrigin();
+
+  m_File.write(FileFormat::HeaderMagic, sizeof(FileFormat::HeaderMagic));
+  WriteValue(m_File, FileFormat::Version);
+  WriteValue(m_File, static_cast<int32_t>(m_PixelType->GetPixelType()));
+  WriteValue(m_File, static_cast<int32_t>(m_PixelType->GetComponentType()));
+  WriteValue(m_File, static_cast<uint32_t>(m_PixelType->GetNumberOfComponents()));
+  WriteValue(m_File, static_cast<uint32_t>(m_PixelType->GetSize() / m_PixelType->GetNumberOfComponents()));
+
+  for (unsigned int i = 0; i < 3; ++i)
+    WriteValue(m_File, static_cast<uint32_t>(m_Dimensions[i]));
+  for (unsigned int i = 0; i < 3; ++i)
+    WriteValue(m_File, static_cast<double>(spacing[i]));
+  for (unsigned int i = 0; i < 3; ++i)
+    WriteValue(m_File, static_cast<double>(origin[i]));
+}
+
+void mitk::USImageRecorder::WriteIndex()
+{
+  const auto indexOffset = static_cast<uint64_t>(m_File.tellp());
+
+  WriteValue(m_File, FileFormat::IndexMagic);
+  WriteValue(m_File, static_cast<uint32_t>(m_Index.size()));
+
+  for (const auto& entry : m_Index)
+  {
+    auto messageIt = m_Messages.find(entry.FrameIndex);
+    const std::string message = messageIt != m_Messages.end() ? messageIt->second : std::string();
+
+    WriteValue(m_File, entry.Offset);
+    WriteValue(m_File, entry.FrameIndex);
+    WriteValue(m_File, entry.TimeStamp);
+    WriteValue(m_File, static_cast<uint32_t>(message.size()));
+    m_File.write(message.data(), message.size());
+  }
+
+  WriteValue(m_File, indexOffset);
+  m_File.write(FileFormat::FooterMagic, sizeof(FileFormat::FooterMagic));
+}
@@ -0,0 +1,155 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKUSImageRecorder_H_HEADER_INCLUDED_
+#define MITKUSImageRecorder_H_HEADER_INCLUDED_
+
+// MITK
+#include <MitkUSExports.h>
+#include <mitkCommon.h>
+#include <mitkImage.h>
+
+// ITK
+#include <itkObject.h>
+
+// STL
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mitk {
+  /** Records a stream of images of constant size and pixel type to a single file.
+   *
+   *  Frames passed to AddFrame(...) are copied into a ring of preallocated slots and
+   *  compressed (LZ4) and appended to the file by a worker thread. Memory is bounded by
+   *  the ring size: if the worker cannot keep up and all slots are occupied, new frames are
+   *  dropped and counted instead of being buffered.
+   *
+   *  The file starts with a header describing pixel type and geometry, followed by one
+   *  chunk per frame. Stop() appends an index with the offset, timestamp and message of
+   *  every frame, which allows mitk::USImageRecordingPlayer random access to the frames.
+   *  If a recording was not stopped properly, the player rebuilds the index from the chunks.
+   *  Data is written in the byte order of the recording machine.
+   *
+   *  Frames must be added by a single thread, e.g. the thread updating the filter pipeline.
+   *
+   *  \ingroup US
+   */
+  class MITKUS_EXPORT USImageRecorder : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(USImageRecorder, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /** Sets the number of frames that may wait for compression (default: 32). Takes effect on the next Start(). */
+    itkSetMacro(RingSize, unsigned int);
+    itkGetConstMacro(RingSize, unsigned int);
+
+    /** Opens (and truncates) the file of the next recording. This allows to report an unwritable
+     *  file before the first image is known; Start(referenceImage) then writes the header.
+     *  @throw mitk::Exception Throws an exception if the recording is already running or the file
+     *                         cannot be opened.
+     */
+    void Open(const std::string& fileName);
+
+    /** Starts the worker thread for the file given to Open(). Pixel type and geometry of the
+     *  recording are taken from the given reference image.
+     *  @throw mitk::Exception Throws an exception if the recording is already running, no file
+     *                         is open or the reference image is invalid.
+     */
+    void Start(const mitk::Image* referenceImage);
+
+    /** Opens the file and starts the worker thread, see Open() and Start(referenceImage). */
+    void Start(const std::string& fileName, const mitk::Image* referenceImage);
+
+    /** Writes all pending frames and the index and closes the file. A file that was opened
+     *  but never started is closed as well. */
+    void Stop();
+
+    bool IsRecording() const;
+
+    /** Copies the first volume of the image into the ring.
+     *  @return False if the frame was dropped because the ring is full or the image does not match
+     *          the pixel type and size of the recording.
+     */
+    bool AddFrame(const mitk::Image* image, double timeStamp);
+
+    /** Attaches a message to the last added frame. The messages are written to the index on Stop(). */
+    void AddMessageToLastFrame(const std::string& message);
+
+    /** Returns the number of frames that were added to the ring. */
+    unsigned int GetNumberOfFrames() const;
+
+    /** Returns the number of frames that were dropped. */
+    unsigned int GetNumberOfDroppedFrames() const;
+
+    /** Constants of the file format shared with mitk::USImageRecordingPlayer. */
+    struct FileFormat
+    {
+      static const char HeaderMagic[8];
+      static const char FooterMagic[8];
+      static const uint32_t Version = 1;
+      static const uint32_t ChunkMagic = 0x4d415246; // "FRAM"
+      static const uint32_t IndexMagic = 0x58444e49; // "INDX"
+    };
+
+  protected:
+    USImageRecorder();
+    ~USImageRecorder() override;
+
+    struct Slot
+    {
+      std::vector<char> Data;
+      double TimeStamp = 0.0;
+      uint32_t FrameIndex = 0;
+    };
+
+    struct IndexEntry
+    {
+      uint64_t Offset;
+      uint32_t FrameIndex;
+      double TimeStamp;
+    };
+
+    /** Compresses and writes the frames of the ring until Stop() is called. */
+    void Run();
+
+    void WriteHeader(const mitk::Image* referenceImage);
+    void WriteIndex();
+
+    unsigned int m_RingSize;
+    std::size_t m_FrameSize;
+    std::unique_ptr<mitk::PixelType> m_PixelType;
+    unsigned int m_Dimensions[3];
+
+    std::ofstream m_File;
+    std::thread m_Thread;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_FrameAdded;
+    std::vector<Slot> m_Ring;
+    std::size_t m_FirstPendingSlot;
+    std::size_t m_NumberOfPendingSlots;
+    bool m_StopThread;
+
+    unsigned int m_NumberOfFrames;
+    unsigned int m_NumberOfDroppedFrames;
+    std::vector<IndexEntry> m_Index;
+    std::map<unsigned int, std::string> m_Messages;
+  };
+} // namespace mitk
+#endif /* MITKUSImageRecorder_H_HEADER_INCLUDED_ */
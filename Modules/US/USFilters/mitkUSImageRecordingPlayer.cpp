@@ -0,0 +1,291 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#include "mitkUSImageRecordingPlayer.h"
+#include "mitkUSImageRecorder.h"
+#include <mitkExceptionMacro.h>
+#include <mitkImageWriteAccessor.h>
+
+#include <lz4.h>
+
+#include <cstring>
+
+namespace
+{
+  template <typename T>
+  bool ReadValue(std::istream& stream, T& value)
+  {
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return stream.good();
+  }
+
+  template <typename T>
+  mitk::PixelType MakeRecordedPixelType(int ioPixelType, unsigned int numberOfComponents)
+  {
+    switch (ioPixelType)
+    {
+    case itk::ImageIOBase::RGB:
+      return mitk::MakePixelType<T, itk::RGBPixel<T>>(3);
+    case itk::ImageIOBase::RGBA:
+      return mitk::MakePixelType<T, itk::RGBAPixel<T>>(4);
+    default:
+      return mitk::MakePixelType<T, T>(numberOfComponents);
+    }
+  }
+
+  mitk::PixelType MakeRecordedPixelType(int ioPixelType, int ioComponentType, unsigned int numberOfComponents)
+  {
+    switch (ioComponentType)
+    {
+    case itk::ImageIOBase::UCHAR:
+      return MakeRecordedPixelType<unsigned char>(ioPixelType, numberOfComponents);
+    case itk::ImageIOBase::CHAR:
+      return MakeRecordedPixelType<char>(ioPixelType, numberOfComponents);
+    case itk::ImageIOBase::USHORT:
+      return MakeRecordedPixelType<unsigned short>(ioPixelType, numberOfComponents);
+    case itk::ImageIOBase::SHORT:
+      return MakeRecordedPixelType<short>(ioPixelType, numberOfComponents);
+    case itk::ImageIOBase::UINT:
+      return MakeRecordedPixelType<unsigned int>(ioPixelType, numberOfComponents);
+    case itk::ImageIOBase::INT:
+      return MakeRecordedPixelType<int>(ioPixelType, numberOfComponents);
+    case itk::ImageIOBase::ULONG:
+      return MakeRecordedPixelType<unsigned long>(ioPixelType, numberOfComponents);
+    case itk::ImageIOBase::LONG:
+      return MakeRecordedPixelType<long>(ioPixelType, numberOfComponents);
+    case itk::ImageIOBase::FLOAT:
+      return MakeRecordedPixelType<float>(ioPixelType, numberOfComponents);
+    case itk::ImageIOBase::DOUBLE:
+      return MakeRecordedPixelType<double>(ioPixelType, numberOfComponents);
+    default:
+      mitkThrow() << "Unsupported component type " << ioComponentType << " in recording.";
+    }
+  }
+}
+
+mitk::USImageRecordingPlayer::USImageRecordingPlayer()
+  : m_FrameSize(0),
+    m_FirstChunkOffset(0)
+{
+  m_Dimensions[0] = m_Dimensions[1] = m_Dimensions[2] = 0;
+  m_Spacing.Fill(1.0);
+  m_Origin.Fill(0.0);
+}
+
+mitk::USImageRecordingPlayer::~USImageRecordingPlayer()
+{
+}
+
+void mitk::USImageRecordingPlayer::Open(const std::string& fileName)
+{
+  if (m_File.is_open())
+    m_File.close();
+  m_File.clear();
+  m_Index.clear();
+
+  m_File.open(fileName, std::ios::in | std::ios::binary);
+  if (!m_File.is_open())
+    mitkThrow() << "Cannot open recording " << fileName << ".";
+
+  this->ReadHeader();
+
+  if (!this->ReadIndex())
+  {
+    MITK_WARN << "Recording " << fileName << " has no index, probably it was not stopped properly. Rebuilding index.";
+    this->RebuildIndex();
+  }
+}
+
+unsigned int mitk::USImageRecordingPlayer::GetNumberOfFrames() const
+{
+  return static_cast<unsigned int>(m_Index.size());
+}
+
+double mitk::USImageRecordingPlayer::GetTimeStamp(unsigned int index) const
+{
+  if (index >= m_Index.size())
+    mitkThrow() << "Frame index " << index << " is out of range.";
+
+  return m_Index[index].TimeStamp;
+}
+
+std::string mitk::USImageRecordingPlayer::GetMessage(unsigned int index) const
+{
+  if (index >= m_Index.size())
+    mitkThrow() << "Frame index " << index << " is out of range.";
+
+  return m_Index[index].Message;
+}
+
+mitk::Image::Pointer mitk::USImageRecordingPlayer::GetFrame(unsigned int index)
+{
+  if (index >= m_Index.size())
+    mitkThrow() << "Frame index " << index << " is out of range.";
+
+  m_File.clear();
+  m_File.seekg(static_cast<std::streamoff>(m_Index[index].Offset));
+
+  uint32_t magic = 0, frameIndex = 0, uncompressedSize = 0, compressedSize = 0;
+  double timeStamp = 0.0;
+  if (!ReadValue(m_File, magic) || magic != USImageRecorder::FileFormat::ChunkMagic ||
+      !ReadValue(m_File, frameIndex) || !ReadValue(m_File, timeStamp) ||
+      !ReadValue(m_File, uncompressedSize) || !ReadValue(m_File, compressedSize) ||
+      uncompressedSize != m_FrameSize)
+  {
+    mitkThrow() << "Frame " << index << " of the recording is corrupt.";
+  }
+
+  m_CompressedBuffer.resize(compressedSize);
+  if (!m_File.read(m_CompressedBuffer.data(), compressedSize))
+    mitkThrow() << "Frame " << index << " of the recording is truncated.";
+
+  mitk::Image::Pointer image = mitk::Image::New();
+  image->Initialize(*m_PixelType, 3, m_Dimensions);
+  image->GetGeometry()->SetSpacing(m_Spacing);
+  image->GetGeometry()->SetOrigin(m_Origin);
+
+  mitk::ImageWriteAccessor accessor(image);
+  const int decompressedSize = LZ4_decompress_safe(m_CompressedBuffer.data(), static_cast<char*>(accessor.GetData()),
+    static_cast<int>(compressedSize), static_cast<int>(m_FrameSize));
+
+  if (decompressedSize != static_cast<int>(m_FrameSize))
+    mitkThrow() << "LZ4 decompression of frame " << index << " failed!";
+
+  return image;
+}
+
+void mitk::USImageRecordingPlayer::ReadHeader()
+{
+  char magic[8];
+  m_File.read(magic, sizeof(magic));
+  if (!m_File || 0 != std::memcmp(magic, USImageRecorder::FileFormat::HeaderMagic, sizeof(magic)))
+    mitkThrow() << "File is no ultrasound image recording.";
+
+  uint32_t version = 0, numberOfComponents = 0, bytesPerComponent = 0;
+  int32_t ioPixelType = 0, ioComponentType = 0;
+  if (!ReadValue(m_File, version) || version != USImageRecorder::FileFormat::Version)
+    mitkThrow() << "Unsupported version " << version << " of ultrasound image recording.";
+
+  ReadValue(m_File, ioPixelType);
+  ReadValue(m_File, ioComponentType);
+  ReadValue(m_File, numberOfComponents);
+  ReadValue(m_File, bytesPerComponent);
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    uint32_t dimension = 0;
+    ReadValue(m_File, dimension);
+    m_Dimensions[i] = dimension;
+  }
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    double spacing = 1.0;
+    ReadValue(m_File, spacing);
+    m_Spacing[i] = spacing;
+  }
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    double origin = 0.0;
+    ReadValue(m_File, origin);
+    m_Origin[i] = origin;
+  }
+
+  if (!m_File)
+    mitkThrow() << "Header of ultrasound image recording is truncated.";
+
+  m_PixelType = std::make_unique<mitk::PixelType>(MakeRecordedPixelType(ioPixelType, ioComponentType, numberOfComponents));
+  if (m_PixelType->GetSize() != bytesPerComponent * numberOfComponents)
+    mitkThrow() << "Pixel type of ultrasound image recording does not match this platform.";
+
+  m_FrameSize = static_cast<std::size_t>(m_Dimensions[0]) * m_Dimensions[1] * m_Dimensions[2] * m_PixelType->GetSize();
+  m_FirstChunkOffset = static_cast<uint64_t>(m_File.tellg());
+}
+
+bool mitk::USImageRecordingPlayer::ReadIndex()
+{
+  const std::streamoff footerSize = sizeof(uint64_t) + sizeof(USImageRecorder::FileFormat::FooterMagic);
+
+  m_File.clear();
+  m_File.seekg(0, std::ios::end);
+  const std::streamoff fileSize = m_File.tellg();
+  if (fileSize < static_cast<std::streamoff>(m_FirstChunkOffset) + footerSize)
+    return false;
+
+  uint64_t indexOffset = 0;
+  char magic[8];
+  m_File.seekg(fileSize - footerSize);
+  ReadValue(m_File, indexOffset);
+  m_File.read(magic, sizeof(magic));
+  if (!m_File || 0 != std::memcmp(magic, USImageRecorder::FileFormat::FooterMagic, sizeof(magic)))
+    return false;
+
+  uint32_t indexMagic = 0, numberOfFrames = 0;
+  m_File.seekg(static_cast<std::streamoff>(indexOffset));
+  if (!ReadValue(m_File, indexMagic) || indexMagic != USImageRecorder::FileFormat::IndexMagic ||
+      !ReadValue(m_File, numberOfFrames))
+    return false;
+
+  m_Index.reserve(numberOfFrames);
+  for (uint32_t i = 0; i < numberOfFrames; ++i)
+  {
+    IndexEntry entry;
+    uint32_t frameIndex = 0, messageLength = 0;
+    if (!ReadValue(m_File, entry.Offset) || !ReadValue(m_File, frameIndex) ||
+        !ReadValue(m_File, entry.TimeStamp) || !ReadValue(m_File, messageLength))
+    {
+      m_Index.clear();
+      return false;
+    }
+
+    entry.Message.resize(messageLength);
+    if (messageLength > 0 && !m_File.read(&entry.Message[0], messageLength))
+    {
+      m_Index.clear();
+      return false;
+    }
+
+    m_Index.push_back(std::move(entry));
+  }
+
+  return true;
+}
+
+void mitk::USImageRecordingPlayer::RebuildIndex()
+{
+  m_Index.clear();
+  m_File.clear();
+  m_File.seekg(0, std::ios::end);
+  const uint64_t fileSize = static_cast<uint64_t>(m_File.tellg());
+
+  uint64_t offset = m_FirstChunkOffset;
+  while (true)
+  {
+    m_File.clear();
+    m_File.seekg(static_cast<std::streamoff>(offset));
+
+    uint32_t magic = 0, frameIndex = 0, uncompressedSize = 0, compressedSize = 0;
+    double timeStamp = 0.0;
+    if (!ReadValue(m_File, magic) || magic != USImageRecorder::FileFormat::ChunkMagic ||
+        !ReadValue(m_File, frameIndex) || !ReadValue(m_File, timeStamp) ||
+        !ReadValue(m_File, uncompressedSize) || !ReadValue(m_File, compressedSize))
+      break;
+
+    const uint64_t dataOffset = static_cast<uint64_t>(m_File.tellg());
+    if (dataOffset + compressedSize > fileSize)
+      break; // the last chunk was not written completely
+
+    m_Index.push_back({ offset, timeStamp, std::string() });
+    offset = dataOffset + compressedSize;
+  }
+
+  m_File.clear();
+}
@@ -0,0 +1,88 @@
+/*============================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center (DKFZ)
+All rights reserved.
+
+Use of this source code is governed by a 3-clause BSD license that can be
+found in the LICENSE file.
+
+============================================================================*/
+
+#ifndef MITKUSImageRecordingPlayer_H_HEADER_INCLUDED_
+#define MITKUSImageRecordingPlayer_H_HEADER_INCLUDED_
+
+// MITK
+#include <MitkUSExports.h>
+#include <mitkCommon.h>
+#include <mitkImage.h>
+
+// ITK
+#include <itkObject.h>
+
+// STL
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace mitk {
+  /** Reads recordings written by mitk::USImageRecorder. Frames are decompressed on demand,
+   *  so only the requested frame is held in memory.
+   *
+   *  \ingroup US
+   */
+  class MITKUS_EXPORT USImageRecordingPlayer : public itk::Object
+  {
+  public:
+    mitkClassMacroItkParent(USImageRecordingPlayer, itk::Object);
+    itkFactorylessNewMacro(Self);
+
+    /** Opens a recording and reads its index. If the index is missing because the recording was
+     *  not stopped properly, it is rebuilt from the frame chunks.
+     *  @throw mitk::Exception Throws an exception if the file cannot be opened or is no valid recording.
+     */
+    void Open(const std::string& fileName);
+
+    unsigned int GetNumberOfFrames() const;
+
+    /** @throw mitk::Exception Throws an exception if the index is out of range. */
+    double GetTimeStamp(unsigned int index) const;
+
+    /** @throw mitk::Exception Throws an exception if the index is out of range. */
+    std::string GetMessage(unsigned int index) const;
+
+    /** Decompresses the frame with the given index into a new image.
+     *  @throw mitk::Exception Throws an exception if the index is out of range or the frame is corrupt.
+     */
+    mitk::Image::Pointer GetFrame(unsigned int index);
+
+  protected:
+    USImageRecordingPlayer();
+    ~USImageRecordingPlayer() override;
+
+    struct IndexEntry
+    {
+      uint64_t Offset;
+      double TimeStamp;
+      std::string Message;
+    };
+
+    void ReadHeader();
+    bool ReadIndex();
+    void RebuildIndex();
+
+    std::ifstream m_File;
+    std::unique_ptr<mitk::PixelType> m_PixelType;
+    unsigned int m_Dimensions[3];
+    mitk::Vector3D m_Spacing;
+    mitk::Point3D m_Origin;
+    std::size_t m_FrameSize;
+    uint64_t m_FirstChunkOffset;
+
+    std::vector<IndexEntry> m_Index;
+    std::vector<char> m_CompressedBuffer;
+  };
+} // namespace mitk
+#endif /* MITKUSImageRecordingPlayer_H_HEADER_INCLUDED_ */
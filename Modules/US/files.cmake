@@ -18,6 +18,8 @@ USModel/mitkUSDeviceWriterXML.cpp
 
 ## Filters and Sources
 USFilters/mitkUSImageLoggingFilter.cpp
+USFilters/mitkUSImageRecorder.cpp
+USFilters/mitkUSImageRecordingPlayer.cpp
 USFilters/mitkUSImageSource.cpp
 USFilters/mitkUSImageVideoSource.cpp
 USFilters/mitkIGTLMessageToUSImageFilter.cpp